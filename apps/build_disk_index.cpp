@@ -20,10 +20,16 @@ int main(int argc, char **argv)
 {
     std::string data_type, dist_fn, data_path, index_path_prefix, codebook_prefix, label_file, universal_label,
         label_type, partitioning_algorithm_str;
-    uint32_t num_threads, R, L, disk_PQ, build_PQ, QD, Lf, filter_threshold, ommega;
+    uint32_t num_threads, R, L, disk_PQ, build_PQ, QD, PQ_bits, Lf, filter_threshold, ommega;
     float B, M, episilon;
     bool append_reorder_data = false;
     bool use_opq = false;
+    bool use_disk_opq = false;
+    bool use_rabitq = false;
+    bool bfs_layout = false;
+    bool pack_nhoods = false;
+    bool inline_pq_codes = false;
+    bool separate_vectors = false;
 
     po::options_description desc{
         program_options_utils::make_program_description("build_disk_index", "Build a disk-based index.")};
@@ -64,14 +70,38 @@ int main(int argc, char **argv)
                                        program_options_utils::GRAPH_BUILD_COMPLEXITY);
         optional_configs.add_options()("QD", po::value<uint32_t>(&QD)->default_value(0),
                                        " Quantized Dimension for compression");
+        optional_configs.add_options()("PQ_bits", po::value<uint32_t>(&PQ_bits)->default_value(8),
+                                       "Bits per code of the in-memory PQ data used during search: 8 to 16 "
+                                       "(codes wider than 8 bits are packed, so B buys fewer but finer "
+                                       "chunks), or 4 for fast-scan distances (16 centers per chunk)");
         optional_configs.add_options()("codebook_prefix", po::value<std::string>(&codebook_prefix)->default_value(""),
                                        "Path prefix for pre-trained codebook");
         optional_configs.add_options()("PQ_disk_bytes", po::value<uint32_t>(&disk_PQ)->default_value(0),
                                        "Number of bytes to which vectors should be compressed "
                                        "on SSD; 0 for no compression");
+        optional_configs.add_options()("use_disk_opq", po::bool_switch()->default_value(false),
+                                       "Compress the vectors on SSD (PQ_disk_bytes) with OPQ, which learns a "
+                                       "rotation of the data along with the codebooks.");
+        optional_configs.add_options()("rabitq", po::bool_switch()->default_value(false),
+                                       "Also keep 1-bit RaBitQ codes of the vectors in memory, whose error bounds "
+                                       "discard neighbors before their PQ distances are computed (L2 only).");
         optional_configs.add_options()("append_reorder_data", po::bool_switch()->default_value(false),
                                        "Include full precision data in the index. Use only in "
                                        "conjuction with compressed data on SSD.");
+        optional_configs.add_options()("bfs_layout", po::bool_switch()->default_value(false),
+                                       "Lay out nodes on disk in BFS order from the medoid so that graph "
+                                       "neighbors tend to share sectors. Search results keep the original ids.");
+        optional_configs.add_options()("pack_nhoods", po::bool_switch()->default_value(false),
+                                       "Store neighbor lists delta-encoded on disk to fit more nodes per "
+                                       "sector. Works best with --bfs_layout.");
+        optional_configs.add_options()("inline_pq_codes", po::bool_switch()->default_value(false),
+                                       "Store the PQ code of every neighbor next to its id on disk, so that "
+                                       "search computes neighbor distances from the sector it read. Costs "
+                                       "more bytes per node.");
+        optional_configs.add_options()("separate_vectors", po::bool_switch()->default_value(false),
+                                       "Store full precision vectors apart from the graph on disk, so that "
+                                       "search reads only neighbor lists and fetches full vectors just to "
+                                       "rerank the final candidates. Not used with PQ_disk_bytes.");
         optional_configs.add_options()("build_PQ_bytes", po::value<uint32_t>(&build_PQ)->default_value(0),
                                        program_options_utils::BUIlD_GRAPH_PQ_BYTES);
         optional_configs.add_options()("use_opq", po::bool_switch()->default_value(false),
@@ -103,6 +133,18 @@ int main(int argc, char **argv)
             append_reorder_data = true;
         if (vm["use_opq"].as<bool>())
             use_opq = true;
+        if (vm["use_disk_opq"].as<bool>())
+            use_disk_opq = true;
+        if (vm["rabitq"].as<bool>())
+            use_rabitq = true;
+        if (vm["bfs_layout"].as<bool>())
+            bfs_layout = true;
+        if (vm["pack_nhoods"].as<bool>())
+            pack_nhoods = true;
+        if (vm["inline_pq_codes"].as<bool>())
+            inline_pq_codes = true;
+        if (vm["separate_vectors"].as<bool>())
+            separate_vectors = true;
     }
     catch (const std::exception &ex)
     {
@@ -142,13 +184,30 @@ int main(int argc, char **argv)
         }
     }
 
+    if (use_disk_opq && disk_PQ == 0)
+    {
+        std::cout << "Error: use_disk_opq needs vectors compressed on disk (PQ_disk_bytes)." << std::endl;
+        return -1;
+    }
+
+    if (use_rabitq && metric != diskann::Metric::L2)
+    {
+        std::cout << "Error: rabitq codes only support the l2 distance function." << std::endl;
+        return -1;
+    }
+
     auto partitioning_algorithm = stringToPartitioningAlgorithm(partitioning_algorithm_str);
 
     std::string params = std::string(std::to_string(R)) + " " + std::string(std::to_string(L)) + " " +
                          std::string(std::to_string(B)) + " " + std::string(std::to_string(M)) + " " +
                          std::string(std::to_string(num_threads)) + " " + std::string(std::to_string(disk_PQ)) + " " +
                          std::string(std::to_string(append_reorder_data)) + " " +
-                         std::string(std::to_string(build_PQ)) + " " + std::string(std::to_string(QD));
+                         std::string(std::to_string(build_PQ)) + " " + std::string(std::to_string(QD)) + " " +
+                         std::string(std::to_string(bfs_layout)) + " " + std::string(std::to_string(pack_nhoods)) +
+                         " " + std::string(std::to_string(inline_pq_codes)) + " " +
+                         std::string(std::to_string(separate_vectors)) + " " + std::string(std::to_string(PQ_bits)) +
+                         " " + std::string(std::to_string(use_disk_opq)) + " " +
+                         std::string(std::to_string(use_rabitq));
 
     try
     {
@@ -169,6 +228,16 @@ int main(int argc, char **argv)
                     data_path.c_str(), index_path_prefix.c_str(), params.c_str(), metric, partitioning_algorithm,
                     use_opq, codebook_prefix, use_filters, label_file, universal_label, filter_threshold, Lf, ommega,
                     episilon);
+            else if (data_type == std::string("float16"))
+                return diskann::build_disk_index<diskann::float16, uint16_t>(
+                    data_path.c_str(), index_path_prefix.c_str(), params.c_str(), metric, partitioning_algorithm,
+                    use_opq, codebook_prefix, use_filters, label_file, universal_label, filter_threshold, Lf, ommega,
+                    episilon);
+            else if (data_type == std::string("bfloat16"))
+                return diskann::build_disk_index<diskann::bfloat16, uint16_t>(
+                    data_path.c_str(), index_path_prefix.c_str(), params.c_str(), metric, partitioning_algorithm,
+                    use_opq, codebook_prefix, use_filters, label_file, universal_label, filter_threshold, Lf, ommega,
+                    episilon);
             else
             {
                 diskann::cerr << "Error. Unsupported data type" << std::endl;
@@ -192,6 +261,16 @@ int main(int argc, char **argv)
                                                         metric, partitioning_algorithm, use_opq, codebook_prefix,
                                                         use_filters, label_file, universal_label, filter_threshold, Lf,
                                                         ommega, episilon);
+            else if (data_type == std::string("float16"))
+                return diskann::build_disk_index<diskann::float16>(
+                    data_path.c_str(), index_path_prefix.c_str(), params.c_str(), metric, partitioning_algorithm,
+                    use_opq, codebook_prefix, use_filters, label_file, universal_label, filter_threshold, Lf, ommega,
+                    episilon);
+            else if (data_type == std::string("bfloat16"))
+                return diskann::build_disk_index<diskann::bfloat16>(
+                    data_path.c_str(), index_path_prefix.c_str(), params.c_str(), metric, partitioning_algorithm,
+                    use_opq, codebook_prefix, use_filters, label_file, universal_label, filter_threshold, Lf, ommega,
+                    episilon);
             else
             {
                 diskann::cerr << "Error. Unsupported data type" << std::endl;
@@ -25,9 +25,9 @@ namespace po = boost::program_options;
 int main(int argc, char **argv)
 {
     std::string data_type, dist_fn, data_path, index_path_prefix, label_file, universal_label, label_type;
-    uint32_t num_threads, R, L, Lf, build_PQ_bytes;
+    uint32_t num_threads, R, L, Lf, build_PQ_bytes, build_PQ_bits, sq_bits;
     float alpha;
-    bool use_pq_build, use_opq;
+    bool use_pq_build, use_opq, sq_rerank;
 
     po::options_description desc{
         program_options_utils::make_program_description("build_memory_index", "Build a memory-based DiskANN index.")};
@@ -59,8 +59,17 @@ int main(int argc, char **argv)
                                        program_options_utils::GRAPH_BUILD_ALPHA);
         optional_configs.add_options()("build_PQ_bytes", po::value<uint32_t>(&build_PQ_bytes)->default_value(0),
                                        program_options_utils::BUIlD_GRAPH_PQ_BYTES);
+        optional_configs.add_options()("build_PQ_bits", po::value<uint32_t>(&build_PQ_bits)->default_value(8),
+                                       "Bits per PQ code when building with build_PQ_bytes: 8, or 4 for "
+                                       "fast-scan distances (16 centers per chunk)");
         optional_configs.add_options()("use_opq", po::bool_switch()->default_value(false),
                                        program_options_utils::USE_OPQ);
+        optional_configs.add_options()("sq_bits", po::value<uint32_t>(&sq_bits)->default_value(0),
+                                       "Store the vectors scalar-quantized to 8 or 4 bits per dimension, or 1 for "
+                                       "RaBitQ binary codes (L2 only). Default 0, full precision");
+        optional_configs.add_options()("sq_rerank", po::bool_switch(&sq_rerank)->default_value(false),
+                                       "With sq_bits, also keep the full precision vectors to prune with and to "
+                                       "re-rank search results. The index then saves full precision data");
         optional_configs.add_options()("label_file", po::value<std::string>(&label_file)->default_value(""),
                                        program_options_utils::LABEL_FILE);
         optional_configs.add_options()("universal_label", po::value<std::string>(&universal_label)->default_value(""),
@@ -91,6 +100,29 @@ int main(int argc, char **argv)
         return -1;
     }
 
+    diskann::DataStoreStrategy data_strategy;
+    if (sq_bits == 0)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY;
+    }
+    else if (sq_bits == 8)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY_SQ8;
+    }
+    else if (sq_bits == 4)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY_SQ4;
+    }
+    else if (sq_bits == 1)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY_RABITQ;
+    }
+    else
+    {
+        std::cout << "sq_bits must be 0, 1, 4 or 8." << std::endl;
+        return -1;
+    }
+
     diskann::Metric metric;
     if (dist_fn == std::string("mips"))
     {
@@ -136,7 +168,7 @@ int main(int argc, char **argv)
                           .with_metric(metric)
                           .with_dimension(data_dim)
                           .with_max_points(data_num)
-                          .with_data_load_store_strategy(diskann::DataStoreStrategy::MEMORY)
+                          .with_data_load_store_strategy(data_strategy)
                           .with_graph_load_store_strategy(diskann::GraphStoreStrategy::MEMORY)
                           .with_data_type(data_type)
                           .with_label_type(label_type)
@@ -144,8 +176,10 @@ int main(int argc, char **argv)
                           .with_index_write_params(index_build_params)
                           .is_enable_tags(false)
                           .is_use_opq(use_opq)
+                          .is_full_precision_rerank(sq_rerank)
                           .is_pq_dist_build(use_pq_build)
                           .with_num_pq_chunks(build_PQ_bytes)
+                          .with_num_pq_bits(build_PQ_bits)
                           .build();
 
         auto index_factory = diskann::IndexFactory(config);
@@ -22,6 +22,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include "linux_aligned_file_reader.h"
+#include "io_uring_aligned_file_reader.h"
 #else
 #ifdef USE_BING_INFRA
 #include "bing_aligned_file_reader.h"
@@ -93,8 +94,12 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
 #else
     reader.reset(new diskann::BingAlignedFileReader());
 #endif
+#else
+#ifdef USE_IO_URING
+    reader.reset(new IoUringAlignedFileReader());
 #else
     reader.reset(new LinuxAlignedFileReader());
+#endif
 #endif
 
     std::unique_ptr<diskann::PQFlashIndex<T, LabelT>> _pFlashIndex(
@@ -19,6 +19,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include "linux_aligned_file_reader.h"
+#include "io_uring_aligned_file_reader.h"
 #else
 #ifdef USE_BING_INFRA
 #include "bing_aligned_file_reader.h"
@@ -53,7 +54,11 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
                       const uint32_t num_threads, const uint32_t recall_at, const uint32_t beamwidth,
                       const uint32_t num_nodes_to_cache, const uint32_t search_io_limit,
                       const std::vector<uint32_t> &Lvec, const float fail_if_recall_below,
-                      const std::vector<std::string> &query_filters, const bool use_reorder_data = false)
+                      const std::vector<std::string> &query_filters, const bool use_reorder_data = false,
+                      const std::string &search_mode = "beam", const uint32_t num_interleaved = 1,
+                      const uint32_t batch_size = 1, const uint32_t sector_cache_mb = 0,
+                      const std::string &cache_snapshot = "", const std::string &pq_vectors = "heap",
+                      const bool pq_huge_pages = false, const uint32_t rerank_depth = 0)
 {
     diskann::cout << "Search parameters: #threads: " << num_threads << ", ";
     if (beamwidth <= 0)
@@ -108,14 +113,27 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
 #else
     reader.reset(new diskann::BingAlignedFileReader());
 #endif
+#else
+#ifdef USE_IO_URING
+    reader.reset(new IoUringAlignedFileReader());
 #else
     reader.reset(new LinuxAlignedFileReader());
+#endif
 #endif
 
     std::unique_ptr<diskann::PQFlashIndex<T, LabelT>> _pFlashIndex(
         new diskann::PQFlashIndex<T, LabelT>(reader, metric));
 
-    int res = _pFlashIndex->load(num_threads, index_path_prefix.c_str());
+    // interleaved and batch search keep several queries, each with its own
+    // scratch, in flight per thread
+    uint32_t num_scratch = num_threads;
+    if (search_mode == "interleaved")
+        num_scratch = num_threads * num_interleaved;
+    else if (search_mode == "batch")
+        num_scratch = num_threads * batch_size;
+    if (pq_vectors != "heap")
+        _pFlashIndex->set_pq_vectors_mmap(pq_vectors == "mmap_populate", pq_huge_pages);
+    int res = _pFlashIndex->load(num_scratch, index_path_prefix.c_str());
 
     if (res != 0)
     {
@@ -123,12 +141,18 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
     }
 
     std::vector<uint32_t> node_list;
-    diskann::cout << "Caching " << num_nodes_to_cache << " nodes around medoid(s)" << std::endl;
-    _pFlashIndex->cache_bfs_levels(num_nodes_to_cache, node_list);
-    // if (num_nodes_to_cache > 0)
-    //     _pFlashIndex->generate_cache_list_from_sample_queries(warmup_query_file, 15, 6, num_nodes_to_cache,
-    //     num_threads, node_list);
-    _pFlashIndex->load_cache_list(node_list);
+    if (cache_snapshot.empty() || !_pFlashIndex->load_cache_snapshot(cache_snapshot))
+    {
+        diskann::cout << "Caching " << num_nodes_to_cache << " nodes around medoid(s)" << std::endl;
+        _pFlashIndex->cache_bfs_levels(num_nodes_to_cache, node_list);
+        // if (num_nodes_to_cache > 0)
+        //     _pFlashIndex->generate_cache_list_from_sample_queries(warmup_query_file, 15, 6, num_nodes_to_cache,
+        //     num_threads, node_list);
+        _pFlashIndex->load_cache_list(node_list);
+        if (!cache_snapshot.empty())
+            _pFlashIndex->save_cache_snapshot(cache_snapshot);
+    }
+    _pFlashIndex->set_sector_cache((uint64_t)sector_cache_mb * 1024 * 1024);
     node_list.clear();
     node_list.shrink_to_fit();
 
@@ -227,31 +251,82 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
         std::vector<uint64_t> query_result_ids_64(recall_at * query_num);
         auto s = std::chrono::high_resolution_clock::now();
 
-#pragma omp parallel for schedule(dynamic, 1)
-        for (int64_t i = 0; i < (int64_t)query_num; i++)
+        if (search_mode == "interleaved" || search_mode == "batch")
         {
-            if (!filtered_search)
+            std::vector<LabelT> query_labels;
+            if (filtered_search)
             {
-                _pFlashIndex->cached_beam_search(query + (i * query_aligned_dim), recall_at, L,
-                                                 query_result_ids_64.data() + (i * recall_at),
-                                                 query_result_dists[test_id].data() + (i * recall_at),
-                                                 optimized_beamwidth, use_reorder_data, stats + i);
+                for (size_t i = 0; i < query_num; i++)
+                    query_labels.push_back(
+                        _pFlashIndex->get_converted_label(query_filters[query_filters.size() == 1 ? 0 : i]));
             }
-            else
+
+            // every thread runs its share of the queries, several at a time
+            const int64_t chunk_size = DIV_ROUND_UP(query_num, num_threads);
+#pragma omp parallel for schedule(static, 1)
+            for (int64_t chunk = 0; chunk < (int64_t)num_threads; chunk++)
+            {
+                int64_t begin = chunk * chunk_size;
+                if (begin >= (int64_t)query_num)
+                    continue;
+                int64_t count = std::min<int64_t>(chunk_size, (int64_t)query_num - begin);
+                if (search_mode == "batch")
+                {
+                    _pFlashIndex->batch_cached_beam_search(
+                        query + (begin * query_aligned_dim), count, query_aligned_dim, recall_at, L,
+                        query_result_ids_64.data() + (begin * recall_at),
+                        query_result_dists[test_id].data() + (begin * recall_at), optimized_beamwidth, batch_size,
+                        filtered_search ? query_labels.data() + begin : nullptr, search_io_limit, use_reorder_data,
+                        stats + begin, rerank_depth);
+                }
+                else
+                {
+#ifndef _WINDOWS
+                    _pFlashIndex->interleaved_beam_search(
+                        query + (begin * query_aligned_dim), count, query_aligned_dim, recall_at, L,
+                        query_result_ids_64.data() + (begin * recall_at),
+                        query_result_dists[test_id].data() + (begin * recall_at), optimized_beamwidth,
+                        num_interleaved, filtered_search ? query_labels.data() + begin : nullptr, search_io_limit,
+                        use_reorder_data, stats + begin, rerank_depth);
+#endif
+                }
+            }
+        }
+        else
+        {
+#pragma omp parallel for schedule(dynamic, 1)
+            for (int64_t i = 0; i < (int64_t)query_num; i++)
             {
-                LabelT label_for_search;
-                if (query_filters.size() == 1)
-                { // one label for all queries
-                    label_for_search = _pFlashIndex->get_converted_label(query_filters[0]);
+                LabelT label_for_search = 0;
+                if (filtered_search)
+                {
+                    if (query_filters.size() == 1)
+                    { // one label for all queries
+                        label_for_search = _pFlashIndex->get_converted_label(query_filters[0]);
+                    }
+                    else
+                    { // one label for each query
+                        label_for_search = _pFlashIndex->get_converted_label(query_filters[i]);
+                    }
+                }
+
+                if (search_mode == "pipelined")
+                {
+#ifndef _WINDOWS
+                    _pFlashIndex->pipelined_beam_search(
+                        query + (i * query_aligned_dim), recall_at, L, query_result_ids_64.data() + (i * recall_at),
+                        query_result_dists[test_id].data() + (i * recall_at), optimized_beamwidth, filtered_search,
+                        label_for_search, search_io_limit, use_reorder_data, stats + i, rerank_depth);
+#endif
                 }
                 else
-                { // one label for each query
-                    label_for_search = _pFlashIndex->get_converted_label(query_filters[i]);
+                {
+                    _pFlashIndex->cached_beam_search(
+                        query + (i * query_aligned_dim), recall_at, L, query_result_ids_64.data() + (i * recall_at),
+                        query_result_dists[test_id].data() + (i * recall_at), optimized_beamwidth, filtered_search,
+                        label_for_search, std::numeric_limits<uint32_t>::max(), use_reorder_data, stats + i,
+                        rerank_depth);
                 }
-                _pFlashIndex->cached_beam_search(
-                    query + (i * query_aligned_dim), recall_at, L, query_result_ids_64.data() + (i * recall_at),
-                    query_result_dists[test_id].data() + (i * recall_at), optimized_beamwidth, true, label_for_search,
-                    use_reorder_data, stats + i);
             }
         }
         auto e = std::chrono::high_resolution_clock::now();
@@ -296,6 +371,14 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
         delete[] stats;
     }
 
+    if (sector_cache_mb > 0)
+    {
+        auto cache_stats = _pFlashIndex->get_sector_cache_stats();
+        diskann::cout << "Sector cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses, "
+                      << cache_stats.insertions << " insertions, " << cache_stats.evictions << " evictions"
+                      << std::endl;
+    }
+
     diskann::cout << "Done searching. Now saving results " << std::endl;
     uint64_t test_id = 0;
     for (auto L : Lvec)
@@ -319,10 +402,12 @@ int search_disk_index(diskann::Metric &metric, const std::string &index_path_pre
 int main(int argc, char **argv)
 {
     std::string data_type, dist_fn, index_path_prefix, result_path_prefix, query_file, gt_file, filter_label,
-        label_type, query_filters_file;
+        label_type, query_filters_file, cache_snapshot, pq_vectors;
     uint32_t num_threads, K, W, num_nodes_to_cache, search_io_limit;
     std::vector<uint32_t> Lvec;
-    bool use_reorder_data = false;
+    std::string search_mode;
+    uint32_t num_interleaved, batch_size, sector_cache_mb, rerank_depth;
+    bool use_reorder_data = false, pq_huge_pages = false;
     float fail_if_recall_below = 0.0f;
 
     po::options_description desc{
@@ -357,6 +442,13 @@ int main(int argc, char **argv)
                                        program_options_utils::BEAMWIDTH);
         optional_configs.add_options()("num_nodes_to_cache", po::value<uint32_t>(&num_nodes_to_cache)->default_value(0),
                                        program_options_utils::NUMBER_OF_NODES_TO_CACHE);
+        optional_configs.add_options()("sector_cache_mb", po::value<uint32_t>(&sector_cache_mb)->default_value(0),
+                                       "Budget in MB for the dynamic cache of sectors read during search, on top "
+                                       "of num_nodes_to_cache. 0 disables it.  Default value: 0");
+        optional_configs.add_options()("cache_snapshot",
+                                       po::value<std::string>(&cache_snapshot)->default_value(std::string("")),
+                                       "File to restore the node cache from instead of recomputing it. If it does "
+                                       "not exist yet, the cache is computed as usual and saved there.");
         optional_configs.add_options()(
             "search_io_limit",
             po::value<uint32_t>(&search_io_limit)->default_value(std::numeric_limits<uint32_t>::max()),
@@ -367,6 +459,9 @@ int main(int argc, char **argv)
         optional_configs.add_options()("use_reorder_data", po::bool_switch()->default_value(false),
                                        "Include full precision data in the index. Use only in "
                                        "conjuction with compressed data on SSD.  Default value: false");
+        optional_configs.add_options()("rerank_depth", po::value<uint32_t>(&rerank_depth)->default_value(0),
+                                       "Number of candidates re-ranked with full-precision vectors. 0 re-ranks "
+                                       "K * 3 candidates.  Default value: 0");
         optional_configs.add_options()("filter_label",
                                        po::value<std::string>(&filter_label)->default_value(std::string("")),
                                        program_options_utils::FILTER_LABEL_DESCRIPTION);
@@ -378,6 +473,29 @@ int main(int argc, char **argv)
         optional_configs.add_options()("fail_if_recall_below",
                                        po::value<float>(&fail_if_recall_below)->default_value(0.0f),
                                        program_options_utils::FAIL_IF_RECALL_BELOW);
+        optional_configs.add_options()("search_mode",
+                                       po::value<std::string>(&search_mode)->default_value(std::string("beam")),
+                                       "beam: issue W reads per hop and wait for all of them. pipelined (Linux "
+                                       "only): keep up to W reads in flight and expand nodes as their reads "
+                                       "complete. interleaved (Linux only): like pipelined, with each thread "
+                                       "running num_interleaved queries at once. batch: each thread searches "
+                                       "batch_size queries in lock-step and reads sectors shared by them once per "
+                                       "hop.  Default value: beam");
+        optional_configs.add_options()("num_interleaved", po::value<uint32_t>(&num_interleaved)->default_value(4),
+                                       "Number of queries each thread keeps in flight with "
+                                       "--search_mode interleaved.  Default value: 4");
+        optional_configs.add_options()("batch_size", po::value<uint32_t>(&batch_size)->default_value(8),
+                                       "Number of queries each thread searches in lock-step with "
+                                       "--search_mode batch.  Default value: 8");
+        optional_configs.add_options()("pq_vectors",
+                                       po::value<std::string>(&pq_vectors)->default_value(std::string("heap")),
+                                       "heap: copy the compressed PQ vectors into memory. mmap: map the file "
+                                       "instead, so that processes searching the same index share one copy. "
+                                       "mmap_populate: like mmap, but fault in the whole file at load.  Default "
+                                       "value: heap");
+        optional_configs.add_options()("pq_huge_pages", po::bool_switch()->default_value(false),
+                                       "Ask for huge pages for the mapped PQ vectors (needs --pq_vectors mmap or "
+                                       "mmap_populate).  Default value: false");
 
         // Merge required and optional parameters
         desc.add(required_configs).add(optional_configs);
@@ -392,6 +510,7 @@ int main(int argc, char **argv)
         po::notify(vm);
         if (vm["use_reorder_data"].as<bool>())
             use_reorder_data = true;
+        pq_huge_pages = vm["pq_huge_pages"].as<bool>();
     }
     catch (const std::exception &ex)
     {
@@ -434,6 +553,33 @@ int main(int argc, char **argv)
         return -1;
     }
 
+#ifdef _WINDOWS
+    if (search_mode != std::string("beam") && search_mode != std::string("batch"))
+#else
+    if (search_mode != std::string("beam") && search_mode != std::string("pipelined") &&
+        search_mode != std::string("interleaved") && search_mode != std::string("batch"))
+#endif
+    {
+        std::cerr << "Unsupported search_mode " << search_mode << std::endl;
+        return -1;
+    }
+
+#ifdef _WINDOWS
+    if (pq_vectors != std::string("heap") && pq_vectors != std::string("mmap"))
+#else
+    if (pq_vectors != std::string("heap") && pq_vectors != std::string("mmap") &&
+        pq_vectors != std::string("mmap_populate"))
+#endif
+    {
+        std::cerr << "Unsupported pq_vectors " << pq_vectors << std::endl;
+        return -1;
+    }
+    if (pq_huge_pages && pq_vectors == std::string("heap"))
+    {
+        std::cerr << "pq_huge_pages needs the PQ vectors to be mapped, see pq_vectors" << std::endl;
+        return -1;
+    }
+
     if (filter_label != "" && query_filters_file != "")
     {
         std::cerr << "Only one of filter_label and query_filters_file should be provided" << std::endl;
@@ -457,18 +603,36 @@ int main(int argc, char **argv)
             if (data_type == std::string("float"))
                 return search_disk_index<float, uint16_t>(
                     metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
-                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data);
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                    pq_vectors, pq_huge_pages, rerank_depth);
             else if (data_type == std::string("int8"))
                 return search_disk_index<int8_t, uint16_t>(
                     metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
-                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data);
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                    pq_vectors, pq_huge_pages, rerank_depth);
             else if (data_type == std::string("uint8"))
                 return search_disk_index<uint8_t, uint16_t>(
                     metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
-                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data);
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                    pq_vectors, pq_huge_pages, rerank_depth);
+            else if (data_type == std::string("float16"))
+                return search_disk_index<diskann::float16, uint16_t>(
+                    metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                    pq_vectors, pq_huge_pages, rerank_depth);
+            else if (data_type == std::string("bfloat16"))
+                return search_disk_index<diskann::bfloat16, uint16_t>(
+                    metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                    pq_vectors, pq_huge_pages, rerank_depth);
             else
             {
-                std::cerr << "Unsupported data type. Use float or int8 or uint8" << std::endl;
+                std::cerr << "Unsupported data type. Use float, int8, uint8, float16 or bfloat16" << std::endl;
                 return -1;
             }
         }
@@ -477,18 +641,36 @@ int main(int argc, char **argv)
             if (data_type == std::string("float"))
                 return search_disk_index<float>(metric, index_path_prefix, result_path_prefix, query_file, gt_file,
                                                 num_threads, K, W, num_nodes_to_cache, search_io_limit, Lvec,
-                                                fail_if_recall_below, query_filters, use_reorder_data);
+                                                fail_if_recall_below, query_filters, use_reorder_data, search_mode,
+                                                num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                                                pq_vectors, pq_huge_pages, rerank_depth);
             else if (data_type == std::string("int8"))
                 return search_disk_index<int8_t>(metric, index_path_prefix, result_path_prefix, query_file, gt_file,
                                                  num_threads, K, W, num_nodes_to_cache, search_io_limit, Lvec,
-                                                 fail_if_recall_below, query_filters, use_reorder_data);
+                                                 fail_if_recall_below, query_filters, use_reorder_data, search_mode,
+                                                 num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                                                 pq_vectors, pq_huge_pages, rerank_depth);
             else if (data_type == std::string("uint8"))
                 return search_disk_index<uint8_t>(metric, index_path_prefix, result_path_prefix, query_file, gt_file,
                                                   num_threads, K, W, num_nodes_to_cache, search_io_limit, Lvec,
-                                                  fail_if_recall_below, query_filters, use_reorder_data);
+                                                  fail_if_recall_below, query_filters, use_reorder_data, search_mode,
+                                                  num_interleaved, batch_size, sector_cache_mb, cache_snapshot,
+                                                  pq_vectors, pq_huge_pages, rerank_depth);
+            else if (data_type == std::string("float16"))
+                return search_disk_index<diskann::float16>(
+                    metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot, pq_vectors,
+                    pq_huge_pages, rerank_depth);
+            else if (data_type == std::string("bfloat16"))
+                return search_disk_index<diskann::bfloat16>(
+                    metric, index_path_prefix, result_path_prefix, query_file, gt_file, num_threads, K, W,
+                    num_nodes_to_cache, search_io_limit, Lvec, fail_if_recall_below, query_filters, use_reorder_data,
+                    search_mode, num_interleaved, batch_size, sector_cache_mb, cache_snapshot, pq_vectors,
+                    pq_huge_pages, rerank_depth);
             else
             {
-                std::cerr << "Unsupported data type. Use float or int8 or uint8" << std::endl;
+                std::cerr << "Unsupported data type. Use float, int8, uint8, float16 or bfloat16" << std::endl;
                 return -1;
             }
         }
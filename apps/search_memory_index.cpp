@@ -30,6 +30,7 @@ int search_memory_index(diskann::Metric &metric, const std::string &index_path,
                         const std::string &query_file, const std::string &truthset_file, const uint32_t num_threads,
                         const uint32_t recall_at, const bool print_all_recalls, const std::vector<uint32_t> &Lvec,
                         const bool dynamic, const bool tags, const bool show_qps_per_thread,
+                        const diskann::DataStoreStrategy data_strategy, const bool sq_rerank,
                         const std::vector<std::string> &query_filters, const float fail_if_recall_below)
 {
     using TagT = uint32_t;
@@ -74,7 +75,7 @@ int search_memory_index(diskann::Metric &metric, const std::string &index_path,
                       .with_metric(metric)
                       .with_dimension(query_dim)
                       .with_max_points(0)
-                      .with_data_load_store_strategy(diskann::DataStoreStrategy::MEMORY)
+                      .with_data_load_store_strategy(data_strategy)
                       .with_graph_load_store_strategy(diskann::GraphStoreStrategy::MEMORY)
                       .with_data_type(diskann_type_to_name<T>())
                       .with_label_type(diskann_type_to_name<LabelT>())
@@ -84,6 +85,7 @@ int search_memory_index(diskann::Metric &metric, const std::string &index_path,
                       .is_concurrent_consolidate(false)
                       .is_pq_dist_build(false)
                       .is_use_opq(false)
+                      .is_full_precision_rerank(sq_rerank)
                       .with_num_pq_chunks(0)
                       .with_num_frozen_pts(num_frozen_pts)
                       .build();
@@ -281,7 +283,8 @@ int main(int argc, char **argv)
         query_filters_file;
     uint32_t num_threads, K;
     std::vector<uint32_t> Lvec;
-    bool print_all_recalls, dynamic, tags, show_qps_per_thread;
+    bool print_all_recalls, dynamic, tags, show_qps_per_thread, sq_rerank;
+    uint32_t sq_bits;
     float fail_if_recall_below = 0.0f;
 
     po::options_description desc{
@@ -328,6 +331,12 @@ int main(int argc, char **argv)
             "Whether the index is dynamic. Dynamic indices must have associated tags.  Default false.");
         optional_configs.add_options()("tags", po::value<bool>(&tags)->default_value(false),
                                        "Whether to search with external identifiers (tags). Default false.");
+        optional_configs.add_options()("sq_bits", po::value<uint32_t>(&sq_bits)->default_value(0),
+                                       "Bits per dimension the index vectors are quantized to: 8 or 4, or 1 for "
+                                       "RaBitQ binary codes (L2 only). Default 0, full precision");
+        optional_configs.add_options()("sq_rerank", po::bool_switch(&sq_rerank)->default_value(false),
+                                       "With sq_bits, search on vectors quantized from the full precision index "
+                                       "data and re-rank the results in full precision");
         optional_configs.add_options()("fail_if_recall_below",
                                        po::value<float>(&fail_if_recall_below)->default_value(0.0f),
                                        program_options_utils::FAIL_IF_RECALL_BELOW);
@@ -385,6 +394,29 @@ int main(int argc, char **argv)
         return -1;
     }
 
+    diskann::DataStoreStrategy data_strategy;
+    if (sq_bits == 0)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY;
+    }
+    else if (sq_bits == 8)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY_SQ8;
+    }
+    else if (sq_bits == 4)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY_SQ4;
+    }
+    else if (sq_bits == 1)
+    {
+        data_strategy = diskann::DataStoreStrategy::MEMORY_RABITQ;
+    }
+    else
+    {
+        std::cerr << "sq_bits must be 0, 1, 4 or 8." << std::endl;
+        return -1;
+    }
+
     if (dynamic && not tags)
     {
         std::cerr << "Tags must be enabled while searching dynamically built indices" << std::endl;
@@ -421,23 +453,40 @@ int main(int argc, char **argv)
             {
                 return search_memory_index<int8_t, uint16_t>(
                     metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
-                    Lvec, dynamic, tags, show_qps_per_thread, query_filters, fail_if_recall_below);
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
             }
             else if (data_type == std::string("uint8"))
             {
                 return search_memory_index<uint8_t, uint16_t>(
                     metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
-                    Lvec, dynamic, tags, show_qps_per_thread, query_filters, fail_if_recall_below);
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
             }
             else if (data_type == std::string("float"))
             {
-                return search_memory_index<float, uint16_t>(metric, index_path_prefix, result_path, query_file, gt_file,
-                                                            num_threads, K, print_all_recalls, Lvec, dynamic, tags,
-                                                            show_qps_per_thread, query_filters, fail_if_recall_below);
+                return search_memory_index<float, uint16_t>(
+                    metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
+            }
+            else if (data_type == std::string("float16"))
+            {
+                return search_memory_index<diskann::float16, uint16_t>(
+                    metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
+            }
+            else if (data_type == std::string("bfloat16"))
+            {
+                return search_memory_index<diskann::bfloat16, uint16_t>(
+                    metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
             }
             else
             {
-                std::cout << "Unsupported type. Use float/int8/uint8" << std::endl;
+                std::cout << "Unsupported type. Use float/int8/uint8/float16/bfloat16" << std::endl;
                 return -1;
             }
         }
@@ -447,23 +496,40 @@ int main(int argc, char **argv)
             {
                 return search_memory_index<int8_t>(metric, index_path_prefix, result_path, query_file, gt_file,
                                                    num_threads, K, print_all_recalls, Lvec, dynamic, tags,
-                                                   show_qps_per_thread, query_filters, fail_if_recall_below);
+                                                   show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                                                   fail_if_recall_below);
             }
             else if (data_type == std::string("uint8"))
             {
                 return search_memory_index<uint8_t>(metric, index_path_prefix, result_path, query_file, gt_file,
                                                     num_threads, K, print_all_recalls, Lvec, dynamic, tags,
-                                                    show_qps_per_thread, query_filters, fail_if_recall_below);
+                                                    show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                                                    fail_if_recall_below);
             }
             else if (data_type == std::string("float"))
             {
                 return search_memory_index<float>(metric, index_path_prefix, result_path, query_file, gt_file,
                                                   num_threads, K, print_all_recalls, Lvec, dynamic, tags,
-                                                  show_qps_per_thread, query_filters, fail_if_recall_below);
+                                                  show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                                                  fail_if_recall_below);
+            }
+            else if (data_type == std::string("float16"))
+            {
+                return search_memory_index<diskann::float16>(
+                    metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
+            }
+            else if (data_type == std::string("bfloat16"))
+            {
+                return search_memory_index<diskann::bfloat16>(
+                    metric, index_path_prefix, result_path, query_file, gt_file, num_threads, K, print_all_recalls,
+                    Lvec, dynamic, tags, show_qps_per_thread, data_strategy, sq_rerank, query_filters,
+                    fail_if_recall_below);
             }
             else
             {
-                std::cout << "Unsupported type. Use float/int8/uint8" << std::endl;
+                std::cout << "Unsupported type. Use float/int8/uint8/float16/bfloat16" << std::endl;
                 return -1;
             }
         }
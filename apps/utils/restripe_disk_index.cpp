@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/program_options.hpp>
+
+#include "utils.h"
+#include "disk_utils.h"
+
+namespace po = boost::program_options;
+
+int main(int argc, char **argv)
+{
+    std::string index_path_prefix;
+    std::vector<std::string> stripe_files;
+    uint64_t stripe_sectors;
+
+    po::options_description desc{"Arguments"};
+    try
+    {
+        desc.add_options()("help,h", "Print information on arguments");
+        desc.add_options()("index_path_prefix", po::value<std::string>(&index_path_prefix)->required(),
+                           "Path prefix of the disk index to restripe");
+        desc.add_options()("stripe_files", po::value<std::vector<std::string>>(&stripe_files)->multitoken()->required(),
+                           "Files to stripe the disk index over, e.g. one on each device");
+        desc.add_options()("stripe_sectors", po::value<uint64_t>(&stripe_sectors)->default_value(1),
+                           "Number of consecutive 4KB sectors placed on a file before moving to the next");
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help"))
+        {
+            std::cout << desc;
+            return 0;
+        }
+        po::notify(vm);
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return -1;
+    }
+
+    try
+    {
+        diskann::restripe_disk_index(index_path_prefix + "_disk.index", stripe_files, stripe_sectors);
+        return 0;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << std::string(e.what()) << std::endl;
+        diskann::cerr << "Restriping the disk index failed." << std::endl;
+        return -1;
+    }
+}
@@ -114,12 +114,43 @@ class AlignedFileReader
     virtual void open(const std::string &fname) = 0;
     virtual void close() = 0;
 
+    // opens a file striped round-robin over `fnames` (e.g. one per device) in
+    // units of `stripe_sectors` sectors: unit u of the logical file is unit
+    // u / fnames.size() of fnames[u % fnames.size()]. Reads keep using logical
+    // offsets. Readers without striping support throw.
+    virtual void open_striped(const std::vector<std::string> &fnames, uint64_t stripe_sectors)
+    {
+        throw diskann::ANNException("This reader does not support striped files", -1, __FUNCSIG__, __FILE__,
+                                    __LINE__);
+    }
+
     // process batch of aligned requests in parallel
     // NOTE :: blocking call
     virtual void read(std::vector<AlignedRead> &read_reqs, IOContext &ctx, bool async = false) = 0;
 
+    // hint that reads issued through `ctx` will mostly land in [buf, buf + len).
+    // readers that support pre-registered I/O buffers can pin it once here
+    // instead of mapping pages on every request; default is a no-op.
+    virtual void register_buffer(IOContext &ctx, void *buf, uint64_t len)
+    {
+    }
+
 #ifdef USE_BING_INFRA
     // wait for completion of one request in a batch of requests
     virtual void wait(IOContext &ctx, int &completedIndex) = 0;
 #endif
+
+#ifndef _WINDOWS
+    // asynchronous reads: submit_reads() queues the batch and returns
+    // immediately. The caller owns the target buffers and must keep them alive
+    // until the corresponding request has been reaped.
+    virtual void submit_reads(std::vector<AlignedRead> &read_reqs, IOContext &ctx) = 0;
+
+    // reaps finished requests of earlier submit_reads() calls and appends their
+    // `buf` pointers to `completed_bufs`. Blocks until at least
+    // `min_completions` requests are done; 0 polls without blocking.
+    // Returns the number of requests reaped.
+    virtual uint64_t get_completed_reads(IOContext &ctx, uint64_t min_completions,
+                                         std::vector<void *> &completed_bufs) = 0;
+#endif
 };
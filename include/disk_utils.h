@@ -104,9 +104,43 @@ DISKANN_DLLEXPORT int build_disk_index(
     const float episilon = 1.1 // for sogaic partition algorithm
 );
 
+// Orders the npts nodes of the vamana graph in mem_index_file breadth-first
+// from its medoid, so that nodes that are close in the graph also end up close
+// on disk. new_to_old[i] is the id of the node to place at position i; nodes
+// not reachable from the medoid follow in id order.
+DISKANN_DLLEXPORT void compute_bfs_layout_order(const std::string &mem_index_file, uint64_t npts,
+                                                std::vector<uint32_t> &new_to_old);
+
+// id_map_file, if given, is a bin file of npts x 1 uint32_t holding the
+// original id of the node to place at each position (see
+// compute_bfs_layout_order). Nodes are then written in that order with their
+// neighbor ids, the medoid and the reorder data renumbered to match.
+// pack_nhoods stores neighbor lists with encode_packed_nhood, if that fits
+// more nodes per sector than plain uint32_t lists.
+// inline_pq_file, if given, is the PQ compressed vectors file (in the final
+// node order) used by search. The code of every neighbor is then stored in the
+// node right after the neighbor ids, so that a search computes the PQ
+// distances of a node's neighbors from the sector it read instead of looking
+// them up in memory at random.
+// separate_vectors leaves the coords out of the nodes and writes the base
+// vectors after the graph instead, where the reorder data would go. Search then
+// walks a dense graph and fetches full vectors only to rerank the final
+// candidates. Can not be combined with reorder_data_file.
 template <typename T>
 DISKANN_DLLEXPORT void create_disk_layout(const std::string base_file, const std::string mem_index_file,
                                           const std::string output_file,
-                                          const std::string reorder_data_file = std::string(""));
+                                          const std::string reorder_data_file = std::string(""),
+                                          const std::string id_map_file = std::string(""),
+                                          const bool pack_nhoods = false,
+                                          const std::string inline_pq_file = std::string(""),
+                                          const bool separate_vectors = false);
+
+// Moves the sectors of disk_index_file round-robin onto stripe_files (e.g. one
+// per device) in units of stripe_sectors sectors, see
+// AlignedFileReader::open_striped. The layout is recorded in the metadata;
+// disk_index_file keeps only the metadata sector and disk_index_file +
+// "_stripes.txt" lists the stripe files for the loader.
+DISKANN_DLLEXPORT void restripe_disk_index(const std::string &disk_index_file,
+                                           const std::vector<std::string> &stripe_files, uint64_t stripe_sectors);
 
 } // namespace diskann
@@ -1,5 +1,6 @@
 #pragma once
 #include "windows_customizations.h"
+#include "float16.h"
 #include <cstring>
 
 namespace diskann
@@ -26,6 +27,22 @@ template <typename T> class Distance
     DISKANN_DLLEXPORT virtual float compare(const T *a, const T *b, const float normA, const float normB,
                                             uint32_t length) const;
 
+    // Distances from query to the num_bases vectors bases[0..num_bases),
+    // written to distances. The default calls compare() on each vector;
+    // implementations override it to compute several vectors at a time,
+    // loading each part of the query once for all of them, and to prefetch
+    // the vectors that follow.
+    DISKANN_DLLEXPORT virtual void compare_batch(const T *query, const T *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+
+    // A distance function computing the same distances with kernels compiled
+    // for vectors of exactly length elements, so that their loops are
+    // unrolled with no tail handling, or nullptr if there are none for this
+    // length (the default). Vectors of other lengths fall back to the generic
+    // kernels. Callers whose vectors all have one length pick it once at load
+    // time, and own the returned object.
+    DISKANN_DLLEXPORT virtual Distance<T> *specialize(uint32_t length) const;
+
     // For MIPS, normalization adds an extra dimension to the vectors.
     // This function lets callers know if the normalization process
     // changes the dimension.
@@ -57,9 +74,8 @@ template <typename T> class Distance
 
     // If an algorithm has a requirement that some data be aligned to a certain
     // boundary it can use this function to indicate that requirement. Currently,
-    // we are setting it to 8 because that works well for AVX2. If we have AVX512
-    // implementations of distance algos, they might have to set this to 16
-    // (depending on how they are implemented)
+    // we are setting it to 8 because that works well for AVX2. The AVX512
+    // implementations use unaligned and masked loads, so they keep it at 8.
     DISKANN_DLLEXPORT virtual size_t get_required_alignment() const;
 
     // Providing a default implementation for the virtual destructor because we
@@ -120,6 +136,9 @@ class DistanceL2Float : public Distance<float>
 #else
     DISKANN_DLLEXPORT virtual float compare(const float *a, const float *b, uint32_t size) const __attribute__((hot));
 #endif
+    DISKANN_DLLEXPORT virtual void compare_batch(const float *query, const float *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+    DISKANN_DLLEXPORT virtual Distance<float> *specialize(uint32_t length) const;
 };
 
 class AVXDistanceL2Float : public Distance<float>
@@ -199,12 +218,59 @@ class AVXDistanceInnerProductFloat : public Distance<float>
     {
     }
     DISKANN_DLLEXPORT virtual float compare(const float *a, const float *b, uint32_t length) const;
+    DISKANN_DLLEXPORT virtual void compare_batch(const float *query, const float *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+    DISKANN_DLLEXPORT virtual Distance<float> *specialize(uint32_t length) const;
+};
+
+// AVX-512 implementations, picked by get_distance_function when the CPU
+// supports AVX-512 F, BW, VL and VNNI (Avx512SupportedCPU). They are compiled
+// for AVX-512 regardless of the build target, so the same binary runs on AVX2
+// machines. Vectors of any length and alignment are handled, the tails with
+// masked loads. Byte vectors are widened to 16 bits and accumulated with VNNI
+// (vpdpwssd). Defined for float, int8_t, uint8_t, float16 and bfloat16, the
+// inner product for the floating point types only.
+template <typename T> class AVX512DistanceL2 : public Distance<T>
+{
+  public:
+    AVX512DistanceL2() : Distance<T>(diskann::Metric::L2)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const T *a, const T *b, uint32_t length) const;
+    DISKANN_DLLEXPORT virtual void compare_batch(const T *query, const T *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+    DISKANN_DLLEXPORT virtual Distance<T> *specialize(uint32_t length) const;
+};
+
+template <typename T> class AVX512DistanceInnerProduct : public Distance<T>
+{
+  public:
+    AVX512DistanceInnerProduct() : Distance<T>(diskann::Metric::INNER_PRODUCT)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const T *a, const T *b, uint32_t length) const;
+    DISKANN_DLLEXPORT virtual void compare_batch(const T *query, const T *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+    DISKANN_DLLEXPORT virtual Distance<T> *specialize(uint32_t length) const;
+};
+
+template <typename T> class AVX512DistanceCosine : public Distance<T>
+{
+  public:
+    AVX512DistanceCosine() : Distance<T>(diskann::Metric::COSINE)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const T *a, const T *b, uint32_t length) const;
+    DISKANN_DLLEXPORT virtual void compare_batch(const T *query, const T *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+    DISKANN_DLLEXPORT virtual Distance<T> *specialize(uint32_t length) const;
 };
 
 class AVXNormalizedCosineDistanceFloat : public Distance<float>
 {
   private:
     AVXDistanceInnerProductFloat _innerProduct;
+    AVX512DistanceInnerProduct<float> _avx512InnerProduct;
 
   protected:
     void normalize_and_copy(const float *a, uint32_t length, float *a_norm) const;
@@ -213,12 +279,10 @@ class AVXNormalizedCosineDistanceFloat : public Distance<float>
     AVXNormalizedCosineDistanceFloat() : Distance<float>(diskann::Metric::COSINE)
     {
     }
-    DISKANN_DLLEXPORT virtual float compare(const float *a, const float *b, uint32_t length) const
-    {
-        // Inner product returns negative values to indicate distance.
-        // This will ensure that cosine is between -1 and 1.
-        return 1.0f + _innerProduct.compare(a, b, length);
-    }
+    DISKANN_DLLEXPORT virtual float compare(const float *a, const float *b, uint32_t length) const;
+    DISKANN_DLLEXPORT virtual void compare_batch(const float *query, const float *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const;
+    DISKANN_DLLEXPORT virtual Distance<float> *specialize(uint32_t length) const;
     DISKANN_DLLEXPORT virtual uint32_t post_normalization_dimension(uint32_t orig_dimension) const override;
 
     DISKANN_DLLEXPORT virtual bool preprocessing_required() const;
@@ -230,6 +294,64 @@ class AVXNormalizedCosineDistanceFloat : public Distance<float>
                                                     float *scratch_query_vector) override;
 };
 
+// Distances over 16-bit float vectors. With AVX2 the elements are widened to
+// float in registers (F16C for float16, a 16-bit shift for bfloat16), so the
+// vectors are read at half the bandwidth of float vectors. Cosine distances
+// are computed in full, without assuming normalized data.
+class DistanceL2Float16 : public Distance<float16>
+{
+  public:
+    DistanceL2Float16() : Distance<float16>(diskann::Metric::L2)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const float16 *a, const float16 *b, uint32_t length) const;
+};
+
+class DistanceInnerProductFloat16 : public Distance<float16>
+{
+  public:
+    DistanceInnerProductFloat16() : Distance<float16>(diskann::Metric::INNER_PRODUCT)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const float16 *a, const float16 *b, uint32_t length) const;
+};
+
+class DistanceCosineFloat16 : public Distance<float16>
+{
+  public:
+    DistanceCosineFloat16() : Distance<float16>(diskann::Metric::COSINE)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const float16 *a, const float16 *b, uint32_t length) const;
+};
+
+class DistanceL2BFloat16 : public Distance<bfloat16>
+{
+  public:
+    DistanceL2BFloat16() : Distance<bfloat16>(diskann::Metric::L2)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const bfloat16 *a, const bfloat16 *b, uint32_t length) const;
+};
+
+class DistanceInnerProductBFloat16 : public Distance<bfloat16>
+{
+  public:
+    DistanceInnerProductBFloat16() : Distance<bfloat16>(diskann::Metric::INNER_PRODUCT)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const bfloat16 *a, const bfloat16 *b, uint32_t length) const;
+};
+
+class DistanceCosineBFloat16 : public Distance<bfloat16>
+{
+  public:
+    DistanceCosineBFloat16() : Distance<bfloat16>(diskann::Metric::COSINE)
+    {
+    }
+    DISKANN_DLLEXPORT virtual float compare(const bfloat16 *a, const bfloat16 *b, uint32_t length) const;
+};
+
 template <typename T> Distance<T> *get_distance_function(Metric m);
 
 } // namespace diskann
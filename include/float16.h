@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace diskann
+{
+// 16-bit floating point element types. Both are storage types: they convert
+// implicitly to and from float, and all arithmetic is done in float. Vectors
+// of these types take half the memory and disk space of float vectors, and
+// the distance functions in distance.h read them without a float copy.
+//
+// float16 is IEEE 754 binary16 (1 sign, 5 exponent and 10 mantissa bits).
+// bfloat16 is the upper half of a binary32 float (1 sign, 8 exponent and 7
+// mantissa bits): it has the range of float with less precision. Conversions
+// from float round to nearest even.
+#pragma pack(push, 1)
+
+struct float16
+{
+    std::uint16_t bits;
+
+    float16() = default;
+    float16(float value) : bits(from_float(value))
+    {
+    }
+    operator float() const
+    {
+        return to_float(bits);
+    }
+
+    static inline std::uint16_t from_float(float value)
+    {
+        std::uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        const std::uint16_t sign = (std::uint16_t)((x >> 16) & 0x8000);
+        std::uint32_t abs_x = x & 0x7fffffff;
+
+        if (abs_x >= 0x7f800000) // inf or nan
+            return sign | 0x7c00 | (abs_x > 0x7f800000 ? 0x0200 : 0);
+        if (abs_x >= 0x477ff000) // rounds to a magnitude above 65504
+            return sign | 0x7c00;
+        if (abs_x < 0x38800000) // subnormal in half precision
+        {
+            // Adding 0.5 leaves the value in units of 2^-24, correctly
+            // rounded, in the low mantissa bits.
+            float shifted;
+            std::memcpy(&shifted, &abs_x, sizeof(shifted));
+            shifted += 0.5f;
+            std::uint32_t y;
+            std::memcpy(&y, &shifted, sizeof(y));
+            return sign | (std::uint16_t)(y - 0x3f000000);
+        }
+        // rebias the exponent from 127 to 15 and round the mantissa
+        abs_x += 0xc8000fff + ((abs_x >> 13) & 1);
+        return sign | (std::uint16_t)(abs_x >> 13);
+    }
+
+    static inline float to_float(std::uint16_t h)
+    {
+        const std::uint32_t sign = (std::uint32_t)(h & 0x8000) << 16;
+        const std::uint32_t exponent = (h >> 10) & 0x1f;
+        const std::uint32_t mantissa = h & 0x3ff;
+        std::uint32_t x;
+        if (exponent == 0x1f)
+        {
+            x = sign | 0x7f800000 | (mantissa << 13);
+        }
+        else if (exponent == 0)
+        {
+            // zero or subnormal: mantissa * 2^-24 is exact in float
+            float value = (float)mantissa * (1.0f / 16777216.0f);
+            std::memcpy(&x, &value, sizeof(x));
+            x |= sign;
+        }
+        else
+        {
+            x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        float value;
+        std::memcpy(&value, &x, sizeof(value));
+        return value;
+    }
+};
+
+struct bfloat16
+{
+    std::uint16_t bits;
+
+    bfloat16() = default;
+    bfloat16(float value) : bits(from_float(value))
+    {
+    }
+    operator float() const
+    {
+        return to_float(bits);
+    }
+
+    static inline std::uint16_t from_float(float value)
+    {
+        std::uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        if ((x & 0x7fffffff) > 0x7f800000) // keep nans quiet
+            return (std::uint16_t)((x >> 16) | 0x0040);
+        x += 0x7fff + ((x >> 16) & 1);
+        return (std::uint16_t)(x >> 16);
+    }
+
+    static inline float to_float(std::uint16_t h)
+    {
+        const std::uint32_t x = (std::uint32_t)h << 16;
+        float value;
+        std::memcpy(&value, &x, sizeof(value));
+        return value;
+    }
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2, "16-bit float types must be 2 bytes");
+// like the other element types they are raw storage, memset and memcpy'd in
+// buffers of T
+static_assert(std::is_trivial<float16>::value && std::is_trivial<bfloat16>::value,
+              "16-bit float types must be trivial");
+
+// std::is_floating_point extended to the 16-bit float types, for code that
+// treats floating point data differently from integral data.
+template <typename T>
+struct is_floating_type
+    : std::integral_constant<bool, std::is_floating_point<T>::value || std::is_same<T, float16>::value ||
+                                       std::is_same<T, bfloat16>::value>
+{
+};
+} // namespace diskann
+
+namespace std
+{
+template <> class numeric_limits<diskann::float16> : public numeric_limits<float>
+{
+  public:
+    static diskann::float16 min() noexcept
+    {
+        return 6.103515625e-05f;
+    }
+    static diskann::float16 lowest() noexcept
+    {
+        return -65504.0f;
+    }
+    static diskann::float16 max() noexcept
+    {
+        return 65504.0f;
+    }
+    static constexpr int digits = 11;
+    static constexpr int max_exponent = 16;
+    static constexpr int min_exponent = -13;
+};
+
+template <> class numeric_limits<diskann::bfloat16> : public numeric_limits<float>
+{
+  public:
+    static diskann::bfloat16 min() noexcept
+    {
+        return numeric_limits<float>::min();
+    }
+    static diskann::bfloat16 lowest() noexcept
+    {
+        return -3.38953139e+38f;
+    }
+    static diskann::bfloat16 max() noexcept
+    {
+        return 3.38953139e+38f;
+    }
+    static constexpr int digits = 8;
+};
+} // namespace std
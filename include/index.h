@@ -422,6 +422,11 @@ template <typename T, typename TagT = uint32_t, typename LabelT = uint32_t> clas
     // Flags for PQ based distance calculation
     bool _pq_dist = false;
     bool _use_opq = false;
+    // navigate on the quantized _pq_data_store, prune and re-rank with the
+    // full precision _data_store
+    bool _full_precision_rerank = false;
+    // the quantized queries of the RaBitQ data store live in the PQScratch
+    bool _rabitq_dist = false;
     size_t _num_pq_chunks = 0;
     // REFACTOR
     // uint8_t *_pq_data = nullptr;
@@ -2,12 +2,18 @@
 
 #include "common_includes.h"
 #include "parameters.h"
+#include "pq_common.h"
 
 namespace diskann
 {
 enum class DataStoreStrategy
 {
-    MEMORY
+    MEMORY,
+    // in-memory vectors scalar-quantized to 8 or 4 bits per dimension
+    MEMORY_SQ8,
+    MEMORY_SQ4,
+    // in-memory RaBitQ codes, one bit per dimension (see rabitq.h)
+    MEMORY_RABITQ
 };
 
 enum class GraphStoreStrategy
@@ -30,8 +36,12 @@ struct IndexConfig
     bool concurrent_consolidate;
     bool use_opq;
     bool filtered_index;
+    // with a scalar-quantized data strategy, also keep the full precision
+    // vectors to prune with and to re-rank the final candidates of a search
+    bool full_precision_rerank;
 
     size_t num_pq_chunks;
+    uint32_t num_pq_bits;
     size_t num_frozen_pts;
 
     std::string label_type;
@@ -45,16 +55,19 @@ struct IndexConfig
 
   private:
     IndexConfig(DataStoreStrategy data_strategy, GraphStoreStrategy graph_strategy, Metric metric, size_t dimension,
-                size_t max_points, size_t num_pq_chunks, size_t num_frozen_points, bool dynamic_index, bool enable_tags,
-                bool pq_dist_build, bool concurrent_consolidate, bool use_opq, bool filtered_index,
-                std::string &data_type, const std::string &tag_type, const std::string &label_type,
+                size_t max_points, size_t num_pq_chunks, uint32_t num_pq_bits, size_t num_frozen_points,
+                bool dynamic_index, bool enable_tags, bool pq_dist_build, bool concurrent_consolidate, bool use_opq,
+                bool filtered_index, bool full_precision_rerank, std::string &data_type, const std::string &tag_type,
+                const std::string &label_type,
                 std::shared_ptr<IndexWriteParameters> index_write_params,
                 std::shared_ptr<IndexSearchParams> index_search_params)
         : data_strategy(data_strategy), graph_strategy(graph_strategy), metric(metric), dimension(dimension),
           max_points(max_points), dynamic_index(dynamic_index), enable_tags(enable_tags), pq_dist_build(pq_dist_build),
           concurrent_consolidate(concurrent_consolidate), use_opq(use_opq), filtered_index(filtered_index),
-          num_pq_chunks(num_pq_chunks), num_frozen_pts(num_frozen_points), label_type(label_type), tag_type(tag_type),
-          data_type(data_type), index_write_params(index_write_params), index_search_params(index_search_params)
+          full_precision_rerank(full_precision_rerank), num_pq_chunks(num_pq_chunks), num_pq_bits(num_pq_bits),
+          num_frozen_pts(num_frozen_points),
+          label_type(label_type), tag_type(tag_type), data_type(data_type), index_write_params(index_write_params),
+          index_search_params(index_search_params)
     {
     }
 
@@ -132,12 +145,26 @@ class IndexConfigBuilder
         return *this;
     }
 
+    IndexConfigBuilder &is_full_precision_rerank(bool full_precision_rerank)
+    {
+        this->_full_precision_rerank = full_precision_rerank;
+        return *this;
+    }
+
     IndexConfigBuilder &with_num_pq_chunks(size_t num_pq_chunks)
     {
         this->_num_pq_chunks = num_pq_chunks;
         return *this;
     }
 
+    // bits per PQ code: NUM_PQ_BITS, or PQ_FAST_SCAN_BITS for 4-bit codes
+    // searched with fast-scan
+    IndexConfigBuilder &with_num_pq_bits(uint32_t num_pq_bits)
+    {
+        this->_num_pq_bits = num_pq_bits;
+        return *this;
+    }
+
     IndexConfigBuilder &with_num_frozen_pts(size_t num_frozen_pts)
     {
         this->_num_frozen_pts = num_frozen_pts;
@@ -219,10 +246,15 @@ class IndexConfigBuilder
             _num_frozen_pts = 1;
         }
 
+        if (_num_pq_bits != NUM_PQ_BITS && _num_pq_bits != PQ_FAST_SCAN_BITS)
+            throw ANNException("Error: num_pq_bits must be " + std::to_string(NUM_PQ_BITS) + " or " +
+                                   std::to_string(PQ_FAST_SCAN_BITS),
+                               -1);
+
         return IndexConfig(_data_strategy, _graph_strategy, _metric, _dimension, _max_points, _num_pq_chunks,
-                           _num_frozen_pts, _dynamic_index, _enable_tags, _pq_dist_build, _concurrent_consolidate,
-                           _use_opq, _filtered_index, _data_type, _tag_type, _label_type, _index_write_params,
-                           _index_search_params);
+                           _num_pq_bits, _num_frozen_pts, _dynamic_index, _enable_tags, _pq_dist_build, _concurrent_consolidate,
+                           _use_opq, _filtered_index, _full_precision_rerank, _data_type, _tag_type, _label_type,
+                           _index_write_params, _index_search_params);
     }
 
     IndexConfigBuilder(const IndexConfigBuilder &) = delete;
@@ -242,8 +274,10 @@ class IndexConfigBuilder
     bool _concurrent_consolidate = false;
     bool _use_opq = false;
     bool _filtered_index{defaults::HAS_LABELS};
+    bool _full_precision_rerank = false;
 
     size_t _num_pq_chunks = 0;
+    uint32_t _num_pq_bits = NUM_PQ_BITS;
     size_t _num_frozen_pts{defaults::NUM_FROZEN_POINTS_STATIC};
 
     std::string _label_type{"uint32"};
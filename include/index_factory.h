@@ -4,6 +4,8 @@
 #include "abstract_graph_store.h"
 #include "in_mem_graph_store.h"
 #include "pq_data_store.h"
+#include "sq_data_store.h"
+#include "rabitq_data_store.h"
 
 namespace diskann
 {
@@ -27,7 +29,8 @@ class IndexFactory
     DISKANN_DLLEXPORT static std::shared_ptr<PQDataStore<T>> construct_pq_datastore(DataStoreStrategy strategy,
                                                                                     size_t num_points, size_t dimension,
                                                                                     Metric m, size_t num_pq_chunks,
-                                                                                    bool use_opq);
+                                                                                    bool use_opq,
+                                                                                    uint32_t num_pq_bits = NUM_PQ_BITS);
     template <typename T> static Distance<T> *construct_inmem_distance_fn(Metric m);
 
   private:
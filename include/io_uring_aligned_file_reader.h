@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+#if !defined(_WINDOWS) && defined(USE_IO_URING)
+
+#include <liburing.h>
+#include <memory>
+
+#include "aligned_file_reader.h"
+
+// AlignedFileReader backed by io_uring. Every registered thread gets its own
+// ring with the index file (or each of its stripes) registered as fixed
+// files. The IOContext handed out by get_ctx() is an opaque handle to that
+// ring, so PQFlashIndex can use this reader exactly like
+// LinuxAlignedFileReader.
+class IoUringAlignedFileReader : public AlignedFileReader
+{
+  private:
+    struct RingContext
+    {
+        struct io_uring ring;
+        // buffer registered with io_uring_register_buffers (nullptr if none)
+        char *fixed_buf = nullptr;
+        uint64_t fixed_buf_len = 0;
+        // number of unfinished pieces of each striped async read
+        tsl::robin_map<void *, uint32_t> pending_pieces;
+    };
+
+    FileHandle file_desc;
+    bool use_sqpoll;
+    uint32_t sqpoll_idle_ms;
+    io_context_t bad_ctx = (io_context_t)-1;
+
+    // files of a striped open (empty otherwise), registered with every ring
+    // in this order, and bytes per stripe unit
+    std::vector<FileHandle> stripe_descs;
+    uint64_t stripe_len = 0;
+    tsl::robin_map<io_context_t, std::unique_ptr<RingContext>> ring_map;
+
+    static RingContext *to_ring(IOContext ctx)
+    {
+        return reinterpret_cast<RingContext *>(ctx);
+    }
+
+    void destroy_ring(io_context_t ctx);
+    // throws if ctx is the bad_ctx get_ctx() hands to unregistered threads
+    void check_ctx(IOContext ctx) const;
+    // appends the pieces of `req` that lie in one stripe unit each, with the
+    // registered file slot they are read from; returns the number of pieces
+    uint32_t split_read(const AlignedRead &req, std::vector<AlignedRead> &pieces, std::vector<uint32_t> &slots);
+    void prep_read(RingContext *ring_ctx, struct io_uring_sqe *sqe, const AlignedRead &req, uint32_t file_slot,
+                   uint64_t user_data);
+    // preps `req` in a free SQE, submitting queued ones while there is none
+    void queue_read(RingContext *ring_ctx, const AlignedRead &req, uint32_t file_slot, uint64_t user_data);
+
+  public:
+    // use_sqpoll: let a kernel thread poll the submission queue so that
+    // submitting reads does not need a syscall. sqpoll_idle_ms is how long
+    // that thread spins before going to sleep.
+    IoUringAlignedFileReader(bool use_sqpoll = false, uint32_t sqpoll_idle_ms = 2000);
+    ~IoUringAlignedFileReader();
+
+    IOContext &get_ctx();
+
+    // register thread-id for a context
+    void register_thread();
+
+    // de-register thread-id for a context
+    void deregister_thread();
+    void deregister_all_threads();
+
+    // Open & close ops
+    // Blocking calls
+    void open(const std::string &fname);
+    void open_striped(const std::vector<std::string> &fnames, uint64_t stripe_sectors);
+    void close();
+
+    // process batch of aligned requests in parallel
+    // NOTE :: blocking call
+    void read(std::vector<AlignedRead> &read_reqs, IOContext &ctx, bool async = false);
+
+    // asynchronous reads, see AlignedFileReader
+    void submit_reads(std::vector<AlignedRead> &read_reqs, IOContext &ctx);
+    uint64_t get_completed_reads(IOContext &ctx, uint64_t min_completions, std::vector<void *> &completed_bufs);
+
+    // registers `buf` as a fixed buffer of the ring behind `ctx`; reads that
+    // land inside it are issued with IORING_OP_READ_FIXED
+    void register_buffer(IOContext &ctx, void *buf, uint64_t len);
+};
+
+#endif
@@ -4,6 +4,8 @@
 #pragma once
 #ifndef _WINDOWS
 
+#include <memory>
+
 #include "aligned_file_reader.h"
 
 class LinuxAlignedFileReader : public AlignedFileReader
@@ -13,6 +15,22 @@ class LinuxAlignedFileReader : public AlignedFileReader
     FileHandle file_desc;
     io_context_t bad_ctx = (io_context_t)-1;
 
+    // files of a striped open (empty otherwise) and bytes per stripe unit
+    std::vector<FileHandle> stripe_descs;
+    uint64_t stripe_len = 0;
+    // per context, the number of unfinished pieces of each striped async read
+    tsl::robin_map<io_context_t, std::unique_ptr<tsl::robin_map<void *, uint32_t>>> pending_pieces;
+    // per context, buffers of async reads reaped by submit_reads while it
+    // waited for room in the context, not yet returned to the caller
+    tsl::robin_map<io_context_t, std::unique_ptr<std::vector<void *>>> early_completions;
+
+    // appends the pieces of `req` that lie in one stripe unit each, with the
+    // file they are read from; returns the number of pieces
+    uint32_t split_read(const AlignedRead &req, std::vector<AlignedRead> &pieces, std::vector<FileHandle> &fds);
+
+    // get_completed_reads without the reads reaped early
+    uint64_t reap_reads(io_context_t ctx, uint64_t min_completions, std::vector<void *> &completed_bufs);
+
   public:
     LinuxAlignedFileReader();
     ~LinuxAlignedFileReader();
@@ -29,11 +47,16 @@ class LinuxAlignedFileReader : public AlignedFileReader
     // Open & close ops
     // Blocking calls
     void open(const std::string &fname);
+    void open_striped(const std::vector<std::string> &fnames, uint64_t stripe_sectors);
     void close();
 
     // process batch of aligned requests in parallel
     // NOTE :: blocking call
     void read(std::vector<AlignedRead> &read_reqs, IOContext &ctx, bool async = false);
+
+    // asynchronous reads, see AlignedFileReader
+    void submit_reads(std::vector<AlignedRead> &read_reqs, IOContext &ctx);
+    uint64_t get_completed_reads(IOContext &ctx, uint64_t min_completions, std::vector<void *> &completed_bufs);
 };
 
 #endif
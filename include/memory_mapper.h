@@ -27,13 +27,20 @@ class MemoryMapper
     HANDLE _fd;
 
 #endif
-    char *_buf;
-    size_t _fileSize;
+    char *_buf = nullptr;
+    size_t _fileSize = 0;
     const char *_fileName;
 
   public:
-    MemoryMapper(const char *filename);
-    MemoryMapper(const std::string &filename);
+    // populate: prefault the whole mapping (MAP_POPULATE) instead of taking a
+    // page fault on first access.
+    // huge_pages: ask for transparent huge pages (MADV_HUGEPAGE). For file
+    // mappings the kernel honors this only on filesystems that support huge
+    // pages (tmpfs mounted with huge=, or CONFIG_READ_ONLY_THP_FOR_FS); files
+    // on hugetlbfs are always mapped with huge pages.
+    // Both are ignored on Windows.
+    MemoryMapper(const char *filename, bool populate = false, bool huge_pages = false);
+    MemoryMapper(const std::string &filename, bool populate = false, bool huge_pages = false);
 
     char *getBuf();
     size_t getFileSize();
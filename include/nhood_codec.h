@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "windows_customizations.h"
+
+namespace diskann
+{
+// Codec for neighbor lists in the packed disk node format. Ids are sorted,
+// delta-encoded and stored with Stream VByte: one control byte per group of
+// four deltas, holding the byte length - 1 of each in two bits (lowest bits
+// first), followed by the little-endian delta bytes of all groups. Decoding a
+// group is one shuffle and a prefix sum, see decode_packed_nhood.
+
+// upper bound on the encoded length of n ids
+inline size_t packed_nhood_max_len(uint32_t n)
+{
+    return (n + 3) / 4 + 4 * (size_t)n;
+}
+
+// sorts ids[0..n) in place, writes their encoding to out and returns its length
+DISKANN_DLLEXPORT size_t encode_packed_nhood(uint32_t *ids, uint32_t n, uint8_t *out);
+
+// decodes n ids encoded by encode_packed_nhood from in into out[0..n) and
+// returns the length of the encoding. Never reads past the end of the encoding
+// nor writes past out[n - 1].
+DISKANN_DLLEXPORT size_t decode_packed_nhood(const uint8_t *in, uint32_t n, uint32_t *out);
+} // namespace diskann
@@ -24,17 +24,33 @@ struct QueryStats
     float io_us = 0;    // total time spent in IO
     float cpu_us = 0;   // total time spent in CPU
 
-    unsigned n_4k = 0;         // # of 4kB reads
-    unsigned n_8k = 0;         // # of 8kB reads
-    unsigned n_12k = 0;        // # of 12kB reads
-    unsigned n_ios = 0;        // total # of IOs issued
-    unsigned read_size = 0;    // total # of bytes read
-    unsigned n_cmps_saved = 0; // # cmps saved
-    unsigned n_cmps = 0;       // # cmps
-    unsigned n_cache_hits = 0; // # cache_hits
-    unsigned n_hops = 0;       // # search hops
+    unsigned n_4k = 0;          // # of 4kB reads
+    unsigned n_8k = 0;          // # of 8kB reads
+    unsigned n_12k = 0;         // # of reads of 12kB or more
+    unsigned n_ios = 0;         // total # of IOs issued
+    unsigned read_size = 0;     // total # of bytes read
+    unsigned n_reads_saved = 0; // # node reads served by a read issued for another node
+    unsigned n_cmps_saved = 0;  // # cmps saved
+    unsigned n_cmps = 0;        // # cmps
+    unsigned n_cache_hits = 0;  // # cache_hits
+    unsigned n_hops = 0;        // # search hops
 };
 
+// accounts for one read of len bytes in stats (which may be nullptr)
+inline void record_read(QueryStats *stats, uint64_t len)
+{
+    if (stats == nullptr)
+        return;
+    stats->n_ios++;
+    stats->read_size += (unsigned)len;
+    if (len <= 4096)
+        stats->n_4k++;
+    else if (len <= 8192)
+        stats->n_8k++;
+    else
+        stats->n_12k++;
+}
+
 template <typename T>
 inline T get_percentile_stats(QueryStats *stats, uint64_t len, float percentile,
                               const std::function<T(const QueryStats &)> &member_fn)
@@ -8,11 +8,29 @@
 
 namespace diskann
 {
+// code of a chunk in a PQ code of num_bits bits per chunk, see pq_code_len
+inline uint32_t get_pq_code(const uint8_t *code, const size_t chunk, const uint32_t num_bits)
+{
+    if (num_bits == NUM_PQ_BITS)
+        return code[chunk];
+    if (num_bits == PQ_FAST_SCAN_BITS)
+        return (code[chunk / 2] >> (4 * (chunk % 2))) & 0x0f;
+    const size_t bit = chunk * num_bits;
+    const uint8_t *p = code + bit / 8;
+    const uint32_t shift = bit % 8;
+    uint32_t v = p[0] | ((uint32_t)p[1] << 8);
+    if (shift + num_bits > 16)
+        v |= (uint32_t)p[2] << 16;
+    return (v >> shift) & ((1u << num_bits) - 1);
+}
+
 class FixedChunkPQTable
 {
-    float *tables = nullptr; // pq_tables = float array of size [256 * ndims]
+    float *tables = nullptr; // pq_tables = float array of size [num_centers * ndims]
     uint64_t ndims = 0;      // ndims = true dimension of vectors
     uint64_t n_chunks = 0;
+    uint64_t num_centers = NUM_PQ_CENTROIDS;
+    uint32_t num_bits = NUM_PQ_BITS;
     bool use_rotation = false;
     uint32_t *chunk_offsets = nullptr;
     float *centroid = nullptr;
@@ -32,32 +50,94 @@ class FixedChunkPQTable
 
     uint32_t get_num_chunks();
 
+    // NUM_PQ_CENTROIDS, or PQ_FAST_SCAN_CENTROIDS for 4-bit codebooks
+    uint32_t get_num_centers();
+
+    // log2 of the number of centers, as given by the pivots in the file
+    uint32_t get_num_bits();
+
     void preprocess_query(float *query_vec);
 
-    // assumes pre-processed query
+    // assumes pre-processed query. Fills pq_table_stride(get_num_bits())
+    // floats per chunk.
     void populate_chunk_distances(const float *query_vec, float *dist_vec);
 
     float l2_distance(const float *query_vec, uint8_t *base_vec);
 
     float inner_product(const float *query_vec, uint8_t *base_vec);
 
-    // assumes no rotation is involved
+    // decodes base_vec back to the space of the original vectors
     void inflate_vector(uint8_t *base_vec, float *out_vec);
 
     void populate_chunk_inner_products(const float *query_vec, float *dist_vec);
 };
 
+// gathers the codes of ids, ndims = pq_code_len bytes each, back to back in out
 void aggregate_coords(const std::vector<unsigned> &ids, const uint8_t *all_coords, const uint64_t ndims, uint8_t *out);
 
+// codes of n_pts points stored back to back, pq_code_len(pq_nchunks, num_bits)
+// bytes each
 void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, const float *pq_dists,
-                    std::vector<float> &dists_out);
+                    std::vector<float> &dists_out, const uint32_t num_bits = NUM_PQ_BITS);
 
 // Need to replace calls to these with calls to vector& based functions above
 void aggregate_coords(const unsigned *ids, const uint64_t n_ids, const uint8_t *all_coords, const uint64_t ndims,
                       uint8_t *out);
 
 void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, const float *pq_dists,
-                    float *dists_out);
+                    float *dists_out, const uint32_t num_bits = NUM_PQ_BITS);
+
+// Transposed PQ codes, for 8-bit codebooks. Codes are laid out in blocks of
+// PQ_TRANSPOSE_BLOCK points, holding for every chunk the codes of the points
+// of the block next to each other, so that the table lookups of a chunk for
+// a whole block are one SIMD gather. Lanes past the last point are zero.
+
+// bytes of the transposed layout of n_pts codes
+inline size_t transposed_codes_len(const size_t n_pts, const size_t pq_nchunks)
+{
+    return ROUND_UP(n_pts, PQ_TRANSPOSE_BLOCK) * pq_nchunks;
+}
+
+// aggregate_coords writing the codes in the transposed layout
+void aggregate_coords_transposed(const std::vector<unsigned> &ids, const uint8_t *all_coords, const uint64_t ndims,
+                                 uint8_t *out);
+
+void aggregate_coords_transposed(const unsigned *ids, const uint64_t n_ids, const uint8_t *all_coords,
+                                 const uint64_t ndims, uint8_t *out);
+
+// converts n_pts codes stored back to back to the transposed layout in out
+void transpose_pq_codes(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, uint8_t *out);
+
+// pq_dist_lookup over transposed codes. Uses AVX2 gathers if the CPU has
+// them, else a scalar loop.
+void pq_dist_lookup_transposed(const uint8_t *tr_pq_ids, const size_t n_pts, const size_t pq_nchunks,
+                               const float *pq_dists, float *dists_out);
+
+// PQ fast-scan, for 4-bit codebooks. Distance tables are quantized to one
+// byte per entry so that the 16 entries of a chunk fit in a SIMD register and
+// are looked up for 16 points at once with a byte shuffle. Codes are laid out
+// in blocks of PQ_FAST_SCAN_BLOCK points: for every chunk (rounded up to an
+// even count) 16 bytes, byte i holding the code of point i of the block in
+// its low and of point i + 16 in its high nibble.
+
+// bytes of the fast-scan layout of n_pts codes
+inline size_t fast_scan_codes_len(const size_t n_pts, const size_t pq_nchunks)
+{
+    return DIV_ROUND_UP(n_pts, PQ_FAST_SCAN_BLOCK) * ROUND_UP(pq_nchunks, 2) * 16;
+}
+
+// quantizes the chunk distances from populate_chunk_distances into lut (at
+// least ROUND_UP(pq_nchunks, 2) * 16 bytes). The distance of a point is then
+// bias + scale * (sum of its lut entries).
+void quantize_fast_scan_lut(const float *pq_dists, const size_t pq_nchunks, uint8_t *lut, float &scale, float &bias);
+
+// converts n_pts nibble-packed codes stored back to back (pq_code_len(
+// pq_nchunks, PQ_FAST_SCAN_BITS) bytes each, as written by aggregate_coords)
+// to the fast-scan layout in out
+void pack_fast_scan_codes(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, uint8_t *out);
+
+void pq_fast_scan_lookup(const uint8_t *packed_ids, const size_t n_pts, const size_t pq_nchunks, const uint8_t *lut,
+                         const float scale, const float bias, float *dists_out);
 
 DISKANN_DLLEXPORT int generate_pq_pivots(const float *const train_data, size_t num_train, unsigned dim,
                                          unsigned num_centers, unsigned num_pq_chunks, unsigned max_k_means_reps,
@@ -83,11 +163,12 @@ DISKANN_DLLEXPORT int generate_pq_data_from_pivots_simplified(const float *data,
 template <typename T>
 void generate_disk_quantized_data(const std::string &data_file_to_use, const std::string &disk_pq_pivots_path,
                                   const std::string &disk_pq_compressed_vectors_path,
-                                  const diskann::Metric compareMetric, const double p_val, size_t &disk_pq_dims);
+                                  const diskann::Metric compareMetric, const double p_val, size_t &disk_pq_dims,
+                                  const bool use_opq = false);
 
 template <typename T>
 void generate_quantized_data(const std::string &data_file_to_use, const std::string &pq_pivots_path,
                              const std::string &pq_compressed_vectors_path, const diskann::Metric compareMetric,
                              const double p_val, const uint64_t num_pq_chunks, const bool use_opq,
-                             const std::string &codebook_prefix = "");
+                             const std::string &codebook_prefix = "", const uint32_t num_centers = NUM_PQ_CENTROIDS);
 } // namespace diskann
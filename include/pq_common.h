@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <sstream>
 
 #define NUM_PQ_BITS 8
 #define NUM_PQ_CENTROIDS (1 << NUM_PQ_BITS)
+// 4-bit codebooks, whose distances are computed with fast-scan (see pq.h)
+#define PQ_FAST_SCAN_BITS 4
+#define PQ_FAST_SCAN_CENTROIDS (1 << PQ_FAST_SCAN_BITS)
+#define PQ_FAST_SCAN_BLOCK 32
+// points per block of the transposed code layout of 8-bit codes (see pq.h)
+#define PQ_TRANSPOSE_BLOCK 16
+// widest codebooks, 2^16 centroids per chunk
+#define MAX_PQ_BITS 16
 #define MAX_OPQ_ITERS 20
 #define NUM_KMEANS_REPS_PQ 12
 #define MAX_PQ_TRAINING_SET_SIZE 256000
@@ -12,6 +21,26 @@
 
 namespace diskann
 {
+// codebooks of 4 bits (fast-scan) or 8 to MAX_PQ_BITS bits per chunk
+inline bool is_valid_pq_bits(uint32_t num_bits)
+{
+    return num_bits == PQ_FAST_SCAN_BITS || (num_bits >= NUM_PQ_BITS && num_bits <= MAX_PQ_BITS);
+}
+
+// bytes of the PQ code of a point. 8-bit codes take one byte per chunk, other
+// widths are packed back to back in a little-endian bit stream, so 4-bit codes
+// hold two chunks per byte (see get_pq_code in pq.h).
+inline uint64_t pq_code_len(uint64_t n_chunks, uint32_t num_bits)
+{
+    return num_bits == NUM_PQ_BITS ? n_chunks : (n_chunks * num_bits + 7) / 8;
+}
+
+// floats per chunk in the distance tables filled by populate_chunk_distances
+inline uint64_t pq_table_stride(uint32_t num_bits)
+{
+    return num_bits <= NUM_PQ_BITS ? NUM_PQ_CENTROIDS : (uint64_t)1 << num_bits;
+}
+
 inline std::string get_quantized_vectors_filename(const std::string &prefix, bool use_opq, uint32_t num_chunks)
 {
     return prefix + (use_opq ? "_opq" : "pq") + std::to_string(num_chunks) + "_compressed.bin";
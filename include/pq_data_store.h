@@ -83,6 +83,9 @@ template <typename data_t> class PQDataStore : public AbstractDataStore<data_t>
 #endif
 
   private:
+    // bytes of the code of a point, two chunks per byte for 4-bit codes
+    size_t code_len() const;
+
     uint8_t *_quantized_data = nullptr;
     size_t _num_chunks = 0;
 
@@ -6,13 +6,17 @@
 
 #include "aligned_file_reader.h"
 #include "concurrent_queue.h"
+#include "memory_mapper.h"
 #include "neighbor.h"
 #include "parameters.h"
 #include "percentile_stats.h"
 #include "pq.h"
+#include "rabitq.h"
 #include "utils.h"
 #include "windows_customizations.h"
 #include "scratch.h"
+#include "sector_cache.h"
+#include "timer.h"
 #include "tsl/robin_map.h"
 #include "tsl/robin_set.h"
 
@@ -46,6 +50,14 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
 
     DISKANN_DLLEXPORT void load_cache_list(std::vector<uint32_t> &node_list);
 
+#ifndef EXEC_ENV_OLS
+    // Makes the next load map the compressed PQ vectors file read-only
+    // instead of copying it to the heap, so that processes serving the same
+    // index share one copy of the PQ codes through the page cache. populate
+    // and huge_pages are passed on to MemoryMapper.
+    DISKANN_DLLEXPORT void set_pq_vectors_mmap(bool populate = false, bool huge_pages = false);
+#endif
+
 #ifdef EXEC_ENV_OLS
     DISKANN_DLLEXPORT void generate_cache_list_from_sample_queries(MemoryMappedFiles &files, std::string sample_bin,
                                                                    uint64_t l_search, uint64_t beamwidth,
@@ -61,6 +73,37 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     DISKANN_DLLEXPORT void cache_bfs_levels(uint64_t num_nodes_to_cache, std::vector<uint32_t> &node_list,
                                             const bool shuffle = false);
 
+    // Writes the ids, neighborhoods and coordinates of the currently cached
+    // nodes to snapshot_path, packed so that load_cache_snapshot can restore
+    // the cache with one sequential read instead of recomputing the cache
+    // list and reading every cached node from the index file again.
+    DISKANN_DLLEXPORT void save_cache_snapshot(const std::string &snapshot_path);
+
+    // Replaces the node cache with the one saved in snapshot_path. Returns
+    // false, leaving the cache untouched, if the file does not exist or was
+    // saved from a different index, or holds invalid ids.
+    DISKANN_DLLEXPORT bool load_cache_snapshot(const std::string &snapshot_path);
+
+    // Starts a background thread that counts how often searches visit each
+    // node and, every period_sec seconds, builds a cache of the
+    // num_nodes_to_cache most visited nodes off the query path and swaps it in
+    // for the current one. Counts are halved after every refresh so that the
+    // cache follows drift in the query distribution. Searches keep using the
+    // cache they started with, so they are never blocked by a refresh. Do not
+    // combine with generate_cache_list_from_sample_queries, which uses the
+    // same visit counters.
+    DISKANN_DLLEXPORT void start_cache_refresh(uint64_t num_nodes_to_cache, uint32_t period_sec);
+    DISKANN_DLLEXPORT void stop_cache_refresh();
+
+    // Sets up a dynamic cache of up to budget_bytes for the node sectors read
+    // during search, on top of the static cache from load_cache_list. Nodes
+    // are admitted as they are read and evicted with CLOCK, so the cache
+    // follows the query distribution. A budget of 0 turns it off. Must not be
+    // called while searches are running.
+    DISKANN_DLLEXPORT void set_sector_cache(uint64_t budget_bytes, uint32_t num_shards = 64);
+    DISKANN_DLLEXPORT SectorCache::Stats get_sector_cache_stats();
+    DISKANN_DLLEXPORT void reset_sector_cache_stats();
+
     DISKANN_DLLEXPORT void cached_beam_search(const T *query, const uint64_t k_search, const uint64_t l_search,
                                               uint64_t *res_ids, float *res_dists, const uint64_t beam_width,
                                               const bool use_reorder_data = false, QueryStats *stats = nullptr);
@@ -79,7 +122,49 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
                                               uint64_t *res_ids, float *res_dists, const uint64_t beam_width,
                                               const bool use_filter, const LabelT &filter_label,
                                               const uint32_t io_limit, const bool use_reorder_data = false,
-                                              QueryStats *stats = nullptr);
+                                              QueryStats *stats = nullptr, const uint32_t rerank_depth = 0);
+
+#ifndef _WINDOWS
+    // Same contract as cached_beam_search, but keeps up to beam_width reads in
+    // flight at all times: each node is expanded as soon as its sector lands,
+    // and the next candidate is issued right away instead of waiting for the
+    // whole beam to finish.
+    DISKANN_DLLEXPORT void pipelined_beam_search(const T *query, const uint64_t k_search, const uint64_t l_search,
+                                                 uint64_t *res_ids, float *res_dists, const uint64_t beam_width,
+                                                 const bool use_filter, const LabelT &filter_label,
+                                                 const uint32_t io_limit, const bool use_reorder_data = false,
+                                                 QueryStats *stats = nullptr, const uint32_t rerank_depth = 0);
+
+    // Runs num_queries queries (stored query_aligned_dim apart) on the calling
+    // thread, keeping up to num_interleaved of them in flight on a single I/O
+    // context: whenever one query waits on its reads, the others whose reads
+    // have landed make progress. Each in-flight query needs its own scratch,
+    // so num_interleaved is capped by the scratch that is free when the call
+    // starts. filter_labels is nullptr for unfiltered search or holds one label
+    // per query. Results and stats of query i start at i * k_search and i.
+    DISKANN_DLLEXPORT void interleaved_beam_search(const T *queries, const uint64_t num_queries,
+                                                   const uint64_t query_aligned_dim, const uint64_t k_search,
+                                                   const uint64_t l_search, uint64_t *res_ids, float *res_dists,
+                                                   const uint64_t beam_width, const uint32_t num_interleaved,
+                                                   const LabelT *filter_labels, const uint32_t io_limit,
+                                                   const bool use_reorder_data = false, QueryStats *stats = nullptr,
+                                                   const uint32_t rerank_depth = 0);
+#endif
+
+    // Searches num_queries queries (stored query_aligned_dim apart) in groups
+    // of up to batch_size that advance hop by hop in lock-step. The frontier
+    // reads of a group are merged into a single read call and a sector wanted
+    // by several queries in the same hop is only read once. batch_size is
+    // capped by the scratch that is free when the call starts. filter_labels
+    // is nullptr for unfiltered search or holds one label per query. Results
+    // and stats of query i start at i * k_search and i.
+    DISKANN_DLLEXPORT void batch_cached_beam_search(const T *queries, const uint64_t num_queries,
+                                                    const uint64_t query_aligned_dim, const uint64_t k_search,
+                                                    const uint64_t l_search, uint64_t *res_ids, float *res_dists,
+                                                    const uint64_t beam_width, const uint32_t batch_size,
+                                                    const LabelT *filter_labels, const uint32_t io_limit,
+                                                    const bool use_reorder_data = false, QueryStats *stats = nullptr,
+                                                    const uint32_t rerank_depth = 0);
 
     DISKANN_DLLEXPORT LabelT get_converted_label(const std::string &filter_label);
 
@@ -124,6 +209,148 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
                                                   const uint32_t nthreads);
     void reset_stream_for_reading(std::basic_istream<char> &infile);
 
+    // search building blocks shared by the beam search variants
+    //
+    // copies (and normalizes, for cosine/mips) the query into the scratch and
+    // fills the PQ distance tables. Returns the query norm.
+    float preprocess_query(const T *query, SSDQueryScratch<T> *query_scratch);
+
+    // query <-> node distances in PQ space for `n_ids` nodes
+    void compute_pq_dists(PQScratch<T> *pq_query_scratch, const uint32_t *ids, const uint64_t n_ids,
+                          float *dists_out);
+
+    // same, from the codes of the nodes stored back to back. 8-bit codes are
+    // transposed into aligned_pq_coord_scratch, which codes must not alias then.
+    void pq_codes_dists(PQScratch<T> *pq_query_scratch, const uint8_t *codes, const uint64_t n_ids,
+                        float *dists_out);
+
+    // picks the entry point (closest medoid) and seeds retset/visited with it
+    void init_search_state(SSDQueryScratch<T> *query_scratch, const bool use_filter, const LabelT &filter_label);
+
+    // records the full-precision distance of an expanded node and inserts its
+    // unvisited neighbors into retset. `node_coords` must be aligned. If given,
+    // nbr_codes holds the PQ codes of node_nbrs, otherwise they are gathered
+    // from the in-memory PQ data, and node_dist the distance of node_coords,
+    // otherwise it is computed.
+    void expand_node(SSDQueryScratch<T> *query_scratch, const uint32_t node_id, T *node_coords,
+                     const uint64_t nnbrs, uint32_t *node_nbrs, const bool use_filter, const LabelT &filter_label,
+                     QueryStats *stats, const uint8_t *nbr_codes = nullptr, const float *node_dist = nullptr);
+
+    // expand_node for the cached nodes of a hop, with the full-precision
+    // distances of their coords (from coord_cache) computed in one batch
+    void expand_cached_nodes(SSDQueryScratch<T> *query_scratch, const tsl::robin_map<uint32_t, T *> &coord_cache,
+                             const std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t *>>> &cached_nhoods,
+                             const bool use_filter, const LabelT &filter_label, QueryStats *stats);
+
+    // expand_node for a node whose sector(s) have been read into sector_buf
+    void expand_sector_node(SSDQueryScratch<T> *query_scratch, const uint32_t node_id, char *sector_buf,
+                            const bool use_filter, const LabelT &filter_label, QueryStats *stats);
+
+    // plans the reads for one hop: frontier nodes that share a sector are read
+    // once and runs of contiguous sectors are merged into a single read, all
+    // into consecutive space of sector_scratch. frontier_nhoods receives every
+    // frontier node (in order) with the buffer holding its sector. If
+    // hop_sectors is given, sectors already in it (read for other queries in
+    // the same hop) are not read again, and the new ones are added to it.
+    void plan_frontier_reads(const std::vector<uint32_t> &frontier, char *sector_scratch,
+                             std::vector<std::pair<uint32_t, char *>> &frontier_nhoods,
+                             std::vector<AlignedRead> &read_reqs, QueryStats *stats,
+                             tsl::robin_map<uint64_t, char *> *hop_sectors = nullptr);
+
+    // adds the node sectors covered by completed frontier reads to the
+    // sector cache, if there is one
+    void admit_to_sector_cache(const std::vector<AlignedRead> &read_reqs);
+
+    // optional full-precision re-ranking, then copies the top k_search results out
+    void finalize_search(SSDQueryScratch<T> *query_scratch, IOContext &ctx, const uint64_t k_search,
+                         const float query_norm, uint64_t *indices, float *distances, const bool use_reorder_data,
+                         const uint32_t rerank_depth, QueryStats *stats);
+
+    // whether re-ranking has to read full-precision vectors: always for
+    // separate vectors, and for use_reorder_data on disk PQ indices. Nodes
+    // with full-precision coords already gave full_retset exact distances.
+    bool needs_rerank_reads(const bool use_reorder_data);
+
+    // re-ranking with full-precision vectors: get_reorder_reads trims the
+    // (sorted) full_retset to rerank_depth candidates (k_search *
+    // FULL_PRECISION_REORDER_MULTIPLIER if 0) and queues reads of the sectors
+    // holding their vectors into the sector scratch, each distinct sector once
+    // and runs of adjacent ones merged. Once those have landed,
+    // rerank_full_retset recomputes the distances and re-sorts full_retset.
+    void get_reorder_reads(SSDQueryScratch<T> *query_scratch, const uint64_t k_search, const uint32_t rerank_depth,
+                           std::vector<AlignedRead> &read_reqs, QueryStats *stats);
+    void rerank_full_retset(SSDQueryScratch<T> *query_scratch);
+
+    // read_nodes for indices with separate vectors: reads the vectors of the
+    // nodes with a coord buffer (and read so far) through ctx
+    void read_separate_vectors(const std::vector<uint32_t> &node_ids, std::vector<T *> &coord_buffers,
+                               IOContext &ctx, std::vector<bool> &retval);
+
+    // takes up to max_count thread data off the pool without waiting, for
+    // searches that run several queries on one thread. Return them with
+    // release_thread_data.
+    std::vector<SSDThreadData<T> *> try_acquire_thread_data(const uint64_t max_count);
+    void release_thread_data(std::vector<SSDThreadData<T> *> &thread_data);
+
+    // copies the top k_search entries of full_retset out, mapping dummy points
+    // back to their real ids and undoing the mips scaling
+    void copy_results(SSDQueryScratch<T> *query_scratch, const uint64_t k_search, const float query_norm,
+                      uint64_t *indices, float *distances);
+
+#ifndef _WINDOWS
+    struct NodeCache;
+
+    // state of one query driven by the pipelined search state machine. Every
+    // in-flight read owns a slot of the query's sector scratch until the node
+    // read into it is expanded.
+    struct PipelinedQuery
+    {
+        enum Phase
+        {
+            SEARCHING,
+            RERANKING,
+            DONE
+        };
+
+        Phase phase = DONE;
+        SSDQueryScratch<T> *scratch = nullptr;
+        uint64_t k_search = 0;
+        uint64_t *indices = nullptr;
+        float *distances = nullptr;
+        bool use_filter = false;
+        LabelT filter_label{};
+        bool use_reorder_data = false;
+        uint32_t rerank_depth = 0;
+        float query_norm = 0;
+        QueryStats *stats = nullptr;
+        std::shared_ptr<const NodeCache> node_cache;
+
+        std::vector<uint32_t> slot_to_node;
+        std::vector<uint64_t> free_slots;
+        uint64_t n_in_flight = 0;
+        uint32_t num_ios = 0;
+        Timer query_timer;
+    };
+
+    // sets up `q` for a new query and seeds its candidate list
+    void start_pipelined_query(PipelinedQuery &q, const T *query, const uint64_t k_search, const uint64_t l_search,
+                               uint64_t *indices, float *distances, const bool use_filter,
+                               const LabelT &filter_label, const bool use_reorder_data, const uint32_t rerank_depth,
+                               QueryStats *stats);
+
+    // expands cached candidates and appends reads for the closest uncached
+    // ones to `read_reqs` until beam_width reads are in flight. Moves the query
+    // on to re-ranking or DONE when there is nothing left to read.
+    void advance_pipelined_query(PipelinedQuery &q, const uint64_t beam_width, const uint32_t io_limit,
+                                 std::vector<AlignedRead> &read_reqs);
+
+    // handles the completion of the read into `buf`, which belongs to `q`
+    void complete_pipelined_read(PipelinedQuery &q, char *buf);
+
+    // re-ranks (after the reorder reads have landed) and copies the results out
+    void finish_pipelined_query(PipelinedQuery &q);
+#endif
+
     // sector # on disk where node_id is present with in the graph part
     DISKANN_DLLEXPORT uint64_t get_node_sector(uint64_t node_id);
 
@@ -133,6 +360,13 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     // returns region of `node_buf` containing [NNBRS][NBR_ID(uint32_t)]
     DISKANN_DLLEXPORT uint32_t *offset_to_node_nhood(char *node_buf);
 
+    // sets nnbrs and returns the neighbor ids of the node at `node_buf`.
+    // Packed nhoods are decoded into nbrs_buf (at least _max_degree ids),
+    // plain ones are returned in place. If nbr_codes is given, it is set to
+    // the inline PQ codes of the neighbors, or nullptr if the index has none.
+    uint32_t *get_node_nbrs(char *node_buf, uint32_t *nbrs_buf, uint32_t &nnbrs,
+                            const uint8_t **nbr_codes = nullptr);
+
     // returns region of `node_buf` containing [COORD(T)]
     DISKANN_DLLEXPORT T *offset_to_node_coords(char *node_buf);
 
@@ -144,19 +378,29 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     // nhood of node `i` is in sector: [i * DIV_ROUND_UP(_max_node_len, SECTOR_LEN)]
     // offset in sector: [0]
     //
+    // index info for packed nhoods (always multi-node sectors)
+    // nhood of node `i` is in sector: [i / nnodes_per_sector]
+    // offset in sector: ((uint16_t*) sector)[i % nnodes_per_sector]
+    //
     // Common info
     // coords start at ofsset
     // #nbrs of node `i`: *(unsigned*) (offset + disk_bytes_per_point)
-    // nbrs of node `i` : (unsigned*) (offset + disk_bytes_per_point + 1)
+    // nbrs of node `i` : (unsigned*) (offset + disk_bytes_per_point + 1),
+    //                    encoded with encode_packed_nhood for packed nhoods
+    // PQ codes of the nbrs (if inlined): _pq_code_len bytes per nbr, right after
+    //                    the (encoded) nbrs
 
     uint64_t _max_node_len = 0;
     uint64_t _nnodes_per_sector = 0; // 0 for multi-sector nodes, >0 for multi-node sectors
+    bool _packed_nhoods = false;
+    bool _inline_pq_codes = false;
     uint64_t _max_degree = 0;
 
     // Data used for searching with re-order vectors
     uint64_t _ndims_reorder_vecs = 0;
     uint64_t _reorder_data_start_sector = 0;
-    uint64_t _nvecs_per_sector = 0;
+    uint64_t _nvecs_per_sector = 0; // 0 for vectors spanning several sectors
+    uint64_t _reorder_vec_len = 0;
 
     diskann::Metric metric = diskann::Metric::L2;
 
@@ -173,16 +417,32 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     uint64_t _disk_bytes_per_point = 0; // Number of bytes
 
     std::string _disk_index_file;
-    std::vector<std::pair<uint32_t, uint32_t>> _node_visit_counter;
+    // visits per node, counted by searches while _count_visited_nodes is set;
+    // allocated once at load time since searches may index it concurrently
+    std::vector<std::atomic<uint32_t>> _node_visit_counter;
 
     // PQ data
     // _n_chunks = # of chunks ndims is split into
-    // data: char * _n_chunks
+    // _pq_num_bits = bits per chunk code, _pq_code_len = pq_code_len(_n_chunks, _pq_num_bits)
+    // data: char * _pq_code_len
     // chunk_size = chunk size of each dimension chunk
-    // pq_tables = float* [[2^8 * [chunk_size]] * _n_chunks]
+    // pq_tables = float* [[2^_pq_num_bits * [chunk_size]] * _n_chunks]
     uint8_t *data = nullptr;
     uint64_t _n_chunks;
+    uint32_t _pq_num_bits = NUM_PQ_BITS;
+    uint64_t _pq_code_len = 0;
+#ifndef EXEC_ENV_OLS
+    // set when data points into a mapping of the compressed vectors file, see
+    // set_pq_vectors_mmap
+    bool _mmap_pq_vectors = false;
+    bool _mmap_pq_populate = false;
+    bool _mmap_pq_huge_pages = false;
+    std::unique_ptr<MemoryMapper> _pq_vectors_mapper;
+    bool map_pq_vectors(const std::string &pq_compressed_vectors, size_t &npts, size_t &nchunks);
+#endif
     FixedChunkPQTable _pq_table;
+    // 4-bit codebook: PQ distances are computed with fast-scan
+    bool _pq_fast_scan = false;
 
     // distance comparator
     std::shared_ptr<Distance<T>> _dist_cmp;
@@ -193,6 +453,14 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     uint64_t _disk_pq_n_chunks = 0;
     FixedChunkPQTable _disk_pq_table;
 
+    // RaBitQ codes of all points (see rabitq.h), filtering the neighbors of
+    // an expanded node before their PQ distances are computed: a neighbor
+    // whose estimate minus error bound is above the worst candidate can not
+    // enter the candidate list. L2 only.
+    bool _use_rabitq = false;
+    RaBitQuantizer _rabitq;
+    std::unique_ptr<uint8_t[]> _rabitq_codes;
+
     // medoid/start info
 
     // graph has one entry point by default,
@@ -205,20 +473,48 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     // closest centroid as the starting point of search
     float *_centroid_data = nullptr;
 
-    // nhood_cache; the uint32_t in nhood_Cache are offsets into nhood_cache_buf
-    unsigned *_nhood_cache_buf = nullptr;
-    tsl::robin_map<uint32_t, std::pair<uint32_t, uint32_t *>> _nhood_cache;
-
-    // coord_cache; The T* in coord_cache are offsets into coord_cache_buf
-    T *_coord_cache_buf = nullptr;
-    tsl::robin_map<uint32_t, T *> _coord_cache;
+    // cache of node neighborhoods and coordinates, see load_cache_list.
+    // Searches hold on to the cache that was current when they started
+    // (get_node_cache), so a new one can be swapped in while they run; the old
+    // one is freed when the last search using it finishes.
+    struct NodeCache
+    {
+        // nhood_cache; the uint32_t in nhood_Cache are offsets into nhood_cache_buf
+        unsigned *nhood_cache_buf = nullptr;
+        tsl::robin_map<uint32_t, std::pair<uint32_t, uint32_t *>> nhood_cache;
+
+        // coord_cache; The T* in coord_cache are offsets into coord_cache_buf
+        T *coord_cache_buf = nullptr;
+        tsl::robin_map<uint32_t, T *> coord_cache;
+
+        ~NodeCache();
+    };
+    std::shared_ptr<const NodeCache> _node_cache;
+
+    std::shared_ptr<const NodeCache> get_node_cache() const
+    {
+        return std::atomic_load(&_node_cache);
+    }
+    std::shared_ptr<NodeCache> build_node_cache(const std::vector<uint32_t> &node_list);
+
+    // background cache refresh, see start_cache_refresh
+    std::thread _cache_refresh_thread;
+    std::mutex _cache_refresh_mutex;
+    std::condition_variable _cache_refresh_cv;
+    bool _stop_cache_refresh = false;
+    void refresh_node_cache(uint64_t num_nodes_to_cache);
+
+    // dynamic cache of node sectors, see set_sector_cache
+    std::unique_ptr<SectorCache> _sector_cache;
 
     // thread-specific scratch
     ConcurrentQueue<SSDThreadData<T> *> _thread_data;
     uint64_t _max_nthreads;
     bool _load_flag = false;
-    bool _count_visited_nodes = false;
+    std::atomic<bool> _count_visited_nodes{false};
     bool _reorder_data_exists = false;
+    // nodes hold no coords; the reorder data are the full vectors (of type T)
+    bool _separate_vectors = false;
     uint64_t _reoreder_data_offset = 0;
 
     // filter support
@@ -234,6 +530,10 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
     tsl::robin_map<uint32_t, std::vector<uint32_t>> _real_to_dummy_map;
     std::unordered_map<std::string, LabelT> _label_map;
 
+    // original id of the node at each position of a reordered disk index
+    // (see compute_bfs_layout_order); empty if nodes are laid out by id
+    std::vector<uint32_t> _id_map;
+
 #ifdef EXEC_ENV_OLS
     // Set to a larger value than the actual header to accommodate
     // any additions we make to the header. This is an outer limit
@@ -1,5 +1,6 @@
 #pragma once
 #include "quantized_distance.h"
+#include "pq_common.h"
 
 namespace diskann
 {
@@ -17,7 +18,10 @@ template <typename data_t> class PQL2Distance : public QuantizedDistance<data_t>
     // load_pivot_data. Hence this. The TODO is whether we should check
     // that the num_chunks from the file is the same as this one.
 
-    PQL2Distance(uint32_t num_chunks, bool use_opq = false);
+    // num_centers is NUM_PQ_CENTROIDS, or PQ_FAST_SCAN_CENTROIDS for 4-bit
+    // codes whose distances are computed with fast-scan. Loading pivot data
+    // takes it from the file.
+    PQL2Distance(uint32_t num_chunks, bool use_opq = false, uint32_t num_centers = NUM_PQ_CENTROIDS);
 
     virtual ~PQL2Distance() override;
 
@@ -38,6 +42,8 @@ template <typename data_t> class PQL2Distance : public QuantizedDistance<data_t>
     // Has to be < ndim
     virtual uint32_t get_num_chunks() const override;
 
+    virtual uint32_t get_num_centers() const override;
+
     // Preprocess the query by computing chunk distances from the query vector to
     // various centroids. Since we don't want this class to do scratch management,
     // we will take a PQScratch object which can come either from Index class or
@@ -52,7 +58,8 @@ template <typename data_t> class PQL2Distance : public QuantizedDistance<data_t>
     // called at each iteration of the graph walk. NOTE: This function expects
     // 1. the query to be preprocessed using preprocess_query()
     // 2. the scratch object to contain the quantized vectors corresponding to ids
-    // in aligned_pq_coord_scratch. Done by calling aggregate_coords()
+    // in aligned_pq_coord_scratch. Done by calling aggregate_coords_transposed()
+    // for 8-bit codebooks (NUM_PQ_CENTROIDS centers), aggregate_coords() else
     //
     virtual void preprocessed_distance(PQScratch<data_t> &pq_scratch, const uint32_t id_count,
                                        float *dists_out) override;
@@ -78,6 +85,7 @@ template <typename data_t> class PQL2Distance : public QuantizedDistance<data_t>
     float *_tables = nullptr; // pq_tables = float array of size [256 * ndims]
     uint64_t _ndims = 0;      // ndims = true dimension of vectors
     uint64_t _num_chunks = 0;
+    uint64_t _num_centers = NUM_PQ_CENTROIDS;
     bool _is_opq = false;
     uint32_t *_chunk_offsets = nullptr;
     float *_centroid = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include "pq_common.h"
+#include "rabitq.h"
 #include "utils.h"
 
 namespace diskann
@@ -9,13 +10,25 @@ namespace diskann
 template <typename T> class PQScratch
 {
   public:
-    float *aligned_pqtable_dist_scratch = nullptr; // MUST BE AT LEAST [256 * NCHUNKS]
+    float *aligned_pqtable_dist_scratch = nullptr; // MUST BE AT LEAST [pq_table_stride * NCHUNKS]
     float *aligned_dist_scratch = nullptr;         // MUST BE AT LEAST diskann MAX_DEGREE
-    uint8_t *aligned_pq_coord_scratch = nullptr;   // AT LEAST  [N_CHUNKS * MAX_DEGREE]
+    uint8_t *aligned_pq_coord_scratch = nullptr;   // AT LEAST  [N_CHUNKS * MAX_DEGREE], rounded up to full
+                                                   // blocks for transposed codes
     float *rotated_query = nullptr;
     float *aligned_query_float = nullptr;
 
-    PQScratch(size_t graph_degree, size_t aligned_dim);
+    // fast-scan state for 4-bit PQ, see quantize_fast_scan_lut
+    uint8_t *aligned_fast_scan_lut = nullptr;   // [16 * MAX_PQ_CHUNKS]
+    uint8_t *aligned_fast_scan_codes = nullptr; // fast-scan layout of up to MAX_DEGREE points
+    float fast_scan_scale = 1.0f;
+    float fast_scan_bias = 0.0f;
+
+    // RaBitQ state of the query, planes of RABITQ_QUERY_BITS * aligned_dim bits
+    RaBitQQuery rabitq_query;
+
+    // pq_table_len: floats of aligned_pqtable_dist_scratch
+    PQScratch(size_t graph_degree, size_t aligned_dim,
+              size_t pq_table_len = (size_t)NUM_PQ_CENTROIDS * MAX_PQ_CHUNKS);
     void initialize(size_t dim, const T *query, const float norm = 1.0f);
     virtual ~PQScratch();
 };
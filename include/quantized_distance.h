@@ -34,6 +34,10 @@ template <typename data_t> class QuantizedDistance
     // Has to be < ndim
     virtual uint32_t get_num_chunks() const = 0;
 
+    // Number of centers per chunk of the codebook the vectors are (to be)
+    // compressed with.
+    virtual uint32_t get_num_centers() const = 0;
+
     // Preprocess the query by computing chunk distances from the query vector to
     // various centroids. Since we don't want this class to do scratch management,
     // we will take a PQScratch object which can come either from Index class or
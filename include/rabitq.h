@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "windows_customizations.h"
+
+// bits per coordinate of the quantized query
+#define RABITQ_QUERY_BITS 4
+#define RABITQ_TRAINING_SET_SIZE 100000
+// confidence multiplier of the error bound of the estimates
+#define RABITQ_ERROR_EPSILON 1.9f
+
+namespace diskann
+{
+// RaBitQ: 1-bit quantization with an error bound on the estimated distance.
+// Points are centered on the data centroid c and rotated by a random
+// orthogonal matrix R. A point o is stored as the signs of r = R(o - c), one
+// bit per dimension, together with |r| and <r / |r|, x> where x is the unit
+// vector of the signs (x_i = +-1 / sqrt(dim)). The query is rotated the same
+// way, normalized and scalar quantized to RABITQ_QUERY_BITS bits, so that the
+// inner product with a code reduces to popcounts of ANDs over bit planes.
+//
+// The estimate of <r / |r|, q_r / |q_r|> is unbiased, and its error is below
+// RABITQ_ERROR_EPSILON * sqrt((1 - ip^2) / ip^2 / (dim - 1)) with high
+// probability, where ip is the stored inner product. estimate() returns the
+// squared L2 distance and that bound scaled to distance units, so callers can
+// discard a point whose distance minus the bound is already too large, and
+// refine the others with a more precise quantizer.
+//
+// Only the L2 metric is supported.
+
+// Query state filled by RaBitQuantizer::preprocess_query. planes holds
+// RABITQ_QUERY_BITS bit planes of num_words() words each, plane j holding
+// bit j of the query codes u_i, with the normalized query reconstructed as
+// lower + step * u_i.
+struct RaBitQQuery
+{
+    uint64_t *planes = nullptr;
+    float norm = 0;
+    float lower = 0;
+    float step = 0;
+    float code_sum = 0;
+};
+
+class RaBitQuantizer
+{
+  public:
+    RaBitQuantizer() = default;
+
+    // Sets the center to the mean of the training points and draws a random
+    // rotation.
+    void train(const float *train_data, size_t num_train, size_t dim);
+
+    // The pivots file holds dim + 1 rows of dim floats: the center followed
+    // by the rows of R.
+    void save(const std::string &pivots_file) const;
+    void load(const std::string &pivots_file);
+
+    size_t get_dim() const
+    {
+        return _dim;
+    }
+    // 64-bit words of the sign bits of a point
+    size_t num_words() const
+    {
+        return (_dim + 63) / 64;
+    }
+    // bytes per encoded point of dimension dim: the sign bits followed by the
+    // float factors |r|, 1 / ip, the relative error bound and the number of
+    // set bits. A multiple of 8, records are read as 64-bit words.
+    static size_t record_len(size_t dim)
+    {
+        return (dim + 63) / 64 * sizeof(uint64_t) + 4 * sizeof(float);
+    }
+    size_t record_len() const
+    {
+        return record_len(_dim);
+    }
+
+    // Encodes num_pts consecutive points into num_pts records.
+    void encode(const float *vectors, size_t num_pts, uint8_t *records) const;
+
+    // Writes to vector the point reconstructed from the record: the center
+    // plus the rotated signs scaled to the norm of the original.
+    void decode(const uint8_t *record, float *vector) const;
+
+    // distance of the encoded point to the center
+    float get_norm(const uint8_t *record) const;
+
+    // query: dim floats. rotated: scratch of dim floats. query_out.planes
+    // must hold RABITQ_QUERY_BITS * num_words() words.
+    void preprocess_query(const float *query, float *rotated, RaBitQQuery &query_out) const;
+
+    // Estimated squared L2 distance from the query to the record, and in
+    // bound (if not null) its error bound.
+    float estimate(const RaBitQQuery &query, const uint8_t *record, float *bound = nullptr) const;
+
+    // Estimates and bounds for the points ids[0..n) of codes, an array of
+    // records indexed by id.
+    void estimate(const RaBitQQuery &query, const uint8_t *codes, const uint32_t *ids, size_t n, float *dists,
+                  float *bounds) const;
+
+    // Estimated squared L2 distance between two encoded points, from the
+    // Hamming distance of their sign bits.
+    float symmetric_distance(const uint8_t *record1, const uint8_t *record2) const;
+
+  private:
+    void rotate(const float *vector, float *rotated) const;
+
+    size_t _dim = 0;
+    std::unique_ptr<float[]> _center;
+    // row major dim x dim
+    std::unique_ptr<float[]> _rotation;
+};
+
+inline std::string get_rabitq_pivots_filename(const std::string &prefix)
+{
+    return prefix + "_rabitq_pivots.bin";
+}
+
+inline std::string get_rabitq_codes_filename(const std::string &prefix)
+{
+    return prefix + "_rabitq_compressed.bin";
+}
+
+// Trains a quantizer on a sample of p_val of the points of data_file, and
+// writes it to pivots_file and the records of all points to codes_file as a
+// bin of (#points, record_len()) bytes.
+template <typename T>
+DISKANN_DLLEXPORT void generate_rabitq_data(const std::string &data_file, double p_val,
+                                            const std::string &pivots_file, const std::string &codes_file);
+} // namespace diskann
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "abstract_data_store.h"
+#include "distance.h"
+#include "rabitq.h"
+
+namespace diskann
+{
+// In-memory data store holding RaBitQ codes, one bit per dimension plus four
+// floats per vector (see rabitq.h). Query distances are popcount estimates
+// and need the RaBitQ state that preprocess_query leaves in the PQScratch of
+// the query scratch. Distances between two stored vectors are estimated from
+// the Hamming distance of their codes, which is too coarse for pruning
+// quality graphs: use the store with full precision re-ranking, which prunes
+// on the full precision vectors.
+//
+// save() writes the records after a regular bin header of (#points, dim), and
+// the quantizer to get_rabitq_pivots_filename(filename). L2 only.
+template <typename data_t> class RaBitQDataStore : public AbstractDataStore<data_t>
+{
+  public:
+    RaBitQDataStore(const location_t capacity, const size_t dim, std::unique_ptr<Distance<data_t>> distance_fn);
+    RaBitQDataStore(const RaBitQDataStore &) = delete;
+    RaBitQDataStore &operator=(const RaBitQDataStore &) = delete;
+    virtual ~RaBitQDataStore();
+
+    virtual location_t load(const std::string &filename) override;
+    virtual size_t save(const std::string &filename, const location_t num_points) override;
+
+    virtual size_t get_aligned_dim() const override;
+
+    // Train the quantizer on (a sample of) the given vectors and encode them.
+    virtual void populate_data(const data_t *vectors, const location_t num_pts) override;
+    virtual void populate_data(const std::string &filename, const size_t offset) override;
+
+    // Writes the reconstructed vectors.
+    virtual void extract_data_to_bin(const std::string &filename, const location_t num_pts) override;
+
+    // Reconstructs the vector as the center plus the rotated signs scaled to
+    // the norm of the original.
+    virtual void get_vector(const location_t i, data_t *target) const override;
+    virtual void set_vector(const location_t i, const data_t *const vector) override;
+    virtual void prefetch_vector(const location_t loc) override;
+
+    virtual void move_vectors(const location_t old_location_start, const location_t new_location_start,
+                              const location_t num_points) override;
+    virtual void copy_vectors(const location_t from_loc, const location_t to_loc, const location_t num_points) override;
+
+    virtual void preprocess_query(const data_t *query, AbstractScratch<data_t> *query_scratch) const override;
+
+    // Without a scratch the query is quantized on every call.
+    virtual float get_distance(const data_t *query, const location_t loc) const override;
+    virtual float get_distance(const location_t loc1, const location_t loc2) const override;
+
+    virtual void get_distance(const data_t *preprocessed_query, const location_t *locations,
+                              const uint32_t location_count, float *distances,
+                              AbstractScratch<data_t> *scratch) const override;
+    virtual void get_distance(const data_t *preprocessed_query, const std::vector<location_t> &ids,
+                              std::vector<float> &distances, AbstractScratch<data_t> *scratch_space) const override;
+
+    // The vector closest to the center, whose distance is stored in its record.
+    virtual location_t calculate_medoid() const override;
+
+    virtual Distance<data_t> *get_dist_fn() const override;
+
+    virtual size_t get_alignment_factor() const override;
+
+  protected:
+    virtual location_t expand(const location_t new_size) override;
+    virtual location_t shrink(const location_t new_size) override;
+
+  private:
+    // Converts num_pts vectors to floats in block and encodes them.
+    void encode(const data_t *vectors, const size_t num_pts, uint8_t *records, std::vector<float> &block) const;
+    const RaBitQQuery &get_query(AbstractScratch<data_t> *scratch) const;
+
+    RaBitQuantizer _quantizer;
+    size_t _record_len;
+    uint8_t *_codes = nullptr;
+
+    std::unique_ptr<Distance<data_t>> _distance_fn;
+};
+} // namespace diskann
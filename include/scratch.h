@@ -16,6 +16,7 @@
 #include "neighbor.h"
 #include "defaults.h"
 #include "concurrent_queue.h"
+#include "pq_common.h"
 
 namespace diskann
 {
@@ -146,11 +147,27 @@ template <typename T> class SSDQueryScratch : public AbstractScratch<T>
     char *sector_scratch = nullptr; // MUST BE AT LEAST [MAX_N_SECTOR_READS * SECTOR_LEN]
     size_t sector_idx = 0;          // index of next [SECTOR_LEN] scratch to use
 
+    uint32_t *nbr_scratch = nullptr; // MUST BE AT LEAST [MAX_GRAPH_DEGREE], for decoding packed nhoods
+    float *disk_pq_query = nullptr;  // [aligned_dim], query preprocessed for the disk PQ table
+    // new neighbors of a node with their positions in its neighbor list and
+    // their RaBitQ estimates and error bounds, each [MAX_GRAPH_DEGREE]
+    uint32_t *rabitq_ids = nullptr;
+    uint32_t *rabitq_pos = nullptr;
+    float *rabitq_dists = nullptr;
+    float *rabitq_bounds = nullptr;
+    // inline PQ codes of the neighbors kept by RaBitQ, [MAX_GRAPH_DEGREE * MAX_PQ_CHUNKS]
+    uint8_t *rabitq_codes = nullptr;
+
     tsl::robin_set<size_t> visited;
     NeighborPriorityQueue retset;
     std::vector<Neighbor> full_retset;
+    std::vector<uint64_t> rerank_sectors; // sorted sectors read for re-ranking
+    // coords of the cached nodes of a hop and their distances to the query
+    std::vector<const T *> cached_coords;
+    std::vector<float> cached_dists;
 
-    SSDQueryScratch(size_t aligned_dim, size_t visited_reserve);
+    SSDQueryScratch(size_t aligned_dim, size_t visited_reserve,
+                    size_t pq_table_len = (size_t)NUM_PQ_CENTROIDS * MAX_PQ_CHUNKS);
     ~SSDQueryScratch();
 
     void reset();
@@ -162,7 +179,8 @@ template <typename T> class SSDThreadData
     SSDQueryScratch<T> scratch;
     IOContext ctx;
 
-    SSDThreadData(size_t aligned_dim, size_t visited_reserve);
+    SSDThreadData(size_t aligned_dim, size_t visited_reserve,
+                  size_t pq_table_len = (size_t)NUM_PQ_CENTROIDS * MAX_PQ_CHUNKS);
     void clear();
 };
 
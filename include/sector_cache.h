@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tsl/robin_map.h"
+#include "windows_customizations.h"
+
+namespace diskann
+{
+// Fixed-budget cache of disk index entries (the sector(s) read for one node),
+// keyed by their starting sector. Entries are spread over independently
+// locked shards, and each shard evicts with the CLOCK policy: a hit sets the
+// entry's reference bit, and the clock hand clears reference bits until it
+// finds an entry without one to replace.
+//
+// Thread-safety: all methods may be called concurrently. lookup() copies the
+// entry out under the shard lock, so callers never hold pointers into the
+// cache.
+class SectorCache
+{
+  public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+    };
+
+    // entry_len: bytes per entry. The cache holds budget_bytes / entry_len
+    // entries, split evenly over num_shards shards.
+    DISKANN_DLLEXPORT SectorCache(uint64_t budget_bytes, uint64_t entry_len, uint32_t num_shards = 64);
+
+    // copies the entry starting at `sector` into buf and returns true if it
+    // is cached, returns false otherwise
+    DISKANN_DLLEXPORT bool lookup(uint64_t sector, char *buf);
+
+    // caches entry_len bytes of buf as the entry starting at `sector`
+    DISKANN_DLLEXPORT void insert(uint64_t sector, const char *buf);
+
+    DISKANN_DLLEXPORT Stats get_stats();
+    DISKANN_DLLEXPORT void reset_stats();
+
+    uint64_t capacity() const
+    {
+        return _shards.size() * _entries_per_shard;
+    }
+    uint64_t entry_len() const
+    {
+        return _entry_len;
+    }
+
+  private:
+    struct Shard
+    {
+        std::mutex lock;
+        tsl::robin_map<uint64_t, uint32_t> sector_to_slot;
+        std::vector<uint64_t> slot_sector;
+        std::vector<uint8_t> referenced;
+        std::vector<char> data;
+        uint32_t num_used = 0;
+        uint32_t hand = 0;
+        Stats stats;
+    };
+
+    Shard &shard_for(uint64_t sector)
+    {
+        return *_shards[sector % _shards.size()];
+    }
+
+    uint64_t _entry_len;
+    uint32_t _entries_per_shard;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+} // namespace diskann
@@ -9,6 +9,8 @@
 #include <immintrin.h>
 #endif
 
+#include "float16.h"
+
 namespace diskann
 {
 static inline __m256 _mm256_mul_epi8(__m256i X)
@@ -103,4 +105,15 @@ static inline float _mm256_reduce_add_ps(__m256 x)
     /* Conversion to float is a no-op on x86-64 */
     return _mm_cvtss_f32(x32);
 }
+// Widens 8 consecutive 16-bit floats to float.
+static inline __m256 _mm256_loadu_ph_ps(const float16 *p)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)p));
+}
+
+static inline __m256 _mm256_loadu_pbh_ps(const bfloat16 *p)
+{
+    __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+}
 } // namespace diskann
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "abstract_data_store.h"
+#include "distance.h"
+
+namespace diskann
+{
+// In-memory data store holding scalar-quantized vectors. Every dimension j is
+// trained to a range [min_j, min_j + scale_j * (2^bits - 1)] and each
+// coordinate is stored as the nearest code c in [0, 2^bits), reconstructed as
+// min_j + scale_j * c. With 8 bits a vector takes dim bytes, with 4 bits two
+// codes share a byte (even dimension in the low nibble). Distances to a query
+// are asymmetric: the query stays in full precision and only the base vectors
+// are quantized.
+//
+// save() writes the codes after a regular bin header of (#points, dim), and
+// the per-dimension min and scale to <filename>_sq_params.bin.
+template <typename data_t> class SQDataStore : public AbstractDataStore<data_t>
+{
+  public:
+    SQDataStore(const location_t capacity, const size_t dim, const uint32_t num_bits,
+                std::unique_ptr<Distance<data_t>> distance_fn);
+    SQDataStore(const SQDataStore &) = delete;
+    SQDataStore &operator=(const SQDataStore &) = delete;
+    virtual ~SQDataStore();
+
+    virtual location_t load(const std::string &filename) override;
+    virtual size_t save(const std::string &filename, const location_t num_points) override;
+
+    virtual size_t get_aligned_dim() const override;
+
+    // Train the quantizer on the given vectors and quantize them.
+    virtual void populate_data(const data_t *vectors, const location_t num_pts) override;
+    virtual void populate_data(const std::string &filename, const size_t offset) override;
+
+    // Writes the reconstructed vectors.
+    virtual void extract_data_to_bin(const std::string &filename, const location_t num_pts) override;
+
+    virtual void get_vector(const location_t i, data_t *target) const override;
+    // Quantizes vector with the current parameters, clamping coordinates that
+    // fall outside the trained range.
+    virtual void set_vector(const location_t i, const data_t *const vector) override;
+    virtual void prefetch_vector(const location_t loc) override;
+
+    virtual void move_vectors(const location_t old_location_start, const location_t new_location_start,
+                              const location_t num_points) override;
+    virtual void copy_vectors(const location_t from_loc, const location_t to_loc, const location_t num_points) override;
+
+    virtual void preprocess_query(const data_t *query, AbstractScratch<data_t> *query_scratch) const override;
+
+    virtual float get_distance(const data_t *preprocessed_query, const location_t loc) const override;
+    virtual float get_distance(const location_t loc1, const location_t loc2) const override;
+
+    virtual void get_distance(const data_t *preprocessed_query, const location_t *locations,
+                              const uint32_t location_count, float *distances,
+                              AbstractScratch<data_t> *scratch) const override;
+    virtual void get_distance(const data_t *preprocessed_query, const std::vector<location_t> &ids,
+                              std::vector<float> &distances, AbstractScratch<data_t> *scratch_space) const override;
+
+    virtual location_t calculate_medoid() const override;
+
+    // The full precision distance function of the metric, as the callers
+    // expect a Distance<T>.
+    virtual Distance<data_t> *get_dist_fn() const override;
+
+    virtual size_t get_alignment_factor() const override;
+
+    uint32_t get_num_bits() const;
+
+  protected:
+    virtual location_t expand(const location_t new_size) override;
+    virtual location_t shrink(const location_t new_size) override;
+
+  private:
+    // Training keeps the running per-dimension minimum in _min; set_scale
+    // derives _scale once all points have been seen.
+    void extend_range(const data_t *vectors, const size_t num_pts, std::vector<float> &max);
+    void set_scale(const std::vector<float> &max);
+    void quantize(const data_t *vector, uint8_t *code) const;
+    float query_distance(const data_t *query, const uint8_t *code) const;
+
+    uint32_t _num_bits;
+    // bytes per quantized vector
+    size_t _code_len;
+    uint8_t *_codes = nullptr;
+
+    // per-dimension offset and step of the quantizer
+    std::unique_ptr<float[]> _min;
+    std::unique_ptr<float[]> _scale;
+
+    Metric _metric;
+    std::unique_ptr<Distance<data_t>> _distance_fn;
+};
+} // namespace diskann
@@ -1162,6 +1162,14 @@ template <> inline const char *diskann_type_to_name<int8_t>()
 {
     return "int8";
 }
+template <> inline const char *diskann_type_to_name<diskann::float16>()
+{
+    return "float16";
+}
+template <> inline const char *diskann_type_to_name<diskann::bfloat16>()
+{
+    return "bfloat16";
+}
 template <> inline const char *diskann_type_to_name<uint16_t>()
 {
     return "uint16";
@@ -1193,6 +1201,7 @@ template <> inline const char *diskann_type_to_name<int64_t>()
 
 extern bool AvxSupportedCPU;
 extern bool Avx2SupportedCPU;
+extern bool Avx512SupportedCPU;
 
 inline size_t getMemoryUsage()
 {
@@ -1251,3 +1260,4 @@ inline size_t getMemoryUsage()
 
 extern bool AvxSupportedCPU;
 extern bool Avx2SupportedCPU;
+extern bool Avx512SupportedCPU;
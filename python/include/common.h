@@ -4,13 +4,38 @@
 #pragma once
 
 #include <stdint.h>
+#include <string>
 #include <utility>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
 
+#include "float16.h"
+
 namespace py = pybind11;
 
+namespace pybind11
+{
+namespace detail
+{
+// diskann::float16 is layout compatible with numpy's half precision dtype, so
+// py::array_t<diskann::float16> maps to np.float16 arrays.
+template <> struct npy_format_descriptor<diskann::float16>
+{
+    static constexpr auto name = const_name("numpy.float16");
+    static pybind11::dtype dtype()
+    {
+        constexpr int NPY_HALF = 23;
+        return reinterpret_borrow<pybind11::dtype>(npy_api::get().PyArray_DescrFromType_(NPY_HALF));
+    }
+    static std::string format()
+    {
+        return "e";
+    }
+};
+} // namespace detail
+} // namespace pybind11
+
 namespace diskannpy
 {
 
@@ -13,6 +13,7 @@
 #include "windows_aligned_file_reader.h"
 #else
 #include "linux_aligned_file_reader.h"
+#include "io_uring_aligned_file_reader.h"
 #endif
 
 #include "common.h"
@@ -25,6 +26,8 @@ namespace diskannpy
 
 #ifdef _WINDOWS
 typedef WindowsAlignedFileReader PlatformSpecificAlignedFileReader;
+#elif defined(USE_IO_URING)
+typedef IoUringAlignedFileReader PlatformSpecificAlignedFileReader;
 #else
 typedef LinuxAlignedFileReader PlatformSpecificAlignedFileReader;
 #endif
@@ -49,8 +49,8 @@ from numpy import typing as npt
 
 DistanceMetric = Literal["l2", "mips", "cosine"]
 """ Type alias for one of {"l2", "mips", "cosine"} """
-VectorDType = Union[Type[np.float32], Type[np.int8], Type[np.uint8]]
-""" Type alias for one of {`numpy.float32`, `numpy.int8`, `numpy.uint8`} """
+VectorDType = Union[Type[np.float32], Type[np.float16], Type[np.int8], Type[np.uint8]]
+""" Type alias for one of {`numpy.float32`, `numpy.float16`, `numpy.int8`, `numpy.uint8`} """
 VectorLike = npt.NDArray[VectorDType]
 """ Type alias for something that can be treated as a vector """
 VectorLikeBatch = npt.NDArray[VectorDType]
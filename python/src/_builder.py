@@ -72,11 +72,11 @@ def build_disk_index(
     or error.
 
     ## Distance Metric and Vector Datatype Restrictions
-    | Metric \ Datatype | np.float32 | np.uint8 | np.int8 |
-    |-------------------|------------|----------|---------|
-    | L2                |      ✅     |     ✅    |    ✅    |
-    | MIPS              |      ✅     |     ❌    |    ❌    |
-    | Cosine [^bug-in-disk-cosine]     |      ❌     |     ❌    |    ❌    |
+    | Metric \ Datatype | np.float32 | np.float16 | np.uint8 | np.int8 |
+    |-------------------|------------|------------|----------|---------|
+    | L2                |      ✅     |      ✅     |     ✅    |    ✅    |
+    | MIPS              |      ✅     |      ❌     |     ❌    |    ❌    |
+    | Cosine [^bug-in-disk-cosine]     |      ❌     |      ❌     |     ❌    |    ❌    |
 
     [^bug-in-disk-cosine]: For StaticDiskIndex, Cosine distances are not currently supported.
 
@@ -133,7 +133,7 @@ def build_disk_index(
     if dap_metric == _native_dap.INNER_PRODUCT:
         _assert(
             vector_dtype_actual == np.float32,
-            "Integral vector dtypes (np.uint8, np.int8) are not supported with distance metric mips"
+            "Only np.float32 vectors are supported with distance metric mips in a disk index"
         )
 
     num_points, dimensions = vectors_metadata_from_file(vector_bin_path)
@@ -142,6 +142,8 @@ def build_disk_index(
         _builder = _native_dap.build_disk_uint8_index
     elif vector_dtype_actual == np.int8:
         _builder = _native_dap.build_disk_int8_index
+    elif vector_dtype_actual == np.float16:
+        _builder = _native_dap.build_disk_float16_index
     else:
         _builder = _native_dap.build_disk_float_index
 
@@ -196,18 +198,18 @@ def build_memory_index(
 
     ## Distance Metric and Vector Datatype Restrictions
 
-    | Metric \ Datatype | np.float32 | np.uint8 | np.int8 |
-    |-------------------|------------|----------|---------|
-    | L2                |      ✅     |     ✅    |    ✅    |
-    | MIPS              |      ✅     |     ❌    |    ❌    |
-    | Cosine            |      ✅     |     ✅    |    ✅    |
+    | Metric \ Datatype | np.float32 | np.float16 | np.uint8 | np.int8 |
+    |-------------------|------------|------------|----------|---------|
+    | L2                |      ✅     |      ✅     |     ✅    |    ✅    |
+    | MIPS              |      ✅     |      ✅     |     ❌    |    ❌    |
+    | Cosine            |      ✅     |      ✅     |     ✅    |    ✅    |
 
     ### Parameters
 
     - **data**: Either a `str` representing a path to an existing DiskANN vector bin file, or a numpy.ndarray of a
       supported dtype in 2 dimensions. Note that `vector_dtype` must be provided if `data` is a `str`.
-    - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 3
-      vector dtypes, but `mips` is only available for single precision floats.
+    - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 4
+      vector dtypes, but `mips` is only available for floating point vectors.
     - **index_directory**: The index files will be saved to this **existing** directory path
     - **complexity**: The size of the candidate nearest neighbor list to use when building the index. Values between 75
       and 200 are typical. Larger values will take more time to build but result in indices that provide higher recall
@@ -274,7 +276,7 @@ def build_memory_index(
     )
     if dap_metric == _native_dap.INNER_PRODUCT:
         _assert(
-            vector_dtype_actual == np.float32,
+            vector_dtype_actual in (np.float32, np.float16),
             "Integral vector dtypes (np.uint8, np.int8) are not supported with distance metric mips"
         )
 
@@ -289,6 +291,8 @@ def build_memory_index(
         _builder = _native_dap.build_memory_uint8_index
     elif vector_dtype_actual == np.int8:
         _builder = _native_dap.build_memory_int8_index
+    elif vector_dtype_actual == np.float16:
+        _builder = _native_dap.build_memory_float16_index
     else:
         _builder = _native_dap.build_memory_float_index
 
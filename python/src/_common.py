@@ -20,7 +20,7 @@ from . import _diskannpy as _native_dap
 
 __ALL__ = ["valid_dtype"]
 
-_VALID_DTYPES = [np.float32, np.int8, np.uint8]
+_VALID_DTYPES = [np.float32, np.float16, np.int8, np.uint8]
 
 
 def valid_dtype(dtype: Type) -> VectorDType:
@@ -35,6 +35,8 @@ def valid_dtype(dtype: Type) -> VectorDType:
         return np.int8
     if dtype == np.float32:
         return np.float32
+    if dtype == np.float16:
+        return np.float16
 
 
 def _assert(statement_eval: bool, message: str):
@@ -58,7 +60,8 @@ def _valid_metric(metric: str) -> _native_dap.Metric:
 def _assert_dtype(dtype: Type):
     _assert(
         any(np.can_cast(dtype, _dtype) for _dtype in _VALID_DTYPES),
-        f"Vector dtype must be of one of type {{(np.single, np.float32), (np.byte, np.int8), (np.ubyte, np.uint8)}}",
+        f"Vector dtype must be of one of type {{(np.single, np.float32), (np.half, np.float16), (np.byte, np.int8), "
+        f"(np.ubyte, np.uint8)}}",
     )
 
 
@@ -117,6 +120,7 @@ class _DataType(Enum):
     FLOAT32 = 0
     INT8 = 1
     UINT8 = 2
+    FLOAT16 = 3
 
     @classmethod
     def from_type(cls, vector_dtype: VectorDType) -> "DataType":
@@ -126,6 +130,8 @@ class _DataType(Enum):
             return cls.INT8
         if vector_dtype == np.uint8:
             return cls.UINT8
+        if vector_dtype == np.float16:
+            return cls.FLOAT16
 
     def to_type(self) -> VectorDType:
         if self is _DataType.FLOAT32:
@@ -134,6 +140,8 @@ class _DataType(Enum):
             return np.int8
         if self is _DataType.UINT8:
             return np.uint8
+        if self is _DataType.FLOAT16:
+            return np.float16
 
 
 class _Metric(Enum):
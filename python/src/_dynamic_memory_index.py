@@ -120,8 +120,8 @@ class DynamicMemoryIndex:
         - **concurrent_consolidation**: This flag dictates whether consolidation can be run alongside inserts and
           deletes, or whether the index is locked down to changes while consolidation is ongoing.
         - **index_prefix**: The prefix of the index files. Defaults to "ann".
-        - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 3
-          vector dtypes, but `mips` is only available for single precision floats. Default is `None`. **This
+        - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 4
+          vector dtypes, but `mips` is only available for floating point vectors. Default is `None`. **This
           value is only used if a `{index_prefix}_metadata.bin` file does not exist.** If it does not exist,
           you are required to provide it.
         - **vector_dtype**: The vector dtype this index has been built with. **This value is only used if a
@@ -193,10 +193,10 @@ class DynamicMemoryIndex:
         please use the `diskannpy.DynamicMemoryIndex.from_file` classmethod instead.
 
         ### Parameters
-        - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 3
-          vector dtypes, but `mips` is only available for single precision floats.
-        - **vector_dtype**: One of {`np.float32`, `np.int8`, `np.uint8`}. The dtype of the vectors this index will
-          be storing.
+        - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 4
+          vector dtypes, but `mips` is only available for floating point vectors.
+        - **vector_dtype**: One of {`np.float32`, `np.float16`, `np.int8`, `np.uint8`}. The dtype of the vectors this
+          index will be storing.
         - **dimensions**: The vector dimensionality of this index. All new vectors inserted must be the same
           dimensionality.
         - **max_vectors**: Capacity of the data store including space for future insertions
@@ -260,6 +260,8 @@ class DynamicMemoryIndex:
             _index = _native_dap.DynamicMemoryUInt8Index
         elif vector_dtype == np.int8:
             _index = _native_dap.DynamicMemoryInt8Index
+        elif vector_dtype == np.float16:
+            _index = _native_dap.DynamicMemoryFloat16Index
         else:
             _index = _native_dap.DynamicMemoryFloatIndex
 
@@ -97,6 +97,8 @@ class StaticDiskIndex:
             _index = _native_dap.StaticDiskUInt8Index
         elif vector_dtype == np.int8:
             _index = _native_dap.StaticDiskInt8Index
+        elif vector_dtype == np.float16:
+            _index = _native_dap.StaticDiskFloat16Index
         else:
             _index = _native_dap.StaticDiskFloatIndex
         self._index = _index(
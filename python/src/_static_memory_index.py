@@ -66,8 +66,8 @@ class StaticMemoryIndex:
           `initial_search_complexity` * `search_threads`. Note that it may be resized if a `search` or `batch_search`
           operation requests a space larger than can be accommodated by these values.
         - **index_prefix**: The prefix of the index files. Defaults to "ann".
-        - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 3
-          vector dtypes, but `mips` is only available for single precision floats. Default is `None`. **This
+        - **distance_metric**: A `str`, strictly one of {"l2", "mips", "cosine"}. `l2` and `cosine` are supported for all 4
+          vector dtypes, but `mips` is only available for floating point vectors. Default is `None`. **This
           value is only used if a `{index_prefix}_metadata.bin` file does not exist.** If it does not exist,
           you are required to provide it.
         - **vector_dtype**: The vector dtype this index has been built with. **This value is only used if a
@@ -112,6 +112,8 @@ class StaticMemoryIndex:
             _index = _native_dap.StaticMemoryUInt8Index
         elif vector_dtype == np.int8:
             _index = _native_dap.StaticMemoryInt8Index
+        elif vector_dtype == np.float16:
+            _index = _native_dap.StaticMemoryFloat16Index
         else:
             _index = _native_dap.StaticMemoryFloatIndex
 
@@ -30,6 +30,8 @@ template void build_disk_index<uint8_t>(diskann::Metric, const std::string &, co
                                         double, double, uint32_t, uint32_t);
 template void build_disk_index<int8_t>(diskann::Metric, const std::string &, const std::string &, uint32_t, uint32_t,
                                        double, double, uint32_t, uint32_t);
+template void build_disk_index<diskann::float16>(diskann::Metric, const std::string &, const std::string &, uint32_t,
+                                                 uint32_t, double, double, uint32_t, uint32_t);
 
 template <typename T, typename TagT, typename LabelT>
 std::string prepare_filtered_label_map(diskann::Index<T, TagT, LabelT> &index, const std::string &index_output_path,
@@ -55,6 +57,10 @@ template std::string prepare_filtered_label_map<int8_t>(diskann::Index<int8_t, u
 template std::string prepare_filtered_label_map<uint8_t>(diskann::Index<uint8_t, uint32_t, uint32_t> &,
                                                          const std::string &, const std::string &, const std::string &);
 
+template std::string prepare_filtered_label_map<diskann::float16>(
+    diskann::Index<diskann::float16, uint32_t, uint32_t> &, const std::string &, const std::string &,
+    const std::string &);
+
 template <typename T, typename TagT, typename LabelT>
 void build_memory_index(const diskann::Metric metric, const std::string &vector_bin_path,
                         const std::string &index_output_path, const uint32_t graph_degree, const uint32_t complexity,
@@ -130,4 +136,8 @@ template void build_memory_index<uint8_t>(diskann::Metric, const std::string &,
                                           float, uint32_t, bool, size_t, bool, bool, const std::string &,
                                           const std::string &, uint32_t);
 
+template void build_memory_index<diskann::float16>(diskann::Metric, const std::string &, const std::string &, uint32_t,
+                                                   uint32_t, float, uint32_t, bool, size_t, bool, bool,
+                                                   const std::string &, const std::string &, uint32_t);
+
 } // namespace diskannpy
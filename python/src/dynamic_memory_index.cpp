@@ -163,5 +163,6 @@ template <class DT> size_t DynamicMemoryIndex<DT>::num_points()
 template class DynamicMemoryIndex<float>;
 template class DynamicMemoryIndex<uint8_t>;
 template class DynamicMemoryIndex<int8_t>;
+template class DynamicMemoryIndex<diskann::float16>;
 
 }; // namespace diskannpy
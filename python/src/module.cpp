@@ -18,6 +18,7 @@ PYBIND11_MAKE_OPAQUE(std::vector<uint32_t>);
 PYBIND11_MAKE_OPAQUE(std::vector<float>);
 PYBIND11_MAKE_OPAQUE(std::vector<int8_t>);
 PYBIND11_MAKE_OPAQUE(std::vector<uint8_t>);
+PYBIND11_MAKE_OPAQUE(std::vector<diskann::float16>);
 
 namespace py = pybind11;
 using namespace pybind11::literals;
@@ -40,6 +41,9 @@ const Variant UInt8Variant{"build_disk_uint8_index", "build_memory_uint8_index",
 const Variant Int8Variant{"build_disk_int8_index", "build_memory_int8_index", "DynamicMemoryInt8Index",
                           "StaticMemoryInt8Index", "StaticDiskInt8Index"};
 
+const Variant Float16Variant{"build_disk_float16_index", "build_memory_float16_index", "DynamicMemoryFloat16Index",
+                             "StaticMemoryFloat16Index", "StaticDiskFloat16Index"};
+
 template <typename T> inline void add_variant(py::module_ &m, const Variant &variant)
 {
     m.def(variant.disk_builder_name.c_str(), &diskannpy::build_disk_index<T>, "distance_metric"_a, "data_file_path"_a,
@@ -128,6 +132,7 @@ PYBIND11_MODULE(_diskannpy, m)
     add_variant<float>(m, FloatVariant);
     add_variant<uint8_t>(m, UInt8Variant);
     add_variant<int8_t>(m, Int8Variant);
+    add_variant<diskann::float16>(m, Float16Variant);
 
     py::enum_<diskann::Metric>(m, "Metric")
         .value("L2", diskann::Metric::L2)
@@ -106,4 +106,5 @@ NeighborsAndDistances<StaticIdType> StaticDiskIndex<DT>::batch_search(
 template class StaticDiskIndex<float>;
 template class StaticDiskIndex<uint8_t>;
 template class StaticDiskIndex<int8_t>;
+template class StaticDiskIndex<diskann::float16>;
 } // namespace diskannpy
\ No newline at end of file
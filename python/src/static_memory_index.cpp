@@ -87,5 +87,6 @@ NeighborsAndDistances<StaticIdType> StaticMemoryIndex<DT>::batch_search(
 template class StaticMemoryIndex<float>;
 template class StaticMemoryIndex<uint8_t>;
 template class StaticMemoryIndex<int8_t>;
+template class StaticMemoryIndex<diskann::float16>;
 
 } // namespace diskannpy
\ No newline at end of file
@@ -111,6 +111,12 @@ template DISKANN_DLLEXPORT void AbstractIndex::build<float, int32_t>(const float
 template DISKANN_DLLEXPORT void AbstractIndex::build<int8_t, int32_t>(const int8_t *data,
                                                                       const size_t num_points_to_load,
                                                                       const std::vector<int32_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<float16, int32_t>(const float16 *data,
+                                                                       const size_t num_points_to_load,
+                                                                       const std::vector<int32_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<bfloat16, int32_t>(const bfloat16 *data,
+                                                                        const size_t num_points_to_load,
+                                                                        const std::vector<int32_t> &tags);
 template DISKANN_DLLEXPORT void AbstractIndex::build<uint8_t, int32_t>(const uint8_t *data,
                                                                        const size_t num_points_to_load,
                                                                        const std::vector<int32_t> &tags);
@@ -120,6 +126,12 @@ template DISKANN_DLLEXPORT void AbstractIndex::build<float, uint32_t>(const floa
 template DISKANN_DLLEXPORT void AbstractIndex::build<int8_t, uint32_t>(const int8_t *data,
                                                                        const size_t num_points_to_load,
                                                                        const std::vector<uint32_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<float16, uint32_t>(const float16 *data,
+                                                                        const size_t num_points_to_load,
+                                                                        const std::vector<uint32_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<bfloat16, uint32_t>(const bfloat16 *data,
+                                                                         const size_t num_points_to_load,
+                                                                         const std::vector<uint32_t> &tags);
 template DISKANN_DLLEXPORT void AbstractIndex::build<uint8_t, uint32_t>(const uint8_t *data,
                                                                         const size_t num_points_to_load,
                                                                         const std::vector<uint32_t> &tags);
@@ -128,6 +140,12 @@ template DISKANN_DLLEXPORT void AbstractIndex::build<float, int64_t>(const float
 template DISKANN_DLLEXPORT void AbstractIndex::build<int8_t, int64_t>(const int8_t *data,
                                                                       const size_t num_points_to_load,
                                                                       const std::vector<int64_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<float16, int64_t>(const float16 *data,
+                                                                       const size_t num_points_to_load,
+                                                                       const std::vector<int64_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<bfloat16, int64_t>(const bfloat16 *data,
+                                                                        const size_t num_points_to_load,
+                                                                        const std::vector<int64_t> &tags);
 template DISKANN_DLLEXPORT void AbstractIndex::build<uint8_t, int64_t>(const uint8_t *data,
                                                                        const size_t num_points_to_load,
                                                                        const std::vector<int64_t> &tags);
@@ -137,6 +155,12 @@ template DISKANN_DLLEXPORT void AbstractIndex::build<float, uint64_t>(const floa
 template DISKANN_DLLEXPORT void AbstractIndex::build<int8_t, uint64_t>(const int8_t *data,
                                                                        const size_t num_points_to_load,
                                                                        const std::vector<uint64_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<float16, uint64_t>(const float16 *data,
+                                                                        const size_t num_points_to_load,
+                                                                        const std::vector<uint64_t> &tags);
+template DISKANN_DLLEXPORT void AbstractIndex::build<bfloat16, uint64_t>(const bfloat16 *data,
+                                                                         const size_t num_points_to_load,
+                                                                         const std::vector<uint64_t> &tags);
 template DISKANN_DLLEXPORT void AbstractIndex::build<uint8_t, uint64_t>(const uint8_t *data,
                                                                         const size_t num_points_to_load,
                                                                         const std::vector<uint64_t> &tags);
@@ -147,6 +171,10 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<u
     const uint8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<int8_t, uint32_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<float16, uint32_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<bfloat16, uint32_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<float, uint64_t>(
     const float *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
@@ -154,6 +182,10 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<u
     const uint8_t *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<int8_t, uint64_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<float16, uint64_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search<bfloat16, uint64_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
 
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> AbstractIndex::search_with_filters<uint32_t>(
     const DataType &query, const std::string &raw_label, const size_t K, const uint32_t L, uint32_t *indices,
@@ -174,6 +206,12 @@ template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<uint8_t, int32
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<int8_t, int32_t>(
     const int8_t *query, const uint64_t K, const uint32_t L, int32_t *tags, float *distances,
     std::vector<int8_t *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float16, int32_t>(
+    const float16 *query, const uint64_t K, const uint32_t L, int32_t *tags, float *distances,
+    std::vector<float16 *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<bfloat16, int32_t>(
+    const bfloat16 *query, const uint64_t K, const uint32_t L, int32_t *tags, float *distances,
+    std::vector<bfloat16 *> &res_vectors, bool use_filters, const std::string filter_label);
 
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float, uint32_t>(
     const float *query, const uint64_t K, const uint32_t L, uint32_t *tags, float *distances,
@@ -186,6 +224,12 @@ template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<uint8_t, uint3
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<int8_t, uint32_t>(
     const int8_t *query, const uint64_t K, const uint32_t L, uint32_t *tags, float *distances,
     std::vector<int8_t *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float16, uint32_t>(
+    const float16 *query, const uint64_t K, const uint32_t L, uint32_t *tags, float *distances,
+    std::vector<float16 *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<bfloat16, uint32_t>(
+    const bfloat16 *query, const uint64_t K, const uint32_t L, uint32_t *tags, float *distances,
+    std::vector<bfloat16 *> &res_vectors, bool use_filters, const std::string filter_label);
 
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float, int64_t>(
     const float *query, const uint64_t K, const uint32_t L, int64_t *tags, float *distances,
@@ -198,6 +242,12 @@ template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<uint8_t, int64
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<int8_t, int64_t>(
     const int8_t *query, const uint64_t K, const uint32_t L, int64_t *tags, float *distances,
     std::vector<int8_t *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float16, int64_t>(
+    const float16 *query, const uint64_t K, const uint32_t L, int64_t *tags, float *distances,
+    std::vector<float16 *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<bfloat16, int64_t>(
+    const bfloat16 *query, const uint64_t K, const uint32_t L, int64_t *tags, float *distances,
+    std::vector<bfloat16 *> &res_vectors, bool use_filters, const std::string filter_label);
 
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float, uint64_t>(
     const float *query, const uint64_t K, const uint32_t L, uint64_t *tags, float *distances,
@@ -210,6 +260,12 @@ template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<uint8_t, uint6
 template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<int8_t, uint64_t>(
     const int8_t *query, const uint64_t K, const uint32_t L, uint64_t *tags, float *distances,
     std::vector<int8_t *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<float16, uint64_t>(
+    const float16 *query, const uint64_t K, const uint32_t L, uint64_t *tags, float *distances,
+    std::vector<float16 *> &res_vectors, bool use_filters, const std::string filter_label);
+template DISKANN_DLLEXPORT size_t AbstractIndex::search_with_tags<bfloat16, uint64_t>(
+    const bfloat16 *query, const uint64_t K, const uint32_t L, uint64_t *tags, float *distances,
+    std::vector<bfloat16 *> &res_vectors, bool use_filters, const std::string filter_label);
 
 template DISKANN_DLLEXPORT void AbstractIndex::search_with_optimized_layout<float>(const float *query, size_t K,
                                                                                    size_t L, uint32_t *indices);
@@ -217,22 +273,36 @@ template DISKANN_DLLEXPORT void AbstractIndex::search_with_optimized_layout<uint
                                                                                      size_t L, uint32_t *indices);
 template DISKANN_DLLEXPORT void AbstractIndex::search_with_optimized_layout<int8_t>(const int8_t *query, size_t K,
                                                                                     size_t L, uint32_t *indices);
+template DISKANN_DLLEXPORT void AbstractIndex::search_with_optimized_layout<float16>(
+    const float16 *query, size_t K, size_t L, uint32_t *indices);
+template DISKANN_DLLEXPORT void AbstractIndex::search_with_optimized_layout<bfloat16>(
+    const bfloat16 *query, size_t K, size_t L, uint32_t *indices);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, int32_t>(const float *point, const int32_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, int32_t>(const uint8_t *point, const int32_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, int32_t>(const int8_t *point, const int32_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, int32_t>(const float16 *point, const int32_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, int32_t>(const bfloat16 *point, const int32_t tag);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, uint32_t>(const float *point, const uint32_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, uint32_t>(const uint8_t *point, const uint32_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, uint32_t>(const int8_t *point, const uint32_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, uint32_t>(const float16 *point, const uint32_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, uint32_t>(const bfloat16 *point,
+                                                                               const uint32_t tag);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, int64_t>(const float *point, const int64_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, int64_t>(const uint8_t *point, const int64_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, int64_t>(const int8_t *point, const int64_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, int64_t>(const float16 *point, const int64_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, int64_t>(const bfloat16 *point, const int64_t tag);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, uint64_t>(const float *point, const uint64_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, uint64_t>(const uint8_t *point, const uint64_t tag);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, uint64_t>(const int8_t *point, const uint64_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, uint64_t>(const float16 *point, const uint64_t tag);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, uint64_t>(const bfloat16 *point,
+                                                                               const uint64_t tag);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, int32_t, uint16_t>(
     const float *point, const int32_t tag, const std::vector<uint16_t> &labels);
@@ -240,6 +310,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, int32_t, uin
     const uint8_t *point, const int32_t tag, const std::vector<uint16_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, int32_t, uint16_t>(
     const int8_t *point, const int32_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, int32_t, uint16_t>(
+    const float16 *point, const int32_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, int32_t, uint16_t>(
+    const bfloat16 *point, const int32_t tag, const std::vector<uint16_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, uint32_t, uint16_t>(
     const float *point, const uint32_t tag, const std::vector<uint16_t> &labels);
@@ -247,6 +321,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, uint32_t, ui
     const uint8_t *point, const uint32_t tag, const std::vector<uint16_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, uint32_t, uint16_t>(
     const int8_t *point, const uint32_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, uint32_t, uint16_t>(
+    const float16 *point, const uint32_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, uint32_t, uint16_t>(
+    const bfloat16 *point, const uint32_t tag, const std::vector<uint16_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, int64_t, uint16_t>(
     const float *point, const int64_t tag, const std::vector<uint16_t> &labels);
@@ -254,6 +332,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, int64_t, uin
     const uint8_t *point, const int64_t tag, const std::vector<uint16_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, int64_t, uint16_t>(
     const int8_t *point, const int64_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, int64_t, uint16_t>(
+    const float16 *point, const int64_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, int64_t, uint16_t>(
+    const bfloat16 *point, const int64_t tag, const std::vector<uint16_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, uint64_t, uint16_t>(
     const float *point, const uint64_t tag, const std::vector<uint16_t> &labels);
@@ -261,6 +343,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, uint64_t, ui
     const uint8_t *point, const uint64_t tag, const std::vector<uint16_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, uint64_t, uint16_t>(
     const int8_t *point, const uint64_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, uint64_t, uint16_t>(
+    const float16 *point, const uint64_t tag, const std::vector<uint16_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, uint64_t, uint16_t>(
+    const bfloat16 *point, const uint64_t tag, const std::vector<uint16_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, int32_t, uint32_t>(
     const float *point, const int32_t tag, const std::vector<uint32_t> &labels);
@@ -268,6 +354,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, int32_t, uin
     const uint8_t *point, const int32_t tag, const std::vector<uint32_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, int32_t, uint32_t>(
     const int8_t *point, const int32_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, int32_t, uint32_t>(
+    const float16 *point, const int32_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, int32_t, uint32_t>(
+    const bfloat16 *point, const int32_t tag, const std::vector<uint32_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, uint32_t, uint32_t>(
     const float *point, const uint32_t tag, const std::vector<uint32_t> &labels);
@@ -275,6 +365,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, uint32_t, ui
     const uint8_t *point, const uint32_t tag, const std::vector<uint32_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, uint32_t, uint32_t>(
     const int8_t *point, const uint32_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, uint32_t, uint32_t>(
+    const float16 *point, const uint32_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, uint32_t, uint32_t>(
+    const bfloat16 *point, const uint32_t tag, const std::vector<uint32_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, int64_t, uint32_t>(
     const float *point, const int64_t tag, const std::vector<uint32_t> &labels);
@@ -282,6 +376,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, int64_t, uin
     const uint8_t *point, const int64_t tag, const std::vector<uint32_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, int64_t, uint32_t>(
     const int8_t *point, const int64_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, int64_t, uint32_t>(
+    const float16 *point, const int64_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, int64_t, uint32_t>(
+    const bfloat16 *point, const int64_t tag, const std::vector<uint32_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float, uint64_t, uint32_t>(
     const float *point, const uint64_t tag, const std::vector<uint32_t> &labels);
@@ -289,6 +387,10 @@ template DISKANN_DLLEXPORT int AbstractIndex::insert_point<uint8_t, uint64_t, ui
     const uint8_t *point, const uint64_t tag, const std::vector<uint32_t> &labels);
 template DISKANN_DLLEXPORT int AbstractIndex::insert_point<int8_t, uint64_t, uint32_t>(
     const int8_t *point, const uint64_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<float16, uint64_t, uint32_t>(
+    const float16 *point, const uint64_t tag, const std::vector<uint32_t> &labels);
+template DISKANN_DLLEXPORT int AbstractIndex::insert_point<bfloat16, uint64_t, uint32_t>(
+    const bfloat16 *point, const uint64_t tag, const std::vector<uint32_t> &labels);
 
 template DISKANN_DLLEXPORT int AbstractIndex::lazy_delete<int32_t>(const int32_t &tag);
 template DISKANN_DLLEXPORT int AbstractIndex::lazy_delete<uint32_t>(const uint32_t &tag);
@@ -313,20 +415,32 @@ template DISKANN_DLLEXPORT void AbstractIndex::set_start_points_at_random<float>
 template DISKANN_DLLEXPORT void AbstractIndex::set_start_points_at_random<uint8_t>(uint8_t radius,
                                                                                    uint32_t random_seed);
 template DISKANN_DLLEXPORT void AbstractIndex::set_start_points_at_random<int8_t>(int8_t radius, uint32_t random_seed);
+template DISKANN_DLLEXPORT void AbstractIndex::set_start_points_at_random<float16>(
+    float16 radius, uint32_t random_seed);
+template DISKANN_DLLEXPORT void AbstractIndex::set_start_points_at_random<bfloat16>(
+    bfloat16 radius, uint32_t random_seed);
 
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int32_t, float>(int32_t &tag, float *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int32_t, uint8_t>(int32_t &tag, uint8_t *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int32_t, int8_t>(int32_t &tag, int8_t *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int32_t, float16>(int32_t &tag, float16 *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int32_t, bfloat16>(int32_t &tag, bfloat16 *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint32_t, float>(uint32_t &tag, float *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint32_t, uint8_t>(uint32_t &tag, uint8_t *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint32_t, int8_t>(uint32_t &tag, int8_t *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint32_t, float16>(uint32_t &tag, float16 *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint32_t, bfloat16>(uint32_t &tag, bfloat16 *vec);
 
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int64_t, float>(int64_t &tag, float *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int64_t, uint8_t>(int64_t &tag, uint8_t *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int64_t, int8_t>(int64_t &tag, int8_t *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int64_t, float16>(int64_t &tag, float16 *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<int64_t, bfloat16>(int64_t &tag, bfloat16 *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint64_t, float>(uint64_t &tag, float *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint64_t, uint8_t>(uint64_t &tag, uint8_t *vec);
 template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint64_t, int8_t>(uint64_t &tag, int8_t *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint64_t, float16>(uint64_t &tag, float16 *vec);
+template DISKANN_DLLEXPORT int AbstractIndex::get_vector_by_tag<uint64_t, bfloat16>(uint64_t &tag, bfloat16 *vec);
 
 template DISKANN_DLLEXPORT void AbstractIndex::set_universal_label<uint16_t>(const uint16_t label);
 template DISKANN_DLLEXPORT void AbstractIndex::set_universal_label<uint32_t>(const uint32_t label);
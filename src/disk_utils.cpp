@@ -11,6 +11,8 @@
 #include "disk_utils.h"
 #include "cached_io.h"
 #include "index.h"
+#include "memory_mapper.h"
+#include "nhood_codec.h"
 #include "mkl.h"
 #include "omp.h"
 #include "percentile_stats.h"
@@ -868,9 +870,96 @@ uint32_t optimize_beamwidth(std::unique_ptr<diskann::PQFlashIndex<T, LabelT>> &p
     return best_bw;
 }
 
+// vamana index file: uint64_t file size, uint32_t width, uint32_t medoid,
+// uint64_t #frozen points, then per node its #nbrs followed by the nbrs
+#define VAMANA_HEADER_SIZE (2 * sizeof(uint64_t) + 2 * sizeof(uint32_t))
+
+// byte offsets of the first npts adjacency lists in a vamana index file
+static void get_nhood_offsets(const char *graph_buf, uint64_t graph_size, uint64_t npts,
+                              std::vector<uint64_t> &offsets)
+{
+    offsets.resize(npts);
+    uint64_t offset = VAMANA_HEADER_SIZE;
+    for (uint64_t i = 0; i < npts; i++)
+    {
+        if (offset + sizeof(uint32_t) > graph_size)
+            throw ANNException("Vamana index file has fewer nodes than the base file", -1, __FUNCSIG__, __FILE__,
+                               __LINE__);
+        offsets[i] = offset;
+        uint32_t nnbrs = *(const uint32_t *)(graph_buf + offset);
+        offset += (1 + (uint64_t)nnbrs) * sizeof(uint32_t);
+    }
+}
+
+void compute_bfs_layout_order(const std::string &mem_index_file, uint64_t npts, std::vector<uint32_t> &new_to_old)
+{
+    MemoryMapper graph(mem_index_file);
+    const char *graph_buf = graph.getBuf();
+    if (graph_buf == nullptr)
+        throw ANNException("Could not map vamana index file " + mem_index_file, -1, __FUNCSIG__, __FILE__, __LINE__);
+    uint32_t medoid = *(uint32_t *)(graph_buf + sizeof(uint64_t) + sizeof(uint32_t));
+
+    std::vector<uint64_t> offsets;
+    get_nhood_offsets(graph_buf, graph.getFileSize(), npts, offsets);
+
+    new_to_old.clear();
+    new_to_old.reserve(npts);
+    std::vector<bool> visited(npts, false);
+    uint64_t next_unvisited = 0;
+    uint32_t start = medoid < npts ? medoid : 0;
+    while (true)
+    {
+        // new_to_old doubles as the BFS queue
+        uint64_t head = new_to_old.size();
+        visited[start] = true;
+        new_to_old.push_back(start);
+        while (head < new_to_old.size())
+        {
+            const uint32_t *nhood = (const uint32_t *)(graph_buf + offsets[new_to_old[head++]]);
+            for (uint32_t j = 1; j <= nhood[0]; j++)
+            {
+                uint32_t nbr = nhood[j];
+                if (nbr < npts && !visited[nbr])
+                {
+                    visited[nbr] = true;
+                    new_to_old.push_back(nbr);
+                }
+            }
+        }
+
+        while (next_unvisited < npts && visited[next_unvisited])
+            next_unvisited++;
+        if (next_unvisited == npts)
+            break;
+        start = (uint32_t)next_unvisited;
+    }
+    diskann::cout << "Computed BFS layout order of " << npts << " nodes from medoid " << medoid << std::endl;
+}
+
+// rewrites the rows of a bin file in the order given by new_to_old
+template <typename T> void permute_bin_rows(const std::string &bin_file, const std::vector<uint32_t> &new_to_old)
+{
+    T *data = nullptr;
+    size_t npts, ndims;
+    diskann::load_bin<T>(bin_file, data, npts, ndims);
+    if (npts != new_to_old.size())
+    {
+        delete[] data;
+        throw ANNException("Mismatch in num_points between " + bin_file + " and the id map", -1, __FUNCSIG__,
+                           __FILE__, __LINE__);
+    }
+
+    std::unique_ptr<T[]> permuted = std::make_unique<T[]>(npts * ndims);
+    for (size_t i = 0; i < npts; i++)
+        memcpy(permuted.get() + i * ndims, data + (size_t)new_to_old[i] * ndims, ndims * sizeof(T));
+    delete[] data;
+    diskann::save_bin<T>(bin_file, permuted.get(), npts, ndims);
+}
+
 template <typename T>
 void create_disk_layout(const std::string base_file, const std::string mem_index_file, const std::string output_file,
-                        const std::string reorder_data_file)
+                        const std::string reorder_data_file, const std::string id_map_file, const bool pack_nhoods,
+                        const std::string inline_pq_file, const bool separate_vectors)
 {
     uint32_t npts, ndims;
 
@@ -892,6 +981,9 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
     uint32_t npts_reorder_file = 0, ndims_reorder_file = 0;
     if (reorder_data_file != std::string(""))
     {
+        if (separate_vectors)
+            throw ANNException("Reorder data can not be appended to a disk index with separate vectors", -1,
+                               __FUNCSIG__, __FILE__, __LINE__);
         append_reorder_data = true;
         size_t reorder_data_file_size = get_file_size(reorder_data_file);
         reorder_data_reader.exceptions(std::ofstream::failbit | std::ofstream::badbit);
@@ -939,25 +1031,196 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
     vamana_reader.read((char *)&width_u32, sizeof(uint32_t));
     vamana_reader.read((char *)&medoid_u32, sizeof(uint32_t));
     vamana_reader.read((char *)&vamana_frozen_num, sizeof(uint64_t));
+
+    // optional node order. The graph, base and reorder data are then mapped
+    // and read in that order rather than streamed in id order. Packing
+    // nhoods also maps the graph and base, as it reads every node twice, and
+    // so do separate vectors, which read the base after the graph.
+    bool permute = id_map_file != std::string("");
+    bool mapped = permute || pack_nhoods || separate_vectors;
+    std::vector<uint32_t> new_to_old, old_to_new;
+    std::vector<uint64_t> nhood_offsets;
+    std::unique_ptr<MemoryMapper> graph_map, base_map, reorder_data_map;
+    if (permute)
+    {
+        uint32_t *ids = nullptr;
+        size_t nids, ids_dim;
+        diskann::load_bin<uint32_t>(id_map_file, ids, nids, ids_dim);
+        new_to_old.assign(ids, ids + nids);
+        delete[] ids;
+        if (nids != npts_64)
+            throw ANNException("Mismatch in num_points between id map and base file", -1, __FUNCSIG__, __FILE__,
+                               __LINE__);
+        old_to_new.resize(npts_64);
+        for (uint64_t i = 0; i < npts_64; i++)
+            old_to_new[new_to_old[i]] = (uint32_t)i;
+        if (append_reorder_data)
+            reorder_data_map.reset(new MemoryMapper(reorder_data_file));
+    }
+    if (mapped)
+    {
+        graph_map.reset(new MemoryMapper(mem_index_file));
+        get_nhood_offsets(graph_map->getBuf(), graph_map->getFileSize(), npts_64, nhood_offsets);
+        base_map.reset(new MemoryMapper(base_file));
+    }
+    // PQ codes to inline next to the neighbor ids
+    std::unique_ptr<MemoryMapper> pq_map;
+    uint64_t inline_pq_chunks = 0;
+    const uint8_t *pq_codes = nullptr;
+    uint64_t n_pq_codes = 0;
+    if (inline_pq_file != std::string(""))
+    {
+        pq_map.reset(new MemoryMapper(inline_pq_file));
+        n_pq_codes = ((const uint32_t *)pq_map->getBuf())[0];
+        inline_pq_chunks = ((const uint32_t *)pq_map->getBuf())[1];
+        pq_codes = (const uint8_t *)pq_map->getBuf() + 2 * sizeof(uint32_t);
+        if (n_pq_codes != npts_64)
+            throw ANNException("Mismatch in num_points between PQ compressed vectors and base file", -1,
+                               __FUNCSIG__, __FILE__, __LINE__);
+        if (pq_map->getFileSize() != 2 * sizeof(uint32_t) + n_pq_codes * inline_pq_chunks)
+            throw ANNException("Discrepancy in PQ compressed vectors file size", -1, __FUNCSIG__, __FILE__,
+                               __LINE__);
+    }
+    // writes the PQ codes of nbrs[0..n) to out. Ids without a code (frozen
+    // points) get zeros.
+    auto write_nbr_codes = [&](const uint32_t *nbrs, uint32_t n, char *out) {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            if (nbrs[j] < n_pq_codes)
+                memcpy(out + j * inline_pq_chunks, pq_codes + nbrs[j] * inline_pq_chunks, inline_pq_chunks);
+            else
+                memset(out + j * inline_pq_chunks, 0, inline_pq_chunks);
+        }
+    };
+
+    // ids beyond npts (frozen points) keep their id
+    auto renumber = [&](uint32_t id) { return (permute && id < npts_64) ? old_to_new[id] : id; };
     // compute
     uint64_t medoid, max_node_len, nnodes_per_sector;
     npts_64 = (uint64_t)npts;
-    medoid = (uint64_t)medoid_u32;
+    medoid = (uint64_t)renumber(medoid_u32);
     if (vamana_frozen_num == 1)
         vamana_frozen_loc = medoid;
-    max_node_len = (((uint64_t)width_u32 + 1) * sizeof(uint32_t)) + (ndims_64 * sizeof(T));
+    // with separate vectors, nodes hold only the nhood and the full vectors
+    // follow the graph like reorder data
+    uint64_t node_coords_len = separate_vectors ? 0 : ndims_64 * sizeof(T);
+    max_node_len = (((uint64_t)width_u32 + 1) * sizeof(uint32_t)) + node_coords_len +
+                   (uint64_t)width_u32 * inline_pq_chunks;
     nnodes_per_sector = defaults::SECTOR_LEN / max_node_len; // 0 if max_node_len > SECTOR_LEN
 
-    diskann::cout << "medoid: " << medoid << "B" << std::endl;
-    diskann::cout << "max_node_len: " << max_node_len << "B" << std::endl;
-    diskann::cout << "nnodes_per_sector: " << nnodes_per_sector << "B" << std::endl;
-
     // defaults::SECTOR_LEN buffer for each sector
     std::unique_ptr<char[]> sector_buf = std::make_unique<char[]>(defaults::SECTOR_LEN);
     std::unique_ptr<char[]> multisector_buf = std::make_unique<char[]>(ROUND_UP(max_node_len, defaults::SECTOR_LEN));
     std::unique_ptr<char[]> node_buf = std::make_unique<char[]>(max_node_len);
-    uint32_t &nnbrs = *(uint32_t *)(node_buf.get() + ndims_64 * sizeof(T));
-    uint32_t *nhood_buf = (uint32_t *)(node_buf.get() + (ndims_64 * sizeof(T)) + sizeof(uint32_t));
+    uint32_t &nnbrs = *(uint32_t *)(node_buf.get() + node_coords_len);
+    uint32_t *nhood_buf = (uint32_t *)(node_buf.get() + node_coords_len + sizeof(uint32_t));
+    std::unique_ptr<T[]> cur_node_coords = std::make_unique<T[]>(ndims_64);
+
+    // fills node_buf with the coords, #nbrs and nhood of the node to place at
+    // position pos
+    auto read_node_nhood = [&](uint64_t pos) {
+        memset(node_buf.get(), 0, max_node_len);
+        if (mapped)
+        {
+            uint64_t old_id = permute ? new_to_old[pos] : pos;
+            memcpy(node_buf.get(), base_map->getBuf() + 2 * sizeof(uint32_t) + old_id * ndims_64 * sizeof(T),
+                   node_coords_len);
+            const uint32_t *old_nhood = (const uint32_t *)(graph_map->getBuf() + nhood_offsets[old_id]);
+            nnbrs = (std::min)(old_nhood[0], width_u32);
+            for (uint32_t j = 0; j < nnbrs; j++)
+                nhood_buf[j] = renumber(old_nhood[1 + j]);
+            return;
+        }
+
+        // read cur node's nnbrs
+        vamana_reader.read((char *)&nnbrs, sizeof(uint32_t));
+
+        // sanity checks on nnbrs
+        assert(nnbrs > 0);
+        assert(nnbrs <= width_u32);
+
+        // read node's nhood
+        vamana_reader.read((char *)nhood_buf, (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
+        if (nnbrs > width_u32)
+        {
+            vamana_reader.seekg((nnbrs - width_u32) * sizeof(uint32_t), vamana_reader.cur);
+        }
+
+        // write coords of node first
+        //  T *node_coords = data + ((uint64_t) ndims_64 * cur_node_id);
+        base_reader.read((char *)cur_node_coords.get(), sizeof(T) * ndims_64);
+        memcpy(node_buf.get(), cur_node_coords.get(), node_coords_len);
+
+        // write nnbrs
+        nnbrs = (std::min)(nnbrs, width_u32);
+    };
+    // read_node_nhood, followed by the PQ codes of the nbrs if inlined
+    auto read_node = [&](uint64_t pos) {
+        read_node_nhood(pos);
+        write_nbr_codes(nhood_buf, nnbrs, (char *)(nhood_buf + nnbrs));
+    };
+
+    // Packed nhoods: nodes are [coords][nnbrs][encode_packed_nhood(nbrs)]
+    // [PQ codes, if inlined], padded to 4 bytes, and every sector starts with the uint16_t offsets of
+    // its nodes. Nodes per sector is the largest count for which every
+    // aligned group of nodes fits in a sector.
+    bool packed = false;
+    if (pack_nhoods)
+    {
+        uint64_t node_header_len = node_coords_len + sizeof(uint32_t);
+        std::vector<uint8_t> encode_buf(packed_nhood_max_len(width_u32));
+        std::vector<uint16_t> packed_len(npts_64);
+        uint64_t min_len = max_node_len;
+        for (uint64_t i = 0; i < npts_64; i++)
+        {
+            read_node(i);
+            uint64_t len = ROUND_UP(node_header_len + encode_packed_nhood(nhood_buf, nnbrs, encode_buf.data()) +
+                                        nnbrs * inline_pq_chunks,
+                                    4);
+            packed_len[i] = (uint16_t)(std::min)(len, (uint64_t)defaults::SECTOR_LEN);
+            min_len = (std::min)(min_len, len);
+        }
+
+        auto fits = [&](uint64_t k) {
+            uint64_t budget = defaults::SECTOR_LEN - ROUND_UP(k * sizeof(uint16_t), 4);
+            for (uint64_t start = 0; start < npts_64; start += k)
+            {
+                uint64_t group_len = 0;
+                for (uint64_t i = start; i < (std::min)(start + k, npts_64); i++)
+                    group_len += packed_len[i];
+                if (group_len > budget)
+                    return false;
+            }
+            return true;
+        };
+        // binary search; a count is only taken if it fits
+        uint64_t lo = nnodes_per_sector, hi = defaults::SECTOR_LEN / (min_len + sizeof(uint16_t));
+        while (lo < hi)
+        {
+            uint64_t mid = (lo + hi + 1) / 2;
+            if (fits(mid))
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        if (lo > nnodes_per_sector)
+        {
+            diskann::cout << "Packing nhoods raises nodes per sector from " << nnodes_per_sector << " to " << lo
+                          << std::endl;
+            nnodes_per_sector = lo;
+            packed = true;
+        }
+        else
+        {
+            diskann::cout << "Packing nhoods does not fit more nodes per sector, writing plain nhoods" << std::endl;
+        }
+    }
+
+    diskann::cout << "medoid: " << medoid << "B" << std::endl;
+    diskann::cout << "max_node_len: " << max_node_len << "B" << std::endl;
+    if (inline_pq_chunks > 0)
+        diskann::cout << "inline PQ codes: " << inline_pq_chunks << "B per neighbor" << std::endl;
+    diskann::cout << "nnodes_per_sector: " << nnodes_per_sector << "B" << std::endl;
 
     // number of sectors (1 for meta data)
     uint64_t n_sectors = nnodes_per_sector > 0 ? ROUND_UP(npts_64, nnodes_per_sector) / nnodes_per_sector
@@ -965,10 +1228,20 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
     uint64_t n_reorder_sectors = 0;
     uint64_t n_data_nodes_per_sector = 0;
 
-    if (append_reorder_data)
+    // full-precision vectors after the graph: float reorder data, or the base
+    // vectors themselves for separate vectors. Vectors larger than a sector
+    // take whole sectors each, like multi-sector nodes.
+    bool append_vectors = append_reorder_data || separate_vectors;
+    uint64_t vec_ndims = separate_vectors ? ndims_64 : ndims_reorder_file;
+    uint64_t vec_len = separate_vectors ? ndims_64 * sizeof(T) : ndims_reorder_file * sizeof(float);
+    uint64_t nsectors_per_vec = 0;
+    if (append_vectors)
     {
-        n_data_nodes_per_sector = defaults::SECTOR_LEN / (ndims_reorder_file * sizeof(float));
-        n_reorder_sectors = ROUND_UP(npts_64, n_data_nodes_per_sector) / n_data_nodes_per_sector;
+        n_data_nodes_per_sector = defaults::SECTOR_LEN / vec_len; // 0 if vec_len > SECTOR_LEN
+        nsectors_per_vec = DIV_ROUND_UP(vec_len, defaults::SECTOR_LEN);
+        n_reorder_sectors = n_data_nodes_per_sector > 0
+                                ? ROUND_UP(npts_64, n_data_nodes_per_sector) / n_data_nodes_per_sector
+                                : npts_64 * nsectors_per_vec;
     }
     uint64_t disk_index_file_size = (n_sectors + n_reorder_sectors + 1) * defaults::SECTOR_LEN;
 
@@ -980,22 +1253,59 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
     output_file_meta.push_back(nnodes_per_sector);
     output_file_meta.push_back(vamana_frozen_num);
     output_file_meta.push_back(vamana_frozen_loc);
-    output_file_meta.push_back((uint64_t)append_reorder_data);
-    if (append_reorder_data)
+    // 0: no vectors after the graph, 1: float reorder data, 2: separate
+    // vectors of type T
+    output_file_meta.push_back(separate_vectors ? 2 : (uint64_t)append_reorder_data);
+    if (append_vectors)
     {
         output_file_meta.push_back(n_sectors + 1);
-        output_file_meta.push_back(ndims_reorder_file);
+        output_file_meta.push_back(vec_ndims);
         output_file_meta.push_back(n_data_nodes_per_sector);
     }
     output_file_meta.push_back(disk_index_file_size);
+    // nhood format and inline PQ chunks, left out for plain nhoods without
+    // codes so that such indexes stay readable by older versions
+    if (packed || inline_pq_chunks > 0)
+        output_file_meta.push_back(packed ? 1 : 0);
+    if (inline_pq_chunks > 0)
+        output_file_meta.push_back(inline_pq_chunks);
 
     diskann_writer.write(sector_buf.get(), defaults::SECTOR_LEN);
 
-    std::unique_ptr<T[]> cur_node_coords = std::make_unique<T[]>(ndims_64);
     diskann::cout << "# sectors: " << n_sectors << std::endl;
     uint64_t cur_node_id = 0;
 
-    if (nnodes_per_sector > 0)
+    if (packed)
+    { // Write multiple packed nodes per sector
+        uint64_t node_header_len = node_coords_len + sizeof(uint32_t);
+        for (uint64_t sector = 0; sector < n_sectors; sector++)
+        {
+            if (sector % 100000 == 0)
+            {
+                diskann::cout << "Sector #" << sector << "written" << std::endl;
+            }
+            memset(sector_buf.get(), 0, defaults::SECTOR_LEN);
+            uint16_t *node_offsets = (uint16_t *)sector_buf.get();
+            uint64_t offset = ROUND_UP(nnodes_per_sector * sizeof(uint16_t), 4);
+            for (uint64_t sector_node_id = 0; sector_node_id < nnodes_per_sector && cur_node_id < npts_64;
+                 sector_node_id++)
+            {
+                read_node(cur_node_id);
+                node_offsets[sector_node_id] = (uint16_t)offset;
+                char *sector_node_buf = sector_buf.get() + offset;
+                memcpy(sector_node_buf, node_buf.get(), node_header_len);
+                uint64_t nhood_len =
+                    encode_packed_nhood(nhood_buf, nnbrs, (uint8_t *)(sector_node_buf + node_header_len));
+                // codes follow the sorted ids
+                write_nbr_codes(nhood_buf, nnbrs, sector_node_buf + node_header_len + nhood_len);
+                offset += ROUND_UP(node_header_len + nhood_len + nnbrs * inline_pq_chunks, 4);
+                cur_node_id++;
+            }
+            // flush sector to disk
+            diskann_writer.write(sector_buf.get(), defaults::SECTOR_LEN);
+        }
+    }
+    else if (nnodes_per_sector > 0)
     { // Write multiple nodes per sector
         for (uint64_t sector = 0; sector < n_sectors; sector++)
         {
@@ -1007,32 +1317,7 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
             for (uint64_t sector_node_id = 0; sector_node_id < nnodes_per_sector && cur_node_id < npts_64;
                  sector_node_id++)
             {
-                memset(node_buf.get(), 0, max_node_len);
-                // read cur node's nnbrs
-                vamana_reader.read((char *)&nnbrs, sizeof(uint32_t));
-
-                // sanity checks on nnbrs
-                assert(nnbrs > 0);
-                assert(nnbrs <= width_u32);
-
-                // read node's nhood
-                vamana_reader.read((char *)nhood_buf, (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
-                if (nnbrs > width_u32)
-                {
-                    vamana_reader.seekg((nnbrs - width_u32) * sizeof(uint32_t), vamana_reader.cur);
-                }
-
-                // write coords of node first
-                //  T *node_coords = data + ((uint64_t) ndims_64 * cur_node_id);
-                base_reader.read((char *)cur_node_coords.get(), sizeof(T) * ndims_64);
-                memcpy(node_buf.get(), cur_node_coords.get(), ndims_64 * sizeof(T));
-
-                // write nnbrs
-                *(uint32_t *)(node_buf.get() + ndims_64 * sizeof(T)) = (std::min)(nnbrs, width_u32);
-
-                // write nhood next
-                memcpy(node_buf.get() + ndims_64 * sizeof(T) + sizeof(uint32_t), nhood_buf,
-                       (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
+                read_node(cur_node_id);
 
                 // get offset into sector_buf
                 char *sector_node_buf = sector_buf.get() + (sector_node_id * max_node_len);
@@ -1056,65 +1341,77 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
             }
             memset(multisector_buf.get(), 0, nsectors_per_node * defaults::SECTOR_LEN);
 
-            memset(node_buf.get(), 0, max_node_len);
-            // read cur node's nnbrs
-            vamana_reader.read((char *)&nnbrs, sizeof(uint32_t));
-
-            // sanity checks on nnbrs
-            assert(nnbrs > 0);
-            assert(nnbrs <= width_u32);
-
-            // read node's nhood
-            vamana_reader.read((char *)nhood_buf, (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
-            if (nnbrs > width_u32)
-            {
-                vamana_reader.seekg((nnbrs - width_u32) * sizeof(uint32_t), vamana_reader.cur);
-            }
-
-            // write coords of node first
-            //  T *node_coords = data + ((uint64_t) ndims_64 * cur_node_id);
-            base_reader.read((char *)cur_node_coords.get(), sizeof(T) * ndims_64);
-            memcpy(multisector_buf.get(), cur_node_coords.get(), ndims_64 * sizeof(T));
-
-            // write nnbrs
-            *(uint32_t *)(multisector_buf.get() + ndims_64 * sizeof(T)) = (std::min)(nnbrs, width_u32);
-
-            // write nhood next
-            memcpy(multisector_buf.get() + ndims_64 * sizeof(T) + sizeof(uint32_t), nhood_buf,
-                   (std::min)(nnbrs, width_u32) * sizeof(uint32_t));
+            read_node(i);
+            memcpy(multisector_buf.get(), node_buf.get(), max_node_len);
 
             // flush sector to disk
             diskann_writer.write(multisector_buf.get(), nsectors_per_node * defaults::SECTOR_LEN);
         }
     }
 
-    if (append_reorder_data)
+    if (append_vectors)
     {
-        diskann::cout << "Index written. Appending reorder data..." << std::endl;
+        diskann::cout << "Index written. Appending " << (separate_vectors ? "vectors" : "reorder data") << "..."
+                      << std::endl;
 
-        auto vec_len = ndims_reorder_file * sizeof(float);
-        std::unique_ptr<char[]> vec_buf = std::make_unique<char[]>(vec_len);
+        std::unique_ptr<char[]> vec_buf = std::make_unique<char[]>(nsectors_per_vec * defaults::SECTOR_LEN);
 
-        for (uint64_t sector = 0; sector < n_reorder_sectors; sector++)
-        {
-            if (sector % 100000 == 0)
+        // fills vec_buf with the vector of the node at position pos
+        auto read_vec = [&](uint64_t pos) {
+            memset(vec_buf.get(), 0, vec_len);
+            uint64_t old_id = permute ? new_to_old[pos] : pos;
+            if (separate_vectors)
             {
-                diskann::cout << "Reorder data Sector #" << sector << "written" << std::endl;
+                memcpy(vec_buf.get(), base_map->getBuf() + 2 * sizeof(uint32_t) + old_id * vec_len, vec_len);
             }
-
-            memset(sector_buf.get(), 0, defaults::SECTOR_LEN);
-
-            for (uint64_t sector_node_id = 0; sector_node_id < n_data_nodes_per_sector && sector_node_id < npts_64;
-                 sector_node_id++)
+            else if (permute)
+            {
+                memcpy(vec_buf.get(), reorder_data_map->getBuf() + 2 * sizeof(uint32_t) + old_id * vec_len,
+                       vec_len);
+            }
+            else
             {
-                memset(vec_buf.get(), 0, vec_len);
                 reorder_data_reader.read(vec_buf.get(), vec_len);
+            }
+        };
 
-                // copy node buf into sector_node_buf
-                memcpy(sector_buf.get() + (sector_node_id * vec_len), vec_buf.get(), vec_len);
+        if (n_data_nodes_per_sector > 0)
+        {
+            for (uint64_t sector = 0; sector < n_reorder_sectors; sector++)
+            {
+                if (sector % 100000 == 0)
+                {
+                    diskann::cout << "Reorder data Sector #" << sector << "written" << std::endl;
+                }
+
+                memset(sector_buf.get(), 0, defaults::SECTOR_LEN);
+
+                uint64_t first_pos = sector * n_data_nodes_per_sector;
+                for (uint64_t sector_node_id = 0;
+                     sector_node_id < n_data_nodes_per_sector && first_pos + sector_node_id < npts_64;
+                     sector_node_id++)
+                {
+                    read_vec(first_pos + sector_node_id);
+
+                    // copy node buf into sector_node_buf
+                    memcpy(sector_buf.get() + (sector_node_id * vec_len), vec_buf.get(), vec_len);
+                }
+                // flush sector to disk
+                diskann_writer.write(sector_buf.get(), defaults::SECTOR_LEN);
+            }
+        }
+        else
+        { // Write multi-sector vectors
+            for (uint64_t i = 0; i < npts_64; i++)
+            {
+                if ((i * nsectors_per_vec) % 100000 == 0)
+                {
+                    diskann::cout << "Reorder data Sector #" << i * nsectors_per_vec << "written" << std::endl;
+                }
+                memset(vec_buf.get(), 0, nsectors_per_vec * defaults::SECTOR_LEN);
+                read_vec(i);
+                diskann_writer.write(vec_buf.get(), nsectors_per_vec * defaults::SECTOR_LEN);
             }
-            // flush sector to disk
-            diskann_writer.write(sector_buf.get(), defaults::SECTOR_LEN);
         }
     }
     diskann_writer.close();
@@ -1122,6 +1419,86 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
     diskann::cout << "Output disk index file written to " << output_file << std::endl;
 }
 
+void restripe_disk_index(const std::string &disk_index_file, const std::vector<std::string> &stripe_files,
+                         uint64_t stripe_sectors)
+{
+    uint64_t n_stripes = stripe_files.size();
+    if (n_stripes < 2 || stripe_sectors == 0)
+        throw ANNException("Restriping needs at least two stripe files and a non-zero stripe unit", -1, __FUNCSIG__,
+                           __FILE__, __LINE__);
+    for (auto &stripe_file : stripe_files)
+    {
+        if (stripe_file == disk_index_file)
+            throw ANNException("Stripe file can not be the disk index file itself", -1, __FUNCSIG__, __FILE__,
+                               __LINE__);
+    }
+
+    uint64_t file_size = get_file_size(disk_index_file);
+    std::ifstream index_reader(disk_index_file, std::ios::binary);
+    uint32_t nr, nc;
+    index_reader.read((char *)&nr, sizeof(uint32_t));
+    index_reader.read((char *)&nc, sizeof(uint32_t));
+    std::vector<uint64_t> meta(nr);
+    index_reader.read((char *)meta.data(), nr * sizeof(uint64_t));
+    if (nr < 8 || nc != 1)
+        throw ANNException("Unexpected metadata in disk index " + disk_index_file, -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+
+    // trailing fields after the reorder data info: file size, nhood format,
+    // inline PQ chunks, #stripes, stripe unit
+    uint64_t num_meta_read = meta[7] != 0 ? 11 : 8;
+    if (nr <= num_meta_read)
+        meta.push_back(file_size);
+    meta.resize((std::max)(meta.size(), (size_t)num_meta_read + 5), 0);
+    if (meta[num_meta_read + 3] > 1)
+        throw ANNException("Disk index " + disk_index_file + " is already striped", -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+    meta[num_meta_read + 3] = n_stripes;
+    meta[num_meta_read + 4] = stripe_sectors;
+
+    std::unique_ptr<char[]> meta_sector = std::make_unique<char[]>(defaults::SECTOR_LEN);
+    memset(meta_sector.get(), 0, defaults::SECTOR_LEN);
+    uint32_t meta_nr = (uint32_t)meta.size(), meta_nc = 1;
+    memcpy(meta_sector.get(), &meta_nr, sizeof(uint32_t));
+    memcpy(meta_sector.get() + sizeof(uint32_t), &meta_nc, sizeof(uint32_t));
+    memcpy(meta_sector.get() + 2 * sizeof(uint32_t), meta.data(), meta.size() * sizeof(uint64_t));
+
+    std::vector<std::unique_ptr<std::ofstream>> stripe_writers;
+    for (auto &stripe_file : stripe_files)
+    {
+        stripe_writers.emplace_back(new std::ofstream(stripe_file, std::ios::binary | std::ios::trunc));
+        stripe_writers.back()->exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    }
+
+    // unit u of the index goes to stripe u % n_stripes, in order
+    uint64_t stripe_len = stripe_sectors * defaults::SECTOR_LEN;
+    std::unique_ptr<char[]> unit_buf = std::make_unique<char[]>(stripe_len);
+    index_reader.seekg(0, std::ios::beg);
+    uint64_t n_units = DIV_ROUND_UP(file_size, stripe_len);
+    for (uint64_t unit = 0; unit < n_units; unit++)
+    {
+        uint64_t len = (std::min)(stripe_len, file_size - unit * stripe_len);
+        index_reader.read(unit_buf.get(), len);
+        if (unit == 0)
+            memcpy(unit_buf.get(), meta_sector.get(), defaults::SECTOR_LEN);
+        stripe_writers[unit % n_stripes]->write(unit_buf.get(), len);
+    }
+    index_reader.close();
+    for (auto &writer : stripe_writers)
+        writer->close();
+
+    std::ofstream stripes_writer(disk_index_file + "_stripes.txt");
+    for (auto &stripe_file : stripe_files)
+        stripes_writer << stripe_file << std::endl;
+    stripes_writer.close();
+
+    std::ofstream meta_writer(disk_index_file, std::ios::binary | std::ios::trunc);
+    meta_writer.write(meta_sector.get(), defaults::SECTOR_LEN);
+    meta_writer.close();
+    diskann::cout << "Striped " << n_units << " units of " << stripe_sectors << " sector(s) over " << n_stripes
+                  << " files" << std::endl;
+}
+
 template <typename T, typename LabelT>
 int build_disk_index(const char *dataFilePath, const char *indexFilePath, const char *indexBuildParameters,
                      diskann::Metric _compareMetric, PartitioningAlgorithm partition_algorithm, bool use_opq,
@@ -1139,7 +1516,7 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
     {
         param_list.push_back(cur_param);
     }
-    if (param_list.size() < 5 || param_list.size() > 9)
+    if (param_list.size() < 5 || param_list.size() > 16)
     {
         diskann::cout << "Correct usage of parameters is R (max degree)\n"
                          "L (indexing list size, better if >= R)\n"
@@ -1152,7 +1529,21 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
                          ": optional paramter, use only when using disk PQ\n"
                          "build_PQ_byte (number of PQ bytes for inde build; set 0 to use "
                          "full precision vectors)\n"
-                         "QD Quantized Dimension to overwrite the derived dim from B "
+                         "QD Quantized Dimension to overwrite the derived dim from B\n"
+                         "bfs_layout (set 1 to lay out nodes on disk in BFS order from the medoid: "
+                         "optional parameter)\n"
+                         "pack_nhoods (set 1 to store delta-encoded neighbor lists on disk: "
+                         "optional parameter)\n"
+                         "inline_pq (set 1 to store the PQ codes of neighbors in each disk node: "
+                         "optional parameter)\n"
+                         "separate_vectors (set 1 to store full vectors apart from the graph on disk "
+                         "and fetch them only for reranking: optional parameter)\n"
+                         "PQ_bits (bits per in-memory PQ code, 8 to 16, or 4 for fast-scan distances: "
+                         "optional parameter)\n"
+                         "disk_opq (set 1 to compress the vectors on disk with OPQ, used with B': "
+                         "optional parameter)\n"
+                         "rabitq (set 1 to also keep RaBitQ codes in memory to filter neighbors "
+                         "before PQ distances, L2 only: optional parameter)"
                       << std::endl;
         return -1;
     }
@@ -1196,6 +1587,77 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
         build_pq_bytes = atoi(param_list[7].c_str());
     }
 
+    bool bfs_layout = false;
+    if (param_list.size() >= 10)
+    {
+        if (1 == atoi(param_list[9].c_str()))
+        {
+            bfs_layout = true;
+        }
+    }
+
+    bool pack_nhoods = false;
+    if (param_list.size() >= 11)
+    {
+        if (1 == atoi(param_list[10].c_str()))
+        {
+            pack_nhoods = true;
+        }
+    }
+
+    bool inline_pq = false;
+    if (param_list.size() >= 12)
+    {
+        if (1 == atoi(param_list[11].c_str()))
+        {
+            inline_pq = true;
+        }
+    }
+
+    bool separate_vectors = false;
+    if (param_list.size() >= 13)
+    {
+        if (1 == atoi(param_list[12].c_str()))
+        {
+            separate_vectors = true;
+        }
+    }
+
+    uint32_t num_pq_bits = NUM_PQ_BITS;
+    if (param_list.size() >= 14)
+    {
+        num_pq_bits = (uint32_t)atoi(param_list[13].c_str());
+        if (!is_valid_pq_bits(num_pq_bits))
+        {
+            diskann::cerr << "PQ_bits must be " << PQ_FAST_SCAN_BITS << " or between " << NUM_PQ_BITS << " and "
+                          << MAX_PQ_BITS << std::endl;
+            return -1;
+        }
+    }
+
+    bool disk_opq = false;
+    if (param_list.size() >= 15)
+    {
+        if (1 == atoi(param_list[14].c_str()))
+        {
+            disk_opq = true;
+        }
+    }
+
+    bool use_rabitq = false;
+    if (param_list.size() >= 16)
+    {
+        if (1 == atoi(param_list[15].c_str()))
+        {
+            if (_compareMetric != diskann::Metric::L2)
+            {
+                diskann::cerr << "RaBitQ codes only support the L2 metric" << std::endl;
+                return -1;
+            }
+            use_rabitq = true;
+        }
+    }
+
     std::string base_file(dataFilePath);
     std::string data_file_to_use = base_file;
     std::string labels_file_original = label_file;
@@ -1224,6 +1686,11 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
     std::string disk_pq_pivots_path = index_prefix_path + "_disk.index_pq_pivots.bin";
     // optional, used if disk index must store pq data
     std::string disk_pq_compressed_vectors_path = index_prefix_path + "_disk.index_pq_compressed.bin";
+    // optional, in-memory RaBitQ codes filtering neighbors during search
+    std::string rabitq_pivots_path = get_rabitq_pivots_filename(disk_index_path);
+    std::string rabitq_codes_path = get_rabitq_codes_filename(disk_index_path);
+    // optional, maps positions in the disk index to original ids
+    std::string id_map_path = disk_index_path + "_id_map.bin";
     std::string prepped_base =
         index_prefix_path +
         "_prepped_base.bin"; // temp file for storing pre-processed base file for cosine/ mips metrics
@@ -1320,9 +1787,13 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
     if (use_disk_pq)
     {
         generate_disk_quantized_data<T>(data_file_to_use, disk_pq_pivots_path, disk_pq_compressed_vectors_path,
-                                        _compareMetric, p_val, disk_pq_dims);
+                                        _compareMetric, p_val, disk_pq_dims, disk_opq);
     }
     size_t num_pq_chunks = (size_t)(std::floor)(uint64_t(final_index_ram_limit / points_num));
+    // codes other than 8 bits are bit-packed, so the same budget holds twice
+    // the chunks of 4 bits and fewer of wider codes
+    if (num_pq_bits != NUM_PQ_BITS)
+        num_pq_chunks = num_pq_chunks * 8 / num_pq_bits;
 
     num_pq_chunks = num_pq_chunks <= 0 ? 1 : num_pq_chunks;
     num_pq_chunks = num_pq_chunks > dim ? dim : num_pq_chunks;
@@ -1335,12 +1806,18 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
                   << std::endl;
         num_pq_chunks = atoi(param_list[8].c_str());
     }
+    // search scratch holds codes of up to MAX_PQ_CHUNKS bytes
+    if (pq_code_len(num_pq_chunks, num_pq_bits) > MAX_PQ_CHUNKS)
+        num_pq_chunks = MAX_PQ_CHUNKS * 8 / num_pq_bits;
 
-    diskann::cout << "Compressing " << dim << "-dimensional data into " << num_pq_chunks << " bytes per vector."
+    diskann::cout << "Compressing " << dim << "-dimensional data into " << num_pq_chunks << " chunks of "
+                  << num_pq_bits << " bits, " << pq_code_len(num_pq_chunks, num_pq_bits) << " bytes per vector."
                   << std::endl;
 
     generate_quantized_data<T>(data_file_to_use, pq_pivots_path, pq_compressed_vectors_path, _compareMetric, p_val,
-                               num_pq_chunks, use_opq, codebook_prefix);
+                               num_pq_chunks, use_opq, codebook_prefix, 1u << num_pq_bits);
+    if (use_rabitq)
+        generate_rabitq_data<T>(data_file_to_use, p_val, rabitq_pivots_path, rabitq_codes_path);
     diskann::cout << timer.elapsed_seconds_for_step("generating quantized data") << std::endl;
 
 // Gopal. Splitting diskann_dll into separate DLLs for search and build.
@@ -1357,17 +1834,61 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
     diskann::cout << timer.elapsed_seconds_for_step("building merged vamana index") << std::endl;
 
     timer.reset();
+    // renumber the nodes so that graph neighbors share sectors. The PQ codes
+    // and medoids are renumbered here, the disk index in create_disk_layout.
+    std::remove(id_map_path.c_str());
+    std::string layout_id_map = "";
+    if (bfs_layout && use_filters)
+    {
+        diskann::cout << "BFS layout is not supported with filters, laying out nodes in id order." << std::endl;
+    }
+    else if (bfs_layout)
+    {
+        std::vector<uint32_t> new_to_old;
+        diskann::compute_bfs_layout_order(mem_index_path, points_num, new_to_old);
+        diskann::save_bin<uint32_t>(id_map_path, new_to_old.data(), new_to_old.size(), 1);
+        layout_id_map = id_map_path;
+
+        permute_bin_rows<uint8_t>(pq_compressed_vectors_path, new_to_old);
+        if (use_rabitq)
+            permute_bin_rows<uint8_t>(rabitq_codes_path, new_to_old);
+        if (file_exists(medoids_path))
+        {
+            std::vector<uint32_t> old_to_new(new_to_old.size());
+            for (size_t i = 0; i < new_to_old.size(); i++)
+                old_to_new[new_to_old[i]] = (uint32_t)i;
+
+            uint32_t *medoids = nullptr;
+            size_t num_medoids, medoids_dim;
+            diskann::load_bin<uint32_t>(medoids_path, medoids, num_medoids, medoids_dim);
+            for (size_t i = 0; i < num_medoids; i++)
+                medoids[i] = old_to_new[medoids[i]];
+            diskann::save_bin<uint32_t>(medoids_path, medoids, num_medoids, medoids_dim);
+            delete[] medoids;
+        }
+    }
+
+    std::string inline_pq_file = inline_pq ? pq_compressed_vectors_path : "";
+    if (separate_vectors && use_disk_pq)
+    {
+        diskann::cout << "Separate vectors are not used with disk PQ, whose nodes already hold only PQ codes. "
+                         "Append reorder data instead."
+                      << std::endl;
+    }
     if (!use_disk_pq)
     {
-        diskann::create_disk_layout<T>(data_file_to_use.c_str(), mem_index_path, disk_index_path);
+        diskann::create_disk_layout<T>(data_file_to_use.c_str(), mem_index_path, disk_index_path, "",
+                                       layout_id_map, pack_nhoods, inline_pq_file, separate_vectors);
     }
     else
     {
         if (!reorder_data)
-            diskann::create_disk_layout<uint8_t>(disk_pq_compressed_vectors_path, mem_index_path, disk_index_path);
+            diskann::create_disk_layout<uint8_t>(disk_pq_compressed_vectors_path, mem_index_path, disk_index_path, "",
+                                                 layout_id_map, pack_nhoods, inline_pq_file);
         else
             diskann::create_disk_layout<uint8_t>(disk_pq_compressed_vectors_path, mem_index_path, disk_index_path,
-                                                 data_file_to_use.c_str());
+                                                 data_file_to_use.c_str(), layout_id_map, pack_nhoods,
+                                                 inline_pq_file);
     }
     diskann::cout << timer.elapsed_seconds_for_step("generating disk layout") << std::endl;
 
@@ -1407,17 +1928,44 @@ int build_disk_index(const char *dataFilePath, const char *indexFilePath, const
 template DISKANN_DLLEXPORT void create_disk_layout<int8_t>(const std::string base_file,
                                                            const std::string mem_index_file,
                                                            const std::string output_file,
-                                                           const std::string reorder_data_file);
+                                                           const std::string reorder_data_file,
+                                                           const std::string id_map_file, const bool pack_nhoods,
+                                                           const std::string inline_pq_file,
+                                                           const bool separate_vectors);
+template DISKANN_DLLEXPORT void create_disk_layout<float16>(const std::string base_file,
+                                                            const std::string mem_index_file,
+                                                            const std::string output_file,
+                                                            const std::string reorder_data_file,
+                                                            const std::string id_map_file, const bool pack_nhoods,
+                                                            const std::string inline_pq_file,
+                                                            const bool separate_vectors);
+template DISKANN_DLLEXPORT void create_disk_layout<bfloat16>(const std::string base_file,
+                                                             const std::string mem_index_file,
+                                                             const std::string output_file,
+                                                             const std::string reorder_data_file,
+                                                             const std::string id_map_file, const bool pack_nhoods,
+                                                             const std::string inline_pq_file,
+                                                             const bool separate_vectors);
 template DISKANN_DLLEXPORT void create_disk_layout<uint8_t>(const std::string base_file,
                                                             const std::string mem_index_file,
                                                             const std::string output_file,
-                                                            const std::string reorder_data_file);
+                                                            const std::string reorder_data_file,
+                                                            const std::string id_map_file, const bool pack_nhoods,
+                                                           const std::string inline_pq_file,
+                                                           const bool separate_vectors);
 template DISKANN_DLLEXPORT void create_disk_layout<float>(const std::string base_file, const std::string mem_index_file,
                                                           const std::string output_file,
-                                                          const std::string reorder_data_file);
+                                                          const std::string reorder_data_file,
+                                                          const std::string id_map_file, const bool pack_nhoods,
+                                                          const std::string inline_pq_file,
+                                                          const bool separate_vectors);
 
 template DISKANN_DLLEXPORT int8_t *load_warmup<int8_t>(const std::string &cache_warmup_file, uint64_t &warmup_num,
                                                        uint64_t warmup_dim, uint64_t warmup_aligned_dim);
+template DISKANN_DLLEXPORT float16 *load_warmup<float16>(const std::string &cache_warmup_file, uint64_t &warmup_num,
+                                                         uint64_t warmup_dim, uint64_t warmup_aligned_dim);
+template DISKANN_DLLEXPORT bfloat16 *load_warmup<bfloat16>(const std::string &cache_warmup_file, uint64_t &warmup_num,
+                                                           uint64_t warmup_dim, uint64_t warmup_aligned_dim);
 template DISKANN_DLLEXPORT uint8_t *load_warmup<uint8_t>(const std::string &cache_warmup_file, uint64_t &warmup_num,
                                                          uint64_t warmup_dim, uint64_t warmup_aligned_dim);
 template DISKANN_DLLEXPORT float *load_warmup<float>(const std::string &cache_warmup_file, uint64_t &warmup_num,
@@ -1427,6 +1975,12 @@ template DISKANN_DLLEXPORT float *load_warmup<float>(const std::string &cache_wa
 template DISKANN_DLLEXPORT int8_t *load_warmup<int8_t>(MemoryMappedFiles &files, const std::string &cache_warmup_file,
                                                        uint64_t &warmup_num, uint64_t warmup_dim,
                                                        uint64_t warmup_aligned_dim);
+template DISKANN_DLLEXPORT float16 *load_warmup<float16>(MemoryMappedFiles &files, const std::string &cache_warmup_file,
+                                                         uint64_t &warmup_num, uint64_t warmup_dim,
+                                                         uint64_t warmup_aligned_dim);
+template DISKANN_DLLEXPORT bfloat16 *load_warmup<bfloat16>(MemoryMappedFiles &files,
+                                                           const std::string &cache_warmup_file, uint64_t &warmup_num,
+                                                           uint64_t warmup_dim, uint64_t warmup_aligned_dim);
 template DISKANN_DLLEXPORT uint8_t *load_warmup<uint8_t>(MemoryMappedFiles &files, const std::string &cache_warmup_file,
                                                          uint64_t &warmup_num, uint64_t warmup_dim,
                                                          uint64_t warmup_aligned_dim);
@@ -1438,6 +1992,12 @@ template DISKANN_DLLEXPORT float *load_warmup<float>(MemoryMappedFiles &files, c
 template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<int8_t, uint32_t>(
     std::unique_ptr<diskann::PQFlashIndex<int8_t, uint32_t>> &pFlashIndex, int8_t *tuning_sample,
     uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
+template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<float16, uint32_t>(
+    std::unique_ptr<diskann::PQFlashIndex<float16, uint32_t>> &pFlashIndex, float16 *tuning_sample,
+    uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
+template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<bfloat16, uint32_t>(
+    std::unique_ptr<diskann::PQFlashIndex<bfloat16, uint32_t>> &pFlashIndex, bfloat16 *tuning_sample,
+    uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
 template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<uint8_t, uint32_t>(
     std::unique_ptr<diskann::PQFlashIndex<uint8_t, uint32_t>> &pFlashIndex, uint8_t *tuning_sample,
     uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
@@ -1448,6 +2008,12 @@ template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<float, uint32_t>(
 template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<int8_t, uint16_t>(
     std::unique_ptr<diskann::PQFlashIndex<int8_t, uint16_t>> &pFlashIndex, int8_t *tuning_sample,
     uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
+template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<float16, uint16_t>(
+    std::unique_ptr<diskann::PQFlashIndex<float16, uint16_t>> &pFlashIndex, float16 *tuning_sample,
+    uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
+template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<bfloat16, uint16_t>(
+    std::unique_ptr<diskann::PQFlashIndex<bfloat16, uint16_t>> &pFlashIndex, bfloat16 *tuning_sample,
+    uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
 template DISKANN_DLLEXPORT uint32_t optimize_beamwidth<uint8_t, uint16_t>(
     std::unique_ptr<diskann::PQFlashIndex<uint8_t, uint16_t>> &pFlashIndex, uint8_t *tuning_sample,
     uint64_t tuning_sample_num, uint64_t tuning_sample_aligned_dim, uint32_t L, uint32_t nthreads, uint32_t start_bw);
@@ -1461,6 +2027,24 @@ template DISKANN_DLLEXPORT int build_disk_index<int8_t, uint32_t>(
     const std::string &codebook_prefix, bool use_filters, const std::string &label_file,
     const std::string &universal_label, const uint32_t filter_threshold, const uint32_t Lf, const uint32_t ommega,
     const float episilon);
+template DISKANN_DLLEXPORT int build_disk_index<float16, uint32_t>(const char *dataFilePath, const char *indexFilePath,
+                                                                   const char *indexBuildParameters,
+                                                                   diskann::Metric _compareMetric,
+                                                                   PartitioningAlgorithm partition_algorithm,
+                                                                   bool use_opq, const std::string &codebook_prefix,
+                                                                   bool use_filters, const std::string &label_file,
+                                                                   const std::string &universal_label,
+                                                                   const uint32_t filter_threshold, const uint32_t Lf,
+                                                                   const uint32_t ommega, const float episilon);
+template DISKANN_DLLEXPORT int build_disk_index<bfloat16, uint32_t>(const char *dataFilePath, const char *indexFilePath,
+                                                                    const char *indexBuildParameters,
+                                                                    diskann::Metric _compareMetric,
+                                                                    PartitioningAlgorithm partition_algorithm,
+                                                                    bool use_opq, const std::string &codebook_prefix,
+                                                                    bool use_filters, const std::string &label_file,
+                                                                    const std::string &universal_label,
+                                                                    const uint32_t filter_threshold, const uint32_t Lf,
+                                                                    const uint32_t ommega, const float episilon);
 template DISKANN_DLLEXPORT int build_disk_index<uint8_t, uint32_t>(
     const char *dataFilePath, const char *indexFilePath, const char *indexBuildParameters,
     diskann::Metric _compareMetric, PartitioningAlgorithm partition_algorithm, bool use_opq,
@@ -1480,6 +2064,24 @@ template DISKANN_DLLEXPORT int build_disk_index<int8_t, uint16_t>(
     const std::string &codebook_prefix, bool use_filters, const std::string &label_file,
     const std::string &universal_label, const uint32_t filter_threshold, const uint32_t Lf, const uint32_t ommega,
     const float episilon);
+template DISKANN_DLLEXPORT int build_disk_index<float16, uint16_t>(const char *dataFilePath, const char *indexFilePath,
+                                                                   const char *indexBuildParameters,
+                                                                   diskann::Metric _compareMetric,
+                                                                   PartitioningAlgorithm partition_algorithm,
+                                                                   bool use_opq, const std::string &codebook_prefix,
+                                                                   bool use_filters, const std::string &label_file,
+                                                                   const std::string &universal_label,
+                                                                   const uint32_t filter_threshold, const uint32_t Lf,
+                                                                   const uint32_t ommega, const float episilon);
+template DISKANN_DLLEXPORT int build_disk_index<bfloat16, uint16_t>(const char *dataFilePath, const char *indexFilePath,
+                                                                    const char *indexBuildParameters,
+                                                                    diskann::Metric _compareMetric,
+                                                                    PartitioningAlgorithm partition_algorithm,
+                                                                    bool use_opq, const std::string &codebook_prefix,
+                                                                    bool use_filters, const std::string &label_file,
+                                                                    const std::string &universal_label,
+                                                                    const uint32_t filter_threshold, const uint32_t Lf,
+                                                                    const uint32_t ommega, const float episilon);
 template DISKANN_DLLEXPORT int build_disk_index<uint8_t, uint16_t>(
     const char *dataFilePath, const char *indexFilePath, const char *indexBuildParameters,
     diskann::Metric _compareMetric, PartitioningAlgorithm partition_algorithm, bool use_opq,
@@ -1499,6 +2101,18 @@ template DISKANN_DLLEXPORT int build_merged_vamana_index<int8_t, uint32_t>(
     size_t build_pq_bytes, bool use_opq, uint32_t num_threads, const PartitioningAlgorithm partition_algorithm,
     const uint32_t ommega, const float episilon, bool use_filters, const std::string &label_file,
     const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
+template DISKANN_DLLEXPORT int build_merged_vamana_index<float16, uint32_t>(
+    std::string base_file, diskann::Metric _compareMetric, uint32_t L, uint32_t R, double sampling_rate,
+    double ram_budget, std::string mem_index_path, std::string medoids_file, std::string centroids_file,
+    size_t build_pq_bytes, bool use_opq, uint32_t num_threads, const PartitioningAlgorithm partition_algorithm,
+    const uint32_t ommega, const float episilon, bool use_filters, const std::string &label_file,
+    const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
+template DISKANN_DLLEXPORT int build_merged_vamana_index<bfloat16, uint32_t>(
+    std::string base_file, diskann::Metric _compareMetric, uint32_t L, uint32_t R, double sampling_rate,
+    double ram_budget, std::string mem_index_path, std::string medoids_file, std::string centroids_file,
+    size_t build_pq_bytes, bool use_opq, uint32_t num_threads, const PartitioningAlgorithm partition_algorithm,
+    const uint32_t ommega, const float episilon, bool use_filters, const std::string &label_file,
+    const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
 template DISKANN_DLLEXPORT int build_merged_vamana_index<float, uint32_t>(
     std::string base_file, diskann::Metric _compareMetric, uint32_t L, uint32_t R, double sampling_rate,
     double ram_budget, std::string mem_index_path, std::string medoids_file, std::string centroids_file,
@@ -1518,6 +2132,18 @@ template DISKANN_DLLEXPORT int build_merged_vamana_index<int8_t, uint16_t>(
     size_t build_pq_bytes, bool use_opq, uint32_t num_threads, const PartitioningAlgorithm partition_algorithm,
     const uint32_t ommega, const float episilon, bool use_filters, const std::string &label_file,
     const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
+template DISKANN_DLLEXPORT int build_merged_vamana_index<float16, uint16_t>(
+    std::string base_file, diskann::Metric _compareMetric, uint32_t L, uint32_t R, double sampling_rate,
+    double ram_budget, std::string mem_index_path, std::string medoids_file, std::string centroids_file,
+    size_t build_pq_bytes, bool use_opq, uint32_t num_threads, const PartitioningAlgorithm partition_algorithm,
+    const uint32_t ommega, const float episilon, bool use_filters, const std::string &label_file,
+    const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
+template DISKANN_DLLEXPORT int build_merged_vamana_index<bfloat16, uint16_t>(
+    std::string base_file, diskann::Metric _compareMetric, uint32_t L, uint32_t R, double sampling_rate,
+    double ram_budget, std::string mem_index_path, std::string medoids_file, std::string centroids_file,
+    size_t build_pq_bytes, bool use_opq, uint32_t num_threads, const PartitioningAlgorithm partition_algorithm,
+    const uint32_t ommega, const float episilon, bool use_filters, const std::string &label_file,
+    const std::string &labels_to_medoids_file, const std::string &universal_label, const uint32_t Lf);
 template DISKANN_DLLEXPORT int build_merged_vamana_index<float, uint16_t>(
     std::string base_file, diskann::Metric _compareMetric, uint32_t L, uint32_t R, double sampling_rate,
     double ram_budget, std::string mem_index_path, std::string medoids_file, std::string centroids_file,
@@ -61,6 +61,46 @@ template <typename T> size_t Distance<T>::get_required_alignment() const
     return _alignment_factor;
 }
 
+template <typename T>
+void Distance<T>::compare_batch(const T *query, const T *const *bases, uint32_t num_bases, uint32_t length,
+                                float *distances) const
+{
+    for (uint32_t i = 0; i < num_bases; i++)
+    {
+        distances[i] = compare(query, bases[i], length);
+    }
+}
+
+template <typename T> Distance<T> *Distance<T>::specialize(uint32_t length) const
+{
+    return nullptr;
+}
+
+// A kernel computing the distances from a query to the G vectors b[0..G),
+// and prefetching the vectors next[0..G) when next is not null. The kernels
+// take the length DIM as a template parameter too: when it is not 0 they
+// ignore size, and the compiler unrolls their loops with no tail code.
+template <typename T>
+using group_kernel = void (*)(const T *a, const T *const *b, uint32_t size, float *out, const T *const *next);
+
+// compare_batch from a kernel for groups of 4 vectors and one for single
+// vectors: the groups of 4 prefetch the group after them, the 1 to 3 vectors
+// left over are computed one at a time.
+template <typename T, group_kernel<T> kernel4, group_kernel<T> kernel1>
+static void compare_groups(const T *query, const T *const *bases, uint32_t num_bases, uint32_t length,
+                           float *distances)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= num_bases; i += 4)
+    {
+        kernel4(query, bases + i, length, distances + i, i + 8 <= num_bases ? bases + i + 4 : nullptr);
+    }
+    for (; i < num_bases; i++)
+    {
+        kernel1(query, bases + i, length, distances + i, nullptr);
+    }
+}
+
 //
 // Cosine distance functions.
 //
@@ -220,6 +260,47 @@ float DistanceL2Float::compare(const float *a, const float *b, uint32_t size) co
     return result;
 }
 
+#ifdef USE_AVX2
+// DistanceL2Float::compare for the G vectors b[0..G), see compare_groups.
+// Each vector is accumulated in the order of compare, for identical results.
+template <uint32_t G, uint32_t DIM = 0>
+static inline void l2_float_avx2(const float *a, const float *const *b, uint32_t size, float *out,
+                                 const float *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    __m256 sum[G];
+    for (uint32_t g = 0; g < G; g++)
+        sum[g] = _mm256_setzero_ps();
+    for (uint32_t i = 0; i + 8 <= size; i += 8)
+    {
+        __m256 a_vec = _mm256_load_ps(a + i);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m256 tmp_vec = _mm256_sub_ps(a_vec, _mm256_load_ps(b[g] + i));
+            sum[g] = _mm256_fmadd_ps(tmp_vec, tmp_vec, sum[g]);
+        }
+        if (next != nullptr && i % 16 == 0)
+        {
+            for (uint32_t g = 0; g < G; g++)
+                _mm_prefetch((const char *)(next[g] + i), _MM_HINT_T0);
+        }
+    }
+    for (uint32_t g = 0; g < G; g++)
+        out[g] = _mm256_reduce_add_ps(sum[g]);
+}
+#endif
+
+void DistanceL2Float::compare_batch(const float *query, const float *const *bases, uint32_t num_bases,
+                                    uint32_t length, float *distances) const
+{
+#ifdef USE_AVX2
+    compare_groups<float, l2_float_avx2<4>, l2_float_avx2<1>>(query, bases, num_bases, length, distances);
+#else
+    Distance<float>::compare_batch(query, bases, num_bases, length, distances);
+#endif
+}
+
 template <typename T> float SlowDistanceL2<T>::compare(const T *a, const T *b, uint32_t length) const
 {
     float result = 0.0f;
@@ -561,6 +642,83 @@ float AVXDistanceInnerProductFloat::compare(const float *a, const float *b, uint
     return -result;
 }
 
+float AVXNormalizedCosineDistanceFloat::compare(const float *a, const float *b, uint32_t length) const
+{
+    // Inner product returns negative values to indicate distance.
+    // This will ensure that cosine is between -1 and 1.
+    if (Avx512SupportedCPU)
+    {
+        return 1.0f + _avx512InnerProduct.compare(a, b, length);
+    }
+    return 1.0f + _innerProduct.compare(a, b, length);
+}
+
+// AVXDistanceInnerProductFloat::compare for the G vectors b[0..G), see
+// compare_groups. Each vector is accumulated in the order of compare.
+template <uint32_t G, uint32_t DIM = 0>
+static inline void ip_float_avx(const float *a, const float *const *b, uint32_t size, float *out,
+                                const float *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    uint32_t D = (size + 7) & ~7U;
+    uint32_t DR = D % 16;
+    uint32_t DD = D - DR;
+    __m256 sum[G];
+    for (uint32_t g = 0; g < G; g++)
+    {
+        sum[g] = _mm256_setzero_ps();
+        if (DR)
+        {
+            sum[g] = _mm256_add_ps(sum[g], _mm256_mul_ps(_mm256_loadu_ps(a + DD), _mm256_loadu_ps(b[g] + DD)));
+        }
+    }
+    for (uint32_t i = 0; i < DD; i += 16)
+    {
+        __m256 l0 = _mm256_loadu_ps(a + i);
+        __m256 l1 = _mm256_loadu_ps(a + i + 8);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            sum[g] = _mm256_add_ps(sum[g], _mm256_mul_ps(l0, _mm256_loadu_ps(b[g] + i)));
+            sum[g] = _mm256_add_ps(sum[g], _mm256_mul_ps(l1, _mm256_loadu_ps(b[g] + i + 8)));
+        }
+        if (next != nullptr)
+        {
+            for (uint32_t g = 0; g < G; g++)
+                _mm_prefetch((const char *)(next[g] + i), _MM_HINT_T0);
+        }
+    }
+    for (uint32_t g = 0; g < G; g++)
+    {
+        float unpack[8];
+        _mm256_storeu_ps(unpack, sum[g]);
+        out[g] = -(unpack[0] + unpack[1] + unpack[2] + unpack[3] + unpack[4] + unpack[5] + unpack[6] + unpack[7]);
+    }
+}
+
+void AVXDistanceInnerProductFloat::compare_batch(const float *query, const float *const *bases, uint32_t num_bases,
+                                                 uint32_t length, float *distances) const
+{
+    compare_groups<float, ip_float_avx<4>, ip_float_avx<1>>(query, bases, num_bases, length, distances);
+}
+
+void AVXNormalizedCosineDistanceFloat::compare_batch(const float *query, const float *const *bases,
+                                                     uint32_t num_bases, uint32_t length, float *distances) const
+{
+    if (Avx512SupportedCPU)
+    {
+        _avx512InnerProduct.compare_batch(query, bases, num_bases, length, distances);
+    }
+    else
+    {
+        _innerProduct.compare_batch(query, bases, num_bases, length, distances);
+    }
+    for (uint32_t i = 0; i < num_bases; i++)
+    {
+        distances[i] += 1.0f;
+    }
+}
+
 uint32_t AVXNormalizedCosineDistanceFloat::post_normalization_dimension(uint32_t orig_dimension) const
 {
     return orig_dimension;
@@ -595,12 +753,640 @@ void AVXNormalizedCosineDistanceFloat::normalize_and_copy(const float *query_vec
     }
 }
 
+//
+// 16-bit float distances
+//
+#ifdef USE_AVX2
+static inline __m256 load8_as_float(const float16 *p)
+{
+    return _mm256_loadu_ph_ps(p);
+}
+
+static inline __m256 load8_as_float(const bfloat16 *p)
+{
+    return _mm256_loadu_pbh_ps(p);
+}
+#endif
+
+template <typename T> static float l2_half(const T *a, const T *b, uint32_t size)
+{
+    float result = 0;
+    uint32_t i = 0;
+#ifdef USE_AVX2
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    for (; i + 16 <= size; i += 16)
+    {
+        __m256 d0 = _mm256_sub_ps(load8_as_float(a + i), load8_as_float(b + i));
+        __m256 d1 = _mm256_sub_ps(load8_as_float(a + i + 8), load8_as_float(b + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    if (i + 8 <= size)
+    {
+        __m256 d0 = _mm256_sub_ps(load8_as_float(a + i), load8_as_float(b + i));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        i += 8;
+    }
+    result = _mm256_reduce_add_ps(_mm256_add_ps(sum0, sum1));
+#endif
+    for (; i < size; i++)
+    {
+        float diff = (float)a[i] - (float)b[i];
+        result += diff * diff;
+    }
+    return result;
+}
+
+// Returns <a, b>, and the squared norms of a and b if norms is not null.
+template <typename T> static float dot_half(const T *a, const T *b, uint32_t size, float *norms = nullptr)
+{
+    float dot = 0, norm_a = 0, norm_b = 0;
+    uint32_t i = 0;
+#ifdef USE_AVX2
+    __m256 sum_ab = _mm256_setzero_ps();
+    __m256 sum_aa = _mm256_setzero_ps();
+    __m256 sum_bb = _mm256_setzero_ps();
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256 va = load8_as_float(a + i);
+        __m256 vb = load8_as_float(b + i);
+        sum_ab = _mm256_fmadd_ps(va, vb, sum_ab);
+        if (norms != nullptr)
+        {
+            sum_aa = _mm256_fmadd_ps(va, va, sum_aa);
+            sum_bb = _mm256_fmadd_ps(vb, vb, sum_bb);
+        }
+    }
+    dot = _mm256_reduce_add_ps(sum_ab);
+    norm_a = _mm256_reduce_add_ps(sum_aa);
+    norm_b = _mm256_reduce_add_ps(sum_bb);
+#endif
+    for (; i < size; i++)
+    {
+        float x = a[i], y = b[i];
+        dot += x * y;
+        norm_a += x * x;
+        norm_b += y * y;
+    }
+    if (norms != nullptr)
+    {
+        norms[0] = norm_a;
+        norms[1] = norm_b;
+    }
+    return dot;
+}
+
+template <typename T> static float cosine_half(const T *a, const T *b, uint32_t size)
+{
+    float norms[2];
+    float dot = dot_half(a, b, size, norms);
+    if (norms[0] == 0 || norms[1] == 0)
+    {
+        return 1.0f;
+    }
+    return 1.0f - dot / (std::sqrt(norms[0]) * std::sqrt(norms[1]));
+}
+
+float DistanceL2Float16::compare(const float16 *a, const float16 *b, uint32_t length) const
+{
+    return l2_half(a, b, length);
+}
+
+float DistanceInnerProductFloat16::compare(const float16 *a, const float16 *b, uint32_t length) const
+{
+    return -dot_half(a, b, length);
+}
+
+float DistanceCosineFloat16::compare(const float16 *a, const float16 *b, uint32_t length) const
+{
+    return cosine_half(a, b, length);
+}
+
+float DistanceL2BFloat16::compare(const bfloat16 *a, const bfloat16 *b, uint32_t length) const
+{
+    return l2_half(a, b, length);
+}
+
+float DistanceInnerProductBFloat16::compare(const bfloat16 *a, const bfloat16 *b, uint32_t length) const
+{
+    return -dot_half(a, b, length);
+}
+
+float DistanceCosineBFloat16::compare(const bfloat16 *a, const bfloat16 *b, uint32_t length) const
+{
+    return cosine_half(a, b, length);
+}
+
+//
+// AVX-512 distances. The kernels are compiled for AVX-512 whatever the target
+// of the build, and must only be called when Avx512SupportedCPU is set.
+//
+#ifdef _WINDOWS
+#define AVX512_TARGET
+#else
+#define AVX512_TARGET __attribute__((target("avx512f,avx512bw,avx512vl,avx512vnni")))
+#endif
+
+// Mask of the first min(n, 16) or min(n, 32) lanes.
+static inline __mmask16 avx512_mask16(uint32_t n)
+{
+    return n >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << n) - 1);
+}
+
+static inline __mmask32 avx512_mask32(uint32_t n)
+{
+    return n >= 32 ? (__mmask32)0xffffffff : (__mmask32)((1u << n) - 1);
+}
+
+// Loads the lanes of mask out of 16 consecutive elements as floats, zeroing
+// the others.
+AVX512_TARGET static inline __m512 load16_as_float(const float *p, __mmask16 mask)
+{
+    return _mm512_maskz_loadu_ps(mask, p);
+}
+
+AVX512_TARGET static inline __m512 load16_as_float(const float16 *p, __mmask16 mask)
+{
+    return _mm512_cvtph_ps(_mm256_maskz_loadu_epi16(mask, p));
+}
+
+AVX512_TARGET static inline __m512 load16_as_float(const bfloat16 *p, __mmask16 mask)
+{
+    __m512i wide = _mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(mask, p));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(wide, 16));
+}
+
+// Loads the lanes of mask out of 32 consecutive bytes as 16-bit integers.
+AVX512_TARGET static inline __m512i load32_as_epi16(const int8_t *p, __mmask32 mask)
+{
+    return _mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, p));
+}
+
+AVX512_TARGET static inline __m512i load32_as_epi16(const uint8_t *p, __mmask32 mask)
+{
+    return _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, p));
+}
+
+// Prefetches the lines of the elements [i, i + count) of the vectors
+// next[0..G), if next is not null.
+template <uint32_t G, uint32_t count, typename T>
+static inline void prefetch_group(const T *const *next, uint32_t i)
+{
+    if (next == nullptr)
+        return;
+    for (uint32_t g = 0; g < G; g++)
+    {
+        for (uint32_t offset = 0; offset < count * sizeof(T); offset += 64)
+            _mm_prefetch((const char *)(next[g] + i) + offset, _MM_HINT_T0);
+    }
+}
+
+// The kernels below compute the distances from a to the G vectors b[0..G)
+// together: each chunk of a is loaded once for all of them, and the same
+// chunk of the vectors next[0..G) is prefetched. Each vector is accumulated
+// in the same order whatever G, so compare() (G = 1) and compare_batch()
+// (G = 4) give identical distances.
+template <uint32_t G, typename T, uint32_t DIM = 0>
+AVX512_TARGET static inline void l2_avx512(const T *a, const T *const *b, uint32_t size, float *out,
+                                           const T *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    __m512 sum0[G], sum1[G];
+    for (uint32_t g = 0; g < G; g++)
+        sum0[g] = sum1[g] = _mm512_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m512 a0 = load16_as_float(a + i, 0xffff);
+        __m512 a1 = load16_as_float(a + i + 16, 0xffff);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m512 d0 = _mm512_sub_ps(a0, load16_as_float(b[g] + i, 0xffff));
+            __m512 d1 = _mm512_sub_ps(a1, load16_as_float(b[g] + i + 16, 0xffff));
+            sum0[g] = _mm512_fmadd_ps(d0, d0, sum0[g]);
+            sum1[g] = _mm512_fmadd_ps(d1, d1, sum1[g]);
+        }
+        prefetch_group<G, 32>(next, i);
+    }
+    for (; i < size; i += 16)
+    {
+        __mmask16 mask = avx512_mask16(size - i);
+        __m512 a0 = load16_as_float(a + i, mask);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m512 d0 = _mm512_sub_ps(a0, load16_as_float(b[g] + i, mask));
+            sum0[g] = _mm512_fmadd_ps(d0, d0, sum0[g]);
+        }
+    }
+    for (uint32_t g = 0; g < G; g++)
+        out[g] = _mm512_reduce_add_ps(_mm512_add_ps(sum0[g], sum1[g]));
+}
+
+// Negated inner products.
+template <uint32_t G, typename T, uint32_t DIM = 0>
+AVX512_TARGET static inline void ip_avx512(const T *a, const T *const *b, uint32_t size, float *out,
+                                           const T *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    __m512 sum0[G], sum1[G];
+    for (uint32_t g = 0; g < G; g++)
+        sum0[g] = sum1[g] = _mm512_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m512 a0 = load16_as_float(a + i, 0xffff);
+        __m512 a1 = load16_as_float(a + i + 16, 0xffff);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            sum0[g] = _mm512_fmadd_ps(a0, load16_as_float(b[g] + i, 0xffff), sum0[g]);
+            sum1[g] = _mm512_fmadd_ps(a1, load16_as_float(b[g] + i + 16, 0xffff), sum1[g]);
+        }
+        prefetch_group<G, 32>(next, i);
+    }
+    for (; i < size; i += 16)
+    {
+        __mmask16 mask = avx512_mask16(size - i);
+        __m512 a0 = load16_as_float(a + i, mask);
+        for (uint32_t g = 0; g < G; g++)
+            sum0[g] = _mm512_fmadd_ps(a0, load16_as_float(b[g] + i, mask), sum0[g]);
+    }
+    for (uint32_t g = 0; g < G; g++)
+        out[g] = -_mm512_reduce_add_ps(_mm512_add_ps(sum0[g], sum1[g]));
+}
+
+template <uint32_t G, typename T, uint32_t DIM = 0>
+AVX512_TARGET static inline void cosine_avx512(const T *a, const T *const *b, uint32_t size, float *out,
+                                               const T *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    __m512 sum_aa = _mm512_setzero_ps();
+    __m512 sum_ab[G], sum_bb[G];
+    for (uint32_t g = 0; g < G; g++)
+        sum_ab[g] = sum_bb[g] = _mm512_setzero_ps();
+    for (uint32_t i = 0; i < size; i += 16)
+    {
+        __mmask16 mask = avx512_mask16(size - i);
+        __m512 va = load16_as_float(a + i, mask);
+        sum_aa = _mm512_fmadd_ps(va, va, sum_aa);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m512 vb = load16_as_float(b[g] + i, mask);
+            sum_ab[g] = _mm512_fmadd_ps(va, vb, sum_ab[g]);
+            sum_bb[g] = _mm512_fmadd_ps(vb, vb, sum_bb[g]);
+        }
+        prefetch_group<G, 16>(next, i);
+    }
+    float norm_a = _mm512_reduce_add_ps(sum_aa);
+    for (uint32_t g = 0; g < G; g++)
+    {
+        float norm_b = _mm512_reduce_add_ps(sum_bb[g]);
+        out[g] = (norm_a == 0 || norm_b == 0)
+                     ? 1.0f
+                     : 1.0f - _mm512_reduce_add_ps(sum_ab[g]) / (std::sqrt(norm_a) * std::sqrt(norm_b));
+    }
+}
+
+// The byte kernels: differences and products of 16-bit lanes summed in pairs
+// into 32-bit lanes by vpdpwssd.
+template <uint32_t G, typename T, uint32_t DIM = 0>
+AVX512_TARGET static inline void l2_bytes_avx512(const T *a, const T *const *b, uint32_t size, float *out,
+                                                 const T *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    __m512i sum0[G], sum1[G];
+    for (uint32_t g = 0; g < G; g++)
+        sum0[g] = sum1[g] = _mm512_setzero_si512();
+    uint32_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        __m512i a0 = load32_as_epi16(a + i, 0xffffffff);
+        __m512i a1 = load32_as_epi16(a + i + 32, 0xffffffff);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m512i d0 = _mm512_sub_epi16(a0, load32_as_epi16(b[g] + i, 0xffffffff));
+            __m512i d1 = _mm512_sub_epi16(a1, load32_as_epi16(b[g] + i + 32, 0xffffffff));
+            sum0[g] = _mm512_dpwssd_epi32(sum0[g], d0, d0);
+            sum1[g] = _mm512_dpwssd_epi32(sum1[g], d1, d1);
+        }
+        prefetch_group<G, 64>(next, i);
+    }
+    for (; i < size; i += 32)
+    {
+        __mmask32 mask = avx512_mask32(size - i);
+        __m512i a0 = load32_as_epi16(a + i, mask);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m512i d0 = _mm512_sub_epi16(a0, load32_as_epi16(b[g] + i, mask));
+            sum0[g] = _mm512_dpwssd_epi32(sum0[g], d0, d0);
+        }
+    }
+    for (uint32_t g = 0; g < G; g++)
+        out[g] = (float)_mm512_reduce_add_epi32(_mm512_add_epi32(sum0[g], sum1[g]));
+}
+
+template <uint32_t G, typename T, uint32_t DIM = 0>
+AVX512_TARGET static inline void cosine_bytes_avx512(const T *a, const T *const *b, uint32_t size, float *out,
+                                                     const T *const *next)
+{
+    if (DIM != 0)
+        size = DIM;
+    __m512i sum_aa = _mm512_setzero_si512();
+    __m512i sum_ab[G], sum_bb[G];
+    for (uint32_t g = 0; g < G; g++)
+        sum_ab[g] = sum_bb[g] = _mm512_setzero_si512();
+    for (uint32_t i = 0; i < size; i += 32)
+    {
+        __mmask32 mask = avx512_mask32(size - i);
+        __m512i va = load32_as_epi16(a + i, mask);
+        sum_aa = _mm512_dpwssd_epi32(sum_aa, va, va);
+        for (uint32_t g = 0; g < G; g++)
+        {
+            __m512i vb = load32_as_epi16(b[g] + i, mask);
+            sum_ab[g] = _mm512_dpwssd_epi32(sum_ab[g], va, vb);
+            sum_bb[g] = _mm512_dpwssd_epi32(sum_bb[g], vb, vb);
+        }
+        prefetch_group<G, 32>(next, i);
+    }
+    int32_t norm_a = _mm512_reduce_add_epi32(sum_aa);
+    for (uint32_t g = 0; g < G; g++)
+    {
+        int32_t norm_b = _mm512_reduce_add_epi32(sum_bb[g]);
+        out[g] = (norm_a == 0 || norm_b == 0)
+                     ? 1.0f
+                     : 1.0f - (float)(_mm512_reduce_add_epi32(sum_ab[g]) / (sqrt(norm_a) * sqrt(norm_b)));
+    }
+}
+
+template <typename T> float AVX512DistanceL2<T>::compare(const T *a, const T *b, uint32_t length) const
+{
+    float result;
+    l2_avx512<1>(a, &b, length, &result, (const T *const *)nullptr);
+    return result;
+}
+
+template <> float AVX512DistanceL2<int8_t>::compare(const int8_t *a, const int8_t *b, uint32_t length) const
+{
+    float result;
+    l2_bytes_avx512<1>(a, &b, length, &result, (const int8_t *const *)nullptr);
+    return result;
+}
+
+template <> float AVX512DistanceL2<uint8_t>::compare(const uint8_t *a, const uint8_t *b, uint32_t length) const
+{
+    float result;
+    l2_bytes_avx512<1>(a, &b, length, &result, (const uint8_t *const *)nullptr);
+    return result;
+}
+
+template <typename T>
+void AVX512DistanceL2<T>::compare_batch(const T *query, const T *const *bases, uint32_t num_bases, uint32_t length,
+                                        float *distances) const
+{
+    compare_groups<T, l2_avx512<4, T>, l2_avx512<1, T>>(query, bases, num_bases, length, distances);
+}
+
+template <>
+void AVX512DistanceL2<int8_t>::compare_batch(const int8_t *query, const int8_t *const *bases, uint32_t num_bases,
+                                             uint32_t length, float *distances) const
+{
+    compare_groups<int8_t, l2_bytes_avx512<4, int8_t>, l2_bytes_avx512<1, int8_t>>(query, bases, num_bases, length,
+                                                                                    distances);
+}
+
+template <>
+void AVX512DistanceL2<uint8_t>::compare_batch(const uint8_t *query, const uint8_t *const *bases, uint32_t num_bases,
+                                              uint32_t length, float *distances) const
+{
+    compare_groups<uint8_t, l2_bytes_avx512<4, uint8_t>, l2_bytes_avx512<1, uint8_t>>(query, bases, num_bases,
+                                                                                       length, distances);
+}
+
+template <typename T> float AVX512DistanceInnerProduct<T>::compare(const T *a, const T *b, uint32_t length) const
+{
+    float result;
+    ip_avx512<1>(a, &b, length, &result, (const T *const *)nullptr);
+    return result;
+}
+
+template <typename T>
+void AVX512DistanceInnerProduct<T>::compare_batch(const T *query, const T *const *bases, uint32_t num_bases,
+                                                  uint32_t length, float *distances) const
+{
+    compare_groups<T, ip_avx512<4, T>, ip_avx512<1, T>>(query, bases, num_bases, length, distances);
+}
+
+template <typename T> float AVX512DistanceCosine<T>::compare(const T *a, const T *b, uint32_t length) const
+{
+    float result;
+    cosine_avx512<1>(a, &b, length, &result, (const T *const *)nullptr);
+    return result;
+}
+
+template <> float AVX512DistanceCosine<int8_t>::compare(const int8_t *a, const int8_t *b, uint32_t length) const
+{
+    float result;
+    cosine_bytes_avx512<1>(a, &b, length, &result, (const int8_t *const *)nullptr);
+    return result;
+}
+
+template <> float AVX512DistanceCosine<uint8_t>::compare(const uint8_t *a, const uint8_t *b, uint32_t length) const
+{
+    float result;
+    cosine_bytes_avx512<1>(a, &b, length, &result, (const uint8_t *const *)nullptr);
+    return result;
+}
+
+template <typename T>
+void AVX512DistanceCosine<T>::compare_batch(const T *query, const T *const *bases, uint32_t num_bases,
+                                            uint32_t length, float *distances) const
+{
+    compare_groups<T, cosine_avx512<4, T>, cosine_avx512<1, T>>(query, bases, num_bases, length, distances);
+}
+
+template <>
+void AVX512DistanceCosine<int8_t>::compare_batch(const int8_t *query, const int8_t *const *bases,
+                                                 uint32_t num_bases, uint32_t length, float *distances) const
+{
+    compare_groups<int8_t, cosine_bytes_avx512<4, int8_t>, cosine_bytes_avx512<1, int8_t>>(query, bases, num_bases,
+                                                                                            length, distances);
+}
+
+template <>
+void AVX512DistanceCosine<uint8_t>::compare_batch(const uint8_t *query, const uint8_t *const *bases,
+                                                  uint32_t num_bases, uint32_t length, float *distances) const
+{
+    compare_groups<uint8_t, cosine_bytes_avx512<4, uint8_t>, cosine_bytes_avx512<1, uint8_t>>(
+        query, bases, num_bases, length, distances);
+}
+
+//
+// Fixed length distance functions, see Distance::specialize.
+//
+
+// The lengths with kernels compiled for them: the common embedding dimensions
+// rounded up to the alignment of 8, which takes 100 to 104.
+template <uint32_t... lengths> struct length_list
+{
+};
+using fixed_lengths = length_list<96, 104, 128, 256, 384, 512, 768, 960, 1024, 1536>;
+
+// Base with compare and compare_batch computed by kernel4 and kernel1 (see
+// compare_groups) for vectors of DIM elements, and by Base for the others.
+template <class Base, typename T, uint32_t DIM, group_kernel<T> kernel4, group_kernel<T> kernel1>
+class FixedLengthDistance : public Base
+{
+  public:
+    virtual float compare(const T *a, const T *b, uint32_t length) const override
+    {
+        if (length != DIM)
+            return Base::compare(a, b, length);
+        float result;
+        kernel1(a, &b, DIM, &result, nullptr);
+        return result;
+    }
+
+    virtual void compare_batch(const T *query, const T *const *bases, uint32_t num_bases, uint32_t length,
+                               float *distances) const override
+    {
+        if (length != DIM)
+            Base::compare_batch(query, bases, num_bases, length, distances);
+        else
+            compare_groups<T, kernel4, kernel1>(query, bases, num_bases, DIM, distances);
+    }
+};
+
+// Returns make(std::integral_constant<uint32_t, DIM>()) for the DIM of the
+// list equal to length, nullptr if there is none.
+template <typename T, typename Make> static Distance<T> *make_fixed_length(uint32_t length, Make make, length_list<>)
+{
+    return nullptr;
+}
+
+template <typename T, typename Make, uint32_t DIM, uint32_t... rest>
+static Distance<T> *make_fixed_length(uint32_t length, Make make, length_list<DIM, rest...>)
+{
+    if (length == DIM)
+        return make(std::integral_constant<uint32_t, DIM>());
+    return make_fixed_length<T>(length, make, length_list<rest...>());
+}
+
+// 1 plus the result of the inner product kernel ip, which is the negated dot
+// product: the cosine distance of normalized vectors.
+template <uint32_t G, group_kernel<float> ip>
+static void normalized_cosine(const float *a, const float *const *b, uint32_t size, float *out,
+                              const float *const *next)
+{
+    ip(a, b, size, out, next);
+    for (uint32_t g = 0; g < G; g++)
+    {
+        out[g] = 1.0f + out[g];
+    }
+}
+
+Distance<float> *DistanceL2Float::specialize(uint32_t length) const
+{
+#ifdef USE_AVX2
+    return make_fixed_length<float>(
+        length,
+        [](auto dim) -> Distance<float> * {
+            constexpr uint32_t DIM = decltype(dim)::value;
+            return new FixedLengthDistance<DistanceL2Float, float, DIM, l2_float_avx2<4, DIM>, l2_float_avx2<1, DIM>>();
+        },
+        fixed_lengths());
+#else
+    return nullptr;
+#endif
+}
+
+Distance<float> *AVXDistanceInnerProductFloat::specialize(uint32_t length) const
+{
+    return make_fixed_length<float>(
+        length,
+        [](auto dim) -> Distance<float> * {
+            constexpr uint32_t DIM = decltype(dim)::value;
+            return new FixedLengthDistance<AVXDistanceInnerProductFloat, float, DIM, ip_float_avx<4, DIM>,
+                                           ip_float_avx<1, DIM>>();
+        },
+        fixed_lengths());
+}
+
+Distance<float> *AVXNormalizedCosineDistanceFloat::specialize(uint32_t length) const
+{
+    return make_fixed_length<float>(
+        length,
+        [](auto dim) -> Distance<float> * {
+            constexpr uint32_t DIM = decltype(dim)::value;
+            if (Avx512SupportedCPU)
+                return new FixedLengthDistance<AVXNormalizedCosineDistanceFloat, float, DIM,
+                                               normalized_cosine<4, ip_avx512<4, float, DIM>>,
+                                               normalized_cosine<1, ip_avx512<1, float, DIM>>>();
+            return new FixedLengthDistance<AVXNormalizedCosineDistanceFloat, float, DIM,
+                                           normalized_cosine<4, ip_float_avx<4, DIM>>,
+                                           normalized_cosine<1, ip_float_avx<1, DIM>>>();
+        },
+        fixed_lengths());
+}
+
+template <typename T> Distance<T> *AVX512DistanceL2<T>::specialize(uint32_t length) const
+{
+    return make_fixed_length<T>(
+        length,
+        [](auto dim) -> Distance<T> * {
+            constexpr uint32_t DIM = decltype(dim)::value;
+            if constexpr (std::is_integral<T>::value)
+                return new FixedLengthDistance<AVX512DistanceL2<T>, T, DIM, l2_bytes_avx512<4, T, DIM>,
+                                               l2_bytes_avx512<1, T, DIM>>();
+            else
+                return new FixedLengthDistance<AVX512DistanceL2<T>, T, DIM, l2_avx512<4, T, DIM>,
+                                               l2_avx512<1, T, DIM>>();
+        },
+        fixed_lengths());
+}
+
+template <typename T> Distance<T> *AVX512DistanceInnerProduct<T>::specialize(uint32_t length) const
+{
+    return make_fixed_length<T>(
+        length,
+        [](auto dim) -> Distance<T> * {
+            constexpr uint32_t DIM = decltype(dim)::value;
+            return new FixedLengthDistance<AVX512DistanceInnerProduct<T>, T, DIM, ip_avx512<4, T, DIM>,
+                                           ip_avx512<1, T, DIM>>();
+        },
+        fixed_lengths());
+}
+
+template <typename T> Distance<T> *AVX512DistanceCosine<T>::specialize(uint32_t length) const
+{
+    return make_fixed_length<T>(
+        length,
+        [](auto dim) -> Distance<T> * {
+            constexpr uint32_t DIM = decltype(dim)::value;
+            if constexpr (std::is_integral<T>::value)
+                return new FixedLengthDistance<AVX512DistanceCosine<T>, T, DIM, cosine_bytes_avx512<4, T, DIM>,
+                                               cosine_bytes_avx512<1, T, DIM>>();
+            else
+                return new FixedLengthDistance<AVX512DistanceCosine<T>, T, DIM, cosine_avx512<4, T, DIM>,
+                                               cosine_avx512<1, T, DIM>>();
+        },
+        fixed_lengths());
+}
+
 // Get the right distance function for the given metric.
 template <> diskann::Distance<float> *get_distance_function(diskann::Metric m)
 {
     if (m == diskann::Metric::L2)
     {
-        if (Avx2SupportedCPU)
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "L2: Using AVX-512 distance computation AVX512DistanceL2<float>" << std::endl;
+            return new diskann::AVX512DistanceL2<float>();
+        }
+        else if (Avx2SupportedCPU)
         {
             diskann::cout << "L2: Using AVX2 distance computation DistanceL2Float" << std::endl;
             return new diskann::DistanceL2Float();
@@ -618,11 +1404,22 @@ template <> diskann::Distance<float> *get_distance_function(diskann::Metric m)
     }
     else if (m == diskann::Metric::COSINE)
     {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Cosine: Using AVX-512 implementation AVX512DistanceCosine<float>" << std::endl;
+            return new diskann::AVX512DistanceCosine<float>();
+        }
         diskann::cout << "Cosine: Using either AVX or AVX2 implementation" << std::endl;
         return new diskann::DistanceCosineFloat();
     }
     else if (m == diskann::Metric::INNER_PRODUCT)
     {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Inner product: Using AVX-512 implementation AVX512DistanceInnerProduct<float>"
+                          << std::endl;
+            return new diskann::AVX512DistanceInnerProduct<float>();
+        }
         diskann::cout << "Inner product: Using AVX2 implementation "
                          "AVXDistanceInnerProductFloat"
                       << std::endl;
@@ -650,7 +1447,12 @@ template <> diskann::Distance<int8_t> *get_distance_function(diskann::Metric m)
 {
     if (m == diskann::Metric::L2)
     {
-        if (Avx2SupportedCPU)
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Using AVX-512 distance computation AVX512DistanceL2<int8_t>." << std::endl;
+            return new diskann::AVX512DistanceL2<int8_t>();
+        }
+        else if (Avx2SupportedCPU)
         {
             diskann::cout << "Using AVX2 distance computation DistanceL2Int8." << std::endl;
             return new diskann::DistanceL2Int8();
@@ -670,6 +1472,11 @@ template <> diskann::Distance<int8_t> *get_distance_function(diskann::Metric m)
     }
     else if (m == diskann::Metric::COSINE)
     {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Using AVX-512 for Cosine similarity AVX512DistanceCosine<int8_t>." << std::endl;
+            return new diskann::AVX512DistanceCosine<int8_t>();
+        }
         diskann::cout << "Using either AVX or AVX2 for Cosine similarity "
                          "DistanceCosineInt8."
                       << std::endl;
@@ -688,6 +1495,11 @@ template <> diskann::Distance<uint8_t> *get_distance_function(diskann::Metric m)
 {
     if (m == diskann::Metric::L2)
     {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Using AVX-512 distance computation AVX512DistanceL2<uint8_t>." << std::endl;
+            return new diskann::AVX512DistanceL2<uint8_t>();
+        }
 #ifdef _WINDOWS
         diskann::cout << "WARNING: AVX/AVX2 distance function not defined for Uint8. "
                          "Using "
@@ -699,6 +1511,11 @@ template <> diskann::Distance<uint8_t> *get_distance_function(diskann::Metric m)
     }
     else if (m == diskann::Metric::COSINE)
     {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Using AVX-512 for Cosine similarity AVX512DistanceCosine<uint8_t>." << std::endl;
+            return new diskann::AVX512DistanceCosine<uint8_t>();
+        }
         diskann::cout << "AVX/AVX2 distance function not defined for Uint8. Using "
                          "slow version SlowDistanceCosineUint8() "
                          "Contact gopalsr@microsoft.com if you need AVX/AVX2 support."
@@ -714,20 +1531,130 @@ template <> diskann::Distance<uint8_t> *get_distance_function(diskann::Metric m)
     }
 }
 
+template <> diskann::Distance<float16> *get_distance_function(diskann::Metric m)
+{
+    if (m == diskann::Metric::L2)
+    {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "L2: Using AVX-512 implementation AVX512DistanceL2<float16>" << std::endl;
+            return new diskann::AVX512DistanceL2<float16>();
+        }
+        diskann::cout << "L2: Using either AVX2 or scalar implementation DistanceL2Float16" << std::endl;
+        return new diskann::DistanceL2Float16();
+    }
+    else if (m == diskann::Metric::COSINE)
+    {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Cosine: Using AVX-512 implementation AVX512DistanceCosine<float16>" << std::endl;
+            return new diskann::AVX512DistanceCosine<float16>();
+        }
+        diskann::cout << "Cosine: Using either AVX2 or scalar implementation DistanceCosineFloat16" << std::endl;
+        return new diskann::DistanceCosineFloat16();
+    }
+    else if (m == diskann::Metric::INNER_PRODUCT)
+    {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Inner product: Using AVX-512 implementation AVX512DistanceInnerProduct<float16>"
+                          << std::endl;
+            return new diskann::AVX512DistanceInnerProduct<float16>();
+        }
+        diskann::cout << "Inner product: Using either AVX2 or scalar implementation DistanceInnerProductFloat16"
+                      << std::endl;
+        return new diskann::DistanceInnerProductFloat16();
+    }
+    else
+    {
+        std::stringstream stream;
+        stream << "Only L2, cosine, and inner product supported for float16 vectors." << std::endl;
+        diskann::cerr << stream.str() << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+}
+
+template <> diskann::Distance<bfloat16> *get_distance_function(diskann::Metric m)
+{
+    if (m == diskann::Metric::L2)
+    {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "L2: Using AVX-512 implementation AVX512DistanceL2<bfloat16>" << std::endl;
+            return new diskann::AVX512DistanceL2<bfloat16>();
+        }
+        diskann::cout << "L2: Using either AVX2 or scalar implementation DistanceL2BFloat16" << std::endl;
+        return new diskann::DistanceL2BFloat16();
+    }
+    else if (m == diskann::Metric::COSINE)
+    {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Cosine: Using AVX-512 implementation AVX512DistanceCosine<bfloat16>" << std::endl;
+            return new diskann::AVX512DistanceCosine<bfloat16>();
+        }
+        diskann::cout << "Cosine: Using either AVX2 or scalar implementation DistanceCosineBFloat16" << std::endl;
+        return new diskann::DistanceCosineBFloat16();
+    }
+    else if (m == diskann::Metric::INNER_PRODUCT)
+    {
+        if (Avx512SupportedCPU)
+        {
+            diskann::cout << "Inner product: Using AVX-512 implementation AVX512DistanceInnerProduct<bfloat16>"
+                          << std::endl;
+            return new diskann::AVX512DistanceInnerProduct<bfloat16>();
+        }
+        diskann::cout << "Inner product: Using either AVX2 or scalar implementation DistanceInnerProductBFloat16"
+                      << std::endl;
+        return new diskann::DistanceInnerProductBFloat16();
+    }
+    else
+    {
+        std::stringstream stream;
+        stream << "Only L2, cosine, and inner product supported for bfloat16 vectors." << std::endl;
+        diskann::cerr << stream.str() << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+}
+
 template DISKANN_DLLEXPORT class DistanceInnerProduct<float>;
 template DISKANN_DLLEXPORT class DistanceInnerProduct<int8_t>;
 template DISKANN_DLLEXPORT class DistanceInnerProduct<uint8_t>;
+template DISKANN_DLLEXPORT class DistanceInnerProduct<float16>;
+template DISKANN_DLLEXPORT class DistanceInnerProduct<bfloat16>;
 
 template DISKANN_DLLEXPORT class DistanceFastL2<float>;
 template DISKANN_DLLEXPORT class DistanceFastL2<int8_t>;
 template DISKANN_DLLEXPORT class DistanceFastL2<uint8_t>;
+template DISKANN_DLLEXPORT class DistanceFastL2<float16>;
+template DISKANN_DLLEXPORT class DistanceFastL2<bfloat16>;
 
 template DISKANN_DLLEXPORT class SlowDistanceL2<float>;
 template DISKANN_DLLEXPORT class SlowDistanceL2<int8_t>;
 template DISKANN_DLLEXPORT class SlowDistanceL2<uint8_t>;
+template DISKANN_DLLEXPORT class SlowDistanceL2<float16>;
+template DISKANN_DLLEXPORT class SlowDistanceL2<bfloat16>;
+
+template DISKANN_DLLEXPORT class AVX512DistanceL2<float>;
+template DISKANN_DLLEXPORT class AVX512DistanceL2<int8_t>;
+template DISKANN_DLLEXPORT class AVX512DistanceL2<uint8_t>;
+template DISKANN_DLLEXPORT class AVX512DistanceL2<float16>;
+template DISKANN_DLLEXPORT class AVX512DistanceL2<bfloat16>;
+
+template DISKANN_DLLEXPORT class AVX512DistanceInnerProduct<float>;
+template DISKANN_DLLEXPORT class AVX512DistanceInnerProduct<float16>;
+template DISKANN_DLLEXPORT class AVX512DistanceInnerProduct<bfloat16>;
+
+template DISKANN_DLLEXPORT class AVX512DistanceCosine<float>;
+template DISKANN_DLLEXPORT class AVX512DistanceCosine<int8_t>;
+template DISKANN_DLLEXPORT class AVX512DistanceCosine<uint8_t>;
+template DISKANN_DLLEXPORT class AVX512DistanceCosine<float16>;
+template DISKANN_DLLEXPORT class AVX512DistanceCosine<bfloat16>;
 
 template DISKANN_DLLEXPORT Distance<float> *get_distance_function(Metric m);
 template DISKANN_DLLEXPORT Distance<int8_t> *get_distance_function(Metric m);
 template DISKANN_DLLEXPORT Distance<uint8_t> *get_distance_function(Metric m);
+template DISKANN_DLLEXPORT Distance<float16> *get_distance_function(Metric m);
+template DISKANN_DLLEXPORT Distance<bfloat16> *get_distance_function(Metric m);
 
 } // namespace diskann
@@ -16,6 +16,12 @@ InMemDataStore<data_t>::InMemDataStore(const location_t num_points, const size_t
     : AbstractDataStore<data_t>(num_points, dim), _distance_fn(std::move(distance_fn))
 {
     _aligned_dim = ROUND_UP(dim, _distance_fn->get_required_alignment());
+    // all distances are computed over _aligned_dim elements
+    Distance<data_t> *fixed_length_fn = _distance_fn->specialize((uint32_t)_aligned_dim);
+    if (fixed_length_fn != nullptr)
+    {
+        _distance_fn.reset(fixed_length_fn);
+    }
     alloc_aligned(((void **)&_data), this->_capacity * _aligned_dim * sizeof(data_t), 8 * sizeof(data_t));
     std::memset(_data, 0, this->_capacity * _aligned_dim * sizeof(data_t));
 }
@@ -205,9 +211,18 @@ void InMemDataStore<data_t>::get_distance(const data_t *query, const location_t
                                           const uint32_t location_count, float *distances,
                                           AbstractScratch<data_t> *scratch_space) const
 {
-    for (location_t i = 0; i < location_count; i++)
+    // hand the vectors to the distance function in batches, whose addresses
+    // fit on the stack
+    const uint32_t batch_size = 64;
+    const data_t *bases[batch_size];
+    for (uint32_t start = 0; start < location_count; start += batch_size)
     {
-        distances[i] = _distance_fn->compare(query, _data + locations[i] * _aligned_dim, (uint32_t)this->_aligned_dim);
+        const uint32_t count = std::min(batch_size, location_count - start);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            bases[i] = _data + (size_t)locations[start + i] * _aligned_dim;
+        }
+        _distance_fn->compare_batch(query, bases, count, (uint32_t)this->_aligned_dim, distances + start);
     }
 }
 
@@ -222,11 +237,7 @@ template <typename data_t>
 void InMemDataStore<data_t>::get_distance(const data_t *preprocessed_query, const std::vector<location_t> &ids,
                                           std::vector<float> &distances, AbstractScratch<data_t> *scratch_space) const
 {
-    for (int i = 0; i < ids.size(); i++)
-    {
-        distances[i] =
-            _distance_fn->compare(preprocessed_query, _data + ids[i] * _aligned_dim, (uint32_t)this->_aligned_dim);
-    }
+    get_distance(preprocessed_query, ids.data(), (uint32_t)ids.size(), distances.data(), scratch_space);
 }
 
 template <typename data_t> location_t InMemDataStore<data_t>::expand(const location_t new_size)
@@ -396,6 +407,8 @@ template <typename data_t> Distance<data_t> *InMemDataStore<data_t>::get_dist_fn
 
 template DISKANN_DLLEXPORT class InMemDataStore<float>;
 template DISKANN_DLLEXPORT class InMemDataStore<int8_t>;
+template DISKANN_DLLEXPORT class InMemDataStore<float16>;
+template DISKANN_DLLEXPORT class InMemDataStore<bfloat16>;
 template DISKANN_DLLEXPORT class InMemDataStore<uint8_t>;
 
 } // namespace diskann
\ No newline at end of file
@@ -37,7 +37,9 @@ Index<T, TagT, LabelT>::Index(const IndexConfig &index_config, std::shared_ptr<A
       _num_frozen_pts(index_config.num_frozen_pts), _dynamic_index(index_config.dynamic_index),
       _enable_tags(index_config.enable_tags), _indexingMaxC(DEFAULT_MAXC), _query_scratch(nullptr),
       _pq_dist(index_config.pq_dist_build), _use_opq(index_config.use_opq),
-      _filtered_index(index_config.filtered_index), _num_pq_chunks(index_config.num_pq_chunks),
+      _filtered_index(index_config.filtered_index), _full_precision_rerank(index_config.full_precision_rerank),
+      _rabitq_dist(index_config.data_strategy == DataStoreStrategy::MEMORY_RABITQ),
+      _num_pq_chunks(index_config.num_pq_chunks),
       _delete_set(new tsl::robin_set<uint32_t>), _conc_consolidate(index_config.concurrent_consolidate)
 {
     if (_dynamic_index && !_enable_tags)
@@ -188,7 +190,7 @@ void Index<T, TagT, LabelT>::initialize_query_scratch(uint32_t num_threads, uint
     for (uint32_t i = 0; i < num_threads; i++)
     {
         auto scratch = new InMemQueryScratch<T>(search_l, indexing_l, r, maxc, dim, _data_store->get_aligned_dim(),
-                                                _data_store->get_alignment_factor(), _pq_dist);
+                                                _data_store->get_alignment_factor(), _pq_dist || _rabitq_dist);
         _query_scratch.push(scratch);
     }
 }
@@ -496,6 +498,8 @@ size_t Index<T, TagT, LabelT>::load_data(std::string filename)
     copy_aligned_data_from_file<T>(reader, _data, file_num_points, file_dim, _data_store->get_aligned_dim());
 #else
     _data_store->load(filename); // offset == 0.
+    if (_full_precision_rerank)
+        _pq_data_store->populate_data(filename, 0U);
 #endif
     return file_num_points;
 }
@@ -987,6 +991,32 @@ std::pair<uint32_t, uint32_t> Index<T, TagT, LabelT>::iterate_to_fixed_point(
             best_L_nodes.insert(Neighbor(id_scratch[m], dist_scratch[m]));
         }
     }
+
+    // The traversal ran on quantized vectors, re-rank the final candidates
+    // with their full precision distances.
+    if (search_invocation && _full_precision_rerank)
+    {
+        expanded_nodes.clear();
+        id_scratch.clear();
+        for (size_t i = 0; i < best_L_nodes.size(); i++)
+        {
+            _data_store->prefetch_vector(best_L_nodes[i].id);
+            id_scratch.push_back(best_L_nodes[i].id);
+        }
+        dist_scratch.resize(id_scratch.size());
+        _data_store->get_distance(aligned_query, id_scratch.data(), (uint32_t)id_scratch.size(), dist_scratch.data(),
+                                  scratch);
+        for (size_t i = 0; i < id_scratch.size(); i++)
+        {
+            expanded_nodes.emplace_back(id_scratch[i], dist_scratch[i]);
+        }
+        best_L_nodes.clear();
+        for (auto &nbr : expanded_nodes)
+        {
+            best_L_nodes.insert(nbr);
+        }
+        expanded_nodes.clear();
+    }
     return std::make_pair(hops, cmps);
 }
 
@@ -1185,7 +1215,7 @@ void Index<T, TagT, LabelT>::prune_neighbors(const uint32_t location, std::vecto
 
     // If using _pq_build, over-write the PQ distances with actual distances
     // REFACTOR PQ: TODO: How to get rid of this!?
-    if (_pq_dist)
+    if (_pq_dist || _full_precision_rerank)
     {
         for (auto &ngh : pool)
             ngh.distance = _data_store->get_distance(ngh.id, location);
@@ -1610,6 +1640,8 @@ void Index<T, TagT, LabelT>::build(const T *data, const size_t num_points_to_loa
         _nd = num_points_to_load;
 
         _data_store->populate_data(data, (location_t)num_points_to_load);
+        if (_full_precision_rerank)
+            _pq_data_store->populate_data(data, (location_t)num_points_to_load);
     }
 
     build_with_data_populated(tags);
@@ -1692,6 +1724,8 @@ void Index<T, TagT, LabelT>::build(const char *filename, const size_t num_points
     }
 
     _data_store->populate_data(filename, 0U);
+    if (_full_precision_rerank)
+        _pq_data_store->populate_data(filename, 0U);
     diskann::cout << "Using only first " << num_points_to_load << " from file.. " << std::endl;
 
     {
@@ -2276,6 +2310,8 @@ template <typename T, typename TagT, typename LabelT> void Index<T, TagT, LabelT
     else
     {
         _data_store->copy_vectors((location_t)res, (location_t)_max_points, 1);
+        if (_full_precision_rerank)
+            _pq_data_store->copy_vectors((location_t)res, (location_t)_max_points, 1);
     }
     _frozen_pts_used++;
 }
@@ -3339,34 +3375,54 @@ template <typename T, typename TagT, typename LabelT> const float Index<T, TagT,
 // EXPORTS
 template DISKANN_DLLEXPORT class Index<float, int32_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, int32_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<float16, int32_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, int32_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, int32_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<float, uint32_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, uint32_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<float16, uint32_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, uint32_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, uint32_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<float, int64_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, int64_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<float16, int64_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, int64_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, int64_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<float, uint64_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, uint64_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<float16, uint64_t, uint32_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, uint64_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, uint64_t, uint32_t>;
 template DISKANN_DLLEXPORT class Index<float, tag_uint128, uint32_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, tag_uint128, uint32_t>;
+template DISKANN_DLLEXPORT class Index<float16, tag_uint128, uint32_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, tag_uint128, uint32_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, tag_uint128, uint32_t>;
 // Label with short int 2 byte
 template DISKANN_DLLEXPORT class Index<float, int32_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, int32_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<float16, int32_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, int32_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, int32_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<float, uint32_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, uint32_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<float16, uint32_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, uint32_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, uint32_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<float, int64_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, int64_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<float16, int64_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, int64_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, int64_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<float, uint64_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, uint64_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<float16, uint64_t, uint16_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, uint64_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, uint64_t, uint16_t>;
 template DISKANN_DLLEXPORT class Index<float, tag_uint128, uint16_t>;
 template DISKANN_DLLEXPORT class Index<int8_t, tag_uint128, uint16_t>;
+template DISKANN_DLLEXPORT class Index<float16, tag_uint128, uint16_t>;
+template DISKANN_DLLEXPORT class Index<bfloat16, tag_uint128, uint16_t>;
 template DISKANN_DLLEXPORT class Index<uint8_t, tag_uint128, uint16_t>;
 
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint64_t, uint32_t>::search<uint64_t>(
@@ -3379,8 +3435,16 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint64_t
     const uint8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint32_t>::search<uint64_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint32_t>::search<uint64_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint32_t>::search<uint64_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint32_t>::search<uint32_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint32_t>::search<uint32_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint32_t>::search<uint32_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 // TagT==uint32_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint32_t, uint32_t>::search<uint64_t>(
     const float *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
@@ -3392,8 +3456,16 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint32_t
     const uint8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint32_t>::search<uint64_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint32_t>::search<uint64_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint32_t>::search<uint64_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint32_t>::search<uint32_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint32_t>::search<uint32_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint32_t>::search<uint32_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint64_t, uint32_t>::search_with_filters<
     uint64_t>(const float *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
@@ -3410,9 +3482,21 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint64_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint32_t>::search_with_filters<
     uint64_t>(const int8_t *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint32_t>::search_with_filters<
+    uint64_t>(const float16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint32_t>::search_with_filters<
+    uint64_t>(const bfloat16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint32_t>::search_with_filters<
     uint32_t>(const int8_t *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint32_t>::search_with_filters<
+    uint32_t>(const float16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint32_t>::search_with_filters<
+    uint32_t>(const bfloat16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
 // TagT==uint32_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint32_t, uint32_t>::search_with_filters<
     uint64_t>(const float *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
@@ -3429,9 +3513,21 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint32_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint32_t>::search_with_filters<
     uint64_t>(const int8_t *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint32_t>::search_with_filters<
+    uint64_t>(const float16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint32_t>::search_with_filters<
+    uint64_t>(const bfloat16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint32_t>::search_with_filters<
     uint32_t>(const int8_t *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint32_t>::search_with_filters<
+    uint32_t>(const float16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint32_t>::search_with_filters<
+    uint32_t>(const bfloat16 *query, const uint32_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
 
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint64_t, uint16_t>::search<uint64_t>(
     const float *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
@@ -3443,8 +3539,16 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint64_t
     const uint8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint16_t>::search<uint64_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint16_t>::search<uint64_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint16_t>::search<uint64_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint16_t>::search<uint32_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint16_t>::search<uint32_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint16_t>::search<uint32_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 // TagT==uint32_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint32_t, uint16_t>::search<uint64_t>(
     const float *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
@@ -3456,8 +3560,16 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint32_t
     const uint8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint16_t>::search<uint64_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint16_t>::search<uint64_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint16_t>::search<uint64_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint64_t *indices, float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint16_t>::search<uint32_t>(
     const int8_t *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint16_t>::search<uint32_t>(
+    const float16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint16_t>::search<uint32_t>(
+    const bfloat16 *query, const size_t K, const uint32_t L, uint32_t *indices, float *distances);
 
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint64_t, uint16_t>::search_with_filters<
     uint64_t>(const float *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
@@ -3474,9 +3586,21 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint64_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint16_t>::search_with_filters<
     uint64_t>(const int8_t *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint16_t>::search_with_filters<
+    uint64_t>(const float16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint16_t>::search_with_filters<
+    uint64_t>(const bfloat16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint64_t, uint16_t>::search_with_filters<
     uint32_t>(const int8_t *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint64_t, uint16_t>::search_with_filters<
+    uint32_t>(const float16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint64_t, uint16_t>::search_with_filters<
+    uint32_t>(const bfloat16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
 // TagT==uint32_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float, uint32_t, uint16_t>::search_with_filters<
     uint64_t>(const float *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
@@ -3493,8 +3617,20 @@ template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<uint8_t, uint32_t
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint16_t>::search_with_filters<
     uint64_t>(const int8_t *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint16_t>::search_with_filters<
+    uint64_t>(const float16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint16_t>::search_with_filters<
+    uint64_t>(const bfloat16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint64_t *indices,
+              float *distances);
 template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<int8_t, uint32_t, uint16_t>::search_with_filters<
     uint32_t>(const int8_t *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
               float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<float16, uint32_t, uint16_t>::search_with_filters<
+    uint32_t>(const float16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
+template DISKANN_DLLEXPORT std::pair<uint32_t, uint32_t> Index<bfloat16, uint32_t, uint16_t>::search_with_filters<
+    uint32_t>(const bfloat16 *query, const uint16_t &filter_label, const size_t K, const uint32_t L, uint32_t *indices,
+              float *distances);
 
 } // namespace diskann
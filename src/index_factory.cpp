@@ -34,10 +34,32 @@ void IndexFactory::check_config()
                                -1, __FUNCSIG__, __FILE__, __LINE__);
     }
 
-    if (_config->data_type != "float" && _config->data_type != "uint8" && _config->data_type != "int8")
+    if (_config->data_strategy == DataStoreStrategy::MEMORY_SQ8 ||
+        _config->data_strategy == DataStoreStrategy::MEMORY_SQ4 ||
+        _config->data_strategy == DataStoreStrategy::MEMORY_RABITQ)
+    {
+        if (_config->pq_dist_build)
+            throw ANNException("ERROR: PQ distance based index construction can not be combined with a "
+                               "quantized data store",
+                               -1, __FUNCSIG__, __FILE__, __LINE__);
+        if (_config->dynamic_index)
+            throw ANNException("ERROR: Dynamic Indexing not supported with a quantized data store", -1,
+                               __FUNCSIG__, __FILE__, __LINE__);
+        if (_config->data_strategy == DataStoreStrategy::MEMORY_RABITQ && _config->metric != diskann::Metric::L2)
+            throw ANNException("ERROR: RaBitQ data store supports only the L2 metric", -1, __FUNCSIG__, __FILE__,
+                               __LINE__);
+    }
+    else if (_config->full_precision_rerank)
+    {
+        throw ANNException("ERROR: Full precision re-ranking requires a quantized data store", -1, __FUNCSIG__,
+                           __FILE__, __LINE__);
+    }
+
+    if (_config->data_type != "float" && _config->data_type != "uint8" && _config->data_type != "int8" &&
+        _config->data_type != "float16" && _config->data_type != "bfloat16")
     {
         throw ANNException("ERROR: invalid data type : + " + _config->data_type +
-                               " is not supported. please select from [float, int8, uint8]",
+                               " is not supported. please select from [float, int8, uint8, float16, bfloat16]",
                            -1);
     }
 
@@ -74,6 +96,16 @@ std::shared_ptr<AbstractDataStore<T>> IndexFactory::construct_datastore(DataStor
         distance.reset(construct_inmem_distance_fn<T>(metric));
         return std::make_shared<diskann::InMemDataStore<T>>((location_t)total_internal_points, dimension,
                                                             std::move(distance));
+    case DataStoreStrategy::MEMORY_SQ8:
+    case DataStoreStrategy::MEMORY_SQ4:
+        distance.reset(construct_inmem_distance_fn<T>(metric));
+        return std::make_shared<diskann::SQDataStore<T>>((location_t)total_internal_points, dimension,
+                                                         strategy == DataStoreStrategy::MEMORY_SQ8 ? 8 : 4,
+                                                         std::move(distance));
+    case DataStoreStrategy::MEMORY_RABITQ:
+        distance.reset(construct_inmem_distance_fn<T>(metric));
+        return std::make_shared<diskann::RaBitQDataStore<T>>((location_t)total_internal_points, dimension,
+                                                             std::move(distance));
     default:
         break;
     }
@@ -96,12 +128,12 @@ std::unique_ptr<AbstractGraphStore> IndexFactory::construct_graphstore(const Gra
 template <typename T>
 std::shared_ptr<PQDataStore<T>> IndexFactory::construct_pq_datastore(DataStoreStrategy strategy, size_t num_points,
                                                                      size_t dimension, Metric m, size_t num_pq_chunks,
-                                                                     bool use_opq)
+                                                                     bool use_opq, uint32_t num_pq_bits)
 {
     std::unique_ptr<Distance<T>> distance_fn;
     std::unique_ptr<QuantizedDistance<T>> quantized_distance_fn;
 
-    quantized_distance_fn = std::move(std::make_unique<PQL2Distance<T>>((uint32_t)num_pq_chunks, use_opq));
+    quantized_distance_fn = std::move(std::make_unique<PQL2Distance<T>>((uint32_t)num_pq_chunks, use_opq, 1u << num_pq_bits));
     switch (strategy)
     {
     case DataStoreStrategy::MEMORY:
@@ -121,18 +153,30 @@ std::unique_ptr<AbstractIndex> IndexFactory::create_instance()
     size_t num_points = _config->max_points + _config->num_frozen_pts;
     size_t dim = _config->dimension;
     // auto graph_store = construct_graphstore(_config->graph_strategy, num_points);
-    auto data_store = construct_datastore<data_type>(_config->data_strategy, num_points, dim, _config->metric);
+    std::shared_ptr<AbstractDataStore<data_type>> data_store = nullptr;
     std::shared_ptr<AbstractDataStore<data_type>> pq_data_store = nullptr;
 
-    if (_config->data_strategy == DataStoreStrategy::MEMORY && _config->pq_dist_build)
+    if (_config->full_precision_rerank)
     {
-        pq_data_store =
-            construct_pq_datastore<data_type>(_config->data_strategy, num_points + _config->num_frozen_pts, dim,
-                                              _config->metric, _config->num_pq_chunks, _config->use_opq);
+        // search and build navigate on the quantized vectors, the full
+        // precision ones are only used to prune and re-rank
+        data_store = construct_datastore<data_type>(DataStoreStrategy::MEMORY, num_points, dim, _config->metric);
+        pq_data_store = construct_datastore<data_type>(_config->data_strategy, num_points, dim, _config->metric);
     }
     else
     {
-        pq_data_store = data_store;
+        data_store = construct_datastore<data_type>(_config->data_strategy, num_points, dim, _config->metric);
+        if (_config->data_strategy == DataStoreStrategy::MEMORY && _config->pq_dist_build)
+        {
+            pq_data_store =
+                construct_pq_datastore<data_type>(_config->data_strategy, num_points + _config->num_frozen_pts, dim,
+                                                  _config->metric, _config->num_pq_chunks, _config->use_opq,
+                                                  _config->num_pq_bits);
+        }
+        else
+        {
+            pq_data_store = data_store;
+        }
     }
     size_t max_reserve_degree =
         (size_t)(defaults::GRAPH_SLACK_FACTOR * 1.05 *
@@ -161,8 +205,16 @@ std::unique_ptr<AbstractIndex> IndexFactory::create_instance(const std::string &
     {
         return create_instance<int8_t>(tag_type, label_type);
     }
+    else if (data_type == std::string("float16"))
+    {
+        return create_instance<float16>(tag_type, label_type);
+    }
+    else if (data_type == std::string("bfloat16"))
+    {
+        return create_instance<bfloat16>(tag_type, label_type);
+    }
     else
-        throw ANNException("Error: unsupported data_type please choose from [float/int8/uint8]", -1);
+        throw ANNException("Error: unsupported data_type please choose from [float/int8/uint8/float16/bfloat16]", -1);
 }
 
 template <typename data_type>
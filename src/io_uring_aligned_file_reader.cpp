@@ -0,0 +1,447 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "io_uring_aligned_file_reader.h"
+
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "tsl/robin_map.h"
+#include "defaults.h"
+#include "utils.h"
+#define URING_QUEUE_DEPTH 256
+
+IoUringAlignedFileReader::IoUringAlignedFileReader(bool use_sqpoll, uint32_t sqpoll_idle_ms)
+    : use_sqpoll(use_sqpoll), sqpoll_idle_ms(sqpoll_idle_ms)
+{
+    this->file_desc = -1;
+}
+
+IoUringAlignedFileReader::~IoUringAlignedFileReader()
+{
+    deregister_all_threads();
+
+    int64_t ret;
+    // check to make sure file_desc is closed
+    ret = ::fcntl(this->file_desc, F_GETFD);
+    if (ret == -1)
+    {
+        if (errno != EBADF)
+        {
+            std::cerr << "close() not called" << std::endl;
+            // close file desc
+            ret = ::close(this->file_desc);
+            // error checks
+            if (ret == -1)
+            {
+                std::cerr << "close() failed; returned " << ret << ", errno=" << errno << ":" << ::strerror(errno)
+                          << std::endl;
+            }
+        }
+    }
+}
+
+IOContext &IoUringAlignedFileReader::get_ctx()
+{
+    std::unique_lock<std::mutex> lk(ctx_mut);
+    // perform checks only in DEBUG mode
+    if (ctx_map.find(std::this_thread::get_id()) == ctx_map.end())
+    {
+        std::cerr << "bad thread access; returning -1 as io_context_t" << std::endl;
+        return this->bad_ctx;
+    }
+    else
+    {
+        return ctx_map[std::this_thread::get_id()];
+    }
+}
+
+void IoUringAlignedFileReader::register_thread()
+{
+    auto my_id = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lk(ctx_mut);
+    if (ctx_map.find(my_id) != ctx_map.end())
+    {
+        std::cerr << "multiple calls to register_thread from the same thread" << std::endl;
+        return;
+    }
+
+    std::unique_ptr<RingContext> ring_ctx(new RingContext());
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    if (use_sqpoll)
+    {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = sqpoll_idle_ms;
+    }
+
+    int ret = io_uring_queue_init_params(URING_QUEUE_DEPTH, &ring_ctx->ring, &params);
+    if (ret != 0)
+    {
+        lk.unlock();
+        std::stringstream stream;
+        if (ret == -EPERM && use_sqpoll)
+        {
+            stream << "io_uring_queue_init_params() failed with EPERM: SQPOLL needs CAP_SYS_NICE on older kernels";
+        }
+        else
+        {
+            stream << "io_uring_queue_init_params() failed; returned " << ret << ": " << ::strerror(-ret);
+        }
+        throw diskann::ANNException(stream.str(), ret, __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    // register the index file (or its stripes, in order) so that requests can
+    // refer to it by slot instead of the kernel looking up the fd on every read
+    if (this->stripe_descs.empty())
+        ret = io_uring_register_files(&ring_ctx->ring, &this->file_desc, 1);
+    else
+        ret = io_uring_register_files(&ring_ctx->ring, this->stripe_descs.data(),
+                                      (unsigned)this->stripe_descs.size());
+    if (ret != 0)
+    {
+        lk.unlock();
+        io_uring_queue_exit(&ring_ctx->ring);
+        throw diskann::ANNException(std::string("io_uring_register_files() failed: ") + ::strerror(-ret), ret,
+                                    __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    io_context_t ctx = reinterpret_cast<io_context_t>(ring_ctx.get());
+    diskann::cout << "allocating io_uring ctx: " << ctx << " to thread-id:" << my_id << std::endl;
+    ctx_map[my_id] = ctx;
+    ring_map[ctx] = std::move(ring_ctx);
+    lk.unlock();
+}
+
+void IoUringAlignedFileReader::destroy_ring(io_context_t ctx)
+{
+    auto iter = ring_map.find(ctx);
+    if (iter == ring_map.end())
+        return;
+
+    RingContext *ring_ctx = iter->second.get();
+    if (ring_ctx->fixed_buf != nullptr)
+        io_uring_unregister_buffers(&ring_ctx->ring);
+    io_uring_unregister_files(&ring_ctx->ring);
+    io_uring_queue_exit(&ring_ctx->ring);
+    ring_map.erase(iter);
+}
+
+void IoUringAlignedFileReader::deregister_thread()
+{
+    auto my_id = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lk(ctx_mut);
+    assert(ctx_map.find(my_id) != ctx_map.end());
+
+    io_context_t ctx = ctx_map[my_id];
+    destroy_ring(ctx);
+    ctx_map.erase(my_id);
+    std::cerr << "returned io_uring ctx from thread-id:" << my_id << std::endl;
+    lk.unlock();
+}
+
+void IoUringAlignedFileReader::deregister_all_threads()
+{
+    std::unique_lock<std::mutex> lk(ctx_mut);
+    for (auto x = ctx_map.begin(); x != ctx_map.end(); x++)
+    {
+        destroy_ring(x.value());
+    }
+    ctx_map.clear();
+}
+
+void IoUringAlignedFileReader::open(const std::string &fname)
+{
+    int flags = O_DIRECT | O_RDONLY | O_LARGEFILE;
+    this->file_desc = ::open(fname.c_str(), flags);
+    // error checks
+    assert(this->file_desc != -1);
+    std::cerr << "Opened file : " << fname << std::endl;
+}
+
+void IoUringAlignedFileReader::open_striped(const std::vector<std::string> &fnames, uint64_t stripe_sectors)
+{
+    if (fnames.empty() || stripe_sectors == 0)
+        throw diskann::ANNException("Striped open needs at least one file and a non-zero stripe unit", -1,
+                                    __FUNCSIG__, __FILE__, __LINE__);
+
+    int flags = O_DIRECT | O_RDONLY | O_LARGEFILE;
+    for (auto &fname : fnames)
+    {
+        FileHandle fd = ::open(fname.c_str(), flags);
+        if (fd == -1)
+        {
+            for (auto open_fd : this->stripe_descs)
+                ::close(open_fd);
+            this->stripe_descs.clear();
+            throw diskann::ANNException("Failed to open stripe " + fname + ": " + ::strerror(errno), -1,
+                                        __FUNCSIG__, __FILE__, __LINE__);
+        }
+        this->stripe_descs.push_back(fd);
+    }
+    this->file_desc = this->stripe_descs[0];
+    this->stripe_len = stripe_sectors * diskann::defaults::SECTOR_LEN;
+    std::cerr << "Opened " << fnames.size() << " stripes of " << stripe_sectors << " sector(s), first: " << fnames[0]
+              << std::endl;
+}
+
+uint32_t IoUringAlignedFileReader::split_read(const AlignedRead &req, std::vector<AlignedRead> &pieces,
+                                              std::vector<uint32_t> &slots)
+{
+    if (this->stripe_descs.empty())
+    {
+        pieces.push_back(req);
+        slots.push_back(0);
+        return 1;
+    }
+
+    uint64_t n_stripes = this->stripe_descs.size();
+    uint64_t offset = req.offset, left = req.len;
+    char *buf = (char *)req.buf;
+    uint32_t n_pieces = 0;
+    while (left > 0)
+    {
+        uint64_t unit = offset / this->stripe_len;
+        uint64_t in_unit = offset % this->stripe_len;
+        uint64_t len = (std::min)(left, this->stripe_len - in_unit);
+        pieces.emplace_back((unit / n_stripes) * this->stripe_len + in_unit, len, buf);
+        slots.push_back((uint32_t)(unit % n_stripes));
+        offset += len;
+        buf += len;
+        left -= len;
+        n_pieces++;
+    }
+    return n_pieces;
+}
+
+void IoUringAlignedFileReader::close()
+{
+    if (!this->stripe_descs.empty())
+    {
+        for (auto fd : this->stripe_descs)
+            ::close(fd);
+        this->stripe_descs.clear();
+        this->stripe_len = 0;
+        this->file_desc = -1;
+        return;
+    }
+
+    // check to make sure file_desc is closed
+    ::fcntl(this->file_desc, F_GETFD);
+
+    ::close(this->file_desc);
+}
+
+void IoUringAlignedFileReader::register_buffer(IOContext &ctx, void *buf, uint64_t len)
+{
+    if (ctx == bad_ctx || buf == nullptr)
+        return;
+
+    RingContext *ring_ctx = to_ring(ctx);
+    if (ring_ctx->fixed_buf != nullptr)
+    {
+        // only one fixed buffer per ring; keep the first one
+        return;
+    }
+
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = len;
+    int ret = io_uring_register_buffers(&ring_ctx->ring, &iov, 1);
+    if (ret != 0)
+    {
+        // typically RLIMIT_MEMLOCK; reads still work, just without fixed buffers
+        std::cerr << "io_uring_register_buffers() failed; returned " << ret << ": " << ::strerror(-ret)
+                  << ". Falling back to regular reads." << std::endl;
+        return;
+    }
+    ring_ctx->fixed_buf = (char *)buf;
+    ring_ctx->fixed_buf_len = len;
+}
+
+void IoUringAlignedFileReader::check_ctx(IOContext ctx) const
+{
+    if (ctx == bad_ctx)
+    {
+        throw diskann::ANNException("io_uring reads from a thread without a ring; was register_thread() called?", -1,
+                                    __FUNCSIG__, __FILE__, __LINE__);
+    }
+}
+
+void IoUringAlignedFileReader::prep_read(RingContext *ring_ctx, struct io_uring_sqe *sqe, const AlignedRead &req,
+                                         uint32_t file_slot, uint64_t user_data)
+{
+    // reads into the registered scratch can skip pinning the pages per request
+    char *buf = (char *)req.buf;
+    if (ring_ctx->fixed_buf != nullptr && buf >= ring_ctx->fixed_buf &&
+        buf + req.len <= ring_ctx->fixed_buf + ring_ctx->fixed_buf_len)
+    {
+        io_uring_prep_read_fixed(sqe, (int)file_slot, req.buf, (unsigned)req.len, req.offset, 0);
+    }
+    else
+    {
+        io_uring_prep_read(sqe, (int)file_slot, req.buf, (unsigned)req.len, req.offset);
+    }
+    // file_slot indexes the registered files, not the fd table
+    sqe->flags |= IOSQE_FIXED_FILE;
+    io_uring_sqe_set_data64(sqe, user_data);
+}
+
+void IoUringAlignedFileReader::read(std::vector<AlignedRead> &read_reqs, IOContext &ctx, bool async)
+{
+    if (async == true)
+    {
+        diskann::cout << "Async currently not supported in linux." << std::endl;
+    }
+    assert(this->file_desc != -1);
+    check_ctx(ctx);
+
+    RingContext *ring_ctx = to_ring(ctx);
+    struct io_uring *ring = &ring_ctx->ring;
+
+    // pieces of a striped request go to different files and complete
+    // independently, so they are read as requests of their own
+    std::vector<AlignedRead> pieces;
+    std::vector<uint32_t> slots;
+    pieces.reserve(read_reqs.size());
+    slots.reserve(read_reqs.size());
+    for (auto &req : read_reqs)
+        split_read(req, pieces, slots);
+
+    uint64_t n_reqs = pieces.size();
+    uint64_t n_submitted = 0, n_completed = 0;
+    while (n_completed < n_reqs)
+    {
+        // fill the submission queue with as many requests as it can take
+        while (n_submitted < n_reqs && n_submitted - n_completed < URING_QUEUE_DEPTH)
+        {
+            struct io_uring_sqe *sqe = io_uring_get_sqe(ring);
+            if (sqe == nullptr)
+                break;
+
+            prep_read(ring_ctx, sqe, pieces[n_submitted], slots[n_submitted], n_submitted);
+            n_submitted++;
+        }
+
+        int ret = io_uring_submit_and_wait(ring, 1);
+        if (ret < 0)
+        {
+            std::cerr << "io_uring_submit_and_wait() failed; returned " << ret << ", expected=" << n_submitted
+                      << ", ernno=" << -ret << "=" << ::strerror(-ret) << std::endl;
+            exit(-1);
+        }
+
+        // reap whatever has completed so far
+        struct io_uring_cqe *cqe = nullptr;
+        while (n_completed < n_submitted && io_uring_peek_cqe(ring, &cqe) == 0 && cqe != nullptr)
+        {
+            uint64_t idx = io_uring_cqe_get_data64(cqe);
+            if (cqe->res < 0 || (uint64_t)cqe->res != pieces[idx].len)
+            {
+                std::cerr << "io_uring read failed; returned " << cqe->res << ", expected=" << pieces[idx].len
+                          << ", offset=" << pieces[idx].offset << std::endl;
+                exit(-1);
+            }
+            io_uring_cqe_seen(ring, cqe);
+            n_completed++;
+        }
+    }
+}
+
+void IoUringAlignedFileReader::submit_reads(std::vector<AlignedRead> &read_reqs, IOContext &ctx)
+{
+    assert(this->file_desc != -1);
+    check_ctx(ctx);
+
+    RingContext *ring_ctx = to_ring(ctx);
+    struct io_uring *ring = &ring_ctx->ring;
+
+    // striped reads are submitted as pieces, each carrying the buffer of its
+    // request; get_completed_reads reports the buffer once all are done
+    std::vector<AlignedRead> pieces;
+    std::vector<uint32_t> slots;
+    for (auto &req : read_reqs)
+    {
+        pieces.clear();
+        slots.clear();
+        uint32_t n_pieces = split_read(req, pieces, slots);
+        if (!this->stripe_descs.empty())
+            ring_ctx->pending_pieces[req.buf] = n_pieces;
+        for (uint32_t p = 0; p < n_pieces; p++)
+            queue_read(ring_ctx, pieces[p], slots[p], (uint64_t)req.buf);
+    }
+
+    int ret = io_uring_submit(ring);
+    if (ret < 0)
+    {
+        std::cerr << "io_uring_submit() failed; returned " << ret << ", ernno=" << -ret << "=" << ::strerror(-ret)
+                  << std::endl;
+        exit(-1);
+    }
+}
+
+void IoUringAlignedFileReader::queue_read(RingContext *ring_ctx, const AlignedRead &req, uint32_t file_slot,
+                                          uint64_t user_data)
+{
+    struct io_uring *ring = &ring_ctx->ring;
+    struct io_uring_sqe *sqe = io_uring_get_sqe(ring);
+    while (sqe == nullptr)
+    {
+        // submission queue is full: push what we have and retry. With SQPOLL
+        // the kernel thread may not have consumed the entries yet, so the
+        // queue can still be full right after a submit.
+        int ret = io_uring_submit(ring);
+        if (ret < 0)
+        {
+            std::cerr << "io_uring_submit() failed; returned " << ret << ", ernno=" << -ret << "=" << ::strerror(-ret)
+                      << std::endl;
+            exit(-1);
+        }
+        sqe = io_uring_get_sqe(ring);
+        if (sqe == nullptr)
+            std::this_thread::yield();
+    }
+    prep_read(ring_ctx, sqe, req, file_slot, user_data);
+}
+
+uint64_t IoUringAlignedFileReader::get_completed_reads(IOContext &ctx, uint64_t min_completions,
+                                                       std::vector<void *> &completed_bufs)
+{
+    check_ctx(ctx);
+    RingContext *ring_ctx = to_ring(ctx);
+    struct io_uring *ring = &ring_ctx->ring;
+
+    uint64_t n_reaped = 0;
+    struct io_uring_cqe *cqe = nullptr;
+    while (true)
+    {
+        int ret = n_reaped < min_completions ? io_uring_wait_cqe(ring, &cqe) : io_uring_peek_cqe(ring, &cqe);
+        if (ret == -EAGAIN || (ret == 0 && cqe == nullptr))
+            break;
+        if (ret < 0)
+        {
+            std::cerr << "io_uring_wait_cqe() failed; returned " << ret << ": " << ::strerror(-ret) << std::endl;
+            exit(-1);
+        }
+        if (cqe->res < 0)
+        {
+            std::cerr << "async read failed; returned " << cqe->res << ": " << ::strerror(-cqe->res) << std::endl;
+            exit(-1);
+        }
+        void *buf = (void *)io_uring_cqe_get_data64(cqe);
+        io_uring_cqe_seen(ring, cqe);
+        if (!this->stripe_descs.empty())
+        {
+            // a striped request is done once all of its pieces are
+            auto it = ring_ctx->pending_pieces.find(buf);
+            if (--it.value() > 0)
+                continue;
+            ring_ctx->pending_pieces.erase(it);
+        }
+        completed_bufs.push_back(buf);
+        n_reaped++;
+    }
+    return n_reaped;
+}
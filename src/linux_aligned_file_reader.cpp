@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <iostream>
 #include "tsl/robin_map.h"
+#include "defaults.h"
 #include "utils.h"
 #define MAX_EVENTS 1024
 
@@ -15,7 +16,10 @@ namespace
 typedef struct io_event io_event_t;
 typedef struct iocb iocb_t;
 
-void execute_io(io_context_t ctx, int fd, std::vector<AlignedRead> &read_reqs, uint64_t n_retries = 0)
+// req_fds, if given, holds the file of each request; otherwise all are read
+// from fd
+void execute_io(io_context_t ctx, int fd, std::vector<AlignedRead> &read_reqs, const std::vector<int> *req_fds = nullptr,
+                uint64_t n_retries = 0)
 {
 #ifdef DEBUG
     for (auto &req : read_reqs)
@@ -38,8 +42,9 @@ void execute_io(io_context_t ctx, int fd, std::vector<AlignedRead> &read_reqs, u
         std::vector<struct iocb> cb(n_ops);
         for (uint64_t j = 0; j < n_ops; j++)
         {
-            io_prep_pread(cb.data() + j, fd, read_reqs[j + iter * MAX_EVENTS].buf, read_reqs[j + iter * MAX_EVENTS].len,
-                          read_reqs[j + iter * MAX_EVENTS].offset);
+            int req_fd = req_fds != nullptr ? (*req_fds)[j + iter * MAX_EVENTS] : fd;
+            io_prep_pread(cb.data() + j, req_fd, read_reqs[j + iter * MAX_EVENTS].buf,
+                          read_reqs[j + iter * MAX_EVENTS].len, read_reqs[j + iter * MAX_EVENTS].offset);
         }
 
         // initialize `cbs` using `cb` array
@@ -175,6 +180,8 @@ void LinuxAlignedFileReader::deregister_thread()
     io_destroy(ctx);
     //  assert(ret == 0);
     lk.lock();
+    pending_pieces.erase(ctx);
+    early_completions.erase(ctx);
     ctx_map.erase(my_id);
     std::cerr << "returned ctx from thread-id:" << my_id << std::endl;
     lk.unlock();
@@ -193,6 +200,8 @@ void LinuxAlignedFileReader::deregister_all_threads()
         //  std::cerr << "returned ctx from thread-id:" << my_id << std::endl;
     }
     ctx_map.clear();
+    pending_pieces.clear();
+    early_completions.clear();
     //  lk.unlock();
 }
 
@@ -205,8 +214,66 @@ void LinuxAlignedFileReader::open(const std::string &fname)
     std::cerr << "Opened file : " << fname << std::endl;
 }
 
+void LinuxAlignedFileReader::open_striped(const std::vector<std::string> &fnames, uint64_t stripe_sectors)
+{
+    if (fnames.empty() || stripe_sectors == 0)
+        throw diskann::ANNException("Striped open needs at least one file and a non-zero stripe unit", -1,
+                                    __FUNCSIG__, __FILE__, __LINE__);
+
+    int flags = O_DIRECT | O_RDONLY | O_LARGEFILE;
+    for (auto &fname : fnames)
+    {
+        FileHandle fd = ::open(fname.c_str(), flags);
+        if (fd == -1)
+        {
+            for (auto open_fd : this->stripe_descs)
+                ::close(open_fd);
+            this->stripe_descs.clear();
+            throw diskann::ANNException("Failed to open stripe " + fname + ": " + ::strerror(errno), -1,
+                                        __FUNCSIG__, __FILE__, __LINE__);
+        }
+        this->stripe_descs.push_back(fd);
+    }
+    this->file_desc = this->stripe_descs[0];
+    this->stripe_len = stripe_sectors * diskann::defaults::SECTOR_LEN;
+    std::cerr << "Opened " << fnames.size() << " stripes of " << stripe_sectors << " sector(s), first: " << fnames[0]
+              << std::endl;
+}
+
+uint32_t LinuxAlignedFileReader::split_read(const AlignedRead &req, std::vector<AlignedRead> &pieces,
+                                            std::vector<FileHandle> &fds)
+{
+    uint64_t n_stripes = this->stripe_descs.size();
+    uint64_t offset = req.offset, left = req.len;
+    char *buf = (char *)req.buf;
+    uint32_t n_pieces = 0;
+    while (left > 0)
+    {
+        uint64_t unit = offset / this->stripe_len;
+        uint64_t in_unit = offset % this->stripe_len;
+        uint64_t len = (std::min)(left, this->stripe_len - in_unit);
+        pieces.emplace_back((unit / n_stripes) * this->stripe_len + in_unit, len, buf);
+        fds.push_back(this->stripe_descs[unit % n_stripes]);
+        offset += len;
+        buf += len;
+        left -= len;
+        n_pieces++;
+    }
+    return n_pieces;
+}
+
 void LinuxAlignedFileReader::close()
 {
+    if (!this->stripe_descs.empty())
+    {
+        for (auto fd : this->stripe_descs)
+            ::close(fd);
+        this->stripe_descs.clear();
+        this->stripe_len = 0;
+        this->file_desc = -1;
+        return;
+    }
+
     //  int64_t ret;
 
     // check to make sure file_desc is closed
@@ -224,5 +291,182 @@ void LinuxAlignedFileReader::read(std::vector<AlignedRead> &read_reqs, io_contex
         diskann::cout << "Async currently not supported in linux." << std::endl;
     }
     assert(this->file_desc != -1);
-    execute_io(ctx, this->file_desc, read_reqs);
+    if (this->stripe_descs.empty())
+    {
+        execute_io(ctx, this->file_desc, read_reqs);
+        return;
+    }
+
+    // pieces of one request go to different files and complete independently
+    std::vector<AlignedRead> pieces;
+    std::vector<FileHandle> fds;
+    pieces.reserve(read_reqs.size());
+    fds.reserve(read_reqs.size());
+    for (auto &req : read_reqs)
+        split_read(req, pieces, fds);
+    execute_io(ctx, this->file_desc, pieces, &fds);
+}
+
+void LinuxAlignedFileReader::submit_reads(std::vector<AlignedRead> &read_reqs, io_context_t &ctx)
+{
+    assert(this->file_desc != -1);
+    uint64_t n_ops = read_reqs.size();
+    if (n_ops == 0)
+        return;
+
+    // striped reads are submitted as pieces, each carrying the buffer of its
+    // request; get_completed_reads reports the buffer once all are done
+    std::vector<AlignedRead> pieces;
+    std::vector<FileHandle> fds;
+    std::vector<void *> piece_bufs;
+    if (!this->stripe_descs.empty())
+    {
+        tsl::robin_map<void *, uint32_t> *pending;
+        {
+            std::unique_lock<std::mutex> lk(ctx_mut);
+            auto &entry = pending_pieces[ctx];
+            if (entry == nullptr)
+                entry.reset(new tsl::robin_map<void *, uint32_t>());
+            pending = entry.get();
+        }
+        for (auto &req : read_reqs)
+        {
+            uint32_t n_pieces = split_read(req, pieces, fds);
+            piece_bufs.insert(piece_bufs.end(), n_pieces, req.buf);
+            (*pending)[req.buf] = n_pieces;
+        }
+        n_ops = pieces.size();
+    }
+
+    // the kernel copies the control blocks during io_submit, so they only need
+    // to live until the call returns; `data` carries the target buffer back
+    std::vector<iocb_t> cb(n_ops);
+    std::vector<iocb_t *> cbs(n_ops, nullptr);
+    for (uint64_t j = 0; j < n_ops; j++)
+    {
+        if (this->stripe_descs.empty())
+        {
+            io_prep_pread(cb.data() + j, this->file_desc, read_reqs[j].buf, read_reqs[j].len, read_reqs[j].offset);
+            cb[j].data = read_reqs[j].buf;
+        }
+        else
+        {
+            io_prep_pread(cb.data() + j, fds[j], pieces[j].buf, pieces[j].len, pieces[j].offset);
+            cb[j].data = piece_bufs[j];
+        }
+        cbs[j] = cb.data() + j;
+    }
+
+    uint64_t n_submitted = 0;
+    while (n_submitted < n_ops)
+    {
+        int64_t ret = io_submit(ctx, (int64_t)(n_ops - n_submitted), cbs.data() + n_submitted);
+        if (ret == -EAGAIN)
+        {
+            // the context is full (MAX_EVENTS reads in flight): wait for some
+            // to finish and hand them out with the next get_completed_reads
+            std::vector<void *> *stash;
+            {
+                std::unique_lock<std::mutex> lk(ctx_mut);
+                auto &entry = early_completions[ctx];
+                if (entry == nullptr)
+                    entry.reset(new std::vector<void *>());
+                stash = entry.get();
+            }
+            reap_reads(ctx, 1, *stash);
+            continue;
+        }
+        if (ret <= 0)
+        {
+            std::cerr << "io_submit() failed; returned " << ret << ", expected=" << n_ops - n_submitted
+                      << ", ernno=" << errno << "=" << ::strerror(-ret) << std::endl;
+            exit(-1);
+        }
+        n_submitted += ret;
+    }
+}
+
+uint64_t LinuxAlignedFileReader::get_completed_reads(io_context_t &ctx, uint64_t min_completions,
+                                                     std::vector<void *> &completed_bufs)
+{
+    // reads reaped while submit_reads waited for room come first
+    uint64_t n_done = 0;
+    {
+        std::unique_lock<std::mutex> lk(ctx_mut);
+        auto entry = early_completions.find(ctx);
+        if (entry != early_completions.end() && !entry->second->empty())
+        {
+            std::vector<void *> &stash = *entry->second;
+            completed_bufs.insert(completed_bufs.end(), stash.begin(), stash.end());
+            n_done = stash.size();
+            stash.clear();
+        }
+    }
+    return n_done + reap_reads(ctx, min_completions > n_done ? min_completions - n_done : 0, completed_bufs);
+}
+
+uint64_t LinuxAlignedFileReader::reap_reads(io_context_t ctx, uint64_t min_completions,
+                                            std::vector<void *> &completed_bufs)
+{
+    io_event_t evts[MAX_IO_DEPTH];
+    if (!this->stripe_descs.empty())
+    {
+        tsl::robin_map<void *, uint32_t> *pending;
+        {
+            std::unique_lock<std::mutex> lk(ctx_mut);
+            auto entry = pending_pieces.find(ctx);
+            if (entry == pending_pieces.end())
+                return 0;
+            pending = entry->second.get();
+        }
+
+        // reap pieces until min_completions requests have all of theirs
+        uint64_t n_done = 0;
+        while (true)
+        {
+            int64_t ret = io_getevents(ctx, n_done < min_completions ? 1 : 0, MAX_IO_DEPTH, evts, nullptr);
+            if (ret < 0)
+            {
+                std::cerr << "io_getevents() failed; returned " << ret << ", ernno=" << errno << "="
+                          << ::strerror(-ret) << std::endl;
+                exit(-1);
+            }
+            for (int64_t i = 0; i < ret; i++)
+            {
+                if ((int64_t)evts[i].res < 0)
+                {
+                    std::cerr << "async read failed; returned " << (int64_t)evts[i].res << std::endl;
+                    exit(-1);
+                }
+                auto it = pending->find(evts[i].data);
+                if (--it.value() > 0)
+                    continue;
+                pending->erase(it);
+                completed_bufs.push_back(evts[i].data);
+                n_done++;
+            }
+            if (n_done >= min_completions && (ret == 0 || pending->empty()))
+                break;
+        }
+        return n_done;
+    }
+
+    int64_t ret = io_getevents(ctx, (int64_t)min_completions, MAX_IO_DEPTH, evts, nullptr);
+    if (ret < (int64_t)min_completions)
+    {
+        std::cerr << "io_getevents() failed; returned " << ret << ", expected at least " << min_completions
+                  << ", ernno=" << errno << "=" << ::strerror(-ret) << std::endl;
+        exit(-1);
+    }
+
+    for (int64_t i = 0; i < ret; i++)
+    {
+        if ((int64_t)evts[i].res < 0)
+        {
+            std::cerr << "async read failed; returned " << (int64_t)evts[i].res << std::endl;
+            exit(-1);
+        }
+        completed_bufs.push_back(evts[i].data);
+    }
+    return (uint64_t)ret;
 }
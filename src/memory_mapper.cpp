@@ -3,16 +3,18 @@
 
 #include "logger.h"
 #include "memory_mapper.h"
+#include <cerrno>
 #include <iostream>
 #include <sstream>
 
 using namespace diskann;
 
-MemoryMapper::MemoryMapper(const std::string &filename) : MemoryMapper(filename.c_str())
+MemoryMapper::MemoryMapper(const std::string &filename, bool populate, bool huge_pages)
+    : MemoryMapper(filename.c_str(), populate, huge_pages)
 {
 }
 
-MemoryMapper::MemoryMapper(const char *filename)
+MemoryMapper::MemoryMapper(const char *filename, bool populate, bool huge_pages)
 {
 #ifndef _WINDOWS
     _fd = open(filename, O_RDONLY);
@@ -29,7 +31,21 @@ MemoryMapper::MemoryMapper(const char *filename)
     }
     _fileSize = sb.st_size;
     diskann::cout << "File Size: " << _fileSize << std::endl;
-    _buf = (char *)mmap(NULL, _fileSize, PROT_READ, MAP_PRIVATE, _fd, 0);
+    int flags = MAP_PRIVATE;
+    if (populate)
+        flags |= MAP_POPULATE;
+    _buf = (char *)mmap(NULL, _fileSize, PROT_READ, flags, _fd, 0);
+    if (_buf == MAP_FAILED)
+    {
+        std::cerr << "mmap() of " << filename << " failed with errno " << errno << std::endl;
+        _buf = nullptr;
+        return;
+    }
+    if (huge_pages && madvise(_buf, _fileSize, MADV_HUGEPAGE) != 0)
+    {
+        // not fatal, we just keep using regular pages
+        std::cerr << "madvise(MADV_HUGEPAGE) on " << filename << " failed with errno " << errno << std::endl;
+    }
 #else
     _bareFile =
         CreateFileA(filename, GENERIC_READ | GENERIC_EXECUTE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
@@ -84,7 +100,7 @@ size_t MemoryMapper::getFileSize()
 MemoryMapper::~MemoryMapper()
 {
 #ifndef _WINDOWS
-    if (munmap(_buf, _fileSize) != 0)
+    if (_buf != nullptr && munmap(_buf, _fileSize) != 0)
         std::cerr << "ERROR unmapping. CHECK!" << std::endl;
     close(_fd);
 #else
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef USE_AVX2
+#include <immintrin.h>
+#endif
+
+#include "nhood_codec.h"
+
+namespace diskann
+{
+namespace
+{
+struct StreamVByteTables
+{
+    // total data bytes of the four deltas described by a control byte
+    uint8_t group_len[256];
+    // pshufb mask spreading the data bytes of a group over four uint32 lanes
+    uint8_t shuffle[256][16];
+
+    StreamVByteTables()
+    {
+        for (uint32_t ctrl = 0; ctrl < 256; ctrl++)
+        {
+            uint8_t pos = 0;
+            for (uint32_t lane = 0; lane < 4; lane++)
+            {
+                uint8_t len = ((ctrl >> (2 * lane)) & 3) + 1;
+                for (uint8_t b = 0; b < 4; b++)
+                    shuffle[ctrl][4 * lane + b] = b < len ? pos + b : 0x80;
+                pos += len;
+            }
+            group_len[ctrl] = pos;
+        }
+    }
+};
+
+const StreamVByteTables svb_tables;
+
+inline uint32_t delta_len(uint32_t delta)
+{
+    return delta < (1u << 8) ? 1 : delta < (1u << 16) ? 2 : delta < (1u << 24) ? 3 : 4;
+}
+} // namespace
+
+size_t encode_packed_nhood(uint32_t *ids, uint32_t n, uint8_t *out)
+{
+    std::sort(ids, ids + n);
+
+    uint32_t num_groups = (n + 3) / 4;
+    uint8_t *ctrl = out;
+    uint8_t *data = out + num_groups;
+    memset(ctrl, 0, num_groups);
+
+    uint32_t prev = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t delta = ids[i] - prev;
+        prev = ids[i];
+        uint32_t len = delta_len(delta);
+        ctrl[i / 4] |= (uint8_t)((len - 1) << (2 * (i % 4)));
+        for (uint32_t b = 0; b < len; b++)
+            *data++ = (uint8_t)(delta >> (8 * b));
+    }
+    return data - out;
+}
+
+size_t decode_packed_nhood(const uint8_t *in, uint32_t n, uint32_t *out)
+{
+    uint32_t num_groups = (n + 3) / 4;
+    const uint8_t *ctrl = in;
+    const uint8_t *data = in + num_groups;
+    uint32_t i = 0, prev = 0;
+
+#ifdef USE_AVX2
+    // full groups whose 16 byte load stays inside the encoding
+    const uint8_t *data_end = data;
+    for (uint32_t g = 0; g < n / 4; g++)
+        data_end += svb_tables.group_len[ctrl[g]];
+    for (uint32_t j = n / 4 * 4; j < n; j++)
+        data_end += ((ctrl[j / 4] >> (2 * (j % 4))) & 3) + 1;
+
+    __m128i running = _mm_setzero_si128();
+    for (; i + 4 <= n && data + 16 <= data_end; i += 4)
+    {
+        uint8_t c = ctrl[i / 4];
+        __m128i deltas = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data),
+                                          _mm_loadu_si128((const __m128i *)svb_tables.shuffle[c]));
+        // inclusive prefix sum over the lanes, on top of the last id so far
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+        __m128i ids = _mm_add_epi32(deltas, running);
+        _mm_storeu_si128((__m128i *)(out + i), ids);
+        running = _mm_shuffle_epi32(ids, 0xFF);
+        data += svb_tables.group_len[c];
+    }
+    prev = (uint32_t)_mm_cvtsi128_si32(running);
+#endif
+
+    for (; i < n; i++)
+    {
+        uint32_t len = ((ctrl[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        uint32_t delta = 0;
+        for (uint32_t b = 0; b < len; b++)
+            delta |= (uint32_t)data[b] << (8 * b);
+        data += len;
+        prev += delta;
+        out[i] = prev;
+    }
+    return data - in;
+}
+} // namespace diskann
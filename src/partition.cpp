@@ -826,6 +826,12 @@ int sogaic::partition_with_ram_budget(const std::string data_file, size_t base_d
 
 template void DISKANN_DLLEXPORT gen_random_slice<int8_t>(const std::string base_file, const std::string output_prefix,
                                                          double sampling_rate);
+template void DISKANN_DLLEXPORT gen_random_slice<diskann::float16>(const std::string base_file,
+                                                                   const std::string output_prefix,
+                                                                   double sampling_rate);
+template void DISKANN_DLLEXPORT gen_random_slice<diskann::bfloat16>(const std::string base_file,
+                                                                    const std::string output_prefix,
+                                                                    double sampling_rate);
 template void DISKANN_DLLEXPORT gen_random_slice<uint8_t>(const std::string base_file, const std::string output_prefix,
                                                           double sampling_rate);
 template void DISKANN_DLLEXPORT gen_random_slice<float>(const std::string base_file, const std::string output_prefix,
@@ -837,6 +843,12 @@ template void DISKANN_DLLEXPORT gen_random_slice<uint8_t>(const uint8_t *inputda
                                                           double p_val, float *&sampled_data, size_t &slice_size);
 template void DISKANN_DLLEXPORT gen_random_slice<int8_t>(const int8_t *inputdata, size_t npts, size_t ndims,
                                                          double p_val, float *&sampled_data, size_t &slice_size);
+template void DISKANN_DLLEXPORT gen_random_slice<diskann::float16>(const diskann::float16 *inputdata, size_t npts,
+                                                                   size_t ndims, double p_val, float *&sampled_data,
+                                                                   size_t &slice_size);
+template void DISKANN_DLLEXPORT gen_random_slice<diskann::bfloat16>(const diskann::bfloat16 *inputdata, size_t npts,
+                                                                    size_t ndims, double p_val, float *&sampled_data,
+                                                                    size_t &slice_size);
 
 template void DISKANN_DLLEXPORT gen_random_slice<float>(const std::string data_file, double p_val, float *&sampled_data,
                                                         size_t &slice_size, size_t &ndims);
@@ -844,10 +856,22 @@ template void DISKANN_DLLEXPORT gen_random_slice<uint8_t>(const std::string data
                                                           float *&sampled_data, size_t &slice_size, size_t &ndims);
 template void DISKANN_DLLEXPORT gen_random_slice<int8_t>(const std::string data_file, double p_val,
                                                          float *&sampled_data, size_t &slice_size, size_t &ndims);
+template void DISKANN_DLLEXPORT gen_random_slice<diskann::float16>(const std::string data_file, double p_val,
+                                                                   float *&sampled_data, size_t &slice_size,
+                                                                   size_t &ndims);
+template void DISKANN_DLLEXPORT gen_random_slice<diskann::bfloat16>(const std::string data_file, double p_val,
+                                                                    float *&sampled_data, size_t &slice_size,
+                                                                    size_t &ndims);
 
 template DISKANN_DLLEXPORT int partition<int8_t>(const std::string data_file, const float sampling_rate,
                                                  size_t num_centers, size_t max_k_means_reps,
                                                  const std::string prefix_path, size_t k_base);
+template DISKANN_DLLEXPORT int partition<diskann::float16>(const std::string data_file, const float sampling_rate,
+                                                           size_t num_centers, size_t max_k_means_reps,
+                                                           const std::string prefix_path, size_t k_base);
+template DISKANN_DLLEXPORT int partition<diskann::bfloat16>(const std::string data_file, const float sampling_rate,
+                                                            size_t num_centers, size_t max_k_means_reps,
+                                                            const std::string prefix_path, size_t k_base);
 template DISKANN_DLLEXPORT int partition<uint8_t>(const std::string data_file, const float sampling_rate,
                                                   size_t num_centers, size_t max_k_means_reps,
                                                   const std::string prefix_path, size_t k_base);
@@ -859,6 +883,16 @@ template DISKANN_DLLEXPORT int partition_with_ram_budget<int8_t>(const std::stri
                                                                  const double sampling_rate, double ram_budget,
                                                                  size_t graph_degree, const std::string prefix_path,
                                                                  size_t k_base);
+template DISKANN_DLLEXPORT int partition_with_ram_budget<diskann::float16>(const std::string data_file,
+                                                                           const double sampling_rate,
+                                                                           double ram_budget, size_t graph_degree,
+                                                                           const std::string prefix_path,
+                                                                           size_t k_base);
+template DISKANN_DLLEXPORT int partition_with_ram_budget<diskann::bfloat16>(const std::string data_file,
+                                                                            const double sampling_rate,
+                                                                            double ram_budget, size_t graph_degree,
+                                                                            const std::string prefix_path,
+                                                                            size_t k_base);
 template DISKANN_DLLEXPORT int partition_with_ram_budget<uint8_t>(const std::string data_file,
                                                                   const double sampling_rate, double ram_budget,
                                                                   size_t graph_degree, const std::string prefix_path,
@@ -870,6 +904,12 @@ template DISKANN_DLLEXPORT int partition_with_ram_budget<float>(const std::strin
 template DISKANN_DLLEXPORT int sogaic::partition_with_ram_budget<int8_t>(
     const std::string data_file, size_t base_data_num, const double sampling_rate, double ram_budget,
     size_t graph_degree, const std::string prefix_path, size_t omega, const float epsilon);
+template DISKANN_DLLEXPORT int sogaic::partition_with_ram_budget<diskann::float16>(
+    const std::string data_file, size_t base_data_num, const double sampling_rate, double ram_budget,
+    size_t graph_degree, const std::string prefix_path, size_t omega, const float epsilon);
+template DISKANN_DLLEXPORT int sogaic::partition_with_ram_budget<diskann::bfloat16>(
+    const std::string data_file, size_t base_data_num, const double sampling_rate, double ram_budget,
+    size_t graph_degree, const std::string prefix_path, size_t omega, const float epsilon);
 
 template DISKANN_DLLEXPORT int sogaic::partition_with_ram_budget<uint8_t>(
     const std::string data_file, size_t base_data_num, const double sampling_rate, double ram_budget,
@@ -887,4 +927,10 @@ template DISKANN_DLLEXPORT int retrieve_shard_data_from_ids<uint8_t>(const std::
                                                                      std::string data_filename);
 template DISKANN_DLLEXPORT int retrieve_shard_data_from_ids<int8_t>(const std::string data_file,
                                                                     std::string idmap_filename,
-                                                                    std::string data_filename);
\ No newline at end of file
+                                                                    std::string data_filename);
+template DISKANN_DLLEXPORT int retrieve_shard_data_from_ids<diskann::float16>(const std::string data_file,
+                                                                              std::string idmap_filename,
+                                                                              std::string data_filename);
+template DISKANN_DLLEXPORT int retrieve_shard_data_from_ids<diskann::bfloat16>(const std::string data_file,
+                                                                               std::string idmap_filename,
+                                                                               std::string data_filename);
\ No newline at end of file
@@ -10,6 +10,10 @@
 #include "math_utils.h"
 #include "tsl/robin_map.h"
 
+#ifdef USE_AVX2
+#include <immintrin.h>
+#endif
+
 // block size for reading/processing large files and matrices in blocks
 #define BLOCK_SIZE 5000000
 
@@ -89,14 +93,20 @@ void FixedChunkPQTable::load_pq_centroid_bin(const char *pq_table_file, size_t n
     diskann::load_bin<float>(pq_table_file, tables, nr, nc, file_offset_data[0]);
 #endif
 
-    if ((nr != NUM_PQ_CENTROIDS))
+    uint32_t file_num_bits = 0;
+    while (((uint64_t)1 << file_num_bits) < nr)
+        file_num_bits++;
+    if (((uint64_t)1 << file_num_bits) != nr || !is_valid_pq_bits(file_num_bits))
     {
         diskann::cout << "Error reading pq_pivots file " << pq_table_file << ". file_num_centers  = " << nr
-                      << " but expecting " << NUM_PQ_CENTROIDS << " centers";
+                      << " but expecting " << PQ_FAST_SCAN_CENTROIDS << " or 2^" << NUM_PQ_BITS << " to 2^"
+                      << MAX_PQ_BITS << " centers";
         throw diskann::ANNException("Error reading pq_pivots file at pivots data.", -1, __FUNCSIG__, __FILE__,
                                     __LINE__);
     }
 
+    this->num_centers = nr;
+    this->num_bits = file_num_bits;
     this->ndims = nc;
 
 #ifdef EXEC_ENV_OLS
@@ -132,7 +142,7 @@ void FixedChunkPQTable::load_pq_centroid_bin(const char *pq_table_file, size_t n
     }
 
     this->n_chunks = nr - 1;
-    diskann::cout << "Loaded PQ Pivots: #ctrs: " << NUM_PQ_CENTROIDS << ", #dims: " << this->ndims
+    diskann::cout << "Loaded PQ Pivots: #ctrs: " << this->num_centers << ", #dims: " << this->ndims
                   << ", #chunks: " << this->n_chunks << std::endl;
 
 #ifdef EXEC_ENV_OLS
@@ -153,12 +163,12 @@ void FixedChunkPQTable::load_pq_centroid_bin(const char *pq_table_file, size_t n
     }
 
     // alloc and compute transpose
-    tables_tr = new float[256 * this->ndims];
-    for (size_t i = 0; i < 256; i++)
+    tables_tr = new float[num_centers * this->ndims];
+    for (size_t i = 0; i < num_centers; i++)
     {
         for (size_t j = 0; j < this->ndims; j++)
         {
-            tables_tr[j * 256 + i] = tables[i * this->ndims + j];
+            tables_tr[j * num_centers + i] = tables[i * this->ndims + j];
         }
     }
 }
@@ -168,6 +178,16 @@ uint32_t FixedChunkPQTable::get_num_chunks()
     return static_cast<uint32_t>(n_chunks);
 }
 
+uint32_t FixedChunkPQTable::get_num_centers()
+{
+    return static_cast<uint32_t>(num_centers);
+}
+
+uint32_t FixedChunkPQTable::get_num_bits()
+{
+    return num_bits;
+}
+
 void FixedChunkPQTable::preprocess_query(float *query_vec)
 {
     for (uint32_t d = 0; d < ndims; d++)
@@ -191,16 +211,17 @@ void FixedChunkPQTable::preprocess_query(float *query_vec)
 // assumes pre-processed query
 void FixedChunkPQTable::populate_chunk_distances(const float *query_vec, float *dist_vec)
 {
-    memset(dist_vec, 0, 256 * n_chunks * sizeof(float));
+    const uint64_t stride = pq_table_stride(num_bits);
+    memset(dist_vec, 0, stride * n_chunks * sizeof(float));
     // chunk wise distance computation
     for (size_t chunk = 0; chunk < n_chunks; chunk++)
     {
         // sum (q-c)^2 for the dimensions associated with this chunk
-        float *chunk_dists = dist_vec + (256 * chunk);
+        float *chunk_dists = dist_vec + (stride * chunk);
         for (size_t j = chunk_offsets[chunk]; j < chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = tables_tr + (256 * j);
-            for (size_t idx = 0; idx < 256; idx++)
+            const float *centers_dim_vec = tables_tr + (num_centers * j);
+            for (size_t idx = 0; idx < num_centers; idx++)
             {
                 double diff = centers_dim_vec[idx] - (query_vec[j]);
                 chunk_dists[idx] += (float)(diff * diff);
@@ -214,10 +235,11 @@ float FixedChunkPQTable::l2_distance(const float *query_vec, uint8_t *base_vec)
     float res = 0;
     for (size_t chunk = 0; chunk < n_chunks; chunk++)
     {
+        const uint32_t code = get_pq_code(base_vec, chunk, num_bits);
         for (size_t j = chunk_offsets[chunk]; j < chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = tables_tr + (256 * j);
-            float diff = centers_dim_vec[base_vec[chunk]] - (query_vec[j]);
+            const float *centers_dim_vec = tables_tr + (num_centers * j);
+            float diff = centers_dim_vec[code] - (query_vec[j]);
             res += diff * diff;
         }
     }
@@ -229,11 +251,12 @@ float FixedChunkPQTable::inner_product(const float *query_vec, uint8_t *base_vec
     float res = 0;
     for (size_t chunk = 0; chunk < n_chunks; chunk++)
     {
+        const uint32_t code = get_pq_code(base_vec, chunk, num_bits);
         for (size_t j = chunk_offsets[chunk]; j < chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = tables_tr + (256 * j);
-            float diff = centers_dim_vec[base_vec[chunk]] * query_vec[j]; // assumes centroid is 0 to
-                                                                          // prevent translation errors
+            const float *centers_dim_vec = tables_tr + (num_centers * j);
+            float diff = centers_dim_vec[code] * query_vec[j]; // assumes centroid is 0 to
+                                                               // prevent translation errors
             res += diff;
         }
     }
@@ -241,31 +264,47 @@ float FixedChunkPQTable::inner_product(const float *query_vec, uint8_t *base_vec
                  // conversion)
 }
 
-// assumes no rotation is involved
+// undoes the rotation (if any) and centering of preprocess_query
 void FixedChunkPQTable::inflate_vector(uint8_t *base_vec, float *out_vec)
 {
+    std::vector<float> tmp(use_rotation ? ndims : 0);
+    float *rotated = use_rotation ? tmp.data() : out_vec;
     for (size_t chunk = 0; chunk < n_chunks; chunk++)
     {
+        const uint32_t code = get_pq_code(base_vec, chunk, num_bits);
         for (size_t j = chunk_offsets[chunk]; j < chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = tables_tr + (256 * j);
-            out_vec[j] = centers_dim_vec[base_vec[chunk]] + centroid[j];
+            const float *centers_dim_vec = tables_tr + (num_centers * j);
+            rotated[j] = centers_dim_vec[code];
         }
     }
+    if (use_rotation)
+    {
+        // the rotation is orthogonal, its inverse is the transpose
+        for (size_t d = 0; d < ndims; d++)
+        {
+            out_vec[d] = 0;
+            for (size_t d1 = 0; d1 < ndims; d1++)
+                out_vec[d] += rotated[d1] * rotmat_tr[d * ndims + d1];
+        }
+    }
+    for (size_t d = 0; d < ndims; d++)
+        out_vec[d] += centroid[d];
 }
 
 void FixedChunkPQTable::populate_chunk_inner_products(const float *query_vec, float *dist_vec)
 {
-    memset(dist_vec, 0, 256 * n_chunks * sizeof(float));
+    const uint64_t stride = pq_table_stride(num_bits);
+    memset(dist_vec, 0, stride * n_chunks * sizeof(float));
     // chunk wise distance computation
     for (size_t chunk = 0; chunk < n_chunks; chunk++)
     {
         // sum (q-c)^2 for the dimensions associated with this chunk
-        float *chunk_dists = dist_vec + (256 * chunk);
+        float *chunk_dists = dist_vec + (stride * chunk);
         for (size_t j = chunk_offsets[chunk]; j < chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = tables_tr + (256 * j);
-            for (size_t idx = 0; idx < 256; idx++)
+            const float *centers_dim_vec = tables_tr + (num_centers * j);
+            for (size_t idx = 0; idx < num_centers; idx++)
             {
                 double prod = centers_dim_vec[idx] * query_vec[j]; // assumes that we are not
                                                                    // shifting the vectors to
@@ -286,8 +325,39 @@ void aggregate_coords(const std::vector<uint32_t> &ids, const uint8_t *all_coord
     }
 }
 
+// pq_dist_lookup for bit-packed codes (4 bits or wider than a byte): point by
+// point, reading the bit stream of each code sequentially
+static void pq_dist_lookup_packed(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks,
+                                  const float *pq_dists, float *dists_out, const uint32_t num_bits)
+{
+    const uint64_t code_len = pq_code_len(pq_nchunks, num_bits);
+    const uint64_t stride = pq_table_stride(num_bits);
+    const uint64_t mask = ((uint64_t)1 << num_bits) - 1;
+    for (size_t idx = 0; idx < n_pts; idx++)
+    {
+        const uint8_t *code = pq_ids + idx * code_len;
+        if (idx + 1 < n_pts)
+            _mm_prefetch((char *)(code + code_len), _MM_HINT_T0);
+        uint64_t bits = 0;
+        uint32_t n_bits = 0;
+        float dist = 0;
+        for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
+        {
+            while (n_bits < num_bits)
+            {
+                bits |= (uint64_t)(*code++) << n_bits;
+                n_bits += 8;
+            }
+            dist += pq_dists[stride * chunk + (bits & mask)];
+            bits >>= num_bits;
+            n_bits -= num_bits;
+        }
+        dists_out[idx] = dist;
+    }
+}
+
 void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, const float *pq_dists,
-                    std::vector<float> &dists_out)
+                    std::vector<float> &dists_out, const uint32_t num_bits)
 {
     //_mm_prefetch((char*) dists_out, _MM_HINT_T0);
     _mm_prefetch((char *)pq_ids, _MM_HINT_T0);
@@ -295,6 +365,11 @@ void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_n
     _mm_prefetch((char *)(pq_ids + 128), _MM_HINT_T0);
     dists_out.clear();
     dists_out.resize(n_pts, 0);
+    if (num_bits != NUM_PQ_BITS)
+    {
+        pq_dist_lookup_packed(pq_ids, n_pts, pq_nchunks, pq_dists, dists_out.data(), num_bits);
+        return;
+    }
     for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
     {
         const float *chunk_dists = pq_dists + 256 * chunk;
@@ -322,12 +397,17 @@ void aggregate_coords(const uint32_t *ids, const size_t n_ids, const uint8_t *al
 }
 
 void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, const float *pq_dists,
-                    float *dists_out)
+                    float *dists_out, const uint32_t num_bits)
 {
     _mm_prefetch((char *)dists_out, _MM_HINT_T0);
     _mm_prefetch((char *)pq_ids, _MM_HINT_T0);
     _mm_prefetch((char *)(pq_ids + 64), _MM_HINT_T0);
     _mm_prefetch((char *)(pq_ids + 128), _MM_HINT_T0);
+    if (num_bits != NUM_PQ_BITS)
+    {
+        pq_dist_lookup_packed(pq_ids, n_pts, pq_nchunks, pq_dists, dists_out, num_bits);
+        return;
+    }
     memset(dists_out, 0, n_pts * sizeof(float));
     for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
     {
@@ -344,6 +424,267 @@ void pq_dist_lookup(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_n
     }
 }
 
+#ifdef USE_AVX2
+// transposes the 16 x 16 bytes in m with four rounds of byte interleaving
+static inline void transpose_16x16_epi8(__m128i *m)
+{
+    for (size_t round = 0; round < 4; round++)
+    {
+        __m128i t[16];
+        for (size_t i = 0; i < 8; i++)
+        {
+            t[2 * i] = _mm_unpacklo_epi8(m[i], m[i + 8]);
+            t[2 * i + 1] = _mm_unpackhi_epi8(m[i], m[i + 8]);
+        }
+        memcpy(m, t, sizeof(t));
+    }
+}
+#endif
+
+// writes the codes row(0..n_pts) in the transposed layout
+template <typename RowFn>
+static void transpose_code_rows(const RowFn &row, const size_t n_pts, const size_t pq_nchunks, uint8_t *out)
+{
+    const size_t block_len = PQ_TRANSPOSE_BLOCK * pq_nchunks;
+    const size_t full_pts = n_pts / PQ_TRANSPOSE_BLOCK * PQ_TRANSPOSE_BLOCK;
+    size_t done_chunks = 0;
+#ifdef USE_AVX2
+    // full blocks in tiles of 16 chunks
+    done_chunks = pq_nchunks / 16 * 16;
+    for (size_t blk = 0; blk < n_pts / PQ_TRANSPOSE_BLOCK; blk++)
+    {
+        uint8_t *blk_out = out + blk * block_len;
+        for (size_t c0 = 0; c0 < done_chunks; c0 += 16)
+        {
+            __m128i m[16];
+            for (size_t r = 0; r < 16; r++)
+                m[r] = _mm_loadu_si128((const __m128i *)(row(blk * PQ_TRANSPOSE_BLOCK + r) + c0));
+            transpose_16x16_epi8(m);
+            for (size_t c = 0; c < 16; c++)
+                _mm_storeu_si128((__m128i *)(blk_out + (c0 + c) * PQ_TRANSPOSE_BLOCK), m[c]);
+        }
+    }
+#endif
+
+    for (size_t idx = 0; idx < ROUND_UP(n_pts, PQ_TRANSPOSE_BLOCK); idx++)
+    {
+        uint8_t *lane_out = out + (idx / PQ_TRANSPOSE_BLOCK) * block_len + idx % PQ_TRANSPOSE_BLOCK;
+        if (idx >= n_pts)
+        {
+            for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
+                lane_out[chunk * PQ_TRANSPOSE_BLOCK] = 0;
+            continue;
+        }
+        const uint8_t *ids = row(idx);
+        for (size_t chunk = idx < full_pts ? done_chunks : 0; chunk < pq_nchunks; chunk++)
+            lane_out[chunk * PQ_TRANSPOSE_BLOCK] = ids[chunk];
+    }
+}
+
+void aggregate_coords_transposed(const std::vector<uint32_t> &ids, const uint8_t *all_coords, const size_t ndims,
+                                 uint8_t *out)
+{
+    aggregate_coords_transposed(ids.data(), ids.size(), all_coords, ndims, out);
+}
+
+void aggregate_coords_transposed(const uint32_t *ids, const size_t n_ids, const uint8_t *all_coords,
+                                 const size_t ndims, uint8_t *out)
+{
+    transpose_code_rows([&](size_t i) { return all_coords + ids[i] * ndims; }, n_ids, ndims, out);
+}
+
+void transpose_pq_codes(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, uint8_t *out)
+{
+    transpose_code_rows([&](size_t i) { return pq_ids + i * pq_nchunks; }, n_pts, pq_nchunks, out);
+}
+
+static void pq_block_dists_scalar(const uint8_t *blk_ids, const size_t pq_nchunks, const float *pq_dists,
+                                  float *blk_dists)
+{
+    memset(blk_dists, 0, PQ_TRANSPOSE_BLOCK * sizeof(float));
+    for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
+    {
+        const uint8_t *chunk_ids = blk_ids + chunk * PQ_TRANSPOSE_BLOCK;
+        const float *chunk_dists = pq_dists + 256 * chunk;
+        for (size_t i = 0; i < PQ_TRANSPOSE_BLOCK; i++)
+            blk_dists[i] += chunk_dists[chunk_ids[i]];
+    }
+}
+
+#ifdef USE_AVX2
+static void pq_block_dists_avx2(const uint8_t *blk_ids, const size_t pq_nchunks, const float *pq_dists,
+                                float *blk_dists)
+{
+    __m256 acc_lo = _mm256_setzero_ps();
+    __m256 acc_hi = _mm256_setzero_ps();
+    for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
+    {
+        const __m128i codes = _mm_loadu_si128((const __m128i *)(blk_ids + chunk * PQ_TRANSPOSE_BLOCK));
+        const float *chunk_dists = pq_dists + 256 * chunk;
+        acc_lo = _mm256_add_ps(acc_lo, _mm256_i32gather_ps(chunk_dists, _mm256_cvtepu8_epi32(codes), 4));
+        acc_hi = _mm256_add_ps(
+            acc_hi, _mm256_i32gather_ps(chunk_dists, _mm256_cvtepu8_epi32(_mm_srli_si128(codes, 8)), 4));
+    }
+    _mm256_storeu_ps(blk_dists, acc_lo);
+    _mm256_storeu_ps(blk_dists + 8, acc_hi);
+}
+#endif
+
+void pq_dist_lookup_transposed(const uint8_t *tr_pq_ids, const size_t n_pts, const size_t pq_nchunks,
+                               const float *pq_dists, float *dists_out)
+{
+    auto block_dists = pq_block_dists_scalar;
+#ifdef USE_AVX2
+    if (Avx2SupportedCPU)
+        block_dists = pq_block_dists_avx2;
+#endif
+    const size_t block_len = PQ_TRANSPOSE_BLOCK * pq_nchunks;
+    for (size_t blk = 0; blk * PQ_TRANSPOSE_BLOCK < n_pts; blk++)
+    {
+        float blk_dists[PQ_TRANSPOSE_BLOCK];
+        block_dists(tr_pq_ids + blk * block_len, pq_nchunks, pq_dists, blk_dists);
+        const size_t blk_pts = (std::min)((size_t)PQ_TRANSPOSE_BLOCK, n_pts - blk * PQ_TRANSPOSE_BLOCK);
+        memcpy(dists_out + blk * PQ_TRANSPOSE_BLOCK, blk_dists, blk_pts * sizeof(float));
+    }
+}
+
+void quantize_fast_scan_lut(const float *pq_dists, const size_t pq_nchunks, uint8_t *lut, float &scale, float &bias)
+{
+    // one step for all chunks so that the entries of different chunks add up,
+    // each chunk shifted by its smallest distance
+    float max_range = 0;
+    bias = 0;
+    for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
+    {
+        const float *chunk_dists = pq_dists + 256 * chunk;
+        auto minmax = std::minmax_element(chunk_dists, chunk_dists + PQ_FAST_SCAN_CENTROIDS);
+        max_range = (std::max)(max_range, *minmax.second - *minmax.first);
+        bias += *minmax.first;
+    }
+    scale = max_range > 0 ? max_range / 255 : 1.0f;
+
+    for (size_t chunk = 0; chunk < pq_nchunks; chunk++)
+    {
+        const float *chunk_dists = pq_dists + 256 * chunk;
+        float chunk_min = *std::min_element(chunk_dists, chunk_dists + PQ_FAST_SCAN_CENTROIDS);
+        for (size_t idx = 0; idx < PQ_FAST_SCAN_CENTROIDS; idx++)
+        {
+            float q = std::round((chunk_dists[idx] - chunk_min) / scale);
+            lut[16 * chunk + idx] = (uint8_t)(std::min)(q, 255.0f);
+        }
+    }
+    if (pq_nchunks % 2 != 0)
+        memset(lut + 16 * pq_nchunks, 0, 16);
+}
+
+void pack_fast_scan_codes(const uint8_t *pq_ids, const size_t n_pts, const size_t pq_nchunks, uint8_t *out)
+{
+    const size_t code_len = pq_code_len(pq_nchunks, PQ_FAST_SCAN_BITS);
+    const size_t block_len = ROUND_UP(pq_nchunks, 2) * 16;
+    memset(out, 0, fast_scan_codes_len(n_pts, pq_nchunks));
+
+    size_t done_chunks = 0;
+#ifdef USE_AVX2
+    // full blocks in tiles of 32 chunks (16 code bytes): transpose the 16 x 16
+    // code bytes of each half block, then merge the halves, the low nibbles
+    // giving the even and the high nibbles the odd chunk of every byte
+    done_chunks = pq_nchunks / 32 * 32;
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    const __m128i high_nibble = _mm_set1_epi8((char)0xf0);
+    for (size_t blk = 0; blk < n_pts / PQ_FAST_SCAN_BLOCK; blk++)
+    {
+        const uint8_t *blk_ids = pq_ids + blk * PQ_FAST_SCAN_BLOCK * code_len;
+        uint8_t *blk_out = out + blk * block_len;
+        for (size_t c0 = 0; c0 < done_chunks; c0 += 32)
+        {
+            __m128i half[2][16];
+            for (size_t h = 0; h < 2; h++)
+            {
+                __m128i *m = half[h];
+                for (size_t r = 0; r < 16; r++)
+                    m[r] = _mm_loadu_si128((const __m128i *)(blk_ids + (16 * h + r) * code_len + c0 / 2));
+                transpose_16x16_epi8(m);
+            }
+            for (size_t b = 0; b < 16; b++)
+            {
+                const __m128i even = _mm_or_si128(_mm_and_si128(half[0][b], low_nibble),
+                                                  _mm_slli_epi16(_mm_and_si128(half[1][b], low_nibble), 4));
+                const __m128i odd = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(half[0][b], 4), low_nibble),
+                                                 _mm_and_si128(half[1][b], high_nibble));
+                _mm_storeu_si128((__m128i *)(blk_out + (c0 + 2 * b) * 16), even);
+                _mm_storeu_si128((__m128i *)(blk_out + (c0 + 2 * b + 1) * 16), odd);
+            }
+        }
+    }
+#endif
+
+    for (size_t idx = 0; idx < n_pts; idx++)
+    {
+        const uint8_t *ids = pq_ids + idx * code_len;
+        uint8_t *blk_out = out + (idx / PQ_FAST_SCAN_BLOCK) * block_len + idx % 16;
+        const uint32_t shift = (idx % PQ_FAST_SCAN_BLOCK) < 16 ? 0 : 4;
+        const bool full_block = idx < n_pts / PQ_FAST_SCAN_BLOCK * PQ_FAST_SCAN_BLOCK;
+        for (size_t chunk = full_block ? done_chunks : 0; chunk < pq_nchunks; chunk++)
+            blk_out[chunk * 16] |= (uint8_t)(get_pq_code(ids, chunk, PQ_FAST_SCAN_BITS) << shift);
+    }
+}
+
+void pq_fast_scan_lookup(const uint8_t *packed_ids, const size_t n_pts, const size_t pq_nchunks, const uint8_t *lut,
+                         const float scale, const float bias, float *dists_out)
+{
+    // sums of up to 256 entries per 16 bit lane (MAX_PQ_CHUNKS / 2) can not
+    // overflow
+    const size_t nchunks_even = ROUND_UP(pq_nchunks, 2);
+    const size_t block_len = nchunks_even * 16;
+    for (size_t blk = 0; blk * PQ_FAST_SCAN_BLOCK < n_pts; blk++)
+    {
+        const uint8_t *blk_ids = packed_ids + blk * block_len;
+        float blk_dists[PQ_FAST_SCAN_BLOCK];
+#ifdef USE_AVX2
+        const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc[4] = {zero, zero, zero, zero};
+        // two chunks per step, one in each 128 bit lane
+        for (size_t chunk = 0; chunk < nchunks_even; chunk += 2)
+        {
+            __m256i codes = _mm256_loadu_si256((const __m256i *)(blk_ids + chunk * 16));
+            __m256i tables = _mm256_loadu_si256((const __m256i *)(lut + chunk * 16));
+            __m256i lo = _mm256_shuffle_epi8(tables, _mm256_and_si256(codes, low_nibble));
+            __m256i hi = _mm256_shuffle_epi8(tables, _mm256_and_si256(_mm256_srli_epi16(codes, 4), low_nibble));
+            acc[0] = _mm256_add_epi16(acc[0], _mm256_unpacklo_epi8(lo, zero)); // points 0..7
+            acc[1] = _mm256_add_epi16(acc[1], _mm256_unpackhi_epi8(lo, zero)); // points 8..15
+            acc[2] = _mm256_add_epi16(acc[2], _mm256_unpacklo_epi8(hi, zero)); // points 16..23
+            acc[3] = _mm256_add_epi16(acc[3], _mm256_unpackhi_epi8(hi, zero)); // points 24..31
+        }
+        const __m256 vscale = _mm256_set1_ps(scale);
+        const __m256 vbias = _mm256_set1_ps(bias);
+        for (size_t i = 0; i < 4; i++)
+        {
+            // add up the even and odd chunks of the two lanes
+            __m256i sum = _mm256_add_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(acc[i])),
+                                           _mm256_cvtepu16_epi32(_mm256_extracti128_si256(acc[i], 1)));
+            _mm256_storeu_ps(blk_dists + 8 * i, _mm256_fmadd_ps(_mm256_cvtepi32_ps(sum), vscale, vbias));
+        }
+#else
+        uint32_t acc[PQ_FAST_SCAN_BLOCK] = {0};
+        for (size_t chunk = 0; chunk < nchunks_even; chunk++)
+        {
+            const uint8_t *chunk_ids = blk_ids + chunk * 16;
+            const uint8_t *chunk_lut = lut + chunk * 16;
+            for (size_t i = 0; i < 16; i++)
+            {
+                acc[i] += chunk_lut[chunk_ids[i] & 0x0f];
+                acc[i + 16] += chunk_lut[chunk_ids[i] >> 4];
+            }
+        }
+        for (size_t i = 0; i < PQ_FAST_SCAN_BLOCK; i++)
+            blk_dists[i] = bias + scale * (float)acc[i];
+#endif
+        const size_t blk_pts = (std::min)((size_t)PQ_FAST_SCAN_BLOCK, n_pts - blk * PQ_FAST_SCAN_BLOCK);
+        memcpy(dists_out + blk * PQ_FAST_SCAN_BLOCK, blk_dists, blk_pts * sizeof(float));
+    }
+}
+
 // generate_pq_pivots_simplified is a simplified version of generate_pq_pivots.
 // Input is provided in the in-memory buffer train_data.
 // Output is stored in the in-memory buffer pivot_data_vector.
@@ -417,6 +758,12 @@ int generate_pq_pivots(const float *const passed_train_data, size_t num_train, u
         diskann::cout << " Error: number of chunks more than dimension" << std::endl;
         return -1;
     }
+    if (num_train < num_centers)
+    {
+        diskann::cout << " Error: " << num_train << " training points for " << num_centers << " centers per chunk"
+                      << std::endl;
+        return -1;
+    }
 
     std::unique_ptr<float[]> train_data = std::make_unique<float[]>(num_train * dim);
     std::memcpy(train_data.get(), passed_train_data, num_train * dim * sizeof(float));
@@ -568,6 +915,12 @@ int generate_opq_pivots(const float *passed_train_data, size_t num_train, uint32
         diskann::cout << " Error: number of chunks more than dimension" << std::endl;
         return -1;
     }
+    if (num_train < num_centers)
+    {
+        diskann::cout << " Error: " << num_train << " training points for " << num_centers << " centers per chunk"
+                      << std::endl;
+        return -1;
+    }
 
     std::unique_ptr<float[]> train_data = std::make_unique<float[]>(num_train * dim);
     std::memcpy(train_data.get(), passed_train_data, num_train * dim * sizeof(float));
@@ -843,8 +1196,9 @@ int generate_pq_data_from_pivots_simplified(const float *data, const size_t num,
 // streams the base file (data_file), and computes the closest centers in each
 // chunk to generate the compressed data_file and stores it in
 // pq_compressed_vectors_path.
-// If the numbber of centers is < 256, it stores as byte vector, else as
-// 4-byte vector in binary format.
+// If the number of centers is <= 256, it stores one byte per chunk, else the
+// codes packed in a bit stream of log2(num_centers) bits per chunk (see
+// pq_code_len). The header holds the number of bytes per point.
 template <typename T>
 int generate_pq_data_from_pivots(const std::string &data_file, uint32_t num_centers, uint32_t num_pq_chunks,
                                  const std::string &pq_pivots_path, const std::string &pq_compressed_vectors_path,
@@ -931,11 +1285,16 @@ int generate_pq_data_from_pivots(const std::string &data_file, uint32_t num_cent
         diskann::cout << "Loaded PQ pivot information" << std::endl;
     }
 
+    uint32_t num_bits = 0;
+    while ((1u << num_bits) < num_centers)
+        num_bits++;
+    const uint64_t code_len = pq_code_len(num_pq_chunks, num_bits);
+
     std::ofstream compressed_file_writer(pq_compressed_vectors_path, std::ios::binary);
-    uint32_t num_pq_chunks_u32 = num_pq_chunks;
+    uint32_t code_len_u32 = (uint32_t)code_len;
 
     compressed_file_writer.write((char *)&num_points, sizeof(uint32_t));
-    compressed_file_writer.write((char *)&num_pq_chunks_u32, sizeof(uint32_t));
+    compressed_file_writer.write((char *)&code_len_u32, sizeof(uint32_t));
 
     size_t block_size = num_points <= BLOCK_SIZE ? num_points : BLOCK_SIZE;
 
@@ -1034,10 +1393,26 @@ int generate_pq_data_from_pivots(const std::string &data_file, uint32_t num_cent
             }
         }
 
-        if (num_centers > 256)
+        if (num_bits != NUM_PQ_BITS)
         {
-            compressed_file_writer.write((char *)(block_compressed_base.get()),
-                                         cur_blk_size * num_pq_chunks * sizeof(uint32_t));
+            std::unique_ptr<uint8_t[]> pVec = std::make_unique<uint8_t[]>(cur_blk_size * code_len);
+#pragma omp parallel for schedule(static, 8192)
+            for (int64_t j = 0; j < (int64_t)cur_blk_size; j++)
+            {
+                const uint32_t *ids = block_compressed_base.get() + j * num_pq_chunks;
+                uint8_t *code = pVec.get() + j * code_len;
+                uint64_t bits = 0;
+                uint32_t n_bits = 0;
+                for (size_t i = 0; i < num_pq_chunks; i++)
+                {
+                    bits |= (uint64_t)ids[i] << n_bits;
+                    for (n_bits += num_bits; n_bits >= 8; n_bits -= 8, bits >>= 8)
+                        *code++ = (uint8_t)bits;
+                }
+                if (n_bits > 0)
+                    *code = (uint8_t)bits;
+            }
+            compressed_file_writer.write((char *)(pVec.get()), cur_blk_size * code_len * sizeof(uint8_t));
         }
         else
         {
@@ -1066,7 +1441,7 @@ int generate_pq_data_from_pivots(const std::string &data_file, uint32_t num_cent
 template <typename T>
 void generate_disk_quantized_data(const std::string &data_file_to_use, const std::string &disk_pq_pivots_path,
                                   const std::string &disk_pq_compressed_vectors_path, diskann::Metric compareMetric,
-                                  const double p_val, size_t &disk_pq_dims)
+                                  const double p_val, size_t &disk_pq_dims, const bool use_opq)
 {
     size_t train_size, train_dim;
     float *train_data;
@@ -1078,15 +1453,26 @@ void generate_disk_quantized_data(const std::string &data_file_to_use, const std
     if (disk_pq_dims > train_dim)
         disk_pq_dims = train_dim;
 
-    std::cout << "Compressing base for disk-PQ into " << disk_pq_dims << " chunks " << std::endl;
-    generate_pq_pivots(train_data, train_size, (uint32_t)train_dim, 256, (uint32_t)disk_pq_dims, NUM_KMEANS_REPS_PQ,
-                       disk_pq_pivots_path, false);
+    std::cout << "Compressing base for disk-PQ into " << disk_pq_dims << " chunks " << (use_opq ? "with OPQ" : "")
+              << std::endl;
+    if (use_opq)
+    {
+        generate_opq_pivots(train_data, train_size, (uint32_t)train_dim, 256, (uint32_t)disk_pq_dims,
+                            disk_pq_pivots_path, false);
+    }
+    else
+    {
+        // the search loads a rotation matrix next to the pivots if there is one
+        std::remove(get_rotation_matrix_suffix(disk_pq_pivots_path).c_str());
+        generate_pq_pivots(train_data, train_size, (uint32_t)train_dim, 256, (uint32_t)disk_pq_dims,
+                           NUM_KMEANS_REPS_PQ, disk_pq_pivots_path, false);
+    }
     if (compareMetric == diskann::Metric::INNER_PRODUCT)
         generate_pq_data_from_pivots<float>(data_file_to_use, 256, (uint32_t)disk_pq_dims, disk_pq_pivots_path,
-                                            disk_pq_compressed_vectors_path);
+                                            disk_pq_compressed_vectors_path, use_opq);
     else
         generate_pq_data_from_pivots<T>(data_file_to_use, 256, (uint32_t)disk_pq_dims, disk_pq_pivots_path,
-                                        disk_pq_compressed_vectors_path);
+                                        disk_pq_compressed_vectors_path, use_opq);
 
     delete[] train_data;
 }
@@ -1095,7 +1481,7 @@ template <typename T>
 void generate_quantized_data(const std::string &data_file_to_use, const std::string &pq_pivots_path,
                              const std::string &pq_compressed_vectors_path, diskann::Metric compareMetric,
                              const double p_val, const size_t num_pq_chunks, const bool use_opq,
-                             const std::string &codebook_prefix)
+                             const std::string &codebook_prefix, const uint32_t num_centers)
 {
     size_t train_size, train_dim;
     float *train_data;
@@ -1113,12 +1499,12 @@ void generate_quantized_data(const std::string &data_file_to_use, const std::str
 
         if (!use_opq)
         {
-            generate_pq_pivots(train_data, train_size, (uint32_t)train_dim, NUM_PQ_CENTROIDS, (uint32_t)num_pq_chunks,
+            generate_pq_pivots(train_data, train_size, (uint32_t)train_dim, num_centers, (uint32_t)num_pq_chunks,
                                NUM_KMEANS_REPS_PQ, pq_pivots_path, make_zero_mean);
         }
         else
         {
-            generate_opq_pivots(train_data, train_size, (uint32_t)train_dim, NUM_PQ_CENTROIDS, (uint32_t)num_pq_chunks,
+            generate_opq_pivots(train_data, train_size, (uint32_t)train_dim, num_centers, (uint32_t)num_pq_chunks,
                                 pq_pivots_path, make_zero_mean);
         }
         delete[] train_data;
@@ -1127,7 +1513,7 @@ void generate_quantized_data(const std::string &data_file_to_use, const std::str
     {
         diskann::cout << "Skip Training with predefined pivots in: " << pq_pivots_path << std::endl;
     }
-    generate_pq_data_from_pivots<T>(data_file_to_use, NUM_PQ_CENTROIDS, (uint32_t)num_pq_chunks, pq_pivots_path,
+    generate_pq_data_from_pivots<T>(data_file_to_use, num_centers, (uint32_t)num_pq_chunks, pq_pivots_path,
                                     pq_compressed_vectors_path, use_opq);
 }
 
@@ -1138,6 +1524,16 @@ template DISKANN_DLLEXPORT int generate_pq_data_from_pivots<int8_t>(const std::s
                                                                     const std::string &pq_pivots_path,
                                                                     const std::string &pq_compressed_vectors_path,
                                                                     bool use_opq);
+template DISKANN_DLLEXPORT int generate_pq_data_from_pivots<float16>(const std::string &data_file, uint32_t num_centers,
+                                                                     uint32_t num_pq_chunks,
+                                                                     const std::string &pq_pivots_path,
+                                                                     const std::string &pq_compressed_vectors_path,
+                                                                     bool use_opq);
+template DISKANN_DLLEXPORT int generate_pq_data_from_pivots<bfloat16>(const std::string &data_file,
+                                                                      uint32_t num_centers, uint32_t num_pq_chunks,
+                                                                      const std::string &pq_pivots_path,
+                                                                      const std::string &pq_compressed_vectors_path,
+                                                                      bool use_opq);
 template DISKANN_DLLEXPORT int generate_pq_data_from_pivots<uint8_t>(const std::string &data_file, uint32_t num_centers,
                                                                      uint32_t num_pq_chunks,
                                                                      const std::string &pq_pivots_path,
@@ -1153,37 +1549,62 @@ template DISKANN_DLLEXPORT void generate_disk_quantized_data<int8_t>(const std::
                                                                      const std::string &disk_pq_pivots_path,
                                                                      const std::string &disk_pq_compressed_vectors_path,
                                                                      diskann::Metric compareMetric, const double p_val,
-                                                                     size_t &disk_pq_dims);
+                                                                     size_t &disk_pq_dims, const bool use_opq);
+template DISKANN_DLLEXPORT void generate_disk_quantized_data<float16>(
+    const std::string &data_file_to_use, const std::string &disk_pq_pivots_path,
+    const std::string &disk_pq_compressed_vectors_path, diskann::Metric compareMetric, const double p_val,
+    size_t &disk_pq_dims, const bool use_opq);
+template DISKANN_DLLEXPORT void generate_disk_quantized_data<bfloat16>(
+    const std::string &data_file_to_use, const std::string &disk_pq_pivots_path,
+    const std::string &disk_pq_compressed_vectors_path, diskann::Metric compareMetric, const double p_val,
+    size_t &disk_pq_dims, const bool use_opq);
 
 template DISKANN_DLLEXPORT void generate_disk_quantized_data<uint8_t>(
     const std::string &data_file_to_use, const std::string &disk_pq_pivots_path,
     const std::string &disk_pq_compressed_vectors_path, diskann::Metric compareMetric, const double p_val,
-    size_t &disk_pq_dims);
+    size_t &disk_pq_dims, const bool use_opq);
 
 template DISKANN_DLLEXPORT void generate_disk_quantized_data<float>(const std::string &data_file_to_use,
                                                                     const std::string &disk_pq_pivots_path,
                                                                     const std::string &disk_pq_compressed_vectors_path,
                                                                     diskann::Metric compareMetric, const double p_val,
-                                                                    size_t &disk_pq_dims);
+                                                                    size_t &disk_pq_dims, const bool use_opq);
 
 template DISKANN_DLLEXPORT void generate_quantized_data<int8_t>(const std::string &data_file_to_use,
                                                                 const std::string &pq_pivots_path,
                                                                 const std::string &pq_compressed_vectors_path,
                                                                 diskann::Metric compareMetric, const double p_val,
                                                                 const size_t num_pq_chunks, const bool use_opq,
-                                                                const std::string &codebook_prefix);
+                                                                const std::string &codebook_prefix,
+                                                                const uint32_t num_centers);
+template DISKANN_DLLEXPORT void generate_quantized_data<float16>(const std::string &data_file_to_use,
+                                                                 const std::string &pq_pivots_path,
+                                                                 const std::string &pq_compressed_vectors_path,
+                                                                 diskann::Metric compareMetric, const double p_val,
+                                                                 const size_t num_pq_chunks, const bool use_opq,
+                                                                 const std::string &codebook_prefix,
+                                                                 const uint32_t num_centers);
+template DISKANN_DLLEXPORT void generate_quantized_data<bfloat16>(const std::string &data_file_to_use,
+                                                                  const std::string &pq_pivots_path,
+                                                                  const std::string &pq_compressed_vectors_path,
+                                                                  diskann::Metric compareMetric, const double p_val,
+                                                                  const size_t num_pq_chunks, const bool use_opq,
+                                                                  const std::string &codebook_prefix,
+                                                                  const uint32_t num_centers);
 
 template DISKANN_DLLEXPORT void generate_quantized_data<uint8_t>(const std::string &data_file_to_use,
                                                                  const std::string &pq_pivots_path,
                                                                  const std::string &pq_compressed_vectors_path,
                                                                  diskann::Metric compareMetric, const double p_val,
                                                                  const size_t num_pq_chunks, const bool use_opq,
-                                                                 const std::string &codebook_prefix);
+                                                                 const std::string &codebook_prefix,
+                                                                 const uint32_t num_centers);
 
 template DISKANN_DLLEXPORT void generate_quantized_data<float>(const std::string &data_file_to_use,
                                                                const std::string &pq_pivots_path,
                                                                const std::string &pq_compressed_vectors_path,
                                                                diskann::Metric compareMetric, const double p_val,
                                                                const size_t num_pq_chunks, const bool use_opq,
-                                                               const std::string &codebook_prefix);
+                                                               const std::string &codebook_prefix,
+                                                               const uint32_t num_centers);
 } // namespace diskann
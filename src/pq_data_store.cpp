@@ -41,7 +41,7 @@ template <typename data_t> location_t PQDataStore<data_t>::load(const std::strin
 }
 template <typename data_t> size_t PQDataStore<data_t>::save(const std::string &filename, const location_t num_points)
 {
-    return diskann::save_bin(filename, _quantized_data, this->capacity(), _num_chunks, 0);
+    return diskann::save_bin(filename, _quantized_data, this->capacity(), code_len(), 0);
 }
 
 template <typename data_t> size_t PQDataStore<data_t>::get_aligned_dim() const
@@ -73,12 +73,12 @@ template <typename data_t> void PQDataStore<data_t>::populate_data(const std::st
     auto compressed_file = _pq_distance_fn->get_quantized_vectors_filename(filename);
 
     generate_quantized_data<data_t>(filename, pivots_file, compressed_file, _distance_metric, p_val, _num_chunks,
-                                    _pq_distance_fn->is_opq());
+                                    _pq_distance_fn->is_opq(), "", _pq_distance_fn->get_num_centers());
 
     // REFACTOR TODO: Not sure of the alignment. Just copying from index.cpp
-    alloc_aligned(((void **)&_quantized_data), file_num_points * _num_chunks * sizeof(uint8_t), 1);
-    copy_aligned_data_from_file<uint8_t>(compressed_file.c_str(), _quantized_data, file_num_points, _num_chunks,
-                                         _num_chunks);
+    size_t len = code_len();
+    alloc_aligned(((void **)&_quantized_data), file_num_points * len * sizeof(uint8_t), 1);
+    copy_aligned_data_from_file<uint8_t>(compressed_file.c_str(), _quantized_data, file_num_points, len, len);
 #ifdef EXEC_ENV_OLS
     throw ANNException("load_pq_centroid_bin should not be called when "
                        "EXEC_ENV_OLS is defined.",
@@ -117,8 +117,8 @@ template <typename data_t> void PQDataStore<data_t>::set_vector(const location_t
 
 template <typename data_t> void PQDataStore<data_t>::prefetch_vector(const location_t loc)
 {
-    const uint8_t *ptr = _quantized_data + ((size_t)loc) * _num_chunks * sizeof(data_t);
-    diskann::prefetch_vector((const char *)ptr, _num_chunks * sizeof(data_t));
+    const uint8_t *ptr = _quantized_data + ((size_t)loc) * code_len();
+    diskann::prefetch_vector((const char *)ptr, code_len());
 }
 
 template <typename data_t>
@@ -132,8 +132,8 @@ void PQDataStore<data_t>::move_vectors(const location_t old_location_start, cons
 template <typename data_t>
 void PQDataStore<data_t>::copy_vectors(const location_t from_loc, const location_t to_loc, const location_t num_points)
 {
-    // REFACTOR TODO: Is the number of bytes correct?
-    memcpy(_quantized_data + to_loc * _num_chunks, _quantized_data + from_loc * _num_chunks, _num_chunks * num_points);
+    const size_t len = code_len();
+    memcpy(_quantized_data + to_loc * len, _quantized_data + from_loc * len, len * num_points);
 }
 
 // REFACTOR TODO: Currently, we take aligned_query as parameter, but this
@@ -180,8 +180,12 @@ void PQDataStore<data_t>::get_distance(const data_t *preprocessed_query, const l
     {
         throw diskann::ANNException("PQScratch not set in scratch space.", -1);
     }
-    diskann::aggregate_coords(locations, location_count, _quantized_data, this->_num_chunks,
-                              pq_scratch->aligned_pq_coord_scratch);
+    if (_pq_distance_fn->get_num_centers() == NUM_PQ_CENTROIDS)
+        diskann::aggregate_coords_transposed(locations, location_count, _quantized_data, this->_num_chunks,
+                                             pq_scratch->aligned_pq_coord_scratch);
+    else
+        diskann::aggregate_coords(locations, location_count, _quantized_data, code_len(),
+                                  pq_scratch->aligned_pq_coord_scratch);
     _pq_distance_fn->preprocessed_distance(*pq_scratch, location_count, distances);
 }
 
@@ -198,7 +202,11 @@ void PQDataStore<data_t>::get_distance(const data_t *preprocessed_query, const s
     {
         throw diskann::ANNException("PQScratch not set in scratch space.", -1);
     }
-    diskann::aggregate_coords(ids, _quantized_data, this->_num_chunks, pq_scratch->aligned_pq_coord_scratch);
+    if (_pq_distance_fn->get_num_centers() == NUM_PQ_CENTROIDS)
+        diskann::aggregate_coords_transposed(ids, _quantized_data, this->_num_chunks,
+                                             pq_scratch->aligned_pq_coord_scratch);
+    else
+        diskann::aggregate_coords(ids, _quantized_data, code_len(), pq_scratch->aligned_pq_coord_scratch);
     _pq_distance_fn->preprocessed_distance(*pq_scratch, (location_t)ids.size(), distances);
 }
 
@@ -227,9 +235,19 @@ template <typename data_t> location_t PQDataStore<data_t>::load_impl(const std::
     }
     auto quantized_vectors_file = _pq_distance_fn->get_quantized_vectors_filename(file_prefix);
 
-    size_t num_points;
-    load_aligned_bin(quantized_vectors_file, _quantized_data, num_points, _num_chunks, _num_chunks);
+    size_t num_points, file_code_len;
+    load_aligned_bin(quantized_vectors_file, _quantized_data, num_points, file_code_len, file_code_len);
     this->_capacity = (location_t)num_points;
+    // 8-bit codes give the chunk count, nibble-packed 4-bit ones only half of it
+    if (_pq_distance_fn->get_num_centers() == NUM_PQ_CENTROIDS)
+        _num_chunks = file_code_len;
+    if (file_code_len != code_len())
+    {
+        std::stringstream ss;
+        ss << "Compressed vectors in " << quantized_vectors_file << " have " << file_code_len
+           << " bytes per point, expected " << code_len() << " for " << _num_chunks << " chunks";
+        throw diskann::ANNException(ss.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
 
     auto pivots_file = _pq_distance_fn->get_pivot_data_filename(file_prefix);
     _pq_distance_fn->load_pivot_data(pivots_file, _num_chunks);
@@ -237,6 +255,13 @@ template <typename data_t> location_t PQDataStore<data_t>::load_impl(const std::
     return this->_capacity;
 }
 
+template <typename data_t> size_t PQDataStore<data_t>::code_len() const
+{
+    const uint32_t num_bits =
+        _pq_distance_fn->get_num_centers() == PQ_FAST_SCAN_CENTROIDS ? PQ_FAST_SCAN_BITS : NUM_PQ_BITS;
+    return pq_code_len(_num_chunks, num_bits);
+}
+
 template <typename data_t> location_t PQDataStore<data_t>::expand(const location_t new_size)
 {
     throw std::logic_error("Not implemented yet");
@@ -254,6 +279,8 @@ template <typename data_t> location_t PQDataStore<data_t>::load_impl(AlignedFile
 #endif
 
 template DISKANN_DLLEXPORT class PQDataStore<int8_t>;
+template DISKANN_DLLEXPORT class PQDataStore<float16>;
+template DISKANN_DLLEXPORT class PQDataStore<bfloat16>;
 template DISKANN_DLLEXPORT class PQDataStore<float>;
 template DISKANN_DLLEXPORT class PQDataStore<uint8_t>;
 
@@ -7,6 +7,7 @@
 #include "pq.h"
 #include "pq_scratch.h"
 #include "pq_flash_index.h"
+#include "nhood_codec.h"
 #include "cosine_similarity.h"
 
 #ifdef _WINDOWS
@@ -20,17 +21,20 @@
 #define READ_UNSIGNED(stream, val) stream.read((char *)&val, sizeof(unsigned))
 
 // sector # beyond the end of graph where data for id is present for reordering
-#define VECTOR_SECTOR_NO(id) (((uint64_t)(id)) / _nvecs_per_sector + _reorder_data_start_sector)
+#define VECTOR_SECTOR_NO(id)                                                                                           \
+    ((_nvecs_per_sector > 0 ? ((uint64_t)(id)) / _nvecs_per_sector                                                     \
+                            : ((uint64_t)(id)) * DIV_ROUND_UP(_reorder_vec_len, defaults::SECTOR_LEN)) +               \
+     _reorder_data_start_sector)
 
-// sector # beyond the end of graph where data for id is present for reordering
-#define VECTOR_SECTOR_OFFSET(id) ((((uint64_t)(id)) % _nvecs_per_sector) * _data_dim * sizeof(float))
+// offset in that sector (0 for vectors spanning several sectors)
+#define VECTOR_SECTOR_OFFSET(id) (_nvecs_per_sector > 0 ? (((uint64_t)(id)) % _nvecs_per_sector) * _reorder_vec_len : 0)
 
 namespace diskann
 {
 
 template <typename T, typename LabelT>
 PQFlashIndex<T, LabelT>::PQFlashIndex(std::shared_ptr<AlignedFileReader> &fileReader, diskann::Metric m)
-    : reader(fileReader), metric(m), _thread_data(nullptr)
+    : reader(fileReader), metric(m), _node_cache(new NodeCache()), _thread_data(nullptr)
 {
     diskann::Metric metric_to_invoke = m;
     if (m == diskann::Metric::COSINE || m == diskann::Metric::INNER_PRODUCT)
@@ -55,10 +59,22 @@ PQFlashIndex<T, LabelT>::PQFlashIndex(std::shared_ptr<AlignedFileReader> &fileRe
     this->_dist_cmp_float.reset(diskann::get_distance_function<float>(metric_to_invoke));
 }
 
+template <typename T, typename LabelT> PQFlashIndex<T, LabelT>::NodeCache::~NodeCache()
+{
+    // delete backing bufs for nhood and coord cache
+    if (nhood_cache_buf != nullptr)
+    {
+        delete[] nhood_cache_buf;
+        diskann::aligned_free(coord_cache_buf);
+    }
+}
+
 template <typename T, typename LabelT> PQFlashIndex<T, LabelT>::~PQFlashIndex()
 {
+    stop_cache_refresh();
+
 #ifndef EXEC_ENV_OLS
-    if (data != nullptr)
+    if (data != nullptr && _pq_vectors_mapper == nullptr)
     {
         delete[] data;
     }
@@ -66,13 +82,6 @@ template <typename T, typename LabelT> PQFlashIndex<T, LabelT>::~PQFlashIndex()
 
     if (_centroid_data != nullptr)
         aligned_free(_centroid_data);
-    // delete backing bufs for nhood and coord cache
-    if (_nhood_cache_buf != nullptr)
-    {
-        delete[] _nhood_cache_buf;
-        diskann::aligned_free(_coord_cache_buf);
-    }
-
     if (_load_flag)
     {
         diskann::cout << "Clearing scratch" << std::endl;
@@ -108,6 +117,8 @@ template <typename T, typename LabelT> inline uint64_t PQFlashIndex<T, LabelT>::
 template <typename T, typename LabelT>
 inline char *PQFlashIndex<T, LabelT>::offset_to_node(char *sector_buf, uint64_t node_id)
 {
+    if (_packed_nhoods)
+        return sector_buf + ((uint16_t *)sector_buf)[node_id % _nnodes_per_sector];
     return sector_buf + (_nnodes_per_sector == 0 ? 0 : (node_id % _nnodes_per_sector) * _max_node_len);
 }
 
@@ -116,6 +127,25 @@ template <typename T, typename LabelT> inline uint32_t *PQFlashIndex<T, LabelT>:
     return (unsigned *)(node_buf + _disk_bytes_per_point);
 }
 
+template <typename T, typename LabelT>
+inline uint32_t *PQFlashIndex<T, LabelT>::get_node_nbrs(char *node_buf, uint32_t *nbrs_buf, uint32_t &nnbrs,
+                                                       const uint8_t **nbr_codes)
+{
+    uint32_t *node_nhood = offset_to_node_nhood(node_buf);
+    nnbrs = *node_nhood;
+    uint32_t *nbrs = node_nhood + 1;
+    const uint8_t *nhood_end = (const uint8_t *)(nbrs + nnbrs);
+    if (_packed_nhoods)
+    {
+        nhood_end = (const uint8_t *)nbrs + decode_packed_nhood((const uint8_t *)nbrs, nnbrs, nbrs_buf);
+        nbrs = nbrs_buf;
+    }
+    // inline PQ codes follow the nhood, in the order of the decoded ids
+    if (nbr_codes != nullptr)
+        *nbr_codes = _inline_pq_codes ? nhood_end : nullptr;
+    return nbrs;
+}
+
 template <typename T, typename LabelT> inline T *PQFlashIndex<T, LabelT>::offset_to_node_coords(char *node_buf)
 {
     return (T *)(node_buf);
@@ -125,15 +155,20 @@ template <typename T, typename LabelT>
 void PQFlashIndex<T, LabelT>::setup_thread_data(uint64_t nthreads, uint64_t visited_reserve)
 {
     diskann::cout << "Setting up thread-specific contexts for nthreads: " << nthreads << std::endl;
+    // distance tables of codebooks wider than a byte outgrow the default
+    const size_t pq_table_len =
+        (std::max)((size_t)NUM_PQ_CENTROIDS * MAX_PQ_CHUNKS, (size_t)(pq_table_stride(_pq_num_bits) * _n_chunks));
 // omp parallel for to generate unique thread IDs
 #pragma omp parallel for num_threads((int)nthreads)
     for (int64_t thread = 0; thread < (int64_t)nthreads; thread++)
     {
 #pragma omp critical
         {
-            SSDThreadData<T> *data = new SSDThreadData<T>(this->_aligned_dim, visited_reserve);
+            SSDThreadData<T> *data = new SSDThreadData<T>(this->_aligned_dim, visited_reserve, pq_table_len);
             this->reader->register_thread();
             data->ctx = this->reader->get_ctx();
+            this->reader->register_buffer(data->ctx, data->scratch.sector_scratch,
+                                          defaults::MAX_N_SECTOR_READS * defaults::SECTOR_LEN);
             this->_thread_data.push(data);
         }
     }
@@ -192,31 +227,91 @@ std::vector<bool> PQFlashIndex<T, LabelT>::read_nodes(const std::vector<uint32_t
 
         if (nbr_buffers[i].second != nullptr)
         {
-            uint32_t *node_nhood = offset_to_node_nhood(node_buf);
-            auto num_nbrs = *node_nhood;
+            uint32_t num_nbrs;
+            uint32_t *node_nbrs = get_node_nbrs(node_buf, nbr_buffers[i].second, num_nbrs);
             nbr_buffers[i].first = num_nbrs;
-            memcpy(nbr_buffers[i].second, node_nhood + 1, num_nbrs * sizeof(uint32_t));
+            if (node_nbrs != nbr_buffers[i].second)
+                memcpy(nbr_buffers[i].second, node_nbrs, num_nbrs * sizeof(uint32_t));
         }
     }
 
     aligned_free(buf);
 
+    // with separate vectors the nodes hold no coords: fetch them from the
+    // vector region, the same way the rerank does
+    if (_separate_vectors)
+        read_separate_vectors(node_ids, coord_buffers, ctx, retval);
+
     return retval;
 }
 
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::read_separate_vectors(const std::vector<uint32_t> &node_ids,
+                                                    std::vector<T *> &coord_buffers, IOContext &ctx,
+                                                    std::vector<bool> &retval)
+{
+    const uint64_t vec_read_len =
+        (_nvecs_per_sector > 0 ? 1 : DIV_ROUND_UP(_reorder_vec_len, defaults::SECTOR_LEN)) * defaults::SECTOR_LEN;
+    std::vector<AlignedRead> read_reqs;
+    std::vector<size_t> req_nodes;
+    for (size_t i = 0; i < node_ids.size(); i++)
+    {
+        if (coord_buffers[i] != nullptr && retval[i])
+            req_nodes.push_back(i);
+    }
+    if (req_nodes.empty())
+        return;
+
+    char *buf = nullptr;
+    alloc_aligned((void **)&buf, req_nodes.size() * vec_read_len, defaults::SECTOR_LEN);
+    for (size_t r = 0; r < req_nodes.size(); r++)
+        read_reqs.emplace_back(VECTOR_SECTOR_NO(node_ids[req_nodes[r]]) * defaults::SECTOR_LEN, vec_read_len,
+                               buf + r * vec_read_len);
+
+    reader->read(read_reqs, ctx);
+
+    for (size_t r = 0; r < req_nodes.size(); r++)
+    {
+        size_t i = req_nodes[r];
+#if defined(_WINDOWS) && defined(USE_BING_INFRA)
+        if ((*ctx.m_pRequestsStatus)[r] != IOContext::READ_SUCCESS)
+        {
+            retval[i] = false;
+            continue;
+        }
+#endif
+        memcpy(coord_buffers[i], buf + r * vec_read_len + VECTOR_SECTOR_OFFSET(node_ids[i]),
+               (std::min)(_reorder_vec_len, _data_dim * sizeof(T)));
+    }
+
+    aligned_free(buf);
+}
+
 template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_list(std::vector<uint32_t> &node_list)
 {
     diskann::cout << "Loading the cache list into memory.." << std::flush;
+    std::shared_ptr<const NodeCache> node_cache = build_node_cache(node_list);
+    std::atomic_store(&_node_cache, node_cache);
+    diskann::cout << "..done." << std::endl;
+}
+
+template <typename T, typename LabelT>
+std::shared_ptr<typename PQFlashIndex<T, LabelT>::NodeCache> PQFlashIndex<T, LabelT>::build_node_cache(
+    const std::vector<uint32_t> &node_list)
+{
+    std::shared_ptr<NodeCache> node_cache(new NodeCache());
     size_t num_cached_nodes = node_list.size();
+    if (num_cached_nodes == 0)
+        return node_cache;
 
     // Allocate space for neighborhood cache
-    _nhood_cache_buf = new uint32_t[num_cached_nodes * (_max_degree + 1)];
-    memset(_nhood_cache_buf, 0, num_cached_nodes * (_max_degree + 1));
+    node_cache->nhood_cache_buf = new uint32_t[num_cached_nodes * (_max_degree + 1)];
+    memset(node_cache->nhood_cache_buf, 0, num_cached_nodes * (_max_degree + 1) * sizeof(uint32_t));
 
     // Allocate space for coordinate cache
     size_t coord_cache_buf_len = num_cached_nodes * _aligned_dim;
-    diskann::alloc_aligned((void **)&_coord_cache_buf, coord_cache_buf_len * sizeof(T), 8 * sizeof(T));
-    memset(_coord_cache_buf, 0, coord_cache_buf_len * sizeof(T));
+    diskann::alloc_aligned((void **)&node_cache->coord_cache_buf, coord_cache_buf_len * sizeof(T), 8 * sizeof(T));
+    memset(node_cache->coord_cache_buf, 0, coord_cache_buf_len * sizeof(T));
 
     size_t BLOCK_SIZE = 8;
     size_t num_blocks = DIV_ROUND_UP(num_cached_nodes, BLOCK_SIZE);
@@ -232,8 +327,8 @@ template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_
         for (size_t node_idx = start_idx; node_idx < end_idx; node_idx++)
         {
             nodes_to_read.push_back(node_list[node_idx]);
-            coord_buffers.push_back(_coord_cache_buf + node_idx * _aligned_dim);
-            nbr_buffers.emplace_back(0, _nhood_cache_buf + node_idx * (_max_degree + 1));
+            coord_buffers.push_back(node_cache->coord_cache_buf + node_idx * _aligned_dim);
+            nbr_buffers.emplace_back(0, node_cache->nhood_cache_buf + node_idx * (_max_degree + 1));
         }
 
         // issue the reads
@@ -244,12 +339,193 @@ template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_
         {
             if (read_status[i] == true)
             {
-                _coord_cache.insert(std::make_pair(nodes_to_read[i], coord_buffers[i]));
-                _nhood_cache.insert(std::make_pair(nodes_to_read[i], nbr_buffers[i]));
+                node_cache->coord_cache.insert(std::make_pair(nodes_to_read[i], coord_buffers[i]));
+                node_cache->nhood_cache.insert(std::make_pair(nodes_to_read[i], nbr_buffers[i]));
+            }
+        }
+    }
+    return node_cache;
+}
+
+// Snapshot layout: a header of seven uint64_t (#cached nodes, nhood row length,
+// aligned dim, sizeof(T), #points in the index, size of the disk index file
+// and the medoid, the last two telling apart rebuilds of the same shape), then
+// the node ids, the neighbor counts, the nhood rows and the coordinate rows,
+// each as one array.
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::save_cache_snapshot(const std::string &snapshot_path)
+{
+    std::shared_ptr<const NodeCache> node_cache = get_node_cache();
+    uint64_t num_cached = node_cache->nhood_cache.size();
+    uint64_t row_len = _max_degree + 1;
+
+    // repack, since nodes that failed to load leave holes in the cache bufs
+    std::vector<uint32_t> ids, nnbrs;
+    std::vector<uint32_t> nhoods(num_cached * row_len);
+    std::vector<T> coords(num_cached * _aligned_dim);
+    ids.reserve(num_cached);
+    nnbrs.reserve(num_cached);
+    for (auto &entry : node_cache->nhood_cache)
+    {
+        uint64_t idx = ids.size();
+        ids.push_back(entry.first);
+        nnbrs.push_back(entry.second.first);
+        // only the first nnbrs ids of a row are meaningful, the rest stay 0
+        memcpy(nhoods.data() + idx * row_len, entry.second.second, entry.second.first * sizeof(uint32_t));
+        memcpy(coords.data() + idx * _aligned_dim, node_cache->coord_cache.at(entry.first), _aligned_dim * sizeof(T));
+    }
+
+    std::ofstream writer;
+    open_file_to_write(writer, snapshot_path);
+    uint64_t index_file_size = get_file_size(_disk_index_file);
+    uint64_t header[7] = {num_cached, row_len, _aligned_dim, sizeof(T), _num_points, index_file_size, _medoids[0]};
+    writer.write((char *)header, sizeof(header));
+    writer.write((char *)ids.data(), num_cached * sizeof(uint32_t));
+    writer.write((char *)nnbrs.data(), num_cached * sizeof(uint32_t));
+    writer.write((char *)nhoods.data(), nhoods.size() * sizeof(uint32_t));
+    writer.write((char *)coords.data(), coords.size() * sizeof(T));
+    writer.close();
+    diskann::cout << "Saved cache snapshot of " << num_cached << " nodes to " << snapshot_path << std::endl;
+}
+
+template <typename T, typename LabelT>
+bool PQFlashIndex<T, LabelT>::load_cache_snapshot(const std::string &snapshot_path)
+{
+    if (!file_exists(snapshot_path))
+        return false;
+
+    std::ifstream snapshot_reader(snapshot_path, std::ios::binary);
+    uint64_t header[7];
+    snapshot_reader.read((char *)header, sizeof(header));
+    uint64_t num_cached = header[0], row_len = _max_degree + 1;
+    uint64_t expected_size =
+        sizeof(header) + num_cached * (2 + row_len) * sizeof(uint32_t) + num_cached * _aligned_dim * sizeof(T);
+    if (snapshot_reader.fail() || header[1] != row_len || header[2] != _aligned_dim || header[3] != sizeof(T) ||
+        header[4] != _num_points || header[5] != get_file_size(_disk_index_file) || header[6] != _medoids[0] ||
+        get_file_size(snapshot_path) != expected_size)
+    {
+        diskann::cerr << "Cache snapshot " << snapshot_path << " does not match the loaded index, ignoring it."
+                      << std::endl;
+        return false;
+    }
+
+    diskann::cout << "Loading cache snapshot of " << num_cached << " nodes from " << snapshot_path << ".."
+                  << std::flush;
+    std::shared_ptr<NodeCache> node_cache(new NodeCache());
+    if (num_cached > 0)
+    {
+        std::vector<uint32_t> ids(num_cached), nnbrs(num_cached);
+        node_cache->nhood_cache_buf = new uint32_t[num_cached * row_len];
+        diskann::alloc_aligned((void **)&node_cache->coord_cache_buf, num_cached * _aligned_dim * sizeof(T),
+                               8 * sizeof(T));
+        snapshot_reader.read((char *)ids.data(), num_cached * sizeof(uint32_t));
+        snapshot_reader.read((char *)nnbrs.data(), num_cached * sizeof(uint32_t));
+        snapshot_reader.read((char *)node_cache->nhood_cache_buf, num_cached * row_len * sizeof(uint32_t));
+        snapshot_reader.read((char *)node_cache->coord_cache_buf, num_cached * _aligned_dim * sizeof(T));
+        if (snapshot_reader.fail())
+        {
+            diskann::cerr << "..failed to read cache snapshot " << snapshot_path << std::endl;
+            return false;
+        }
+
+        // searches use cached ids as indices without checking them, so a
+        // corrupt file must not get into the cache
+        for (uint64_t i = 0; i < num_cached; i++)
+        {
+            bool valid = ids[i] < _num_points && nnbrs[i] <= _max_degree;
+            const uint32_t *nbrs = node_cache->nhood_cache_buf + i * row_len;
+            for (uint32_t j = 0; valid && j < nnbrs[i]; j++)
+                valid = nbrs[j] < _num_points;
+            if (!valid)
+            {
+                diskann::cerr << "..cache snapshot " << snapshot_path << " has an invalid entry for node " << ids[i]
+                              << ", ignoring it." << std::endl;
+                return false;
             }
         }
+
+        for (uint64_t i = 0; i < num_cached; i++)
+        {
+            node_cache->nhood_cache.insert(
+                std::make_pair(ids[i], std::make_pair(nnbrs[i], node_cache->nhood_cache_buf + i * row_len)));
+            node_cache->coord_cache.insert(std::make_pair(ids[i], node_cache->coord_cache_buf + i * _aligned_dim));
+        }
     }
+    std::atomic_store(&_node_cache, std::shared_ptr<const NodeCache>(node_cache));
     diskann::cout << "..done." << std::endl;
+    return true;
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::start_cache_refresh(uint64_t num_nodes_to_cache, uint32_t period_sec)
+{
+    stop_cache_refresh();
+
+    for (auto &counter : this->_node_visit_counter)
+        counter.store(0, std::memory_order_relaxed);
+    this->_count_visited_nodes = true;
+
+    _stop_cache_refresh = false;
+    _cache_refresh_thread = std::thread([this, num_nodes_to_cache, period_sec]() {
+        std::unique_lock<std::mutex> lk(_cache_refresh_mutex);
+        while (!_cache_refresh_cv.wait_for(lk, std::chrono::seconds(period_sec),
+                                           [this]() { return _stop_cache_refresh; }))
+        {
+            lk.unlock();
+            refresh_node_cache(num_nodes_to_cache);
+            lk.lock();
+        }
+    });
+}
+
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::stop_cache_refresh()
+{
+    if (!_cache_refresh_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(_cache_refresh_mutex);
+        _stop_cache_refresh = true;
+    }
+    _cache_refresh_cv.notify_all();
+    _cache_refresh_thread.join();
+    this->_count_visited_nodes = false;
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::refresh_node_cache(uint64_t num_nodes_to_cache)
+{
+    // rank nodes by visits since the last refresh (with older visits decayed),
+    // halving the counts as we go. Searches keep counting concurrently, so the
+    // counters are only ever accessed atomically.
+    std::vector<std::pair<uint32_t, uint32_t>> visited;
+    for (uint32_t i = 0; i < _node_visit_counter.size(); i++)
+    {
+        auto &counter = this->_node_visit_counter[i];
+        uint32_t count = counter.load();
+        if (count == 0)
+            continue;
+        counter.fetch_sub(count - count / 2);
+        visited.emplace_back(count, i);
+    }
+
+    num_nodes_to_cache = std::min(num_nodes_to_cache, (uint64_t)visited.size());
+    std::partial_sort(visited.begin(), visited.begin() + num_nodes_to_cache, visited.end(),
+                      [](const std::pair<uint32_t, uint32_t> &left, const std::pair<uint32_t, uint32_t> &right) {
+                          return left.first > right.first;
+                      });
+    std::vector<uint32_t> node_list;
+    node_list.reserve(num_nodes_to_cache);
+    for (uint64_t i = 0; i < num_nodes_to_cache; i++)
+        node_list.push_back(visited[i].second);
+
+    // an idle period keeps the current cache
+    if (node_list.empty())
+        return;
+
+    std::shared_ptr<const NodeCache> node_cache = build_node_cache(node_list);
+    std::atomic_store(&_node_cache, node_cache);
+    diskann::cout << "Refreshed node cache with " << node_list.size() << " nodes" << std::endl;
 }
 
 #ifdef EXEC_ENV_OLS
@@ -278,15 +554,6 @@ void PQFlashIndex<T, LabelT>::generate_cache_list_from_sample_queries(std::strin
         return;
     }
 
-    this->_count_visited_nodes = true;
-    this->_node_visit_counter.clear();
-    this->_node_visit_counter.resize(this->_num_points);
-    for (uint32_t i = 0; i < _node_visit_counter.size(); i++)
-    {
-        this->_node_visit_counter[i].first = i;
-        this->_node_visit_counter[i].second = 0;
-    }
-
     uint64_t sample_num, sample_dim, sample_aligned_dim;
     T *samples;
 
@@ -310,6 +577,11 @@ void PQFlashIndex<T, LabelT>::generate_cache_list_from_sample_queries(std::strin
     std::vector<uint64_t> tmp_result_ids_64(sample_num, 0);
     std::vector<float> tmp_result_dists(sample_num, 0);
 
+    // a running cache refresh keeps counting afterwards, from zero
+    for (auto &counter : this->_node_visit_counter)
+        counter.store(0, std::memory_order_relaxed);
+    bool was_counting = this->_count_visited_nodes.exchange(true);
+
     bool filtered_search = false;
     std::vector<LabelT> random_query_filters(sample_num);
     if (_filter_to_medoid_ids.size() != 0)
@@ -329,19 +601,27 @@ void PQFlashIndex<T, LabelT>::generate_cache_list_from_sample_queries(std::strin
                            tmp_result_dists.data() + i, beamwidth, filtered_search, label_for_search, false);
     }
 
-    std::sort(this->_node_visit_counter.begin(), _node_visit_counter.end(),
+    this->_count_visited_nodes = was_counting;
+
+    // sort a snapshot, as a cache refresh may be reading the counters
+    std::vector<std::pair<uint32_t, uint32_t>> visited(this->_node_visit_counter.size());
+    for (uint32_t i = 0; i < visited.size(); i++)
+    {
+        visited[i].first = i;
+        visited[i].second = this->_node_visit_counter[i].load(std::memory_order_relaxed);
+    }
+    std::sort(visited.begin(), visited.end(),
               [](std::pair<uint32_t, uint32_t> &left, std::pair<uint32_t, uint32_t> &right) {
                   return left.second > right.second;
               });
     node_list.clear();
     node_list.shrink_to_fit();
-    num_nodes_to_cache = std::min(num_nodes_to_cache, this->_node_visit_counter.size());
+    num_nodes_to_cache = std::min(num_nodes_to_cache, visited.size());
     node_list.reserve(num_nodes_to_cache);
     for (uint64_t i = 0; i < num_nodes_to_cache; i++)
     {
-        node_list.push_back(this->_node_visit_counter[i].first);
+        node_list.push_back(visited[i].first);
     }
-    this->_count_visited_nodes = false;
 
     diskann::aligned_free(samples);
 }
@@ -489,6 +769,50 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
     diskann::cout << "done" << std::endl;
 }
 
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::set_sector_cache(uint64_t budget_bytes, uint32_t num_shards)
+{
+    if (budget_bytes == 0)
+    {
+        _sector_cache.reset();
+        return;
+    }
+
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    _sector_cache.reset(new SectorCache(budget_bytes, num_sectors_per_node * defaults::SECTOR_LEN, num_shards));
+    diskann::cout << "Sector cache holds up to " << _sector_cache->capacity() << " entries of "
+                  << _sector_cache->entry_len() << "B" << std::endl;
+}
+
+template <typename T, typename LabelT> SectorCache::Stats PQFlashIndex<T, LabelT>::get_sector_cache_stats()
+{
+    return _sector_cache != nullptr ? _sector_cache->get_stats() : SectorCache::Stats();
+}
+
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::reset_sector_cache_stats()
+{
+    if (_sector_cache != nullptr)
+        _sector_cache->reset_stats();
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::admit_to_sector_cache(const std::vector<AlignedRead> &read_reqs)
+{
+    if (_sector_cache == nullptr)
+        return;
+
+    const uint64_t entry_len = _sector_cache->entry_len();
+    for (auto &req : read_reqs)
+    {
+        // coalesced reads hold several consecutive entries
+        for (uint64_t offset = 0; offset + entry_len <= req.len; offset += entry_len)
+        {
+            _sector_cache->insert((req.offset + offset) / defaults::SECTOR_LEN, (char *)req.buf + offset);
+        }
+    }
+}
+
 template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::use_medoids_data_as_centroids()
 {
     if (_centroid_data != nullptr)
@@ -773,6 +1097,46 @@ template <typename T, typename LabelT> int PQFlashIndex<T, LabelT>::load(uint32_
 #endif
 }
 
+#ifndef EXEC_ENV_OLS
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::set_pq_vectors_mmap(bool populate, bool huge_pages)
+{
+    _mmap_pq_vectors = true;
+    _mmap_pq_populate = populate;
+    _mmap_pq_huge_pages = huge_pages;
+}
+
+template <typename T, typename LabelT>
+bool PQFlashIndex<T, LabelT>::map_pq_vectors(const std::string &pq_compressed_vectors, size_t &npts, size_t &nchunks)
+{
+    _pq_vectors_mapper.reset(new MemoryMapper(pq_compressed_vectors, _mmap_pq_populate, _mmap_pq_huge_pages));
+    char *buf = _pq_vectors_mapper->getBuf();
+    size_t file_size = _pq_vectors_mapper->getFileSize();
+    if (buf == nullptr || file_size < 2 * sizeof(int32_t))
+    {
+        diskann::cerr << "Could not map compressed PQ vectors file " << pq_compressed_vectors << std::endl;
+        _pq_vectors_mapper.reset();
+        return false;
+    }
+
+    // same layout as load_bin: int32 #points, int32 #chunks, then the codes
+    npts = (size_t)((int32_t *)buf)[0];
+    nchunks = (size_t)((int32_t *)buf)[1];
+    if (file_size != 2 * sizeof(int32_t) + npts * nchunks)
+    {
+        diskann::cerr << "Compressed PQ vectors file " << pq_compressed_vectors << " has size " << file_size
+                      << " but its header says " << npts << " x " << nchunks << std::endl;
+        _pq_vectors_mapper.reset();
+        return false;
+    }
+    this->data = (uint8_t *)buf + 2 * sizeof(int32_t);
+    diskann::cout << "Mapped compressed PQ vectors: #pts = " << npts << ", #chunks = " << nchunks
+                  << (_mmap_pq_populate ? ", populated" : "") << (_mmap_pq_huge_pages ? ", huge pages" : "")
+                  << std::endl;
+    return true;
+}
+#endif
+
 #ifdef EXEC_ENV_OLS
 template <typename T, typename LabelT>
 int PQFlashIndex<T, LabelT>::load_from_separate_paths(diskann::MemoryMappedFiles &files, uint32_t num_threads,
@@ -806,9 +1170,13 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
 
     this->_disk_index_file = _disk_index_file;
 
-    if (pq_file_num_centroids != 256)
+    this->_pq_num_bits = 0;
+    while (((size_t)1 << this->_pq_num_bits) < pq_file_num_centroids)
+        this->_pq_num_bits++;
+    if (((size_t)1 << this->_pq_num_bits) != pq_file_num_centroids || !is_valid_pq_bits(this->_pq_num_bits))
     {
-        diskann::cout << "Error. Number of PQ centroids is not 256. Exiting." << std::endl;
+        diskann::cout << "Error. Number of PQ centroids is not " << PQ_FAST_SCAN_CENTROIDS << " or a power of two from "
+                      << NUM_PQ_CENTROIDS << " to " << (1 << MAX_PQ_BITS) << ". Exiting." << std::endl;
         return -1;
     }
 
@@ -822,10 +1190,21 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
 #ifdef EXEC_ENV_OLS
     diskann::load_bin<uint8_t>(files, pq_compressed_vectors, this->data, npts_u64, nchunks_u64);
 #else
-    diskann::load_bin<uint8_t>(pq_compressed_vectors, this->data, npts_u64, nchunks_u64);
+    if (_mmap_pq_vectors)
+    {
+        if (!map_pq_vectors(pq_compressed_vectors, npts_u64, nchunks_u64))
+            return -1;
+    }
+    else
+    {
+        diskann::load_bin<uint8_t>(pq_compressed_vectors, this->data, npts_u64, nchunks_u64);
+    }
 #endif
 
+    // the file holds the bytes per code; wider codes than a byte do not tell
+    // the number of chunks, which then comes from the pivots below
     this->_num_points = npts_u64;
+    this->_pq_code_len = nchunks_u64;
     this->_n_chunks = nchunks_u64;
 #ifdef EXEC_ENV_OLS
     if (files.fileExists(labels_file))
@@ -966,17 +1345,29 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
         }
     }
 
+    const size_t expected_chunks = _pq_num_bits == NUM_PQ_BITS ? nchunks_u64 : 0;
 #ifdef EXEC_ENV_OLS
-    _pq_table.load_pq_centroid_bin(files, pq_table_bin.c_str(), nchunks_u64);
+    _pq_table.load_pq_centroid_bin(files, pq_table_bin.c_str(), expected_chunks);
 #else
-    _pq_table.load_pq_centroid_bin(pq_table_bin.c_str(), nchunks_u64);
+    _pq_table.load_pq_centroid_bin(pq_table_bin.c_str(), expected_chunks);
 #endif
+    this->_n_chunks = _pq_table.get_num_chunks();
+    if (pq_code_len(_n_chunks, _pq_num_bits) != _pq_code_len)
+    {
+        std::stringstream stream;
+        stream << "Compressed vectors have " << _pq_code_len << " bytes per point but the PQ pivots give "
+               << _n_chunks << " chunks of " << _pq_num_bits << " bits" << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+    _pq_fast_scan = _pq_table.get_num_centers() == PQ_FAST_SCAN_CENTROIDS;
+    if (_pq_fast_scan)
+        diskann::cout << "Using fast-scan for 4-bit PQ distances" << std::endl;
 
     diskann::cout << "Loaded PQ centroids and in-memory compressed vectors. #points: " << _num_points
                   << " #dim: " << _data_dim << " #aligned_dim: " << _aligned_dim << " #chunks: " << _n_chunks
-                  << std::endl;
+                  << " #bits: " << _pq_num_bits << std::endl;
 
-    if (_n_chunks > MAX_PQ_CHUNKS)
+    if (_pq_code_len > MAX_PQ_CHUNKS)
     {
         std::stringstream stream;
         stream << "Error loading index. Ensure that max PQ bytes for in-memory "
@@ -1008,6 +1399,36 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
                       << std::endl;
     }
 
+#ifndef EXEC_ENV_OLS
+    std::string rabitq_pivots_path = get_rabitq_pivots_filename(this->_disk_index_file);
+    std::string rabitq_codes_path = get_rabitq_codes_filename(this->_disk_index_file);
+    if (file_exists(rabitq_pivots_path) && file_exists(rabitq_codes_path))
+    {
+        if (metric != diskann::Metric::L2)
+        {
+            diskann::cout << "Ignoring the RaBitQ codes of the index, which only support the L2 metric." << std::endl;
+        }
+        else
+        {
+            _rabitq.load(rabitq_pivots_path);
+            size_t rabitq_npts, rabitq_record_len;
+            diskann::load_bin<uint8_t>(rabitq_codes_path, _rabitq_codes, rabitq_npts, rabitq_record_len);
+            if (_rabitq.get_dim() != _data_dim || rabitq_npts != _num_points ||
+                rabitq_record_len != _rabitq.record_len())
+            {
+                std::stringstream stream;
+                stream << "RaBitQ codes " << rabitq_codes_path << " do not match the index: " << rabitq_npts
+                       << " points of " << rabitq_record_len << " bytes for dimension " << _rabitq.get_dim()
+                       << std::endl;
+                throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+            }
+            _use_rabitq = true;
+            diskann::cout << "Filtering neighbors with in-memory RaBitQ codes of " << rabitq_record_len
+                          << " bytes per point." << std::endl;
+        }
+    }
+#endif
+
 // read index metadata
 #ifdef EXEC_ENV_OLS
     // This is a bit tricky. We have to read the header from the
@@ -1048,16 +1469,6 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
     READ_U64(index_metadata, medoid_id_on_file);
     READ_U64(index_metadata, _max_node_len);
     READ_U64(index_metadata, _nnodes_per_sector);
-    _max_degree = ((_max_node_len - _disk_bytes_per_point) / sizeof(uint32_t)) - 1;
-
-    if (_max_degree > defaults::MAX_GRAPH_DEGREE)
-    {
-        std::stringstream stream;
-        stream << "Error loading index. Ensure that max graph degree (R) does "
-                  "not exceed "
-               << defaults::MAX_GRAPH_DEGREE << std::endl;
-        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
-    }
 
     // setting up concept of frozen points in disk index for streaming-DiskANN
     READ_U64(index_metadata, this->_num_frozen_points);
@@ -1071,10 +1482,26 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
                       << ". Will not output it at search time." << std::endl;
     }
 
-    READ_U64(index_metadata, this->_reorder_data_exists);
+    // 1: float reorder data after the graph, 2: the full vectors after the
+    // graph and no coords in the nodes
+    uint64_t reorder_data_kind;
+    READ_U64(index_metadata, reorder_data_kind);
+    this->_reorder_data_exists = reorder_data_kind != 0;
+    this->_separate_vectors = reorder_data_kind == 2;
+    if (this->_separate_vectors)
+    {
+        if (this->_use_disk_index_pq)
+        {
+            throw ANNException("Disk index with separate vectors can not use disk PQ", -1, __FUNCSIG__, __FILE__,
+                               __LINE__);
+        }
+        _disk_bytes_per_point = 0;
+        diskann::cout << "Disk index stores full vectors apart from the graph, fetching them to rerank"
+                      << std::endl;
+    }
     if (this->_reorder_data_exists)
     {
-        if (this->_use_disk_index_pq == false)
+        if (this->_use_disk_index_pq == false && !this->_separate_vectors)
         {
             throw ANNException("Reordering is designed for used with disk PQ "
                                "compression option",
@@ -1083,6 +1510,53 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
         READ_U64(index_metadata, this->_reorder_data_start_sector);
         READ_U64(index_metadata, this->_ndims_reorder_vecs);
         READ_U64(index_metadata, this->_nvecs_per_sector);
+        this->_reorder_vec_len = this->_ndims_reorder_vecs * (this->_separate_vectors ? sizeof(T) : sizeof(float));
+    }
+
+    // indexes written before packed nhoods end with the file size
+    uint64_t num_meta_read = this->_reorder_data_exists ? 11 : 8;
+    if (nr > num_meta_read + 1)
+    {
+        uint64_t disk_index_file_size, nhood_format;
+        READ_U64(index_metadata, disk_index_file_size);
+        READ_U64(index_metadata, nhood_format);
+        _packed_nhoods = nhood_format == 1;
+        if (_packed_nhoods)
+            diskann::cout << "Disk index stores packed neighbor lists" << std::endl;
+    }
+    if (nr > num_meta_read + 2)
+    {
+        uint64_t inline_pq_chunks;
+        READ_U64(index_metadata, inline_pq_chunks);
+        if (inline_pq_chunks != 0 && inline_pq_chunks != _pq_code_len)
+        {
+            std::stringstream stream;
+            stream << "Disk index inlines " << inline_pq_chunks << " byte PQ codes of neighbors but the PQ "
+                   << "compressed vectors have " << _pq_code_len << " bytes per point" << std::endl;
+            throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+        }
+        _inline_pq_codes = inline_pq_chunks != 0;
+        if (_inline_pq_codes)
+            diskann::cout << "Disk index stores the PQ codes of neighbors inline" << std::endl;
+    }
+    // set by restripe_disk_index
+    uint64_t num_stripes = 1, stripe_sectors = 0;
+    if (nr > num_meta_read + 4)
+    {
+        READ_U64(index_metadata, num_stripes);
+        READ_U64(index_metadata, stripe_sectors);
+    }
+
+    // each neighbor takes its id and, if inlined, its PQ code
+    _max_degree = (_max_node_len - _disk_bytes_per_point - sizeof(uint32_t)) /
+                  (sizeof(uint32_t) + (_inline_pq_codes ? _pq_code_len : 0));
+    if (_max_degree > defaults::MAX_GRAPH_DEGREE)
+    {
+        std::stringstream stream;
+        stream << "Error loading index. Ensure that max graph degree (R) does "
+                  "not exceed "
+               << defaults::MAX_GRAPH_DEGREE << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
     }
 
     diskann::cout << "Disk-Index File Meta-data: ";
@@ -1099,7 +1573,32 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
 #ifndef EXEC_ENV_OLS
     // open AlignedFileReader handle to index_file
     std::string index_fname(_disk_index_file);
-    reader->open(index_fname);
+    if (num_stripes > 1)
+    {
+        // the stripes hold the sectors, index_fname only the metadata
+        std::vector<std::string> stripe_files;
+        std::ifstream stripes_reader(index_fname + "_stripes.txt");
+        std::string stripe_file;
+        while (std::getline(stripes_reader, stripe_file))
+        {
+            if (!stripe_file.empty())
+                stripe_files.push_back(stripe_file);
+        }
+        if (stripe_files.size() != num_stripes)
+        {
+            std::stringstream stream;
+            stream << "Disk index is striped over " << num_stripes << " files but " << index_fname
+                   << "_stripes.txt lists " << stripe_files.size() << std::endl;
+            throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+        }
+        diskann::cout << "Disk index is striped over " << num_stripes << " files in units of " << stripe_sectors
+                      << " sector(s)" << std::endl;
+        reader->open_striped(stripe_files, stripe_sectors);
+    }
+    else
+    {
+        reader->open(index_fname);
+    }
     this->setup_thread_data(num_threads);
     this->_max_nthreads = num_threads;
 
@@ -1186,6 +1685,43 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
         diskann::cout << "Setting re-scaling factor of base vectors to " << this->_max_base_norm << std::endl;
         delete[] norm_val;
     }
+
+    std::string id_map_file = std::string(_disk_index_file) + "_id_map.bin";
+#ifdef EXEC_ENV_OLS
+    if (files.fileExists(id_map_file))
+    {
+        uint32_t *id_map;
+        size_t num_ids, tmp_dim;
+        diskann::load_bin<uint32_t>(files, id_map_file, id_map, num_ids, tmp_dim);
+#else
+    if (file_exists(id_map_file))
+    {
+        uint32_t *id_map;
+        size_t num_ids, tmp_dim;
+        diskann::load_bin<uint32_t>(id_map_file, id_map, num_ids, tmp_dim);
+#endif
+        if (num_ids != _num_points || tmp_dim != 1)
+        {
+            std::stringstream stream;
+            stream << "Error loading id map. Expected bin format of " << _num_points << " times 1 uint32_t."
+                   << std::endl;
+            throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+        }
+        _id_map.assign(id_map, id_map + num_ids);
+        delete[] id_map;
+        diskann::cout << "Disk index is reordered, mapping results back to original ids" << std::endl;
+    }
+
+    // searches count node visits into this while _count_visited_nodes is set
+    _node_visit_counter = std::vector<std::atomic<uint32_t>>(_num_points);
+
+    // Full precision distances are computed over _aligned_dim elements, except
+    // when re-ranking, which falls back to the generic kernels.
+    Distance<T> *fixed_length_cmp = _dist_cmp->specialize((uint32_t)this->_aligned_dim);
+    if (fixed_length_cmp != nullptr)
+    {
+        _dist_cmp.reset(fixed_length_cmp);
+    }
     diskann::cout << "done.." << std::endl;
     return 0;
 }
@@ -1265,32 +1801,14 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
 }
 
 template <typename T, typename LabelT>
-void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t k_search, const uint64_t l_search,
-                                                 uint64_t *indices, float *distances, const uint64_t beam_width,
-                                                 const bool use_filter, const LabelT &filter_label,
-                                                 const uint32_t io_limit, const bool use_reorder_data,
-                                                 QueryStats *stats)
+float PQFlashIndex<T, LabelT>::preprocess_query(const T *query1, SSDQueryScratch<T> *query_scratch)
 {
-
-    uint64_t num_sector_per_nodes = DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
-    if (beam_width > num_sector_per_nodes * defaults::MAX_N_SECTOR_READS)
-        throw ANNException("Beamwidth can not be higher than defaults::MAX_N_SECTOR_READS", -1, __FUNCSIG__, __FILE__,
-                           __LINE__);
-
-    ScratchStoreManager<SSDThreadData<T>> manager(this->_thread_data);
-    auto data = manager.scratch_space();
-    IOContext &ctx = data->ctx;
-    auto query_scratch = &(data->scratch);
-    auto pq_query_scratch = query_scratch->pq_scratch();
-
-    // reset query scratch
-    query_scratch->reset();
+    auto pq_query_scratch = query_scratch->pq_scratch();
 
     // copy query to thread specific aligned and allocated memory (for distance
     // calculations we need aligned data)
     float query_norm = 0;
     T *aligned_query_T = query_scratch->aligned_query_T();
-    float *query_float = pq_query_scratch->aligned_query_float;
     float *query_rotated = pq_query_scratch->rotated_query;
 
     // normalization step. for cosine, we simply normalize the query
@@ -1324,38 +1842,76 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
         pq_query_scratch->initialize(this->_data_dim, aligned_query_T);
     }
 
-    // pointers to buffers for data
-    T *data_buf = query_scratch->coord_scratch;
-    _mm_prefetch((char *)data_buf, _MM_HINT_T1);
-
-    // sector scratch
-    char *sector_scratch = query_scratch->sector_scratch;
-    uint64_t &sector_scratch_idx = query_scratch->sector_idx;
-    const uint64_t num_sectors_per_node =
-        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
-
     // query <-> PQ chunk centers distances
     _pq_table.preprocess_query(query_rotated); // center the query and rotate if
                                                // we have a rotation matrix
-    float *pq_dists = pq_query_scratch->aligned_pqtable_dist_scratch;
-    _pq_table.populate_chunk_distances(query_rotated, pq_dists);
+    _pq_table.populate_chunk_distances(query_rotated, pq_query_scratch->aligned_pqtable_dist_scratch);
+    if (_pq_fast_scan)
+        diskann::quantize_fast_scan_lut(pq_query_scratch->aligned_pqtable_dist_scratch, this->_n_chunks,
+                                        pq_query_scratch->aligned_fast_scan_lut, pq_query_scratch->fast_scan_scale,
+                                        pq_query_scratch->fast_scan_bias);
+
+    // the disk PQ codes may have a rotation (OPQ) of their own
+    if (_use_disk_index_pq)
+    {
+        memcpy(query_scratch->disk_pq_query, pq_query_scratch->aligned_query_float, _data_dim * sizeof(float));
+        _disk_pq_table.preprocess_query(query_scratch->disk_pq_query);
+    }
 
-    // query <-> neighbor list
-    float *dist_scratch = pq_query_scratch->aligned_dist_scratch;
-    uint8_t *pq_coord_scratch = pq_query_scratch->aligned_pq_coord_scratch;
+    // the PQ tables are filled, so rotated_query is free to hold the
+    // RaBitQ rotation of the query
+    if (_use_rabitq)
+        _rabitq.preprocess_query(pq_query_scratch->aligned_query_float, query_rotated, pq_query_scratch->rabitq_query);
 
-    // lambda to batch compute query<-> node distances in PQ space
-    auto compute_dists = [this, pq_coord_scratch, pq_dists](const uint32_t *ids, const uint64_t n_ids,
-                                                            float *dists_out) {
-        diskann::aggregate_coords(ids, n_ids, this->data, this->_n_chunks, pq_coord_scratch);
-        diskann::pq_dist_lookup(pq_coord_scratch, n_ids, this->_n_chunks, pq_dists, dists_out);
-    };
-    Timer query_timer, io_timer, cpu_timer;
+    return query_norm;
+}
 
-    tsl::robin_set<uint64_t> &visited = query_scratch->visited;
-    NeighborPriorityQueue &retset = query_scratch->retset;
-    retset.reserve(l_search);
-    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
+template <typename T, typename LabelT>
+inline void PQFlashIndex<T, LabelT>::compute_pq_dists(PQScratch<T> *pq_query_scratch, const uint32_t *ids,
+                                                      const uint64_t n_ids, float *dists_out)
+{
+    if (_pq_num_bits == NUM_PQ_BITS)
+    {
+        diskann::aggregate_coords_transposed(ids, n_ids, this->data, this->_n_chunks,
+                                             pq_query_scratch->aligned_pq_coord_scratch);
+        diskann::pq_dist_lookup_transposed(pq_query_scratch->aligned_pq_coord_scratch, n_ids, this->_n_chunks,
+                                           pq_query_scratch->aligned_pqtable_dist_scratch, dists_out);
+        return;
+    }
+    diskann::aggregate_coords(ids, n_ids, this->data, this->_pq_code_len, pq_query_scratch->aligned_pq_coord_scratch);
+    pq_codes_dists(pq_query_scratch, pq_query_scratch->aligned_pq_coord_scratch, n_ids, dists_out);
+}
+
+template <typename T, typename LabelT>
+inline void PQFlashIndex<T, LabelT>::pq_codes_dists(PQScratch<T> *pq_query_scratch, const uint8_t *codes,
+                                                    const uint64_t n_ids, float *dists_out)
+{
+    if (_pq_fast_scan)
+    {
+        diskann::pack_fast_scan_codes(codes, n_ids, this->_n_chunks, pq_query_scratch->aligned_fast_scan_codes);
+        diskann::pq_fast_scan_lookup(pq_query_scratch->aligned_fast_scan_codes, n_ids, this->_n_chunks,
+                                     pq_query_scratch->aligned_fast_scan_lut, pq_query_scratch->fast_scan_scale,
+                                     pq_query_scratch->fast_scan_bias, dists_out);
+        return;
+    }
+    if (_pq_num_bits == NUM_PQ_BITS)
+    {
+        diskann::transpose_pq_codes(codes, n_ids, this->_n_chunks, pq_query_scratch->aligned_pq_coord_scratch);
+        diskann::pq_dist_lookup_transposed(pq_query_scratch->aligned_pq_coord_scratch, n_ids, this->_n_chunks,
+                                           pq_query_scratch->aligned_pqtable_dist_scratch, dists_out);
+        return;
+    }
+    diskann::pq_dist_lookup(codes, n_ids, this->_n_chunks, pq_query_scratch->aligned_pqtable_dist_scratch, dists_out,
+                            _pq_num_bits);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::init_search_state(SSDQueryScratch<T> *query_scratch, const bool use_filter,
+                                                const LabelT &filter_label)
+{
+    auto pq_query_scratch = query_scratch->pq_scratch();
+    float *query_float = pq_query_scratch->aligned_query_float;
+    float *dist_scratch = pq_query_scratch->aligned_dist_scratch;
 
     uint32_t best_medoid = 0;
     float best_dist = (std::numeric_limits<float>::max)();
@@ -1381,7 +1937,7 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
             {
                 // for filtered index, we dont store global centroid data as for unfiltered index, so we use PQ distance
                 // as approximation to decide closest medoid matching the query filter.
-                compute_dists(&medoid_ids[cur_m], 1, dist_scratch);
+                compute_pq_dists(pq_query_scratch, &medoid_ids[cur_m], 1, dist_scratch);
                 float cur_expanded_dist = dist_scratch[0];
                 if (cur_expanded_dist < best_dist)
                 {
@@ -1396,11 +1952,467 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
         }
     }
 
-    compute_dists(&best_medoid, 1, dist_scratch);
-    retset.insert(Neighbor(best_medoid, dist_scratch[0]));
-    visited.insert(best_medoid);
+    compute_pq_dists(pq_query_scratch, &best_medoid, 1, dist_scratch);
+    query_scratch->retset.insert(Neighbor(best_medoid, dist_scratch[0]));
+    query_scratch->visited.insert(best_medoid);
+}
+
+template <typename T, typename LabelT>
+inline void PQFlashIndex<T, LabelT>::expand_node(SSDQueryScratch<T> *query_scratch, const uint32_t node_id,
+                                                 T *node_coords, const uint64_t nnbrs, uint32_t *node_nbrs,
+                                                 const bool use_filter, const LabelT &filter_label,
+                                                 QueryStats *stats, const uint8_t *nbr_codes,
+                                                 const float *node_dist)
+{
+    auto pq_query_scratch = query_scratch->pq_scratch();
+    float *dist_scratch = pq_query_scratch->aligned_dist_scratch;
+    tsl::robin_set<size_t> &visited = query_scratch->visited;
+    NeighborPriorityQueue &retset = query_scratch->retset;
+    Timer cpu_timer;
+
+    float cur_expanded_dist;
+    if (_separate_vectors)
+    {
+        // the node has no coords; rank it by PQ distance until the rerank
+        uint32_t id = node_id;
+        compute_pq_dists(pq_query_scratch, &id, 1, dist_scratch);
+        cur_expanded_dist = dist_scratch[0];
+    }
+    else if (node_dist != nullptr)
+    {
+        cur_expanded_dist = *node_dist;
+    }
+    else if (!_use_disk_index_pq)
+    {
+        cur_expanded_dist = _dist_cmp->compare(query_scratch->aligned_query_T(), node_coords, (uint32_t)_aligned_dim);
+    }
+    else
+    {
+        if (metric == diskann::Metric::INNER_PRODUCT)
+            cur_expanded_dist = _disk_pq_table.inner_product(query_scratch->disk_pq_query, (uint8_t *)node_coords);
+        else
+            cur_expanded_dist = _disk_pq_table.l2_distance(query_scratch->disk_pq_query, (uint8_t *)node_coords);
+    }
+    query_scratch->full_retset.push_back(Neighbor(node_id, cur_expanded_dist));
+
+    if (_use_rabitq)
+    {
+        // keep the new neighbors that may still enter the candidate list
+        // judging by their RaBitQ bounds, and rank only those by PQ distance
+        uint32_t *cand_ids = query_scratch->rabitq_ids;
+        uint32_t *cand_pos = query_scratch->rabitq_pos;
+        uint64_t n_cands = 0;
+        for (uint64_t m = 0; m < nnbrs; ++m)
+        {
+            uint32_t id = node_nbrs[m];
+            if (!visited.insert(id).second)
+                continue;
+            if (!use_filter && _dummy_pts.find(id) != _dummy_pts.end())
+                continue;
+            if (use_filter && !(point_has_label(id, filter_label)) &&
+                (!_use_universal_label || !point_has_label(id, _universal_filter_label)))
+                continue;
+            cand_pos[n_cands] = (uint32_t)m;
+            cand_ids[n_cands++] = id;
+        }
+        _rabitq.estimate(pq_query_scratch->rabitq_query, _rabitq_codes.get(), cand_ids, n_cands,
+                         query_scratch->rabitq_dists, query_scratch->rabitq_bounds);
+
+        const float worst_dist = retset.size() == retset.capacity() ? retset[retset.size() - 1].distance
+                                                                    : (std::numeric_limits<float>::max)();
+        uint64_t n_kept = 0;
+        for (uint64_t i = 0; i < n_cands; i++)
+        {
+            if (query_scratch->rabitq_dists[i] - query_scratch->rabitq_bounds[i] < worst_dist)
+            {
+                cand_pos[n_kept] = cand_pos[i];
+                cand_ids[n_kept++] = cand_ids[i];
+            }
+        }
+        // from the codes inlined in the node when the disk index has them
+        if (nbr_codes != nullptr)
+        {
+            uint8_t *kept_codes = query_scratch->rabitq_codes;
+            for (uint64_t i = 0; i < n_kept; i++)
+                memcpy(kept_codes + i * _pq_code_len, nbr_codes + cand_pos[i] * _pq_code_len, _pq_code_len);
+            pq_codes_dists(pq_query_scratch, kept_codes, n_kept, dist_scratch);
+        }
+        else
+            compute_pq_dists(pq_query_scratch, cand_ids, n_kept, dist_scratch);
+        if (stats != nullptr)
+        {
+            stats->n_cmps += (uint32_t)n_kept;
+        }
+        for (uint64_t i = 0; i < n_kept; i++)
+            retset.insert(Neighbor(cand_ids[i], dist_scratch[i]));
+
+        if (stats != nullptr)
+        {
+            stats->cpu_us += (float)cpu_timer.elapsed();
+        }
+        return;
+    }
+
+    // compute node_nbrs <-> query dists in PQ space, from the codes inlined
+    // in the node when the disk index has them
+    if (nbr_codes != nullptr)
+        pq_codes_dists(pq_query_scratch, nbr_codes, nnbrs, dist_scratch);
+    else
+        compute_pq_dists(pq_query_scratch, node_nbrs, nnbrs, dist_scratch);
+    if (stats != nullptr)
+    {
+        stats->n_cmps += (uint32_t)nnbrs;
+    }
+
+    // process prefetched nhood
+    for (uint64_t m = 0; m < nnbrs; ++m)
+    {
+        uint32_t id = node_nbrs[m];
+        if (visited.insert(id).second)
+        {
+            if (!use_filter && _dummy_pts.find(id) != _dummy_pts.end())
+                continue;
+
+            if (use_filter && !(point_has_label(id, filter_label)) &&
+                (!_use_universal_label || !point_has_label(id, _universal_filter_label)))
+                continue;
+            float dist = dist_scratch[m];
+            Neighbor nn(id, dist);
+            retset.insert(nn);
+        }
+    }
+
+    if (stats != nullptr)
+    {
+        stats->cpu_us += (float)cpu_timer.elapsed();
+    }
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::expand_cached_nodes(
+    SSDQueryScratch<T> *query_scratch, const tsl::robin_map<uint32_t, T *> &coord_cache,
+    const std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t *>>> &cached_nhoods, const bool use_filter,
+    const LabelT &filter_label, QueryStats *stats)
+{
+    std::vector<const T *> &coords = query_scratch->cached_coords;
+    std::vector<float> &dists = query_scratch->cached_dists;
+    coords.clear();
+    for (auto &cached_nhood : cached_nhoods)
+    {
+        coords.push_back(coord_cache.find(cached_nhood.first)->second);
+    }
+    // otherwise expand_node ranks the nodes by PQ distance
+    const bool full_precision = !_separate_vectors && !_use_disk_index_pq;
+    if (full_precision)
+    {
+        dists.resize(coords.size());
+        _dist_cmp->compare_batch(query_scratch->aligned_query_T(), coords.data(), (uint32_t)coords.size(),
+                                 (uint32_t)_aligned_dim, dists.data());
+    }
+    for (size_t i = 0; i < cached_nhoods.size(); i++)
+    {
+        expand_node(query_scratch, cached_nhoods[i].first, (T *)coords[i], cached_nhoods[i].second.first,
+                    cached_nhoods[i].second.second, use_filter, filter_label, stats, nullptr,
+                    full_precision ? &dists[i] : nullptr);
+    }
+}
+
+template <typename T, typename LabelT>
+inline void PQFlashIndex<T, LabelT>::expand_sector_node(SSDQueryScratch<T> *query_scratch, const uint32_t node_id,
+                                                        char *sector_buf, const bool use_filter,
+                                                        const LabelT &filter_label, QueryStats *stats)
+{
+    char *node_disk_buf = offset_to_node(sector_buf, node_id);
+    uint32_t nnbrs;
+    const uint8_t *nbr_codes;
+    uint32_t *node_nbrs = get_node_nbrs(node_disk_buf, query_scratch->nbr_scratch, nnbrs, &nbr_codes);
+    T *data_buf = query_scratch->coord_scratch;
+    memcpy(data_buf, offset_to_node_coords(node_disk_buf), _disk_bytes_per_point);
+    expand_node(query_scratch, node_id, data_buf, nnbrs, node_nbrs, use_filter, filter_label, stats, nbr_codes);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::plan_frontier_reads(const std::vector<uint32_t> &frontier, char *sector_scratch,
+                                                  std::vector<std::pair<uint32_t, char *>> &frontier_nhoods,
+                                                  std::vector<AlignedRead> &read_reqs, QueryStats *stats,
+                                                  tsl::robin_map<uint64_t, char *> *hop_sectors)
+{
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    const uint64_t node_read_len = num_sectors_per_node * defaults::SECTOR_LEN;
+
+    // visit the frontier in sector order so that shared and adjacent sectors
+    // are next to each other
+    std::vector<std::pair<uint64_t, uint32_t>> sector_to_idx(frontier.size());
+    for (uint32_t i = 0; i < frontier.size(); i++)
+        sector_to_idx[i] = std::make_pair(get_node_sector((size_t)frontier[i]), i);
+    std::sort(sector_to_idx.begin(), sector_to_idx.end());
+
+    const uint64_t first_req = read_reqs.size();
+    std::vector<char *> bufs(frontier.size());
+    char *next_buf = sector_scratch;
+    bool can_extend = false;
+    uint64_t prev_sector = 0;
+    for (size_t i = 0; i < sector_to_idx.size(); i++)
+    {
+        uint64_t sector = sector_to_idx[i].first;
+        if (i > 0 && sector == sector_to_idx[i - 1].first)
+        {
+            bufs[sector_to_idx[i].second] = bufs[sector_to_idx[i - 1].second];
+            if (stats != nullptr)
+                stats->n_reads_saved++;
+            continue;
+        }
+        if (hop_sectors != nullptr)
+        {
+            auto iter = hop_sectors->find(sector);
+            if (iter != hop_sectors->end())
+            {
+                bufs[sector_to_idx[i].second] = iter->second;
+                if (stats != nullptr)
+                    stats->n_reads_saved++;
+                continue;
+            }
+            hop_sectors->insert(std::make_pair(sector, next_buf));
+        }
+
+        bufs[sector_to_idx[i].second] = next_buf;
+        if (_sector_cache != nullptr && _sector_cache->lookup(sector, next_buf))
+        {
+            if (stats != nullptr)
+                stats->n_cache_hits++;
+            next_buf += node_read_len;
+            can_extend = false;
+            continue;
+        }
+
+        if (can_extend && sector == prev_sector + num_sectors_per_node)
+            read_reqs.back().len += node_read_len;
+        else
+            read_reqs.emplace_back(sector * defaults::SECTOR_LEN, node_read_len, next_buf);
+
+        next_buf += node_read_len;
+        prev_sector = sector;
+        can_extend = true;
+    }
+
+    for (size_t i = 0; i < frontier.size(); i++)
+        frontier_nhoods.push_back(std::make_pair(frontier[i], bufs[i]));
+    for (uint64_t r = first_req; r < read_reqs.size(); r++)
+        record_read(stats, read_reqs[r].len);
+}
+
+template <typename T, typename LabelT> bool PQFlashIndex<T, LabelT>::needs_rerank_reads(const bool use_reorder_data)
+{
+    // separate vectors are always fetched, the search only had PQ distances
+    if (_separate_vectors)
+        return true;
+    // nodes holding full-precision coords already gave full_retset exact
+    // distances during the traversal, re-ranking them is just the sort
+    if (!use_reorder_data || !_use_disk_index_pq)
+        return false;
+    if (!(this->_reorder_data_exists))
+    {
+        throw ANNException("Requested use of reordering data which does "
+                           "not exist in index "
+                           "file",
+                           -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+    return true;
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::get_reorder_reads(SSDQueryScratch<T> *query_scratch, const uint64_t k_search,
+                                                const uint32_t rerank_depth, std::vector<AlignedRead> &read_reqs,
+                                                QueryStats *stats)
+{
+    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
+    std::vector<uint64_t> &rerank_sectors = query_scratch->rerank_sectors;
+    char *sector_scratch = query_scratch->sector_scratch;
+
+    const uint64_t num_sectors_per_vec =
+        _nvecs_per_sector > 0 ? 1 : DIV_ROUND_UP(_reorder_vec_len, defaults::SECTOR_LEN);
+    const uint64_t vec_read_len = num_sectors_per_vec * defaults::SECTOR_LEN;
+    const uint64_t max_sectors = defaults::MAX_N_SECTOR_READS / num_sectors_per_vec;
+    const uint64_t depth = rerank_depth > 0 ? rerank_depth : k_search * FULL_PRECISION_REORDER_MULTIPLIER;
+
+    // take candidates until the depth is reached or the sector scratch is
+    // full. Candidates sharing a sector only need it read once.
+    rerank_sectors.clear();
+    uint64_t n_candidates = 0;
+    for (; n_candidates < (std::min)((uint64_t)full_retset.size(), depth); n_candidates++)
+    {
+        uint64_t sector = VECTOR_SECTOR_NO(((size_t)full_retset[n_candidates].id));
+        if (std::find(rerank_sectors.begin(), rerank_sectors.end(), sector) != rerank_sectors.end())
+        {
+            if (stats != nullptr)
+                stats->n_reads_saved++;
+            continue;
+        }
+        if (rerank_sectors.size() == max_sectors)
+            break;
+        rerank_sectors.push_back(sector);
+    }
+    full_retset.erase(full_retset.begin() + n_candidates, full_retset.end());
+
+    // read the sectors in order into consecutive scratch, merging runs of
+    // adjacent ones
+    std::sort(rerank_sectors.begin(), rerank_sectors.end());
+    const uint64_t first_req = read_reqs.size();
+    for (size_t i = 0; i < rerank_sectors.size(); i++)
+    {
+        if (i > 0 && rerank_sectors[i] == rerank_sectors[i - 1] + num_sectors_per_vec)
+            read_reqs.back().len += vec_read_len;
+        else
+            read_reqs.emplace_back(rerank_sectors[i] * defaults::SECTOR_LEN, vec_read_len,
+                                   sector_scratch + i * vec_read_len);
+    }
+    for (uint64_t r = first_req; r < read_reqs.size(); r++)
+        record_read(stats, read_reqs[r].len);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::rerank_full_retset(SSDQueryScratch<T> *query_scratch)
+{
+    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
+    const std::vector<uint64_t> &rerank_sectors = query_scratch->rerank_sectors;
+    char *sector_scratch = query_scratch->sector_scratch;
+    const uint64_t vec_read_len =
+        (_nvecs_per_sector > 0 ? 1 : DIV_ROUND_UP(_reorder_vec_len, defaults::SECTOR_LEN)) * defaults::SECTOR_LEN;
+
+    for (size_t i = 0; i < full_retset.size(); ++i)
+    {
+        auto id = full_retset[i].id;
+        uint64_t sector_idx =
+            std::lower_bound(rerank_sectors.begin(), rerank_sectors.end(), VECTOR_SECTOR_NO(((size_t)id))) -
+            rerank_sectors.begin();
+        auto location = (sector_scratch + sector_idx * vec_read_len) + VECTOR_SECTOR_OFFSET(id);
+        if (_separate_vectors)
+        {
+            // vectors are packed back to back, copy to aligned scratch
+            T *coords = query_scratch->coord_scratch;
+            memcpy(coords, location, _reorder_vec_len);
+            full_retset[i].distance =
+                _dist_cmp->compare(query_scratch->aligned_query_T(), coords, (uint32_t)this->_aligned_dim);
+            continue;
+        }
+        full_retset[i].distance =
+            _dist_cmp->compare(query_scratch->aligned_query_T(), (T *)location, (uint32_t)this->_data_dim);
+    }
+
+    std::sort(full_retset.begin(), full_retset.end());
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::copy_results(SSDQueryScratch<T> *query_scratch, const uint64_t k_search,
+                                           const float query_norm, uint64_t *indices, float *distances)
+{
+    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
+
+    // copy k_search values
+    for (uint64_t i = 0; i < k_search; i++)
+    {
+        indices[i] = full_retset[i].id;
+        auto key = (uint32_t)indices[i];
+        if (_dummy_pts.find(key) != _dummy_pts.end())
+        {
+            indices[i] = _dummy_to_real_map[key];
+        }
+        if (!_id_map.empty())
+        {
+            indices[i] = _id_map[key];
+        }
+
+        if (distances != nullptr)
+        {
+            distances[i] = full_retset[i].distance;
+            if (metric == diskann::Metric::INNER_PRODUCT)
+            {
+                // flip the sign to convert min to max
+                distances[i] = (-distances[i]);
+                // rescale to revert back to original norms (cancelling the
+                // effect of base and query pre-processing)
+                if (_max_base_norm != 0)
+                    distances[i] *= (_max_base_norm * query_norm);
+            }
+        }
+    }
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::finalize_search(SSDQueryScratch<T> *query_scratch, IOContext &ctx,
+                                              const uint64_t k_search, const float query_norm, uint64_t *indices,
+                                              float *distances, const bool use_reorder_data,
+                                              const uint32_t rerank_depth, QueryStats *stats)
+{
+    // re-sort by distance
+    std::sort(query_scratch->full_retset.begin(), query_scratch->full_retset.end());
+
+    if (needs_rerank_reads(use_reorder_data))
+    {
+        std::vector<AlignedRead> vec_read_reqs;
+        get_reorder_reads(query_scratch, k_search, rerank_depth, vec_read_reqs, stats);
+
+        Timer io_timer;
+#ifdef USE_BING_INFRA
+        reader->read(vec_read_reqs, ctx, true); // async reader windows.
+#else
+        reader->read(vec_read_reqs, ctx); // synchronous IO linux
+#endif
+        if (stats != nullptr)
+        {
+            stats->io_us += io_timer.elapsed();
+        }
+
+        rerank_full_retset(query_scratch);
+    }
+
+    copy_results(query_scratch, k_search, query_norm, indices, distances);
+
+#ifdef USE_BING_INFRA
+    ctx.m_completeCount = 0;
+#endif
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t k_search, const uint64_t l_search,
+                                                 uint64_t *indices, float *distances, const uint64_t beam_width,
+                                                 const bool use_filter, const LabelT &filter_label,
+                                                 const uint32_t io_limit, const bool use_reorder_data,
+                                                 QueryStats *stats, const uint32_t rerank_depth)
+{
+
+    uint64_t num_sector_per_nodes = DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    if (beam_width > num_sector_per_nodes * defaults::MAX_N_SECTOR_READS)
+        throw ANNException("Beamwidth can not be higher than defaults::MAX_N_SECTOR_READS", -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+
+    ScratchStoreManager<SSDThreadData<T>> manager(this->_thread_data);
+    auto data = manager.scratch_space();
+    IOContext &ctx = data->ctx;
+    auto query_scratch = &(data->scratch);
+
+    // reset query scratch
+    query_scratch->reset();
+
+    float query_norm = preprocess_query(query1, query_scratch);
+
+    // pointers to buffers for data
+    T *data_buf = query_scratch->coord_scratch;
+    _mm_prefetch((char *)data_buf, _MM_HINT_T1);
+
+    // sector scratch
+    char *sector_scratch = query_scratch->sector_scratch;
+
+    Timer query_timer, io_timer;
+
+    NeighborPriorityQueue &retset = query_scratch->retset;
+    retset.reserve(l_search);
+    init_search_state(query_scratch, use_filter, filter_label);
+
+    // the node cache may be swapped by a refresh while we search
+    std::shared_ptr<const NodeCache> node_cache = get_node_cache();
 
-    uint32_t cmps = 0;
     uint32_t hops = 0;
     uint32_t num_ios = 0;
 
@@ -1421,15 +2433,14 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
         frontier_nhoods.clear();
         frontier_read_reqs.clear();
         cached_nhoods.clear();
-        sector_scratch_idx = 0;
         // find new beam
         uint32_t num_seen = 0;
         while (retset.has_unexpanded_node() && frontier.size() < beam_width && num_seen < beam_width)
         {
             auto nbr = retset.closest_unexpanded();
             num_seen++;
-            auto iter = _nhood_cache.find(nbr.id);
-            if (iter != _nhood_cache.end())
+            auto iter = node_cache->nhood_cache.find(nbr.id);
+            if (iter != node_cache->nhood_cache.end())
             {
                 cached_nhoods.push_back(std::make_pair(nbr.id, iter->second));
                 if (stats != nullptr)
@@ -1443,7 +2454,7 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
             }
             if (this->_count_visited_nodes)
             {
-                reinterpret_cast<std::atomic<uint32_t> &>(this->_node_visit_counter[nbr.id].second).fetch_add(1);
+                this->_node_visit_counter[nbr.id].fetch_add(1, std::memory_order_relaxed);
             }
         }
 
@@ -1452,23 +2463,8 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
         {
             if (stats != nullptr)
                 stats->n_hops++;
-            for (uint64_t i = 0; i < frontier.size(); i++)
-            {
-                auto id = frontier[i];
-                std::pair<uint32_t, char *> fnhood;
-                fnhood.first = id;
-                fnhood.second = sector_scratch + num_sectors_per_node * sector_scratch_idx * defaults::SECTOR_LEN;
-                sector_scratch_idx++;
-                frontier_nhoods.push_back(fnhood);
-                frontier_read_reqs.emplace_back(get_node_sector((size_t)id) * defaults::SECTOR_LEN,
-                                                num_sectors_per_node * defaults::SECTOR_LEN, fnhood.second);
-                if (stats != nullptr)
-                {
-                    stats->n_4k++;
-                    stats->n_ios++;
-                }
-                num_ios++;
-            }
+            plan_frontier_reads(frontier, sector_scratch, frontier_nhoods, frontier_read_reqs, stats);
+            num_ios += (uint32_t)frontier_read_reqs.size();
             io_timer.reset();
 #ifdef USE_BING_INFRA
             reader->read(frontier_read_reqs, ctx,
@@ -1483,56 +2479,7 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
         }
 
         // process cached nhoods
-        for (auto &cached_nhood : cached_nhoods)
-        {
-            auto global_cache_iter = _coord_cache.find(cached_nhood.first);
-            T *node_fp_coords_copy = global_cache_iter->second;
-            float cur_expanded_dist;
-            if (!_use_disk_index_pq)
-            {
-                cur_expanded_dist = _dist_cmp->compare(aligned_query_T, node_fp_coords_copy, (uint32_t)_aligned_dim);
-            }
-            else
-            {
-                if (metric == diskann::Metric::INNER_PRODUCT)
-                    cur_expanded_dist = _disk_pq_table.inner_product(query_float, (uint8_t *)node_fp_coords_copy);
-                else
-                    cur_expanded_dist = _disk_pq_table.l2_distance( // disk_pq does not support OPQ yet
-                        query_float, (uint8_t *)node_fp_coords_copy);
-            }
-            full_retset.push_back(Neighbor((uint32_t)cached_nhood.first, cur_expanded_dist));
-
-            uint64_t nnbrs = cached_nhood.second.first;
-            uint32_t *node_nbrs = cached_nhood.second.second;
-
-            // compute node_nbrs <-> query dists in PQ space
-            cpu_timer.reset();
-            compute_dists(node_nbrs, nnbrs, dist_scratch);
-            if (stats != nullptr)
-            {
-                stats->n_cmps += (uint32_t)nnbrs;
-                stats->cpu_us += (float)cpu_timer.elapsed();
-            }
-
-            // process prefetched nhood
-            for (uint64_t m = 0; m < nnbrs; ++m)
-            {
-                uint32_t id = node_nbrs[m];
-                if (visited.insert(id).second)
-                {
-                    if (!use_filter && _dummy_pts.find(id) != _dummy_pts.end())
-                        continue;
-
-                    if (use_filter && !(point_has_label(id, filter_label)) &&
-                        (!_use_universal_label || !point_has_label(id, _universal_filter_label)))
-                        continue;
-                    cmps++;
-                    float dist = dist_scratch[m];
-                    Neighbor nn(id, dist);
-                    retset.insert(nn);
-                }
-            }
-        }
+        expand_cached_nodes(query_scratch, node_cache->coord_cache, cached_nhoods, use_filter, filter_label, stats);
 #ifdef USE_BING_INFRA
         // process each frontier nhood - compute distances to unvisited nodes
         int completedIndex = -1;
@@ -1542,160 +2489,491 @@ void PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint64_t
         while (requestCount > 0 && getNextCompletedRequest(reader, ctx, requestCount, completedIndex))
         {
             assert(completedIndex >= 0);
-            auto &frontier_nhood = frontier_nhoods[completedIndex];
             (*ctx.m_pRequestsStatus)[completedIndex] = IOContext::PROCESS_COMPLETE;
+            // a read may cover several frontier nodes
+            char *read_begin = (char *)frontier_read_reqs[completedIndex].buf;
+            char *read_end = read_begin + frontier_read_reqs[completedIndex].len;
+            for (auto &frontier_nhood : frontier_nhoods)
+            {
+                if (frontier_nhood.second >= read_begin && frontier_nhood.second < read_end)
+                    expand_sector_node(query_scratch, frontier_nhood.first, frontier_nhood.second, use_filter,
+                                       filter_label, stats);
+            }
+        }
 #else
         for (auto &frontier_nhood : frontier_nhoods)
         {
+            expand_sector_node(query_scratch, frontier_nhood.first, frontier_nhood.second, use_filter, filter_label,
+                               stats);
+        }
 #endif
-            char *node_disk_buf = offset_to_node(frontier_nhood.second, frontier_nhood.first);
-            uint32_t *node_buf = offset_to_node_nhood(node_disk_buf);
-            uint64_t nnbrs = (uint64_t)(*node_buf);
-            T *node_fp_coords = offset_to_node_coords(node_disk_buf);
-            memcpy(data_buf, node_fp_coords, _disk_bytes_per_point);
-            float cur_expanded_dist;
-            if (!_use_disk_index_pq)
-            {
-                cur_expanded_dist = _dist_cmp->compare(aligned_query_T, data_buf, (uint32_t)_aligned_dim);
-            }
-            else
-            {
-                if (metric == diskann::Metric::INNER_PRODUCT)
-                    cur_expanded_dist = _disk_pq_table.inner_product(query_float, (uint8_t *)data_buf);
-                else
-                    cur_expanded_dist = _disk_pq_table.l2_distance(query_float, (uint8_t *)data_buf);
-            }
-            full_retset.push_back(Neighbor(frontier_nhood.first, cur_expanded_dist));
-            uint32_t *node_nbrs = (node_buf + 1);
-            // compute node_nbrs <-> query dist in PQ space
-            cpu_timer.reset();
-            compute_dists(node_nbrs, nnbrs, dist_scratch);
-            if (stats != nullptr)
-            {
-                stats->n_cmps += (uint32_t)nnbrs;
-                stats->cpu_us += (float)cpu_timer.elapsed();
-            }
+        admit_to_sector_cache(frontier_read_reqs);
 
-            cpu_timer.reset();
-            // process prefetch-ed nhood
-            for (uint64_t m = 0; m < nnbrs; ++m)
-            {
-                uint32_t id = node_nbrs[m];
-                if (visited.insert(id).second)
-                {
-                    if (!use_filter && _dummy_pts.find(id) != _dummy_pts.end())
-                        continue;
+        hops++;
+    }
 
-                    if (use_filter && !(point_has_label(id, filter_label)) &&
-                        (!_use_universal_label || !point_has_label(id, _universal_filter_label)))
-                        continue;
-                    cmps++;
-                    float dist = dist_scratch[m];
-                    if (stats != nullptr)
-                    {
-                        stats->n_cmps++;
-                    }
+    finalize_search(query_scratch, ctx, k_search, query_norm, indices, distances, use_reorder_data, rerank_depth,
+                    stats);
 
-                    Neighbor nn(id, dist);
-                    retset.insert(nn);
-                }
+    if (stats != nullptr)
+    {
+        stats->total_us = (float)query_timer.elapsed();
+    }
+}
+
+#ifndef _WINDOWS
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::start_pipelined_query(PipelinedQuery &q, const T *query, const uint64_t k_search,
+                                                    const uint64_t l_search, uint64_t *indices, float *distances,
+                                                    const bool use_filter, const LabelT &filter_label,
+                                                    const bool use_reorder_data, const uint32_t rerank_depth,
+                                                    QueryStats *stats)
+{
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    const uint64_t num_slots = defaults::MAX_N_SECTOR_READS / num_sectors_per_node;
+
+    q.phase = PipelinedQuery::SEARCHING;
+    q.k_search = k_search;
+    q.indices = indices;
+    q.distances = distances;
+    q.use_filter = use_filter;
+    q.filter_label = filter_label;
+    q.use_reorder_data = needs_rerank_reads(use_reorder_data);
+    q.rerank_depth = rerank_depth;
+    q.stats = stats;
+    q.n_in_flight = 0;
+    q.num_ios = 0;
+    q.slot_to_node.resize(num_slots);
+    q.free_slots.clear();
+    for (uint64_t slot = num_slots; slot > 0; slot--)
+        q.free_slots.push_back(slot - 1);
+
+    q.node_cache = get_node_cache();
+    q.scratch->reset();
+    q.query_norm = preprocess_query(query, q.scratch);
+    q.query_timer.reset();
+
+    q.scratch->retset.reserve(l_search);
+    init_search_state(q.scratch, use_filter, filter_label);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::advance_pipelined_query(PipelinedQuery &q, const uint64_t beam_width,
+                                                      const uint32_t io_limit, std::vector<AlignedRead> &read_reqs)
+{
+    if (q.phase != PipelinedQuery::SEARCHING)
+        return;
+
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    const uint64_t slot_len = num_sectors_per_node * defaults::SECTOR_LEN;
+    SSDQueryScratch<T> *query_scratch = q.scratch;
+    NeighborPriorityQueue &retset = query_scratch->retset;
+    QueryStats *stats = q.stats;
+
+    // top up the pipeline with the closest unexpanded candidates. Cached
+    // nodes need no I/O and are expanded on the spot.
+    uint64_t n_issued = 0;
+    while (q.n_in_flight < beam_width && retset.has_unexpanded_node() && q.num_ios < io_limit)
+    {
+        auto nbr = retset.closest_unexpanded();
+        if (this->_count_visited_nodes)
+        {
+            this->_node_visit_counter[nbr.id].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto iter = q.node_cache->nhood_cache.find(nbr.id);
+        if (iter != q.node_cache->nhood_cache.end())
+        {
+            if (stats != nullptr)
+            {
+                stats->n_cache_hits++;
             }
+            expand_node(query_scratch, nbr.id, q.node_cache->coord_cache.find(nbr.id)->second, iter->second.first,
+                        iter->second.second,
+                        q.use_filter, q.filter_label, stats);
+            continue;
+        }
 
+        uint64_t slot = q.free_slots.back();
+        char *slot_buf = query_scratch->sector_scratch + slot * slot_len;
+        uint64_t sector = get_node_sector((size_t)nbr.id);
+        if (_sector_cache != nullptr && _sector_cache->lookup(sector, slot_buf))
+        {
             if (stats != nullptr)
             {
-                stats->cpu_us += (float)cpu_timer.elapsed();
+                stats->n_cache_hits++;
             }
+            expand_sector_node(query_scratch, nbr.id, slot_buf, q.use_filter, q.filter_label, stats);
+            continue;
         }
 
-        hops++;
+        q.free_slots.pop_back();
+        q.slot_to_node[slot] = nbr.id;
+        read_reqs.emplace_back(sector * defaults::SECTOR_LEN, slot_len, slot_buf);
+        record_read(stats, slot_len);
+        q.num_ios++;
+        q.n_in_flight++;
+        n_issued++;
     }
 
-    // re-sort by distance
-    std::sort(full_retset.begin(), full_retset.end());
+    if (n_issued > 0 && stats != nullptr)
+        stats->n_hops++;
+
+    if (q.n_in_flight > 0)
+        return;
 
-    if (use_reorder_data)
+    // nothing left to read: the search itself is done
+    std::sort(query_scratch->full_retset.begin(), query_scratch->full_retset.end());
+    if (q.use_reorder_data)
     {
-        if (!(this->_reorder_data_exists))
-        {
-            throw ANNException("Requested use of reordering data which does "
-                               "not exist in index "
-                               "file",
-                               -1, __FUNCSIG__, __FILE__, __LINE__);
-        }
+        uint64_t n_reqs = read_reqs.size();
+        get_reorder_reads(query_scratch, q.k_search, q.rerank_depth, read_reqs, stats);
+        q.n_in_flight = read_reqs.size() - n_reqs;
+        q.phase = PipelinedQuery::RERANKING;
+        if (q.n_in_flight > 0)
+            return;
+    }
+    finish_pipelined_query(q);
+}
 
-        std::vector<AlignedRead> vec_read_reqs;
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::complete_pipelined_read(PipelinedQuery &q, char *buf)
+{
+    q.n_in_flight--;
+    if (q.phase == PipelinedQuery::RERANKING)
+    {
+        if (q.n_in_flight == 0)
+            finish_pipelined_query(q);
+        return;
+    }
+
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    const uint64_t slot_len = num_sectors_per_node * defaults::SECTOR_LEN;
+    uint64_t slot = (buf - q.scratch->sector_scratch) / slot_len;
+    uint32_t node_id = q.slot_to_node[slot];
+
+    expand_sector_node(q.scratch, node_id, buf, q.use_filter, q.filter_label, q.stats);
+    if (_sector_cache != nullptr)
+        _sector_cache->insert(get_node_sector((size_t)node_id), buf);
 
-        if (full_retset.size() > k_search * FULL_PRECISION_REORDER_MULTIPLIER)
-            full_retset.erase(full_retset.begin() + k_search * FULL_PRECISION_REORDER_MULTIPLIER, full_retset.end());
+    q.free_slots.push_back(slot);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::finish_pipelined_query(PipelinedQuery &q)
+{
+    if (q.phase == PipelinedQuery::RERANKING)
+        rerank_full_retset(q.scratch);
+    copy_results(q.scratch, q.k_search, q.query_norm, q.indices, q.distances);
+    q.phase = PipelinedQuery::DONE;
+    q.node_cache.reset();
+
+    if (q.stats != nullptr)
+    {
+        q.stats->total_us = (float)q.query_timer.elapsed();
+    }
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::pipelined_beam_search(const T *query1, const uint64_t k_search, const uint64_t l_search,
+                                                    uint64_t *indices, float *distances, const uint64_t beam_width,
+                                                    const bool use_filter, const LabelT &filter_label,
+                                                    const uint32_t io_limit, const bool use_reorder_data,
+                                                    QueryStats *stats, const uint32_t rerank_depth)
+{
+    interleaved_beam_search(query1, 1, 0, k_search, l_search, indices, distances, beam_width, 1,
+                            use_filter ? &filter_label : nullptr, io_limit, use_reorder_data, stats, rerank_depth);
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::interleaved_beam_search(const T *queries, const uint64_t num_queries,
+                                                      const uint64_t query_aligned_dim, const uint64_t k_search,
+                                                      const uint64_t l_search, uint64_t *indices, float *distances,
+                                                      const uint64_t beam_width, const uint32_t num_interleaved,
+                                                      const LabelT *filter_labels, const uint32_t io_limit,
+                                                      const bool use_reorder_data, QueryStats *stats,
+                                                      const uint32_t rerank_depth)
+{
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    if (beam_width > defaults::MAX_N_SECTOR_READS / num_sectors_per_node)
+        throw ANNException("Beamwidth can not be higher than defaults::MAX_N_SECTOR_READS", -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+
+    // the first scratch (whose I/O context all queries share) is waited for
+    // like in cached_beam_search. Further ones are only taken if free, so that
+    // threads never block each other holding part of what they need.
+    ScratchStoreManager<SSDThreadData<T>> manager(this->_thread_data);
+    IOContext &ctx = manager.scratch_space()->ctx;
+    std::vector<SSDThreadData<T> *> extra_data =
+        try_acquire_thread_data(std::min<uint64_t>(num_interleaved, num_queries) - 1);
+
+    std::vector<PipelinedQuery> inflight(extra_data.size() + 1);
+    inflight[0].scratch = &(manager.scratch_space()->scratch);
+    for (size_t i = 0; i < extra_data.size(); i++)
+        inflight[i + 1].scratch = &(extra_data[i]->scratch);
 
-        for (size_t i = 0; i < full_retset.size(); ++i)
+    std::vector<AlignedRead> read_reqs;
+    std::vector<void *> completed_bufs;
+    Timer io_timer;
+    uint64_t next_query = 0;
+    while (true)
+    {
+        // start new queries in idle slots and let every query queue its reads
+        read_reqs.clear();
+        uint64_t n_in_flight = 0;
+        for (auto &q : inflight)
         {
-            // MULTISECTORFIX
-            vec_read_reqs.emplace_back(VECTOR_SECTOR_NO(((size_t)full_retset[i].id)) * defaults::SECTOR_LEN,
-                                       defaults::SECTOR_LEN, sector_scratch + i * defaults::SECTOR_LEN);
+            advance_pipelined_query(q, beam_width, io_limit, read_reqs);
+            while (q.phase == PipelinedQuery::DONE && next_query < num_queries)
+            {
+                start_pipelined_query(q, queries + next_query * query_aligned_dim, k_search, l_search,
+                                      indices + next_query * k_search,
+                                      distances != nullptr ? distances + next_query * k_search : nullptr,
+                                      filter_labels != nullptr,
+                                      filter_labels != nullptr ? filter_labels[next_query] : LabelT{},
+                                      use_reorder_data, rerank_depth, stats != nullptr ? stats + next_query : nullptr);
+                next_query++;
+                advance_pipelined_query(q, beam_width, io_limit, read_reqs);
+            }
+            n_in_flight += q.n_in_flight;
+        }
 
-            if (stats != nullptr)
+        if (!read_reqs.empty())
+        {
+            io_timer.reset();
+            reader->submit_reads(read_reqs, ctx);
+            float submit_us = (float)io_timer.elapsed();
+            for (auto &q : inflight)
             {
-                stats->n_4k++;
-                stats->n_ios++;
+                if (q.n_in_flight > 0 && q.stats != nullptr)
+                    q.stats->io_us += submit_us;
             }
         }
 
+        if (n_in_flight == 0)
+            break;
+
+        // wait for at least one read and process everything that has landed
+        completed_bufs.clear();
         io_timer.reset();
-#ifdef USE_BING_INFRA
-        reader->read(vec_read_reqs, ctx, true); // async reader windows.
-#else
-        reader->read(vec_read_reqs, ctx); // synchronous IO linux
-#endif
-        if (stats != nullptr)
+        reader->get_completed_reads(ctx, 1, completed_bufs);
+        float wait_us = (float)io_timer.elapsed();
+        for (auto &q : inflight)
         {
-            stats->io_us += io_timer.elapsed();
+            if (q.n_in_flight > 0 && q.stats != nullptr)
+                q.stats->io_us += wait_us;
         }
 
-        for (size_t i = 0; i < full_retset.size(); ++i)
+        for (void *buf : completed_bufs)
         {
-            auto id = full_retset[i].id;
-            // MULTISECTORFIX
-            auto location = (sector_scratch + i * defaults::SECTOR_LEN) + VECTOR_SECTOR_OFFSET(id);
-            full_retset[i].distance = _dist_cmp->compare(aligned_query_T, (T *)location, (uint32_t)this->_data_dim);
+            char *cbuf = (char *)buf;
+            for (auto &q : inflight)
+            {
+                char *sector_scratch = q.scratch->sector_scratch;
+                if (cbuf >= sector_scratch &&
+                    cbuf < sector_scratch + defaults::MAX_N_SECTOR_READS * defaults::SECTOR_LEN)
+                {
+                    complete_pipelined_read(q, cbuf);
+                    break;
+                }
+            }
         }
+    }
+
+    release_thread_data(extra_data);
+}
+#endif
 
-        std::sort(full_retset.begin(), full_retset.end());
+template <typename T, typename LabelT>
+std::vector<SSDThreadData<T> *> PQFlashIndex<T, LabelT>::try_acquire_thread_data(const uint64_t max_count)
+{
+    std::vector<SSDThreadData<T> *> thread_data;
+    while (thread_data.size() < max_count)
+    {
+        SSDThreadData<T> *data = this->_thread_data.pop();
+        if (data == nullptr)
+            break;
+        thread_data.push_back(data);
     }
+    return thread_data;
+}
 
-    // copy k_search values
-    for (uint64_t i = 0; i < k_search; i++)
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::release_thread_data(std::vector<SSDThreadData<T> *> &thread_data)
+{
+    for (auto data : thread_data)
     {
-        indices[i] = full_retset[i].id;
-        auto key = (uint32_t)indices[i];
-        if (_dummy_pts.find(key) != _dummy_pts.end())
+        data->clear();
+        this->_thread_data.push(data);
+    }
+    this->_thread_data.push_notify_all();
+    thread_data.clear();
+}
+
+template <typename T, typename LabelT>
+void PQFlashIndex<T, LabelT>::batch_cached_beam_search(const T *queries, const uint64_t num_queries,
+                                                       const uint64_t query_aligned_dim, const uint64_t k_search,
+                                                       const uint64_t l_search, uint64_t *indices, float *distances,
+                                                       const uint64_t beam_width, const uint32_t batch_size,
+                                                       const LabelT *filter_labels, const uint32_t io_limit,
+                                                       const bool use_reorder_data, QueryStats *stats,
+                                                       const uint32_t rerank_depth)
+{
+    const uint64_t num_sectors_per_node =
+        _nnodes_per_sector > 0 ? 1 : DIV_ROUND_UP(_max_node_len, defaults::SECTOR_LEN);
+    if (beam_width > defaults::MAX_N_SECTOR_READS / num_sectors_per_node)
+        throw ANNException("Beamwidth can not be higher than defaults::MAX_N_SECTOR_READS", -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+    if (num_queries == 0)
+        return;
+
+    // as in interleaved_beam_search, only the first scratch is waited for
+    ScratchStoreManager<SSDThreadData<T>> manager(this->_thread_data);
+    IOContext &ctx = manager.scratch_space()->ctx;
+    std::vector<SSDThreadData<T> *> extra_data =
+        try_acquire_thread_data(std::min<uint64_t>(std::max<uint32_t>(batch_size, 1), num_queries) - 1);
+
+    std::vector<SSDQueryScratch<T> *> batch_scratch;
+    batch_scratch.push_back(&(manager.scratch_space()->scratch));
+    for (auto data : extra_data)
+        batch_scratch.push_back(&(data->scratch));
+    const uint64_t max_batch = batch_scratch.size();
+
+    std::shared_ptr<const NodeCache> node_cache = get_node_cache();
+    std::vector<float> query_norms(max_batch);
+    std::vector<uint32_t> num_ios(max_batch);
+    std::vector<Timer> query_timers(max_batch);
+    std::vector<uint32_t> frontier;
+    std::vector<std::vector<std::pair<uint32_t, char *>>> frontier_nhoods(max_batch);
+    std::vector<std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t *>>>> cached_nhoods(max_batch);
+    std::vector<AlignedRead> read_reqs;
+    // sector -> buffer it is being read into during the current hop
+    tsl::robin_map<uint64_t, char *> sector_bufs;
+    Timer io_timer;
+
+    for (uint64_t batch_start = 0; batch_start < num_queries; batch_start += max_batch)
+    {
+        const uint64_t cur_batch = std::min(max_batch, num_queries - batch_start);
+
+        for (uint64_t b = 0; b < cur_batch; b++)
         {
-            indices[i] = _dummy_to_real_map[key];
+            const uint64_t q = batch_start + b;
+            SSDQueryScratch<T> *query_scratch = batch_scratch[b];
+            query_scratch->reset();
+            query_norms[b] = preprocess_query(queries + q * query_aligned_dim, query_scratch);
+            query_timers[b].reset();
+            num_ios[b] = 0;
+
+            query_scratch->retset.reserve(l_search);
+            init_search_state(query_scratch, filter_labels != nullptr,
+                              filter_labels != nullptr ? filter_labels[q] : LabelT{});
         }
 
-        if (distances != nullptr)
+        while (true)
         {
-            distances[i] = full_retset[i].distance;
-            if (metric == diskann::Metric::INNER_PRODUCT)
+            // pick every query's next beam and merge the reads
+            read_reqs.clear();
+            sector_bufs.clear();
+            bool any_active = false;
+            for (uint64_t b = 0; b < cur_batch; b++)
             {
-                // flip the sign to convert min to max
-                distances[i] = (-distances[i]);
-                // rescale to revert back to original norms (cancelling the
-                // effect of base and query pre-processing)
-                if (_max_base_norm != 0)
-                    distances[i] *= (_max_base_norm * query_norm);
+                SSDQueryScratch<T> *query_scratch = batch_scratch[b];
+                QueryStats *query_stats = stats != nullptr ? stats + batch_start + b : nullptr;
+                NeighborPriorityQueue &retset = query_scratch->retset;
+                frontier.clear();
+                frontier_nhoods[b].clear();
+                cached_nhoods[b].clear();
+                if (!retset.has_unexpanded_node() || num_ios[b] >= io_limit)
+                    continue;
+                any_active = true;
+
+                uint32_t num_seen = 0;
+                while (retset.has_unexpanded_node() && frontier.size() < beam_width && num_seen < beam_width)
+                {
+                    auto nbr = retset.closest_unexpanded();
+                    num_seen++;
+                    if (this->_count_visited_nodes)
+                    {
+                        this->_node_visit_counter[nbr.id].fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    auto iter = node_cache->nhood_cache.find(nbr.id);
+                    if (iter != node_cache->nhood_cache.end())
+                    {
+                        cached_nhoods[b].push_back(std::make_pair(nbr.id, iter->second));
+                        if (query_stats != nullptr)
+                        {
+                            query_stats->n_cache_hits++;
+                        }
+                        continue;
+                    }
+
+                    frontier.push_back(nbr.id);
+                }
+
+                // sectors already read for another query in this hop are shared
+                uint64_t n_reqs = read_reqs.size();
+                plan_frontier_reads(frontier, query_scratch->sector_scratch, frontier_nhoods[b], read_reqs,
+                                    query_stats, &sector_bufs);
+                num_ios[b] += (uint32_t)(read_reqs.size() - n_reqs);
+
+                if (!frontier_nhoods[b].empty() && query_stats != nullptr)
+                    query_stats->n_hops++;
             }
-        }
-    }
 
-#ifdef USE_BING_INFRA
-    ctx.m_completeCount = 0;
-#endif
+            if (!any_active)
+                break;
 
-    if (stats != nullptr)
-    {
-        stats->total_us = (float)query_timer.elapsed();
+            if (!read_reqs.empty())
+            {
+                io_timer.reset();
+                reader->read(read_reqs, ctx);
+                float io_us = (float)io_timer.elapsed();
+                for (uint64_t b = 0; b < cur_batch; b++)
+                {
+                    if (!frontier_nhoods[b].empty() && stats != nullptr)
+                        stats[batch_start + b].io_us += io_us;
+                }
+                admit_to_sector_cache(read_reqs);
+            }
+
+            for (uint64_t b = 0; b < cur_batch; b++)
+            {
+                const uint64_t q = batch_start + b;
+                SSDQueryScratch<T> *query_scratch = batch_scratch[b];
+                QueryStats *query_stats = stats != nullptr ? stats + q : nullptr;
+                const bool use_filter = filter_labels != nullptr;
+                const LabelT filter_label = use_filter ? filter_labels[q] : LabelT{};
+
+                expand_cached_nodes(query_scratch, node_cache->coord_cache, cached_nhoods[b], use_filter,
+                                    filter_label, query_stats);
+                for (auto &frontier_nhood : frontier_nhoods[b])
+                {
+                    expand_sector_node(query_scratch, frontier_nhood.first, frontier_nhood.second, use_filter,
+                                       filter_label, query_stats);
+                }
+            }
+        }
+
+        for (uint64_t b = 0; b < cur_batch; b++)
+        {
+            const uint64_t q = batch_start + b;
+            QueryStats *query_stats = stats != nullptr ? stats + q : nullptr;
+            finalize_search(batch_scratch[b], ctx, k_search, query_norms[b], indices + q * k_search,
+                            distances != nullptr ? distances + q * k_search : nullptr, use_reorder_data,
+                            rerank_depth, query_stats);
+            if (query_stats != nullptr)
+            {
+                query_stats->total_us = (float)query_timers[b].elapsed();
+            }
+        }
     }
+
+    release_thread_data(extra_data);
 }
 
 // range search returns results of all neighbors within distance of range.
@@ -1773,8 +3051,8 @@ template <typename T, typename LabelT> char *PQFlashIndex<T, LabelT>::getHeaderB
 template <typename T, typename LabelT>
 std::vector<std::uint8_t> PQFlashIndex<T, LabelT>::get_pq_vector(std::uint64_t vid)
 {
-    std::uint8_t *pqVec = &this->data[vid * this->_n_chunks];
-    return std::vector<std::uint8_t>(pqVec, pqVec + this->_n_chunks);
+    std::uint8_t *pqVec = &this->data[vid * this->_pq_code_len];
+    return std::vector<std::uint8_t>(pqVec, pqVec + this->_pq_code_len);
 }
 
 template <typename T, typename LabelT> std::uint64_t PQFlashIndex<T, LabelT>::get_num_points()
@@ -1785,9 +3063,13 @@ template <typename T, typename LabelT> std::uint64_t PQFlashIndex<T, LabelT>::ge
 // instantiations
 template class PQFlashIndex<uint8_t>;
 template class PQFlashIndex<int8_t>;
+template class PQFlashIndex<float16>;
+template class PQFlashIndex<bfloat16>;
 template class PQFlashIndex<float>;
 template class PQFlashIndex<uint8_t, uint16_t>;
 template class PQFlashIndex<int8_t, uint16_t>;
+template class PQFlashIndex<float16, uint16_t>;
+template class PQFlashIndex<bfloat16, uint16_t>;
 template class PQFlashIndex<float, uint16_t>;
 
 } // namespace diskann
@@ -10,7 +10,8 @@ namespace diskann
 {
 
 template <typename data_t>
-PQL2Distance<data_t>::PQL2Distance(uint32_t num_chunks, bool use_opq) : _num_chunks(num_chunks), _is_opq(use_opq)
+PQL2Distance<data_t>::PQL2Distance(uint32_t num_chunks, bool use_opq, uint32_t num_centers)
+    : _num_chunks(num_chunks), _num_centers(num_centers), _is_opq(use_opq)
 {
 }
 
@@ -116,14 +117,15 @@ void PQL2Distance<data_t>::load_pivot_data(const std::string &pq_table_file, siz
     diskann::load_bin<float>(pq_table_file, _tables, nr, nc, file_offset_data[0]);
 #endif
 
-    if ((nr != NUM_PQ_CENTROIDS))
+    if (nr != NUM_PQ_CENTROIDS && nr != PQ_FAST_SCAN_CENTROIDS)
     {
         diskann::cout << "Error reading pq_pivots file " << pq_table_file << ". file_num_centers  = " << nr
-                      << " but expecting " << NUM_PQ_CENTROIDS << " centers";
+                      << " but expecting " << NUM_PQ_CENTROIDS << " or " << PQ_FAST_SCAN_CENTROIDS << " centers";
         throw diskann::ANNException("Error reading pq_pivots file at pivots data.", -1, __FUNCSIG__, __FILE__,
                                     __LINE__);
     }
 
+    this->_num_centers = nr;
     this->_ndims = nc;
 
 #ifdef EXEC_ENV_OLS
@@ -159,7 +161,7 @@ void PQL2Distance<data_t>::load_pivot_data(const std::string &pq_table_file, siz
     }
 
     this->_num_chunks = nr - 1;
-    diskann::cout << "Loaded PQ Pivots: #ctrs: " << NUM_PQ_CENTROIDS << ", #dims: " << this->_ndims
+    diskann::cout << "Loaded PQ Pivots: #ctrs: " << this->_num_centers << ", #dims: " << this->_ndims
                   << ", #chunks: " << this->_num_chunks << std::endl;
 
     // For OPQ there will be a rotation matrix to load.
@@ -179,12 +181,12 @@ void PQL2Distance<data_t>::load_pivot_data(const std::string &pq_table_file, siz
     }
 
     // alloc and compute transpose
-    _tables_tr = new float[256 * this->_ndims];
-    for (size_t i = 0; i < 256; i++)
+    _tables_tr = new float[_num_centers * this->_ndims];
+    for (size_t i = 0; i < _num_centers; i++)
     {
         for (size_t j = 0; j < this->_ndims; j++)
         {
-            _tables_tr[j * 256 + i] = _tables[i * this->_ndims + j];
+            _tables_tr[j * _num_centers + i] = _tables[i * this->_ndims + j];
         }
     }
 }
@@ -194,6 +196,11 @@ template <typename data_t> uint32_t PQL2Distance<data_t>::get_num_chunks() const
     return static_cast<uint32_t>(_num_chunks);
 }
 
+template <typename data_t> uint32_t PQL2Distance<data_t>::get_num_centers() const
+{
+    return static_cast<uint32_t>(_num_centers);
+}
+
 // REFACTOR: Instead of doing half the work in the caller and half in this
 // function, we let this function
 //  do all of the work, making it easier for the caller.
@@ -224,32 +231,44 @@ void PQL2Distance<data_t>::preprocess_query(const data_t *aligned_query, uint32_
         std::memcpy(scratch.rotated_query, tmp.data(), _ndims * sizeof(float));
     }
     this->prepopulate_chunkwise_distances(scratch.rotated_query, scratch.aligned_pqtable_dist_scratch);
+    if (_num_centers == PQ_FAST_SCAN_CENTROIDS)
+        quantize_fast_scan_lut(scratch.aligned_pqtable_dist_scratch, _num_chunks, scratch.aligned_fast_scan_lut,
+                               scratch.fast_scan_scale, scratch.fast_scan_bias);
 }
 
 template <typename data_t>
 void PQL2Distance<data_t>::preprocessed_distance(PQScratch<data_t> &pq_scratch, const uint32_t n_ids, float *dists_out)
 {
-    pq_dist_lookup(pq_scratch.aligned_pq_coord_scratch, n_ids, _num_chunks, pq_scratch.aligned_pqtable_dist_scratch,
-                   dists_out);
+    if (_num_centers == PQ_FAST_SCAN_CENTROIDS)
+    {
+        pack_fast_scan_codes(pq_scratch.aligned_pq_coord_scratch, n_ids, _num_chunks,
+                             pq_scratch.aligned_fast_scan_codes);
+        pq_fast_scan_lookup(pq_scratch.aligned_fast_scan_codes, n_ids, _num_chunks, pq_scratch.aligned_fast_scan_lut,
+                            pq_scratch.fast_scan_scale, pq_scratch.fast_scan_bias, dists_out);
+        return;
+    }
+    pq_dist_lookup_transposed(pq_scratch.aligned_pq_coord_scratch, n_ids, _num_chunks,
+                              pq_scratch.aligned_pqtable_dist_scratch, dists_out);
 }
 
 template <typename data_t>
 void PQL2Distance<data_t>::preprocessed_distance(PQScratch<data_t> &pq_scratch, const uint32_t n_ids,
                                                  std::vector<float> &dists_out)
 {
-    pq_dist_lookup(pq_scratch.aligned_pq_coord_scratch, n_ids, _num_chunks, pq_scratch.aligned_pqtable_dist_scratch,
-                   dists_out);
+    dists_out.resize(n_ids);
+    preprocessed_distance(pq_scratch, n_ids, dists_out.data());
 }
 
 template <typename data_t> float PQL2Distance<data_t>::brute_force_distance(const float *query_vec, uint8_t *base_vec)
 {
     float res = 0;
+    const uint32_t num_bits = _num_centers == PQ_FAST_SCAN_CENTROIDS ? PQ_FAST_SCAN_BITS : NUM_PQ_BITS;
     for (size_t chunk = 0; chunk < _num_chunks; chunk++)
     {
         for (size_t j = _chunk_offsets[chunk]; j < _chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = _tables_tr + (256 * j);
-            float diff = centers_dim_vec[base_vec[chunk]] - (query_vec[j]);
+            const float *centers_dim_vec = _tables_tr + (_num_centers * j);
+            float diff = centers_dim_vec[get_pq_code(base_vec, chunk, num_bits)] - (query_vec[j]);
             res += diff * diff;
         }
     }
@@ -267,8 +286,8 @@ void PQL2Distance<data_t>::prepopulate_chunkwise_distances(const float *query_ve
         float *chunk_dists = dist_vec + (256 * chunk);
         for (size_t j = _chunk_offsets[chunk]; j < _chunk_offsets[chunk + 1]; j++)
         {
-            const float *centers_dim_vec = _tables_tr + (256 * j);
-            for (size_t idx = 0; idx < 256; idx++)
+            const float *centers_dim_vec = _tables_tr + (_num_centers * j);
+            for (size_t idx = 0; idx < _num_centers; idx++)
             {
                 double diff = centers_dim_vec[idx] - (query_vec[j]);
                 chunk_dists[idx] += (float)(diff * diff);
@@ -278,6 +297,8 @@ void PQL2Distance<data_t>::prepopulate_chunkwise_distances(const float *query_ve
 }
 
 template DISKANN_DLLEXPORT class PQL2Distance<int8_t>;
+template DISKANN_DLLEXPORT class PQL2Distance<float16>;
+template DISKANN_DLLEXPORT class PQL2Distance<bfloat16>;
 template DISKANN_DLLEXPORT class PQL2Distance<uint8_t>;
 template DISKANN_DLLEXPORT class PQL2Distance<float>;
 
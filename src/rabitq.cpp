@@ -0,0 +1,363 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "mkl.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <random>
+
+#ifdef USE_AVX2
+#include <immintrin.h>
+#endif
+
+#include "rabitq.h"
+#include "partition.h"
+#include "utils.h"
+
+namespace diskann
+{
+namespace
+{
+inline uint32_t popcount64(uint64_t x)
+{
+#ifdef USE_AVX2
+    return (uint32_t)_mm_popcnt_u64(x);
+#else
+    return (uint32_t)std::bitset<64>(x).count();
+#endif
+}
+
+// factors stored after the sign bits of a record
+struct RecordFactors
+{
+    float norm;
+    float inv_ip;
+    float bound;
+    float num_ones;
+};
+
+inline RecordFactors get_factors(const uint8_t *record, size_t num_words)
+{
+    RecordFactors f;
+    memcpy(&f, record + num_words * sizeof(uint64_t), sizeof(f));
+    return f;
+}
+} // namespace
+
+void RaBitQuantizer::train(const float *train_data, size_t num_train, size_t dim)
+{
+    _dim = dim;
+    _center.reset(new float[dim]);
+    _rotation.reset(new float[dim * dim]);
+
+    std::vector<double> sum(dim, 0.0);
+    for (size_t i = 0; i < num_train; i++)
+        for (size_t j = 0; j < dim; j++)
+            sum[j] += train_data[i * dim + j];
+    for (size_t j = 0; j < dim; j++)
+        _center[j] = num_train == 0 ? 0.0f : (float)(sum[j] / num_train);
+
+    // Orthonormalize the rows of a gaussian matrix (modified Gram-Schmidt),
+    // which gives a uniformly random rotation.
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::normal_distribution<double> distribution(0.0, 1.0);
+    std::vector<double> rows(dim * dim);
+    for (size_t i = 0; i < dim; i++)
+    {
+        double *row = rows.data() + i * dim;
+        double norm = 0;
+        while (norm < 1e-6)
+        {
+            for (size_t j = 0; j < dim; j++)
+                row[j] = distribution(generator);
+            for (size_t k = 0; k < i; k++)
+            {
+                const double *prev = rows.data() + k * dim;
+                double dot = 0;
+                for (size_t j = 0; j < dim; j++)
+                    dot += row[j] * prev[j];
+                for (size_t j = 0; j < dim; j++)
+                    row[j] -= dot * prev[j];
+            }
+            norm = 0;
+            for (size_t j = 0; j < dim; j++)
+                norm += row[j] * row[j];
+            norm = std::sqrt(norm);
+        }
+        for (size_t j = 0; j < dim; j++)
+        {
+            row[j] /= norm;
+            _rotation[i * dim + j] = (float)row[j];
+        }
+    }
+}
+
+void RaBitQuantizer::save(const std::string &pivots_file) const
+{
+    std::unique_ptr<float[]> pivots(new float[(_dim + 1) * _dim]);
+    memcpy(pivots.get(), _center.get(), _dim * sizeof(float));
+    memcpy(pivots.get() + _dim, _rotation.get(), _dim * _dim * sizeof(float));
+    save_bin<float>(pivots_file, pivots.get(), _dim + 1, _dim);
+}
+
+void RaBitQuantizer::load(const std::string &pivots_file)
+{
+    std::unique_ptr<float[]> pivots;
+    size_t rows, dim;
+    load_bin<float>(pivots_file, pivots, rows, dim);
+    if (rows != dim + 1)
+    {
+        throw ANNException("ERROR: " + pivots_file + " must hold " + std::to_string(dim + 1) + " rows of " +
+                               std::to_string(dim) + " floats, found " + std::to_string(rows),
+                           -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+    _dim = dim;
+    _center.reset(new float[dim]);
+    _rotation.reset(new float[dim * dim]);
+    memcpy(_center.get(), pivots.get(), dim * sizeof(float));
+    memcpy(_rotation.get(), pivots.get() + dim, dim * dim * sizeof(float));
+}
+
+void RaBitQuantizer::rotate(const float *vector, float *rotated) const
+{
+    for (size_t i = 0; i < _dim; i++)
+    {
+        const float *row = _rotation.get() + i * _dim;
+        float sum = 0;
+        for (size_t j = 0; j < _dim; j++)
+            sum += row[j] * (vector[j] - _center[j]);
+        rotated[i] = sum;
+    }
+}
+
+void RaBitQuantizer::encode(const float *vectors, size_t num_pts, uint8_t *records) const
+{
+    std::vector<float> centered(num_pts * _dim), rotated(num_pts * _dim);
+    for (size_t i = 0; i < num_pts; i++)
+        for (size_t j = 0; j < _dim; j++)
+            centered[i * _dim + j] = vectors[i * _dim + j] - _center[j];
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, (MKL_INT)num_pts, (MKL_INT)_dim, (MKL_INT)_dim, 1.0f,
+                centered.data(), (MKL_INT)_dim, _rotation.get(), (MKL_INT)_dim, 0.0f, rotated.data(), (MKL_INT)_dim);
+
+    const size_t words = num_words();
+    const float sqrt_dim = std::sqrt((float)_dim);
+    const float bound_scale = _dim > 1 ? RABITQ_ERROR_EPSILON / std::sqrt((float)(_dim - 1)) : 0.0f;
+    for (size_t i = 0; i < num_pts; i++)
+    {
+        const float *r = rotated.data() + i * _dim;
+        uint8_t *record = records + i * record_len();
+        uint64_t *bits = (uint64_t *)record;
+        memset(bits, 0, words * sizeof(uint64_t));
+
+        float sq_norm = 0, abs_sum = 0;
+        uint32_t num_ones = 0;
+        for (size_t j = 0; j < _dim; j++)
+        {
+            sq_norm += r[j] * r[j];
+            abs_sum += std::fabs(r[j]);
+            if (r[j] > 0)
+            {
+                bits[j / 64] |= (uint64_t)1 << (j % 64);
+                num_ones++;
+            }
+        }
+
+        RecordFactors f;
+        f.norm = std::sqrt(sq_norm);
+        f.num_ones = (float)num_ones;
+        if (f.norm > 0)
+        {
+            // <r / |r|, x> with x_j = +-1 / sqrt(dim), always >= 1 / sqrt(dim)
+            float ip = std::min(abs_sum / (sqrt_dim * f.norm), 1.0f);
+            f.inv_ip = 1.0f / ip;
+            f.bound = std::sqrt(1.0f - ip * ip) / ip * bound_scale;
+        }
+        else
+        {
+            f.inv_ip = 0;
+            f.bound = 0;
+        }
+        memcpy(record + words * sizeof(uint64_t), &f, sizeof(f));
+    }
+}
+
+void RaBitQuantizer::decode(const uint8_t *record, float *vector) const
+{
+    const uint64_t *bits = (const uint64_t *)record;
+    const RecordFactors f = get_factors(record, num_words());
+    const float coord = f.norm / std::sqrt((float)_dim);
+    memcpy(vector, _center.get(), _dim * sizeof(float));
+    for (size_t i = 0; i < _dim; i++)
+    {
+        // column i of R^T is row i of R
+        const float x = (bits[i / 64] >> (i % 64)) & 1 ? coord : -coord;
+        const float *row = _rotation.get() + i * _dim;
+        for (size_t j = 0; j < _dim; j++)
+            vector[j] += x * row[j];
+    }
+}
+
+float RaBitQuantizer::get_norm(const uint8_t *record) const
+{
+    return get_factors(record, num_words()).norm;
+}
+
+void RaBitQuantizer::preprocess_query(const float *query, float *rotated, RaBitQQuery &query_out) const
+{
+    const size_t words = num_words();
+    memset(query_out.planes, 0, RABITQ_QUERY_BITS * words * sizeof(uint64_t));
+    query_out.norm = query_out.lower = query_out.step = query_out.code_sum = 0;
+
+    rotate(query, rotated);
+    float sq_norm = 0;
+    for (size_t j = 0; j < _dim; j++)
+        sq_norm += rotated[j] * rotated[j];
+    query_out.norm = std::sqrt(sq_norm);
+    if (query_out.norm == 0)
+        return;
+
+    float lower = std::numeric_limits<float>::max(), upper = std::numeric_limits<float>::lowest();
+    for (size_t j = 0; j < _dim; j++)
+    {
+        rotated[j] /= query_out.norm;
+        lower = std::min(lower, rotated[j]);
+        upper = std::max(upper, rotated[j]);
+    }
+    const uint32_t max_code = (1u << RABITQ_QUERY_BITS) - 1;
+    const float step = (upper - lower) / (float)max_code;
+    uint32_t code_sum = 0;
+    for (size_t j = 0; j < _dim; j++)
+    {
+        uint32_t u = step > 0 ? (uint32_t)std::min(std::round((rotated[j] - lower) / step), (float)max_code) : 0;
+        code_sum += u;
+        for (uint32_t b = 0; b < RABITQ_QUERY_BITS; b++)
+        {
+            if (u & (1u << b))
+                query_out.planes[b * words + j / 64] |= (uint64_t)1 << (j % 64);
+        }
+    }
+    query_out.lower = lower;
+    query_out.step = step;
+    query_out.code_sum = (float)code_sum;
+}
+
+float RaBitQuantizer::estimate(const RaBitQQuery &query, const uint8_t *record, float *bound) const
+{
+    const size_t words = num_words();
+    const uint64_t *bits = (const uint64_t *)record;
+    const RecordFactors f = get_factors(record, words);
+
+    // <x_b, u> over the bit planes of the query codes
+    uint64_t bits_dot_codes = 0;
+    for (uint32_t b = 0; b < RABITQ_QUERY_BITS; b++)
+    {
+        const uint64_t *plane = query.planes + b * words;
+        uint32_t count = 0;
+        for (size_t w = 0; w < words; w++)
+            count += popcount64(bits[w] & plane[w]);
+        bits_dot_codes += (uint64_t)count << b;
+    }
+
+    // <x, q> with x_j = (2 x_b,j - 1) / sqrt(dim) and q_j = lower + step * u_j
+    const float sqrt_dim = std::sqrt((float)_dim);
+    float x_dot_q = (2 * query.step * (float)bits_dot_codes + 2 * query.lower * f.num_ones -
+                     query.step * query.code_sum - (float)_dim * query.lower) /
+                    sqrt_dim;
+    float cos_estimate = x_dot_q * f.inv_ip;
+
+    float norm_product = f.norm * query.norm;
+    if (bound != nullptr)
+        *bound = 2 * norm_product * f.bound;
+    return f.norm * f.norm + query.norm * query.norm - 2 * norm_product * cos_estimate;
+}
+
+void RaBitQuantizer::estimate(const RaBitQQuery &query, const uint8_t *codes, const uint32_t *ids, size_t n,
+                              float *dists, float *bounds) const
+{
+    const size_t len = record_len();
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i + 1 < n)
+            prefetch_vector((const char *)codes + (size_t)ids[i + 1] * len, len);
+        dists[i] = estimate(query, codes + (size_t)ids[i] * len, bounds == nullptr ? nullptr : bounds + i);
+    }
+}
+
+float RaBitQuantizer::symmetric_distance(const uint8_t *record1, const uint8_t *record2) const
+{
+    const size_t words = num_words();
+    const uint64_t *bits1 = (const uint64_t *)record1;
+    const uint64_t *bits2 = (const uint64_t *)record2;
+    uint32_t hamming = 0;
+    for (size_t w = 0; w < words; w++)
+        hamming += popcount64(bits1[w] ^ bits2[w]);
+
+    // after a random rotation, each coordinate acts as a random hyperplane,
+    // so the fraction of differing signs estimates angle / pi
+    const float pi = 3.14159265358979f;
+    float cos_estimate = std::cos(pi * (float)hamming / (float)_dim);
+    const RecordFactors f1 = get_factors(record1, words), f2 = get_factors(record2, words);
+    return f1.norm * f1.norm + f2.norm * f2.norm - 2 * f1.norm * f2.norm * cos_estimate;
+}
+
+template <typename T>
+void generate_rabitq_data(const std::string &data_file, double p_val, const std::string &pivots_file,
+                          const std::string &codes_file)
+{
+    size_t num_points, dim;
+    get_bin_metadata(data_file, num_points, dim);
+
+    size_t train_size, train_dim;
+    float *train_data;
+    p_val = std::min(p_val, (double)RABITQ_TRAINING_SET_SIZE / (double)num_points);
+    gen_random_slice<T>(data_file, p_val, train_data, train_size, train_dim);
+    diskann::cout << "Training RaBitQ on " << train_size << " points of dimension " << train_dim << std::endl;
+
+    RaBitQuantizer quantizer;
+    quantizer.train(train_data, train_size, train_dim);
+    delete[] train_data;
+    quantizer.save(pivots_file);
+
+    const size_t len = quantizer.record_len();
+    std::ofstream writer;
+    open_file_to_write(writer, codes_file);
+    int npts_i32 = (int)num_points, len_i32 = (int)len;
+    writer.write((char *)&npts_i32, sizeof(int));
+    writer.write((char *)&len_i32, sizeof(int));
+
+    const size_t block_size = std::max<size_t>(1, std::min<size_t>(num_points, 65536));
+    std::unique_ptr<T[]> block_T(new T[block_size * dim]);
+    std::unique_ptr<float[]> block_float(new float[block_size * dim]);
+    std::unique_ptr<uint8_t[]> block_codes(new uint8_t[block_size * len]);
+    std::ifstream reader(data_file, std::ios::binary);
+    reader.seekg(2 * sizeof(uint32_t), reader.beg);
+    for (size_t start = 0; start < num_points; start += block_size)
+    {
+        size_t count = std::min(block_size, num_points - start);
+        reader.read((char *)block_T.get(), count * dim * sizeof(T));
+        convert_types<T, float>(block_T.get(), block_float.get(), count, dim);
+        quantizer.encode(block_float.get(), count, block_codes.get());
+        writer.write((char *)block_codes.get(), count * len);
+    }
+    diskann::cout << "Saved RaBitQ codes of " << num_points << " points to " << codes_file << std::endl;
+}
+
+template DISKANN_DLLEXPORT void generate_rabitq_data<float>(const std::string &data_file, double p_val,
+                                                           const std::string &pivots_file,
+                                                           const std::string &codes_file);
+template DISKANN_DLLEXPORT void generate_rabitq_data<int8_t>(const std::string &data_file, double p_val,
+                                                            const std::string &pivots_file,
+                                                            const std::string &codes_file);
+template DISKANN_DLLEXPORT void generate_rabitq_data<float16>(const std::string &data_file, double p_val,
+                                                              const std::string &pivots_file,
+                                                              const std::string &codes_file);
+template DISKANN_DLLEXPORT void generate_rabitq_data<bfloat16>(const std::string &data_file, double p_val,
+                                                               const std::string &pivots_file,
+                                                               const std::string &codes_file);
+template DISKANN_DLLEXPORT void generate_rabitq_data<uint8_t>(const std::string &data_file, double p_val,
+                                                             const std::string &pivots_file,
+                                                             const std::string &codes_file);
+} // namespace diskann
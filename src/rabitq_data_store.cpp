@@ -0,0 +1,398 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "abstract_scratch.h"
+#include "pq_scratch.h"
+#include "rabitq_data_store.h"
+#include "utils.h"
+
+namespace diskann
+{
+template <typename data_t>
+RaBitQDataStore<data_t>::RaBitQDataStore(const location_t capacity, const size_t dim,
+                                         std::unique_ptr<Distance<data_t>> distance_fn)
+    : AbstractDataStore<data_t>(capacity, dim), _record_len(RaBitQuantizer::record_len(dim)),
+      _distance_fn(std::move(distance_fn))
+{
+    if (_distance_fn->get_metric() != Metric::L2)
+    {
+        throw ANNException("ERROR: RaBitQ quantization supports only the L2 metric", -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+    }
+    alloc_aligned(((void **)&_codes), this->_capacity * _record_len, 8);
+    std::memset(_codes, 0, this->_capacity * _record_len);
+}
+
+template <typename data_t> RaBitQDataStore<data_t>::~RaBitQDataStore()
+{
+    if (_codes != nullptr)
+    {
+        aligned_free(_codes);
+    }
+}
+
+template <typename data_t> size_t RaBitQDataStore<data_t>::get_aligned_dim() const
+{
+    return this->_dim;
+}
+
+template <typename data_t> size_t RaBitQDataStore<data_t>::get_alignment_factor() const
+{
+    return 1;
+}
+
+template <typename data_t> location_t RaBitQDataStore<data_t>::load(const std::string &filename)
+{
+    const std::string pivots_file = get_rabitq_pivots_filename(filename);
+    if (!file_exists(filename) || !file_exists(pivots_file))
+    {
+        std::stringstream stream;
+        stream << "ERROR: quantized data file " << filename << " or its quantizer " << pivots_file
+               << " does not exist." << std::endl;
+        diskann::cerr << stream.str() << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    size_t file_num_points, file_dim;
+    diskann::get_bin_metadata(filename, file_num_points, file_dim);
+    if (file_dim != this->_dim || get_file_size(filename) != 2 * sizeof(uint32_t) + file_num_points * _record_len)
+    {
+        std::stringstream stream;
+        stream << "ERROR: " << filename << " does not hold RaBitQ codes of dimension " << this->_dim << "."
+               << std::endl;
+        diskann::cerr << stream.str() << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    _quantizer.load(pivots_file);
+    if (_quantizer.get_dim() != this->_dim)
+    {
+        throw diskann::ANNException("ERROR: " + pivots_file + " is not a quantizer of dimension " +
+                                        std::to_string(this->_dim),
+                                    -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    if (file_num_points > this->capacity())
+    {
+        this->resize((location_t)file_num_points);
+    }
+    std::ifstream reader(filename, std::ios::binary);
+    reader.seekg(2 * sizeof(uint32_t), reader.beg);
+    reader.read((char *)_codes, file_num_points * _record_len);
+
+    return (location_t)file_num_points;
+}
+
+template <typename data_t>
+size_t RaBitQDataStore<data_t>::save(const std::string &filename, const location_t num_points)
+{
+    std::ofstream writer;
+    open_file_to_write(writer, filename);
+    int npts_i32 = (int)num_points, ndims_i32 = (int)this->_dim;
+    writer.write((char *)&npts_i32, sizeof(int));
+    writer.write((char *)&ndims_i32, sizeof(int));
+    writer.write((char *)_codes, num_points * _record_len);
+    writer.close();
+
+    const std::string pivots_file = get_rabitq_pivots_filename(filename);
+    _quantizer.save(pivots_file);
+
+    return 2 * sizeof(uint32_t) + num_points * _record_len + get_file_size(pivots_file);
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::encode(const data_t *vectors, const size_t num_pts, uint8_t *records,
+                                     std::vector<float> &block) const
+{
+    block.resize(num_pts * this->_dim);
+    convert_types<data_t, float>(vectors, block.data(), num_pts, this->_dim);
+    _quantizer.encode(block.data(), num_pts, records);
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::populate_data(const data_t *vectors, const location_t num_pts)
+{
+    if (num_pts > this->capacity())
+    {
+        this->resize(num_pts);
+    }
+
+    // train on an evenly spaced sample
+    const size_t stride = std::max<size_t>(1, DIV_ROUND_UP((size_t)num_pts, RABITQ_TRAINING_SET_SIZE));
+    std::vector<float> train;
+    for (size_t i = 0; i < num_pts; i += stride)
+    {
+        for (size_t j = 0; j < this->_dim; j++)
+            train.push_back((float)vectors[i * this->_dim + j]);
+    }
+    _quantizer.train(train.data(), train.size() / this->_dim, this->_dim);
+
+    const size_t block_size = 65536;
+    std::vector<float> block;
+    for (size_t start = 0; start < num_pts; start += block_size)
+    {
+        size_t count = std::min(block_size, (size_t)num_pts - start);
+        encode(vectors + start * this->_dim, count, _codes + start * _record_len, block);
+    }
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::populate_data(const std::string &filename, const size_t offset)
+{
+    size_t npts, ndim;
+    diskann::get_bin_metadata(filename, npts, ndim, offset);
+    if (ndim != this->_dim)
+    {
+        std::stringstream ss;
+        ss << "Number of dimensions of a point in the file: " << filename
+           << " is not equal to dimensions of data store: " << this->_dim << "." << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    if (npts > this->capacity())
+    {
+        this->resize((location_t)npts);
+    }
+
+    // Stream the file in blocks, once to sample the training points and once
+    // to encode, so the full precision data is never resident.
+    const size_t block_size = std::max<size_t>(1, std::min<size_t>(npts, 65536));
+    const size_t stride = std::max<size_t>(1, DIV_ROUND_UP(npts, RABITQ_TRAINING_SET_SIZE));
+    std::unique_ptr<data_t[]> block(new data_t[block_size * ndim]);
+    std::vector<float> block_float, train;
+    std::ifstream reader(filename, std::ios::binary);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        reader.seekg(offset + 2 * sizeof(uint32_t), reader.beg);
+        for (size_t start = 0; start < npts; start += block_size)
+        {
+            size_t count = std::min(block_size, npts - start);
+            reader.read((char *)block.get(), count * ndim * sizeof(data_t));
+            if (pass == 0)
+            {
+                for (size_t i = DIV_ROUND_UP(start, stride) * stride; i < start + count; i += stride)
+                {
+                    for (size_t j = 0; j < ndim; j++)
+                        train.push_back((float)block[(i - start) * ndim + j]);
+                }
+            }
+            else
+            {
+                encode(block.get(), count, _codes + start * _record_len, block_float);
+            }
+        }
+        if (pass == 0)
+        {
+            _quantizer.train(train.data(), train.size() / ndim, ndim);
+        }
+    }
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::extract_data_to_bin(const std::string &filename, const location_t num_pts)
+{
+    std::unique_ptr<data_t[]> data(new data_t[(size_t)num_pts * this->_dim]);
+    for (location_t i = 0; i < num_pts; i++)
+    {
+        get_vector(i, data.get() + (size_t)i * this->_dim);
+    }
+    save_bin<data_t>(filename, data.get(), num_pts, this->_dim);
+}
+
+template <typename data_t> void RaBitQDataStore<data_t>::get_vector(const location_t i, data_t *target) const
+{
+    std::vector<float> vector(this->_dim);
+    _quantizer.decode(_codes + (size_t)i * _record_len, vector.data());
+    for (size_t j = 0; j < this->_dim; j++)
+        target[j] = is_floating_type<data_t>::value ? (data_t)vector[j] : (data_t)std::round(vector[j]);
+}
+
+template <typename data_t> void RaBitQDataStore<data_t>::set_vector(const location_t loc, const data_t *const vector)
+{
+    std::vector<float> block;
+    encode(vector, 1, _codes + (size_t)loc * _record_len, block);
+}
+
+template <typename data_t> void RaBitQDataStore<data_t>::prefetch_vector(const location_t loc)
+{
+    diskann::prefetch_vector((const char *)_codes + (size_t)loc * _record_len, _record_len);
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::preprocess_query(const data_t *query, AbstractScratch<data_t> *query_scratch) const
+{
+    PQScratch<data_t> *pq_scratch = query_scratch == nullptr ? nullptr : query_scratch->pq_scratch();
+    if (pq_scratch == nullptr)
+    {
+        throw diskann::ANNException("PQScratch space has not been set in the scratch object.", -1);
+    }
+    if (query != query_scratch->aligned_query_T())
+    {
+        memcpy(query_scratch->aligned_query_T(), query, sizeof(data_t) * this->get_dims());
+    }
+    pq_scratch->initialize(this->_dim, query);
+    _quantizer.preprocess_query(pq_scratch->aligned_query_float, pq_scratch->rotated_query, pq_scratch->rabitq_query);
+}
+
+template <typename data_t>
+const RaBitQQuery &RaBitQDataStore<data_t>::get_query(AbstractScratch<data_t> *scratch) const
+{
+    PQScratch<data_t> *pq_scratch = scratch == nullptr ? nullptr : scratch->pq_scratch();
+    if (pq_scratch == nullptr)
+    {
+        throw diskann::ANNException("PQScratch not set in scratch space.", -1);
+    }
+    return pq_scratch->rabitq_query;
+}
+
+template <typename data_t> float RaBitQDataStore<data_t>::get_distance(const data_t *query, const location_t loc) const
+{
+    std::vector<float> query_float(this->_dim), rotated(this->_dim);
+    std::vector<uint64_t> planes(RABITQ_QUERY_BITS * _quantizer.num_words());
+    convert_types<data_t, float>(query, query_float.data(), 1, this->_dim);
+    RaBitQQuery rabitq_query;
+    rabitq_query.planes = planes.data();
+    _quantizer.preprocess_query(query_float.data(), rotated.data(), rabitq_query);
+    return _quantizer.estimate(rabitq_query, _codes + (size_t)loc * _record_len);
+}
+
+template <typename data_t>
+float RaBitQDataStore<data_t>::get_distance(const location_t loc1, const location_t loc2) const
+{
+    return _quantizer.symmetric_distance(_codes + (size_t)loc1 * _record_len, _codes + (size_t)loc2 * _record_len);
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::get_distance(const data_t *preprocessed_query, const location_t *locations,
+                                           const uint32_t location_count, float *distances,
+                                           AbstractScratch<data_t> *scratch) const
+{
+    _quantizer.estimate(get_query(scratch), _codes, locations, location_count, distances, nullptr);
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::get_distance(const data_t *preprocessed_query, const std::vector<location_t> &ids,
+                                           std::vector<float> &distances, AbstractScratch<data_t> *scratch_space) const
+{
+    _quantizer.estimate(get_query(scratch_space), _codes, ids.data(), ids.size(), distances.data(), nullptr);
+}
+
+template <typename data_t> location_t RaBitQDataStore<data_t>::expand(const location_t new_size)
+{
+    if (new_size == this->capacity())
+    {
+        return this->capacity();
+    }
+    else if (new_size < this->capacity())
+    {
+        std::stringstream ss;
+        ss << "Cannot 'expand' datastore when new capacity (" << new_size << ") < existing capacity("
+           << this->capacity() << ")" << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    uint8_t *new_codes;
+    alloc_aligned((void **)&new_codes, (size_t)new_size * _record_len, 8);
+    memcpy(new_codes, _codes, (size_t)this->capacity() * _record_len);
+    memset(new_codes + (size_t)this->capacity() * _record_len, 0,
+           (size_t)(new_size - this->capacity()) * _record_len);
+    aligned_free(_codes);
+    _codes = new_codes;
+    this->_capacity = new_size;
+    return this->_capacity;
+}
+
+template <typename data_t> location_t RaBitQDataStore<data_t>::shrink(const location_t new_size)
+{
+    if (new_size == this->capacity())
+    {
+        return this->capacity();
+    }
+    else if (new_size > this->capacity())
+    {
+        std::stringstream ss;
+        ss << "Cannot 'shrink' datastore when new capacity (" << new_size << ") > existing capacity("
+           << this->capacity() << ")" << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    uint8_t *new_codes;
+    alloc_aligned((void **)&new_codes, (size_t)new_size * _record_len, 8);
+    memcpy(new_codes, _codes, (size_t)new_size * _record_len);
+    aligned_free(_codes);
+    _codes = new_codes;
+    this->_capacity = new_size;
+    return this->_capacity;
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::move_vectors(const location_t old_location_start, const location_t new_location_start,
+                                           const location_t num_locations)
+{
+    if (num_locations == 0 || old_location_start == new_location_start)
+    {
+        return;
+    }
+
+    // The [start, end) interval which will contain obsolete points to be
+    // cleared, not overlapping the newly copied range.
+    uint32_t mem_clear_loc_start = old_location_start;
+    uint32_t mem_clear_loc_end_limit = old_location_start + num_locations;
+    if (new_location_start < old_location_start)
+    {
+        if (mem_clear_loc_start < new_location_start + num_locations)
+            mem_clear_loc_start = new_location_start + num_locations;
+    }
+    else
+    {
+        if (mem_clear_loc_end_limit > new_location_start)
+            mem_clear_loc_end_limit = new_location_start;
+    }
+
+    copy_vectors(old_location_start, new_location_start, num_locations);
+    memset(_codes + (size_t)mem_clear_loc_start * _record_len, 0,
+           (size_t)(mem_clear_loc_end_limit - mem_clear_loc_start) * _record_len);
+}
+
+template <typename data_t>
+void RaBitQDataStore<data_t>::copy_vectors(const location_t from_loc, const location_t to_loc,
+                                           const location_t num_points)
+{
+    assert(from_loc < this->_capacity);
+    assert(to_loc < this->_capacity);
+    assert(num_points < this->_capacity);
+    memmove(_codes + (size_t)to_loc * _record_len, _codes + (size_t)from_loc * _record_len,
+            (size_t)num_points * _record_len);
+}
+
+template <typename data_t> location_t RaBitQDataStore<data_t>::calculate_medoid() const
+{
+    uint32_t min_idx = 0;
+    float min_norm = std::numeric_limits<float>::max();
+    for (location_t i = 0; i < this->capacity(); i++)
+    {
+        float norm = _quantizer.get_norm(_codes + (size_t)i * _record_len);
+        if (norm < min_norm)
+        {
+            min_idx = i;
+            min_norm = norm;
+        }
+    }
+    return min_idx;
+}
+
+template <typename data_t> Distance<data_t> *RaBitQDataStore<data_t>::get_dist_fn() const
+{
+    return _distance_fn.get();
+}
+
+template DISKANN_DLLEXPORT class RaBitQDataStore<float>;
+template DISKANN_DLLEXPORT class RaBitQDataStore<int8_t>;
+template DISKANN_DLLEXPORT class RaBitQDataStore<float16>;
+template DISKANN_DLLEXPORT class RaBitQDataStore<bfloat16>;
+template DISKANN_DLLEXPORT class RaBitQDataStore<uint8_t>;
+
+} // namespace diskann
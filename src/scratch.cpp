@@ -6,6 +6,7 @@
 
 #include "scratch.h"
 #include "pq_scratch.h"
+#include "pq.h"
 
 namespace diskann
 {
@@ -91,9 +92,11 @@ template <typename T> void SSDQueryScratch<T>::reset()
     visited.clear();
     retset.clear();
     full_retset.clear();
+    rerank_sectors.clear();
 }
 
-template <typename T> SSDQueryScratch<T>::SSDQueryScratch(size_t aligned_dim, size_t visited_reserve)
+template <typename T>
+SSDQueryScratch<T>::SSDQueryScratch(size_t aligned_dim, size_t visited_reserve, size_t pq_table_len)
 {
     size_t coord_alloc_size = ROUND_UP(sizeof(T) * aligned_dim, 256);
 
@@ -102,7 +105,14 @@ template <typename T> SSDQueryScratch<T>::SSDQueryScratch(size_t aligned_dim, si
                            defaults::SECTOR_LEN);
     diskann::alloc_aligned((void **)&this->_aligned_query_T, aligned_dim * sizeof(T), 8 * sizeof(T));
 
-    this->_pq_scratch = new PQScratch<T>(defaults::MAX_GRAPH_DEGREE, aligned_dim);
+    this->_pq_scratch = new PQScratch<T>(defaults::MAX_GRAPH_DEGREE, aligned_dim, pq_table_len);
+    nbr_scratch = new uint32_t[defaults::MAX_GRAPH_DEGREE];
+    diskann::alloc_aligned((void **)&disk_pq_query, aligned_dim * sizeof(float), 8 * sizeof(float));
+    rabitq_ids = new uint32_t[defaults::MAX_GRAPH_DEGREE];
+    rabitq_pos = new uint32_t[defaults::MAX_GRAPH_DEGREE];
+    rabitq_dists = new float[defaults::MAX_GRAPH_DEGREE];
+    rabitq_bounds = new float[defaults::MAX_GRAPH_DEGREE];
+    rabitq_codes = new uint8_t[defaults::MAX_GRAPH_DEGREE * MAX_PQ_CHUNKS];
 
     memset(coord_scratch, 0, coord_alloc_size);
     memset(this->_aligned_query_T, 0, aligned_dim * sizeof(T));
@@ -117,11 +127,20 @@ template <typename T> SSDQueryScratch<T>::~SSDQueryScratch()
     diskann::aligned_free((void *)sector_scratch);
     diskann::aligned_free((void *)this->_aligned_query_T);
 
+    diskann::aligned_free((void *)disk_pq_query);
+
     delete this->_pq_scratch;
+    delete[] nbr_scratch;
+    delete[] rabitq_ids;
+    delete[] rabitq_pos;
+    delete[] rabitq_dists;
+    delete[] rabitq_bounds;
+    delete[] rabitq_codes;
 }
 
 template <typename T>
-SSDThreadData<T>::SSDThreadData(size_t aligned_dim, size_t visited_reserve) : scratch(aligned_dim, visited_reserve)
+SSDThreadData<T>::SSDThreadData(size_t aligned_dim, size_t visited_reserve, size_t pq_table_len)
+    : scratch(aligned_dim, visited_reserve, pq_table_len)
 {
 }
 
@@ -130,14 +149,18 @@ template <typename T> void SSDThreadData<T>::clear()
     scratch.reset();
 }
 
-template <typename T> PQScratch<T>::PQScratch(size_t graph_degree, size_t aligned_dim)
+template <typename T> PQScratch<T>::PQScratch(size_t graph_degree, size_t aligned_dim, size_t pq_table_len)
 {
     diskann::alloc_aligned((void **)&aligned_pq_coord_scratch,
-                           (size_t)graph_degree * (size_t)MAX_PQ_CHUNKS * sizeof(uint8_t), 256);
-    diskann::alloc_aligned((void **)&aligned_pqtable_dist_scratch, 256 * (size_t)MAX_PQ_CHUNKS * sizeof(float), 256);
+                           transposed_codes_len(graph_degree, MAX_PQ_CHUNKS) * sizeof(uint8_t), 256);
+    diskann::alloc_aligned((void **)&aligned_pqtable_dist_scratch, pq_table_len * sizeof(float), 256);
     diskann::alloc_aligned((void **)&aligned_dist_scratch, (size_t)graph_degree * sizeof(float), 256);
     diskann::alloc_aligned((void **)&aligned_query_float, aligned_dim * sizeof(float), 8 * sizeof(float));
     diskann::alloc_aligned((void **)&rotated_query, aligned_dim * sizeof(float), 8 * sizeof(float));
+    diskann::alloc_aligned((void **)&aligned_fast_scan_lut, 16 * (size_t)MAX_PQ_CHUNKS * sizeof(uint8_t), 256);
+    diskann::alloc_aligned((void **)&aligned_fast_scan_codes, fast_scan_codes_len(graph_degree, MAX_PQ_CHUNKS), 256);
+    diskann::alloc_aligned((void **)&rabitq_query.planes,
+                           RABITQ_QUERY_BITS * DIV_ROUND_UP(aligned_dim, 64) * sizeof(uint64_t), 32);
 
     memset(aligned_query_float, 0, aligned_dim * sizeof(float));
     memset(rotated_query, 0, aligned_dim * sizeof(float));
@@ -150,6 +173,9 @@ template <typename T> PQScratch<T>::~PQScratch()
     diskann::aligned_free((void *)aligned_dist_scratch);
     diskann::aligned_free((void *)aligned_query_float);
     diskann::aligned_free((void *)rotated_query);
+    diskann::aligned_free((void *)aligned_fast_scan_lut);
+    diskann::aligned_free((void *)aligned_fast_scan_codes);
+    diskann::aligned_free((void *)rabitq_query.planes);
 }
 
 template <typename T> void PQScratch<T>::initialize(size_t dim, const T *query, const float norm)
@@ -164,18 +190,26 @@ template <typename T> void PQScratch<T>::initialize(size_t dim, const T *query,
 }
 
 template DISKANN_DLLEXPORT class InMemQueryScratch<int8_t>;
+template DISKANN_DLLEXPORT class InMemQueryScratch<float16>;
+template DISKANN_DLLEXPORT class InMemQueryScratch<bfloat16>;
 template DISKANN_DLLEXPORT class InMemQueryScratch<uint8_t>;
 template DISKANN_DLLEXPORT class InMemQueryScratch<float>;
 
 template DISKANN_DLLEXPORT class SSDQueryScratch<int8_t>;
+template DISKANN_DLLEXPORT class SSDQueryScratch<float16>;
+template DISKANN_DLLEXPORT class SSDQueryScratch<bfloat16>;
 template DISKANN_DLLEXPORT class SSDQueryScratch<uint8_t>;
 template DISKANN_DLLEXPORT class SSDQueryScratch<float>;
 
 template DISKANN_DLLEXPORT class PQScratch<int8_t>;
+template DISKANN_DLLEXPORT class PQScratch<float16>;
+template DISKANN_DLLEXPORT class PQScratch<bfloat16>;
 template DISKANN_DLLEXPORT class PQScratch<uint8_t>;
 template DISKANN_DLLEXPORT class PQScratch<float>;
 
 template DISKANN_DLLEXPORT class SSDThreadData<int8_t>;
+template DISKANN_DLLEXPORT class SSDThreadData<float16>;
+template DISKANN_DLLEXPORT class SSDThreadData<bfloat16>;
 template DISKANN_DLLEXPORT class SSDThreadData<uint8_t>;
 template DISKANN_DLLEXPORT class SSDThreadData<float>;
 
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <cstring>
+
+#include "ann_exception.h"
+#include "sector_cache.h"
+
+namespace diskann
+{
+SectorCache::SectorCache(uint64_t budget_bytes, uint64_t entry_len, uint32_t num_shards) : _entry_len(entry_len)
+{
+    if (entry_len == 0 || num_shards == 0)
+    {
+        throw ANNException("SectorCache needs a non-zero entry length and shard count.", -1, __FUNCSIG__, __FILE__,
+                           __LINE__);
+    }
+
+    uint64_t num_entries = budget_bytes / entry_len;
+    // no point in having shards that cannot hold anything
+    if (num_entries < num_shards)
+        num_shards = num_entries > 0 ? (uint32_t)num_entries : 1;
+    _entries_per_shard = (uint32_t)(num_entries / num_shards);
+
+    for (uint32_t s = 0; s < num_shards; s++)
+    {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->sector_to_slot.reserve(_entries_per_shard);
+        shard->slot_sector.resize(_entries_per_shard);
+        shard->referenced.resize(_entries_per_shard, 0);
+        shard->data.resize(_entries_per_shard * _entry_len);
+        _shards.push_back(std::move(shard));
+    }
+}
+
+bool SectorCache::lookup(uint64_t sector, char *buf)
+{
+    Shard &shard = shard_for(sector);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto iter = shard.sector_to_slot.find(sector);
+    if (iter == shard.sector_to_slot.end())
+    {
+        shard.stats.misses++;
+        return false;
+    }
+
+    uint32_t slot = iter->second;
+    shard.referenced[slot] = 1;
+    memcpy(buf, shard.data.data() + slot * _entry_len, _entry_len);
+    shard.stats.hits++;
+    return true;
+}
+
+void SectorCache::insert(uint64_t sector, const char *buf)
+{
+    if (_entries_per_shard == 0)
+        return;
+
+    Shard &shard = shard_for(sector);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    // another thread may have read the same entry concurrently
+    if (shard.sector_to_slot.find(sector) != shard.sector_to_slot.end())
+        return;
+
+    uint32_t slot;
+    if (shard.num_used < _entries_per_shard)
+    {
+        slot = shard.num_used++;
+    }
+    else
+    {
+        // CLOCK: give referenced entries a second chance
+        while (shard.referenced[shard.hand])
+        {
+            shard.referenced[shard.hand] = 0;
+            shard.hand = (shard.hand + 1) % _entries_per_shard;
+        }
+        slot = shard.hand;
+        shard.hand = (shard.hand + 1) % _entries_per_shard;
+        shard.sector_to_slot.erase(shard.slot_sector[slot]);
+        shard.stats.evictions++;
+    }
+
+    shard.slot_sector[slot] = sector;
+    shard.referenced[slot] = 0;
+    memcpy(shard.data.data() + slot * _entry_len, buf, _entry_len);
+    shard.sector_to_slot.insert(std::make_pair(sector, slot));
+    shard.stats.insertions++;
+}
+
+SectorCache::Stats SectorCache::get_stats()
+{
+    Stats total;
+    for (auto &shard : _shards)
+    {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        total.hits += shard->stats.hits;
+        total.misses += shard->stats.misses;
+        total.insertions += shard->stats.insertions;
+        total.evictions += shard->stats.evictions;
+    }
+    return total;
+}
+
+void SectorCache::reset_stats()
+{
+    for (auto &shard : _shards)
+    {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        shard->stats = Stats();
+    }
+}
+} // namespace diskann
@@ -0,0 +1,626 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#ifdef USE_AVX2
+#include <immintrin.h>
+#include "simd_utils.h"
+#endif
+
+#include "abstract_scratch.h"
+#include "sq_data_store.h"
+#include "utils.h"
+
+namespace diskann
+{
+namespace
+{
+// Accessors presenting a full precision vector and a quantized one the same
+// way to the distance kernels below: at(j) is coordinate j, and load8(j) the
+// coordinates [j, j + 8) for j a multiple of 8.
+template <typename T> struct FullVector
+{
+    const T *x;
+
+    float at(size_t j) const
+    {
+        return (float)x[j];
+    }
+#ifdef USE_AVX2
+    __m256 load8(size_t j) const;
+#endif
+};
+
+#ifdef USE_AVX2
+template <> inline __m256 FullVector<float>::load8(size_t j) const
+{
+    return _mm256_loadu_ps(x + j);
+}
+template <> inline __m256 FullVector<int8_t>::load8(size_t j) const
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(x + j))));
+}
+template <> inline __m256 FullVector<uint8_t>::load8(size_t j) const
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(x + j))));
+}
+template <> inline __m256 FullVector<float16>::load8(size_t j) const
+{
+    return _mm256_loadu_ph_ps(x + j);
+}
+template <> inline __m256 FullVector<bfloat16>::load8(size_t j) const
+{
+    return _mm256_loadu_pbh_ps(x + j);
+}
+#endif
+
+template <uint32_t BITS> struct SQVector
+{
+    const uint8_t *code;
+    const float *min;
+    const float *scale;
+
+    uint32_t code_at(size_t j) const
+    {
+        if (BITS == 8)
+            return code[j];
+        return (code[j / 2] >> (4 * (j % 2))) & 0xF;
+    }
+    float at(size_t j) const
+    {
+        return min[j] + scale[j] * (float)code_at(j);
+    }
+#ifdef USE_AVX2
+    __m256 load8(size_t j) const
+    {
+        __m256i c;
+        if (BITS == 8)
+        {
+            c = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(code + j)));
+        }
+        else
+        {
+            // spread the 4 bytes holding 8 nibbles to one byte per lane, then
+            // pick the low nibble in even lanes and the high one in odd lanes
+            int32_t packed;
+            memcpy(&packed, code + j / 2, sizeof(packed));
+            __m128i bytes =
+                _mm_shuffle_epi8(_mm_cvtsi32_si128(packed), _mm_setr_epi8(0, 0, 1, 1, 2, 2, 3, 3, -1, -1, -1, -1, -1,
+                                                                          -1, -1, -1));
+            c = _mm256_srlv_epi32(_mm256_cvtepu8_epi32(bytes), _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4));
+            c = _mm256_and_si256(c, _mm256_set1_epi32(0xF));
+        }
+        return _mm256_fmadd_ps(_mm256_cvtepi32_ps(c), _mm256_loadu_ps(scale + j), _mm256_loadu_ps(min + j));
+    }
+#endif
+};
+
+template <typename A, typename B> float l2_sqr(const A &a, const B &b, size_t dim)
+{
+    size_t j = 0;
+    float sum = 0;
+#ifdef USE_AVX2
+    __m256 acc = _mm256_setzero_ps();
+    for (; j + 8 <= dim; j += 8)
+    {
+        __m256 d = _mm256_sub_ps(a.load8(j), b.load8(j));
+        acc = _mm256_fmadd_ps(d, d, acc);
+    }
+    sum = _mm256_reduce_add_ps(acc);
+#endif
+    for (; j < dim; j++)
+    {
+        float d = a.at(j) - b.at(j);
+        sum += d * d;
+    }
+    return sum;
+}
+
+// ab = <a, b>, and with NORMS also aa = |a|^2, bb = |b|^2
+template <bool NORMS, typename A, typename B>
+void dot(const A &a, const B &b, size_t dim, float &ab, float &aa, float &bb)
+{
+    size_t j = 0;
+    ab = aa = bb = 0;
+#ifdef USE_AVX2
+    __m256 acc_ab = _mm256_setzero_ps(), acc_aa = _mm256_setzero_ps(), acc_bb = _mm256_setzero_ps();
+    for (; j + 8 <= dim; j += 8)
+    {
+        __m256 x = a.load8(j), y = b.load8(j);
+        acc_ab = _mm256_fmadd_ps(x, y, acc_ab);
+        if (NORMS)
+        {
+            acc_aa = _mm256_fmadd_ps(x, x, acc_aa);
+            acc_bb = _mm256_fmadd_ps(y, y, acc_bb);
+        }
+    }
+    ab = _mm256_reduce_add_ps(acc_ab);
+    if (NORMS)
+    {
+        aa = _mm256_reduce_add_ps(acc_aa);
+        bb = _mm256_reduce_add_ps(acc_bb);
+    }
+#endif
+    for (; j < dim; j++)
+    {
+        float x = a.at(j), y = b.at(j);
+        ab += x * y;
+        if (NORMS)
+        {
+            aa += x * x;
+            bb += y * y;
+        }
+    }
+}
+
+// distance under metric m, with the conventions of the full precision
+// distance functions: negated inner product for MIPS and 1 - cosine
+template <typename A, typename B> float metric_distance(Metric m, const A &a, const B &b, size_t dim)
+{
+    float ab, aa, bb;
+    switch (m)
+    {
+    case Metric::INNER_PRODUCT:
+        dot<false>(a, b, dim, ab, aa, bb);
+        return -ab;
+    case Metric::COSINE:
+        dot<true>(a, b, dim, ab, aa, bb);
+        if (aa == 0 || bb == 0)
+            return std::numeric_limits<float>::max();
+        return 1.0f - ab / std::sqrt(aa * bb);
+    default:
+        return l2_sqr(a, b, dim);
+    }
+}
+} // namespace
+
+template <typename data_t>
+SQDataStore<data_t>::SQDataStore(const location_t capacity, const size_t dim, const uint32_t num_bits,
+                                 std::unique_ptr<Distance<data_t>> distance_fn)
+    : AbstractDataStore<data_t>(capacity, dim), _num_bits(num_bits), _min(new float[dim]), _scale(new float[dim]),
+      _metric(distance_fn->get_metric()), _distance_fn(std::move(distance_fn))
+{
+    if (num_bits != 8 && num_bits != 4)
+    {
+        throw ANNException("ERROR: scalar quantization supports 8 or 4 bits per dimension, got " +
+                               std::to_string(num_bits),
+                           -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+    if (_metric != Metric::L2 && _metric != Metric::INNER_PRODUCT && _metric != Metric::COSINE)
+    {
+        throw ANNException("ERROR: scalar quantization supports only L2, inner product and cosine metrics", -1,
+                           __FUNCSIG__, __FILE__, __LINE__);
+    }
+    _code_len = num_bits == 8 ? dim : DIV_ROUND_UP(dim, 2);
+    std::fill(_min.get(), _min.get() + dim, 0.0f);
+    std::fill(_scale.get(), _scale.get() + dim, 0.0f);
+    alloc_aligned(((void **)&_codes), this->_capacity * _code_len, 1);
+    std::memset(_codes, 0, this->_capacity * _code_len);
+}
+
+template <typename data_t> SQDataStore<data_t>::~SQDataStore()
+{
+    if (_codes != nullptr)
+    {
+        aligned_free(_codes);
+    }
+}
+
+template <typename data_t> size_t SQDataStore<data_t>::get_aligned_dim() const
+{
+    return this->_dim;
+}
+
+template <typename data_t> size_t SQDataStore<data_t>::get_alignment_factor() const
+{
+    return 1;
+}
+
+template <typename data_t> uint32_t SQDataStore<data_t>::get_num_bits() const
+{
+    return _num_bits;
+}
+
+template <typename data_t> location_t SQDataStore<data_t>::load(const std::string &filename)
+{
+    const std::string params_file = filename + "_sq_params.bin";
+    if (!file_exists(filename) || !file_exists(params_file))
+    {
+        std::stringstream stream;
+        stream << "ERROR: quantized data file " << filename << " or its parameters " << params_file
+               << " does not exist." << std::endl;
+        diskann::cerr << stream.str() << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    size_t file_num_points, file_dim;
+    diskann::get_bin_metadata(filename, file_num_points, file_dim);
+    if (file_dim != this->_dim || get_file_size(filename) != 2 * sizeof(uint32_t) + file_num_points * _code_len)
+    {
+        std::stringstream stream;
+        stream << "ERROR: " << filename << " does not hold " << _num_bits << "-bit quantized vectors of dimension "
+               << this->_dim << "." << std::endl;
+        diskann::cerr << stream.str() << std::endl;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+
+    std::unique_ptr<float[]> params;
+    size_t params_rows, params_dim;
+    diskann::load_bin<float>(params_file, params, params_rows, params_dim);
+    if (params_rows != 2 || params_dim != this->_dim)
+    {
+        throw diskann::ANNException("ERROR: " + params_file + " must hold 2 rows of " + std::to_string(this->_dim) +
+                                        " floats",
+                                    -1, __FUNCSIG__, __FILE__, __LINE__);
+    }
+    memcpy(_min.get(), params.get(), this->_dim * sizeof(float));
+    memcpy(_scale.get(), params.get() + this->_dim, this->_dim * sizeof(float));
+
+    if (file_num_points > this->capacity())
+    {
+        this->resize((location_t)file_num_points);
+    }
+    std::ifstream reader(filename, std::ios::binary);
+    reader.seekg(2 * sizeof(uint32_t), reader.beg);
+    reader.read((char *)_codes, file_num_points * _code_len);
+
+    return (location_t)file_num_points;
+}
+
+template <typename data_t> size_t SQDataStore<data_t>::save(const std::string &filename, const location_t num_points)
+{
+    std::ofstream writer;
+    open_file_to_write(writer, filename);
+    int npts_i32 = (int)num_points, ndims_i32 = (int)this->_dim;
+    writer.write((char *)&npts_i32, sizeof(int));
+    writer.write((char *)&ndims_i32, sizeof(int));
+    writer.write((char *)_codes, num_points * _code_len);
+    writer.close();
+
+    std::unique_ptr<float[]> params(new float[2 * this->_dim]);
+    memcpy(params.get(), _min.get(), this->_dim * sizeof(float));
+    memcpy(params.get() + this->_dim, _scale.get(), this->_dim * sizeof(float));
+    size_t params_bytes = save_bin<float>(filename + "_sq_params.bin", params.get(), 2, this->_dim);
+
+    return 2 * sizeof(uint32_t) + num_points * _code_len + params_bytes;
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::extend_range(const data_t *vectors, const size_t num_pts, std::vector<float> &max)
+{
+    for (size_t i = 0; i < num_pts; i++)
+    {
+        const data_t *vec = vectors + i * this->_dim;
+        for (size_t j = 0; j < this->_dim; j++)
+        {
+            _min[j] = std::min(_min[j], (float)vec[j]);
+            max[j] = std::max(max[j], (float)vec[j]);
+        }
+    }
+}
+
+template <typename data_t> void SQDataStore<data_t>::set_scale(const std::vector<float> &max)
+{
+    const float num_levels = (float)((1u << _num_bits) - 1);
+    for (size_t j = 0; j < this->_dim; j++)
+    {
+        if (max[j] < _min[j])
+        {
+            // no points seen
+            _min[j] = 0;
+            _scale[j] = 0;
+        }
+        else
+        {
+            _scale[j] = (max[j] - _min[j]) / num_levels;
+        }
+    }
+}
+
+template <typename data_t> void SQDataStore<data_t>::quantize(const data_t *vector, uint8_t *code) const
+{
+    const uint32_t max_code = (1u << _num_bits) - 1;
+    memset(code, 0, _code_len);
+    for (size_t j = 0; j < this->_dim; j++)
+    {
+        uint32_t c = 0;
+        if (_scale[j] > 0)
+        {
+            float level = std::round(((float)vector[j] - _min[j]) / _scale[j]);
+            c = (uint32_t)std::min(std::max(level, 0.0f), (float)max_code);
+        }
+        if (_num_bits == 8)
+            code[j] = (uint8_t)c;
+        else
+            code[j / 2] |= (uint8_t)(c << (4 * (j % 2)));
+    }
+}
+
+template <typename data_t> void SQDataStore<data_t>::populate_data(const data_t *vectors, const location_t num_pts)
+{
+    if (num_pts > this->capacity())
+    {
+        this->resize(num_pts);
+    }
+    std::vector<float> max(this->_dim, std::numeric_limits<float>::lowest());
+    std::fill(_min.get(), _min.get() + this->_dim, std::numeric_limits<float>::max());
+    extend_range(vectors, num_pts, max);
+    set_scale(max);
+    for (location_t i = 0; i < num_pts; i++)
+    {
+        quantize(vectors + (size_t)i * this->_dim, _codes + (size_t)i * _code_len);
+    }
+}
+
+template <typename data_t> void SQDataStore<data_t>::populate_data(const std::string &filename, const size_t offset)
+{
+    size_t npts, ndim;
+    diskann::get_bin_metadata(filename, npts, ndim, offset);
+    if (ndim != this->_dim)
+    {
+        std::stringstream ss;
+        ss << "Number of dimensions of a point in the file: " << filename
+           << " is not equal to dimensions of data store: " << this->_dim << "." << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    if (npts > this->capacity())
+    {
+        this->resize((location_t)npts);
+    }
+
+    // Stream the file in blocks, once to train and once to quantize, so the
+    // full precision data is never resident.
+    const size_t block_size = std::max<size_t>(1, std::min<size_t>(npts, 65536));
+    std::unique_ptr<data_t[]> block(new data_t[block_size * ndim]);
+    std::ifstream reader(filename, std::ios::binary);
+
+    std::vector<float> max(this->_dim, std::numeric_limits<float>::lowest());
+    std::fill(_min.get(), _min.get() + this->_dim, std::numeric_limits<float>::max());
+    for (int pass = 0; pass < 2; pass++)
+    {
+        reader.seekg(offset + 2 * sizeof(uint32_t), reader.beg);
+        for (size_t start = 0; start < npts; start += block_size)
+        {
+            size_t count = std::min(block_size, npts - start);
+            reader.read((char *)block.get(), count * ndim * sizeof(data_t));
+            if (pass == 0)
+            {
+                extend_range(block.get(), count, max);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; i++)
+                    quantize(block.get() + i * ndim, _codes + (start + i) * _code_len);
+            }
+        }
+        if (pass == 0)
+        {
+            set_scale(max);
+        }
+    }
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::extract_data_to_bin(const std::string &filename, const location_t num_pts)
+{
+    std::unique_ptr<data_t[]> data(new data_t[(size_t)num_pts * this->_dim]);
+    for (location_t i = 0; i < num_pts; i++)
+    {
+        get_vector(i, data.get() + (size_t)i * this->_dim);
+    }
+    save_bin<data_t>(filename, data.get(), num_pts, this->_dim);
+}
+
+template <typename data_t> void SQDataStore<data_t>::get_vector(const location_t i, data_t *target) const
+{
+    const uint8_t *code = _codes + (size_t)i * _code_len;
+    for (size_t j = 0; j < this->_dim; j++)
+    {
+        uint32_t c = _num_bits == 8 ? code[j] : (code[j / 2] >> (4 * (j % 2))) & 0xF;
+        float value = _min[j] + _scale[j] * (float)c;
+        target[j] = is_floating_type<data_t>::value ? (data_t)value : (data_t)std::round(value);
+    }
+}
+
+template <typename data_t> void SQDataStore<data_t>::set_vector(const location_t loc, const data_t *const vector)
+{
+    quantize(vector, _codes + (size_t)loc * _code_len);
+}
+
+template <typename data_t> void SQDataStore<data_t>::prefetch_vector(const location_t loc)
+{
+    diskann::prefetch_vector((const char *)_codes + (size_t)loc * _code_len, _code_len);
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::preprocess_query(const data_t *query, AbstractScratch<data_t> *query_scratch) const
+{
+    if (query_scratch == nullptr)
+    {
+        std::stringstream ss;
+        ss << "In SQDataStore::preprocess_query: Query scratch is null";
+        diskann::cerr << ss.str() << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    if (query != query_scratch->aligned_query_T())
+    {
+        memcpy(query_scratch->aligned_query_T(), query, sizeof(data_t) * this->get_dims());
+    }
+}
+
+template <typename data_t>
+float SQDataStore<data_t>::query_distance(const data_t *query, const uint8_t *code) const
+{
+    FullVector<data_t> q{query};
+    if (_num_bits == 8)
+        return metric_distance(_metric, q, SQVector<8>{code, _min.get(), _scale.get()}, this->_dim);
+    return metric_distance(_metric, q, SQVector<4>{code, _min.get(), _scale.get()}, this->_dim);
+}
+
+template <typename data_t> float SQDataStore<data_t>::get_distance(const data_t *query, const location_t loc) const
+{
+    return query_distance(query, _codes + (size_t)loc * _code_len);
+}
+
+template <typename data_t>
+float SQDataStore<data_t>::get_distance(const location_t loc1, const location_t loc2) const
+{
+    const uint8_t *code1 = _codes + (size_t)loc1 * _code_len;
+    const uint8_t *code2 = _codes + (size_t)loc2 * _code_len;
+    if (_num_bits == 8)
+        return metric_distance(_metric, SQVector<8>{code1, _min.get(), _scale.get()},
+                               SQVector<8>{code2, _min.get(), _scale.get()}, this->_dim);
+    return metric_distance(_metric, SQVector<4>{code1, _min.get(), _scale.get()},
+                           SQVector<4>{code2, _min.get(), _scale.get()}, this->_dim);
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::get_distance(const data_t *preprocessed_query, const location_t *locations,
+                                       const uint32_t location_count, float *distances,
+                                       AbstractScratch<data_t> *scratch) const
+{
+    for (uint32_t i = 0; i < location_count; i++)
+    {
+        if (i + 1 < location_count)
+            diskann::prefetch_vector((const char *)_codes + (size_t)locations[i + 1] * _code_len, _code_len);
+        distances[i] = query_distance(preprocessed_query, _codes + (size_t)locations[i] * _code_len);
+    }
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::get_distance(const data_t *preprocessed_query, const std::vector<location_t> &ids,
+                                       std::vector<float> &distances, AbstractScratch<data_t> *scratch_space) const
+{
+    get_distance(preprocessed_query, ids.data(), (uint32_t)ids.size(), distances.data(), scratch_space);
+}
+
+template <typename data_t> location_t SQDataStore<data_t>::expand(const location_t new_size)
+{
+    if (new_size == this->capacity())
+    {
+        return this->capacity();
+    }
+    else if (new_size < this->capacity())
+    {
+        std::stringstream ss;
+        ss << "Cannot 'expand' datastore when new capacity (" << new_size << ") < existing capacity("
+           << this->capacity() << ")" << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    uint8_t *new_codes;
+    alloc_aligned((void **)&new_codes, (size_t)new_size * _code_len, 1);
+    memcpy(new_codes, _codes, (size_t)this->capacity() * _code_len);
+    memset(new_codes + (size_t)this->capacity() * _code_len, 0, (size_t)(new_size - this->capacity()) * _code_len);
+    aligned_free(_codes);
+    _codes = new_codes;
+    this->_capacity = new_size;
+    return this->_capacity;
+}
+
+template <typename data_t> location_t SQDataStore<data_t>::shrink(const location_t new_size)
+{
+    if (new_size == this->capacity())
+    {
+        return this->capacity();
+    }
+    else if (new_size > this->capacity())
+    {
+        std::stringstream ss;
+        ss << "Cannot 'shrink' datastore when new capacity (" << new_size << ") > existing capacity("
+           << this->capacity() << ")" << std::endl;
+        throw diskann::ANNException(ss.str(), -1);
+    }
+    uint8_t *new_codes;
+    alloc_aligned((void **)&new_codes, (size_t)new_size * _code_len, 1);
+    memcpy(new_codes, _codes, (size_t)new_size * _code_len);
+    aligned_free(_codes);
+    _codes = new_codes;
+    this->_capacity = new_size;
+    return this->_capacity;
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::move_vectors(const location_t old_location_start, const location_t new_location_start,
+                                       const location_t num_locations)
+{
+    if (num_locations == 0 || old_location_start == new_location_start)
+    {
+        return;
+    }
+
+    // The [start, end) interval which will contain obsolete points to be
+    // cleared, not overlapping the newly copied range.
+    uint32_t mem_clear_loc_start = old_location_start;
+    uint32_t mem_clear_loc_end_limit = old_location_start + num_locations;
+    if (new_location_start < old_location_start)
+    {
+        if (mem_clear_loc_start < new_location_start + num_locations)
+            mem_clear_loc_start = new_location_start + num_locations;
+    }
+    else
+    {
+        if (mem_clear_loc_end_limit > new_location_start)
+            mem_clear_loc_end_limit = new_location_start;
+    }
+
+    copy_vectors(old_location_start, new_location_start, num_locations);
+    memset(_codes + (size_t)mem_clear_loc_start * _code_len, 0,
+           (size_t)(mem_clear_loc_end_limit - mem_clear_loc_start) * _code_len);
+}
+
+template <typename data_t>
+void SQDataStore<data_t>::copy_vectors(const location_t from_loc, const location_t to_loc, const location_t num_points)
+{
+    assert(from_loc < this->_capacity);
+    assert(to_loc < this->_capacity);
+    assert(num_points < this->_capacity);
+    memmove(_codes + (size_t)to_loc * _code_len, _codes + (size_t)from_loc * _code_len, (size_t)num_points * _code_len);
+}
+
+template <typename data_t> location_t SQDataStore<data_t>::calculate_medoid() const
+{
+    // the centroid in code space maps to the centroid of the reconstructions
+    std::vector<double> code_sum(this->_dim, 0.0);
+    for (location_t i = 0; i < this->capacity(); i++)
+    {
+        const uint8_t *code = _codes + (size_t)i * _code_len;
+        for (size_t j = 0; j < this->_dim; j++)
+            code_sum[j] += _num_bits == 8 ? code[j] : (code[j / 2] >> (4 * (j % 2))) & 0xF;
+    }
+    std::vector<float> center(this->_dim);
+    for (size_t j = 0; j < this->_dim; j++)
+        center[j] = _min[j] + _scale[j] * (float)(code_sum[j] / this->capacity());
+
+    FullVector<float> c{center.data()};
+    uint32_t min_idx = 0;
+    float min_dist = std::numeric_limits<float>::max();
+    for (location_t i = 0; i < this->capacity(); i++)
+    {
+        const uint8_t *code = _codes + (size_t)i * _code_len;
+        float dist = _num_bits == 8 ? l2_sqr(c, SQVector<8>{code, _min.get(), _scale.get()}, this->_dim)
+                                    : l2_sqr(c, SQVector<4>{code, _min.get(), _scale.get()}, this->_dim);
+        if (dist < min_dist)
+        {
+            min_idx = i;
+            min_dist = dist;
+        }
+    }
+    return min_idx;
+}
+
+template <typename data_t> Distance<data_t> *SQDataStore<data_t>::get_dist_fn() const
+{
+    return _distance_fn.get();
+}
+
+template DISKANN_DLLEXPORT class SQDataStore<float>;
+template DISKANN_DLLEXPORT class SQDataStore<int8_t>;
+template DISKANN_DLLEXPORT class SQDataStore<float16>;
+template DISKANN_DLLEXPORT class SQDataStore<bfloat16>;
+template DISKANN_DLLEXPORT class SQDataStore<uint8_t>;
+
+} // namespace diskann
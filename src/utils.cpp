@@ -61,13 +61,39 @@ bool cpuHasAvx2Support()
     return false;
 }
 
+// AVX-512 F, BW, VL and VNNI, with the opmask and ZMM state enabled by the OS.
+bool cpuHasAvx512Support()
+{
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] < 7)
+        return false;
+    __cpuid(cpuInfo, 1);
+    bool osUsesXSAVE_XRSTORE = cpuInfo[2] & (1 << 27) || false;
+    if (!osUsesXSAVE_XRSTORE || (_xgetbv(_XCR_XFEATURE_ENABLED_MASK) & 0xe6) != 0xe6)
+        return false;
+    __cpuidex(cpuInfo, 7, 0);
+    static unsigned int ebxMask = (1u << 16) | (1u << 30) | (1u << 31);
+    static unsigned int ecxMask = 1u << 11;
+    return ((unsigned int)cpuInfo[1] & ebxMask) == ebxMask && ((unsigned int)cpuInfo[2] & ecxMask) == ecxMask;
+}
+
 bool AvxSupportedCPU = cpuHasAvxSupport();
 bool Avx2SupportedCPU = cpuHasAvx2Support();
+bool Avx512SupportedCPU = cpuHasAvx512Support();
 
 #else
 
+bool cpuHasAvx512Support()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512vnni");
+}
+
 bool Avx2SupportedCPU = true;
 bool AvxSupportedCPU = false;
+bool Avx512SupportedCPU = cpuHasAvx512Support();
 #endif
 
 namespace diskann
@@ -427,6 +453,10 @@ template DISKANN_DLLEXPORT void load_bin<uint8_t>(AlignedFileReader &reader, std
                                                   size_t &npts, size_t &ndim, size_t offset);
 template DISKANN_DLLEXPORT void load_bin<int8_t>(AlignedFileReader &reader, std::unique_ptr<int8_t[]> &data,
                                                  size_t &npts, size_t &ndim, size_t offset);
+template DISKANN_DLLEXPORT void load_bin<float16>(AlignedFileReader &reader, std::unique_ptr<float16[]> &data,
+                                                  size_t &npts, size_t &ndim, size_t offset);
+template DISKANN_DLLEXPORT void load_bin<bfloat16>(AlignedFileReader &reader, std::unique_ptr<bfloat16[]> &data,
+                                                   size_t &npts, size_t &ndim, size_t offset);
 template DISKANN_DLLEXPORT void load_bin<uint32_t>(AlignedFileReader &reader, std::unique_ptr<uint32_t[]> &data,
                                                    size_t &npts, size_t &ndim, size_t offset);
 template DISKANN_DLLEXPORT void load_bin<uint64_t>(AlignedFileReader &reader, std::unique_ptr<uint64_t[]> &data,
@@ -453,6 +483,12 @@ template DISKANN_DLLEXPORT void copy_aligned_data_from_file<uint8_t>(AlignedFile
 template DISKANN_DLLEXPORT void copy_aligned_data_from_file<int8_t>(AlignedFileReader &reader, int8_t *&data,
                                                                     size_t &npts, size_t &dim,
                                                                     const size_t &rounded_dim, size_t offset);
+template DISKANN_DLLEXPORT void copy_aligned_data_from_file<float16>(AlignedFileReader &reader, float16 *&data,
+                                                                     size_t &npts, size_t &dim,
+                                                                     const size_t &rounded_dim, size_t offset);
+template DISKANN_DLLEXPORT void copy_aligned_data_from_file<bfloat16>(AlignedFileReader &reader, bfloat16 *&data,
+                                                                      size_t &npts, size_t &dim,
+                                                                      const size_t &rounded_dim, size_t offset);
 template DISKANN_DLLEXPORT void copy_aligned_data_from_file<float>(AlignedFileReader &reader, float *&data,
                                                                    size_t &npts, size_t &dim, const size_t &rounded_dim,
                                                                    size_t offset);
@@ -462,12 +498,18 @@ template DISKANN_DLLEXPORT void read_array<char>(AlignedFileReader &reader, char
 template DISKANN_DLLEXPORT void read_array<uint8_t>(AlignedFileReader &reader, uint8_t *data, size_t size,
                                                     size_t offset);
 template DISKANN_DLLEXPORT void read_array<int8_t>(AlignedFileReader &reader, int8_t *data, size_t size, size_t offset);
+template DISKANN_DLLEXPORT void read_array<float16>(AlignedFileReader &reader, float16 *data, size_t size,
+                                                    size_t offset);
+template DISKANN_DLLEXPORT void read_array<bfloat16>(AlignedFileReader &reader, bfloat16 *data, size_t size,
+                                                     size_t offset);
 template DISKANN_DLLEXPORT void read_array<uint32_t>(AlignedFileReader &reader, uint32_t *data, size_t size,
                                                      size_t offset);
 template DISKANN_DLLEXPORT void read_array<float>(AlignedFileReader &reader, float *data, size_t size, size_t offset);
 
 template DISKANN_DLLEXPORT void read_value<uint8_t>(AlignedFileReader &reader, uint8_t &value, size_t offset);
 template DISKANN_DLLEXPORT void read_value<int8_t>(AlignedFileReader &reader, int8_t &value, size_t offset);
+template DISKANN_DLLEXPORT void read_value<float16>(AlignedFileReader &reader, float16 &value, size_t offset);
+template DISKANN_DLLEXPORT void read_value<bfloat16>(AlignedFileReader &reader, bfloat16 &value, size_t offset);
 template DISKANN_DLLEXPORT void read_value<float>(AlignedFileReader &reader, float &value, size_t offset);
 template DISKANN_DLLEXPORT void read_value<uint32_t>(AlignedFileReader &reader, uint32_t &value, size_t offset);
 template DISKANN_DLLEXPORT void read_value<uint64_t>(AlignedFileReader &reader, uint64_t &value, size_t offset);
@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "distance.h"
+#include "in_mem_data_store.h"
+#include "utils.h"
+
+namespace
+{
+// n random vectors of length elements, each in its own 64 byte aligned
+// allocation padded to a multiple of 16 elements plus 16. The padding is
+// filled with large values, so that a kernel reading past length gets a
+// visibly wrong distance.
+template <typename T> class TestVectors
+{
+  public:
+    TestVectors(std::mt19937 &gen, uint32_t n, uint32_t length)
+    {
+        const size_t alloc_len = ROUND_UP(length, 16) + 16;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            T *v;
+            diskann::alloc_aligned((void **)&v, ROUND_UP(alloc_len * sizeof(T), 64), 64);
+            for (size_t j = 0; j < alloc_len; j++)
+                v[j] = j < length ? random_value(gen) : (T)100;
+            _vectors.push_back(v);
+        }
+    }
+    ~TestVectors()
+    {
+        for (T *v : _vectors)
+            diskann::aligned_free(v);
+    }
+
+    const T *operator[](size_t i) const
+    {
+        return _vectors[i];
+    }
+    const T *const *data() const
+    {
+        return _vectors.data();
+    }
+
+  private:
+    static T random_value(std::mt19937 &gen)
+    {
+        // no zeros, since kernels disagree on the cosine distance (1 or nan)
+        // of a zero vector
+        if constexpr (std::is_floating_point<T>::value)
+            return (T)std::uniform_real_distribution<float>(0.01f, 1.0f)(gen) * (gen() % 2 ? 1 : -1);
+        else
+            return (T)std::uniform_int_distribution<int>(1, std::numeric_limits<T>::max())(gen) *
+                   (std::is_signed<T>::value && gen() % 2 ? -1 : 1);
+    }
+
+    std::vector<T *> _vectors;
+};
+
+bool close_enough(float a, float b)
+{
+    return std::abs(a - b) <= 1e-4f * (1.0f + std::abs(b));
+}
+
+// negated inner product, summed one element at a time
+class ScalarInnerProductFloat : public diskann::Distance<float>
+{
+  public:
+    ScalarInnerProductFloat() : diskann::Distance<float>(diskann::Metric::INNER_PRODUCT)
+    {
+    }
+    virtual float compare(const float *a, const float *b, uint32_t length) const
+    {
+        double dot = 0;
+        for (uint32_t i = 0; i < length; i++)
+            dot += (double)a[i] * b[i];
+        return (float)-dot;
+    }
+};
+
+// lengths below, at and above the 16 and 32 element steps of the kernels
+const uint32_t tail_lengths[] = {1, 15, 16, 17, 31, 32, 33, 64, 100, 129};
+
+// checks compare and compare_batch of dist against compare of reference, from
+// a query to 6 vectors of each of the lengths
+template <typename T>
+void check_same_distances(const diskann::Distance<T> &dist, const diskann::Distance<T> &reference)
+{
+    std::mt19937 gen(1);
+    const uint32_t n = 6;
+    for (uint32_t length : tail_lengths)
+    {
+        TestVectors<T> query(gen, 1, length), bases(gen, n, length);
+        float batch[n];
+        dist.compare_batch(query[0], bases.data(), n, length, batch);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            const float expected = reference.compare(query[0], bases[i], length);
+            BOOST_TEST(close_enough(dist.compare(query[0], bases[i], length), expected), "length " << length);
+            BOOST_TEST(close_enough(batch[i], expected), "length " << length << " batch " << i);
+        }
+    }
+}
+
+boost::test_tools::assertion_result avx512_supported(boost::unit_test::test_unit_id)
+{
+    boost::test_tools::assertion_result result(Avx512SupportedCPU);
+    result.message() << "the CPU does not support AVX-512";
+    return result;
+}
+
+// batch sizes with and without full groups of 4, and each remainder after them
+const uint32_t batch_sizes[] = {1, 3, 4, 5, 8, 9, 64, 67};
+
+// checks compare_batch of dist against one compare per vector, from a query to
+// each of the batch sizes of vectors of length elements
+template <typename T> void check_batch(const diskann::Distance<T> &dist, uint32_t length)
+{
+    std::mt19937 gen(2);
+    for (uint32_t n : batch_sizes)
+    {
+        TestVectors<T> query(gen, 1, length), bases(gen, n, length);
+        std::vector<float> batch(n + 1, -1.0f);
+        dist.compare_batch(query[0], bases.data(), n, length, batch.data());
+        for (uint32_t i = 0; i < n; i++)
+            BOOST_TEST(close_enough(batch[i], dist.compare(query[0], bases[i], length)),
+                       "length " << length << " n " << n << " batch " << i);
+        BOOST_TEST(batch[n] == -1.0f, "n " << n);
+    }
+}
+
+// the lengths Distance::specialize has kernels for
+const uint32_t fixed_lengths[] = {96, 104, 128, 256, 384, 512, 768, 960, 1024, 1536};
+
+// checks that dist specializes to each of the fixed lengths, and that compare
+// and compare_batch of the specialized distance match compare of dist, both at
+// the length it was specialized for and at a different one, where it falls
+// back to dist's own kernels
+template <typename T> void check_specialized(const diskann::Distance<T> &dist)
+{
+    std::mt19937 gen(4);
+    const uint32_t n = 7;
+    BOOST_TEST(!std::unique_ptr<diskann::Distance<T>>(dist.specialize(100)));
+    for (uint32_t fixed_length : fixed_lengths)
+    {
+        std::unique_ptr<diskann::Distance<T>> specialized(dist.specialize(fixed_length));
+        BOOST_TEST_REQUIRE((bool)specialized, "length " << fixed_length);
+        for (uint32_t length : {fixed_length, fixed_length - 8})
+        {
+            TestVectors<T> query(gen, 1, length), bases(gen, n, length);
+            float batch[n];
+            specialized->compare_batch(query[0], bases.data(), n, length, batch);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                const float expected = dist.compare(query[0], bases[i], length);
+                BOOST_TEST(close_enough(specialized->compare(query[0], bases[i], length), expected),
+                           "specialized " << fixed_length << " length " << length);
+                BOOST_TEST(close_enough(batch[i], expected),
+                           "specialized " << fixed_length << " length " << length << " batch " << i);
+            }
+        }
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(AVX512Distance_tests)
+
+BOOST_AUTO_TEST_CASE(test_float, *boost::unit_test::precondition(avx512_supported))
+{
+    check_same_distances(diskann::AVX512DistanceL2<float>(), diskann::SlowDistanceL2<float>());
+    check_same_distances(diskann::AVX512DistanceInnerProduct<float>(), ScalarInnerProductFloat());
+    check_same_distances(diskann::AVX512DistanceCosine<float>(), diskann::DistanceCosineFloat());
+}
+
+BOOST_AUTO_TEST_CASE(test_int8, *boost::unit_test::precondition(avx512_supported))
+{
+    check_same_distances(diskann::AVX512DistanceL2<int8_t>(), diskann::SlowDistanceL2<int8_t>());
+    check_same_distances(diskann::AVX512DistanceCosine<int8_t>(), diskann::DistanceCosineInt8());
+}
+
+BOOST_AUTO_TEST_CASE(test_uint8, *boost::unit_test::precondition(avx512_supported))
+{
+    check_same_distances(diskann::AVX512DistanceL2<uint8_t>(), diskann::DistanceL2UInt8());
+    check_same_distances(diskann::AVX512DistanceCosine<uint8_t>(), diskann::SlowDistanceCosineUInt8());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(DistanceBatch_tests)
+
+BOOST_AUTO_TEST_CASE(test_float)
+{
+    // the AVX2 kernels need lengths that are a multiple of 8
+    check_batch(diskann::DistanceL2Float(), 128);
+    check_batch(diskann::AVXDistanceInnerProductFloat(), 128);
+    check_batch(diskann::SlowDistanceL2<float>(), 100);
+
+    // the cosine distance over both of its inner products
+    const bool has_avx512 = Avx512SupportedCPU;
+    for (bool use_avx512 : {false, true})
+    {
+        if (use_avx512 && !has_avx512)
+            continue;
+        Avx512SupportedCPU = use_avx512;
+        check_batch(diskann::AVXNormalizedCosineDistanceFloat(), 128);
+    }
+    Avx512SupportedCPU = has_avx512;
+}
+
+BOOST_AUTO_TEST_CASE(test_avx512, *boost::unit_test::precondition(avx512_supported))
+{
+    for (uint32_t length : {17u, 100u})
+    {
+        check_batch(diskann::AVX512DistanceL2<float>(), length);
+        check_batch(diskann::AVX512DistanceInnerProduct<float>(), length);
+        check_batch(diskann::AVX512DistanceCosine<float>(), length);
+        check_batch(diskann::AVX512DistanceL2<int8_t>(), length);
+        check_batch(diskann::AVX512DistanceCosine<int8_t>(), length);
+        check_batch(diskann::AVX512DistanceL2<uint8_t>(), length);
+        check_batch(diskann::AVX512DistanceCosine<uint8_t>(), length);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_data_store_get_distance)
+{
+    // more points than one batch of the store, looked up in a random order
+    const uint32_t num_points = 200, dim = 100;
+    std::mt19937 gen(3);
+    diskann::InMemDataStore<float> store(num_points, dim, std::make_unique<diskann::DistanceL2Float>());
+    TestVectors<float> points(gen, num_points, dim), query(gen, 1, (uint32_t)store.get_aligned_dim());
+    for (uint32_t i = 0; i < num_points; i++)
+        store.set_vector(i, points[i]);
+
+    std::vector<uint32_t> locations(num_points);
+    for (uint32_t i = 0; i < num_points; i++)
+        locations[i] = i;
+    std::shuffle(locations.begin(), locations.end(), gen);
+    for (uint32_t count : {1u, 3u, 5u, 64u, 67u, 130u})
+    {
+        std::vector<float> distances(count);
+        store.get_distance(query[0], locations.data(), count, distances.data(), nullptr);
+        for (uint32_t i = 0; i < count; i++)
+            BOOST_TEST(close_enough(distances[i], store.get_distance(query[0], locations[i])),
+                       "count " << count << " point " << i);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(FixedLengthDistance_tests)
+
+BOOST_AUTO_TEST_CASE(test_float)
+{
+#ifdef USE_AVX2
+    // without AVX2 DistanceL2Float has no fixed length kernels
+    check_specialized(diskann::DistanceL2Float());
+#endif
+    check_specialized(diskann::AVXDistanceInnerProductFloat());
+
+    // the cosine distance picks its inner product when it is specialized
+    const bool has_avx512 = Avx512SupportedCPU;
+    for (bool use_avx512 : {false, true})
+    {
+        if (use_avx512 && !has_avx512)
+            continue;
+        Avx512SupportedCPU = use_avx512;
+        check_specialized(diskann::AVXNormalizedCosineDistanceFloat());
+    }
+    Avx512SupportedCPU = has_avx512;
+}
+
+BOOST_AUTO_TEST_CASE(test_avx512, *boost::unit_test::precondition(avx512_supported))
+{
+    check_specialized(diskann::AVX512DistanceL2<float>());
+    check_specialized(diskann::AVX512DistanceInnerProduct<float>());
+    check_specialized(diskann::AVX512DistanceCosine<float>());
+    check_specialized(diskann::AVX512DistanceL2<int8_t>());
+    check_specialized(diskann::AVX512DistanceCosine<int8_t>());
+    check_specialized(diskann::AVX512DistanceL2<uint8_t>());
+    check_specialized(diskann::AVX512DistanceCosine<uint8_t>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
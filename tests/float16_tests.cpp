@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <boost/test/unit_test.hpp>
+
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include "float16.h"
+
+using diskann::bfloat16;
+using diskann::float16;
+
+BOOST_AUTO_TEST_SUITE(Float16_tests)
+
+BOOST_AUTO_TEST_CASE(test_float16_round_to_even)
+{
+    BOOST_TEST(float16::from_float(1.0f) == 0x3c00);
+    // halfway between 1 and the next half, and between that and the one after
+    BOOST_TEST(float16::from_float(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);
+    BOOST_TEST(float16::from_float(1.0f + 3 * std::ldexp(1.0f, -11)) == 0x3c02);
+    BOOST_TEST(float16::from_float(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)) == 0x3c01);
+    BOOST_TEST(float16::from_float(-2.0f) == 0xc000);
+}
+
+BOOST_AUTO_TEST_CASE(test_float16_subnormals)
+{
+    const float min_subnormal = std::ldexp(1.0f, -24);
+    BOOST_TEST(float16::from_float(min_subnormal) == 0x0001);
+    BOOST_TEST(float16::from_float(0.5f * min_subnormal) == 0x0000);
+    BOOST_TEST(float16::from_float(1.5f * min_subnormal) == 0x0002);
+    BOOST_TEST(float16::from_float(-min_subnormal) == 0x8001);
+    BOOST_TEST(float16::from_float(std::ldexp(1023.0f, -24)) == 0x03ff);
+    // the largest subnormal rounds up to the smallest normal
+    BOOST_TEST(float16::from_float(std::ldexp(1023.75f, -24)) == 0x0400);
+    BOOST_TEST(float16::from_float(std::ldexp(1.0f, -14)) == 0x0400);
+
+    BOOST_TEST(float16::to_float(0x0001) == min_subnormal);
+    BOOST_TEST(float16::to_float(0x03ff) == std::ldexp(1023.0f, -24));
+    BOOST_TEST(std::signbit(float16::to_float(0x8000)));
+    BOOST_TEST(float16::from_float(-0.0f) == 0x8000);
+}
+
+BOOST_AUTO_TEST_CASE(test_float16_overflow_and_nan)
+{
+    BOOST_TEST(float16::from_float(65504.0f) == 0x7bff);
+    BOOST_TEST(float16::from_float(65519.0f) == 0x7bff);
+    BOOST_TEST(float16::from_float(65520.0f) == 0x7c00);
+    BOOST_TEST(float16::from_float(-1e10f) == 0xfc00);
+    BOOST_TEST(float16::from_float(std::numeric_limits<float>::infinity()) == 0x7c00);
+    BOOST_TEST(float16::to_float(0x7c00) == std::numeric_limits<float>::infinity());
+
+    const uint16_t nan = float16::from_float(std::numeric_limits<float>::quiet_NaN());
+    BOOST_TEST((nan & 0x7c00) == 0x7c00);
+    BOOST_TEST((nan & 0x03ff) != 0);
+    BOOST_TEST(std::isnan(float16::to_float(nan)));
+    BOOST_TEST(std::isnan((float)float16(std::numeric_limits<float>::signaling_NaN())));
+}
+
+BOOST_AUTO_TEST_CASE(test_float16_round_trip)
+{
+    // every finite half converts to float and back unchanged
+    for (uint32_t h = 0; h < 0x10000; h++)
+    {
+        if ((h & 0x7c00) == 0x7c00)
+            continue;
+        BOOST_TEST(float16::from_float(float16::to_float((uint16_t)h)) == h);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_bfloat16)
+{
+    BOOST_TEST(bfloat16::from_float(1.0f) == 0x3f80);
+    BOOST_TEST(bfloat16::from_float(1.0f + std::ldexp(1.0f, -8)) == 0x3f80);
+    BOOST_TEST(bfloat16::from_float(1.0f + 3 * std::ldexp(1.0f, -8)) == 0x3f82);
+    BOOST_TEST(bfloat16::from_float(FLT_MAX) == 0x7f80);
+    BOOST_TEST(bfloat16::from_float(bfloat16::to_float(0x7f7f)) == 0x7f7f);
+    BOOST_TEST(bfloat16::from_float(std::numeric_limits<float>::denorm_min()) == 0x0000);
+    BOOST_TEST(bfloat16::from_float(-std::numeric_limits<float>::infinity()) == 0xff80);
+
+    const uint16_t nan = bfloat16::from_float(std::numeric_limits<float>::quiet_NaN());
+    BOOST_TEST(std::isnan(bfloat16::to_float(nan)));
+    // a nan whose payload is all in the dropped bits must not become inf
+    BOOST_TEST(std::isnan((float)bfloat16(std::numeric_limits<float>::signaling_NaN())));
+    BOOST_TEST((float)bfloat16(2.5f) == 2.5f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
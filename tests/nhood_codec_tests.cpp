@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "nhood_codec.h"
+
+namespace
+{
+// encodes ids, checks the length bound, decodes them from a buffer of exactly
+// the encoded length and checks the sorted ids come back
+void check_round_trip(std::vector<uint32_t> ids)
+{
+    const uint32_t n = (uint32_t)ids.size();
+    std::vector<uint8_t> encoded(diskann::packed_nhood_max_len(n));
+    const size_t len = diskann::encode_packed_nhood(ids.data(), n, encoded.data());
+    BOOST_TEST(len <= diskann::packed_nhood_max_len(n));
+    BOOST_TEST(std::is_sorted(ids.begin(), ids.end()));
+
+    std::vector<uint8_t> exact(encoded.begin(), encoded.begin() + len);
+    // one guard id past the end to catch writes beyond out[n - 1]
+    std::vector<uint32_t> decoded(n + 1, 0xdeadbeef);
+    BOOST_TEST(diskann::decode_packed_nhood(exact.data(), n, decoded.data()) == len);
+    BOOST_TEST(std::equal(ids.begin(), ids.end(), decoded.begin()), "n " << n);
+    BOOST_TEST(decoded[n] == 0xdeadbeefu);
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(NhoodCodec_tests)
+
+BOOST_AUTO_TEST_CASE(test_round_trip_all_group_tails)
+{
+    // every n mod 4, with and without full groups for the SIMD path
+    std::mt19937 gen(1);
+    for (uint32_t n = 0; n <= 70; n++)
+    {
+        std::set<uint32_t> unique_ids;
+        while (unique_ids.size() < n)
+            unique_ids.insert(gen() % 1000000);
+        std::vector<uint32_t> ids(unique_ids.begin(), unique_ids.end());
+        std::shuffle(ids.begin(), ids.end(), gen);
+        check_round_trip(ids);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_round_trip_delta_lengths)
+{
+    // deltas of each byte length, in every position of a group
+    const uint32_t deltas[] = {0x7f, 0xff, 0x100, 0xffff, 0x10000, 0xffffff, 0x1000000};
+    for (uint32_t n = 1; n <= 9; n++)
+        for (uint32_t delta : deltas)
+        {
+            std::vector<uint32_t> ids;
+            uint32_t id = 0;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                ids.push_back(id);
+                id += i % 2 ? 1 : delta;
+            }
+            check_round_trip(ids);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_round_trip_large_deltas)
+{
+    check_round_trip({0xffffffff});
+    check_round_trip({0xffffffff, 0});
+    check_round_trip({0, 1, 0x80000000, 0xfffffffe, 0xffffffff});
+    check_round_trip({3, 0xffffffff, 2, 0xfffffff0, 1, 0x7fffffff, 0});
+
+    // four 4-byte deltas fill a group to its longest encoding
+    std::vector<uint32_t> ids = {0x01000000, 0x02000000, 0x03000000, 0x04000000};
+    std::vector<uint8_t> encoded(diskann::packed_nhood_max_len(4));
+    BOOST_TEST(diskann::encode_packed_nhood(ids.data(), 4, encoded.data()) == diskann::packed_nhood_max_len(4));
+    check_round_trip(ids);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
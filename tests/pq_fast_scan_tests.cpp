@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "pq.h"
+
+namespace
+{
+// point counts around the block sizes of both layouts
+const size_t test_n_pts[] = {1, 15, 16, 17, 31, 32, 33, 64, 70};
+const size_t test_n_chunks[] = {1, 2, 7, 16, 31, 32, 33, 65};
+
+// n_pts random nibble-packed 4-bit codes
+std::vector<uint8_t> random_4bit_codes(std::mt19937 &gen, size_t n_pts, size_t n_chunks,
+                                       std::vector<uint32_t> &code_ids)
+{
+    const size_t code_len = diskann::pq_code_len(n_chunks, PQ_FAST_SCAN_BITS);
+    std::vector<uint8_t> codes(n_pts * code_len, 0);
+    code_ids.resize(n_pts * n_chunks);
+    for (size_t i = 0; i < n_pts; i++)
+        for (size_t c = 0; c < n_chunks; c++)
+        {
+            code_ids[i * n_chunks + c] = gen() % PQ_FAST_SCAN_CENTROIDS;
+            codes[i * code_len + c / 2] |= (uint8_t)(code_ids[i * n_chunks + c] << (4 * (c % 2)));
+        }
+    return codes;
+}
+
+bool close_enough(float a, float b)
+{
+    return std::abs(a - b) <= 1e-4f * (1.0f + std::abs(b));
+}
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(PQFastScan_tests)
+
+BOOST_AUTO_TEST_CASE(test_get_pq_code_4bit)
+{
+    const uint8_t code[] = {0x21, 0x43, 0x05};
+    for (size_t c = 0; c < 5; c++)
+        BOOST_TEST(diskann::get_pq_code(code, c, PQ_FAST_SCAN_BITS) == c + 1);
+    BOOST_TEST(diskann::pq_code_len(5, PQ_FAST_SCAN_BITS) == 3u);
+    BOOST_TEST(diskann::pq_code_len(5, NUM_PQ_BITS) == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pack_fast_scan_codes)
+{
+    std::mt19937 gen(1);
+    for (size_t n_pts : test_n_pts)
+        for (size_t n_chunks : test_n_chunks)
+        {
+            std::vector<uint32_t> code_ids;
+            std::vector<uint8_t> codes = random_4bit_codes(gen, n_pts, n_chunks, code_ids);
+
+            const size_t block_len = ROUND_UP(n_chunks, 2) * 16;
+            std::vector<uint8_t> expected(diskann::fast_scan_codes_len(n_pts, n_chunks), 0);
+            for (size_t i = 0; i < n_pts; i++)
+                for (size_t c = 0; c < n_chunks; c++)
+                    expected[(i / PQ_FAST_SCAN_BLOCK) * block_len + c * 16 + i % 16] |=
+                        (uint8_t)(code_ids[i * n_chunks + c] << ((i % PQ_FAST_SCAN_BLOCK) < 16 ? 0 : 4));
+
+            std::vector<uint8_t> packed(expected.size(), 0xff);
+            diskann::pack_fast_scan_codes(codes.data(), n_pts, n_chunks, packed.data());
+            BOOST_TEST(packed == expected, "n_pts " << n_pts << " n_chunks " << n_chunks);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_pq_fast_scan_lookup)
+{
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<float> dist(0.0f, 10.0f);
+    for (size_t n_pts : test_n_pts)
+        for (size_t n_chunks : test_n_chunks)
+        {
+            std::vector<uint32_t> code_ids;
+            std::vector<uint8_t> codes = random_4bit_codes(gen, n_pts, n_chunks, code_ids);
+            std::vector<float> pq_dists(256 * n_chunks);
+            for (auto &d : pq_dists)
+                d = dist(gen);
+
+            std::vector<uint8_t> lut(ROUND_UP(n_chunks, 2) * 16);
+            float scale, bias;
+            diskann::quantize_fast_scan_lut(pq_dists.data(), n_chunks, lut.data(), scale, bias);
+
+            std::vector<uint8_t> packed(diskann::fast_scan_codes_len(n_pts, n_chunks));
+            diskann::pack_fast_scan_codes(codes.data(), n_pts, n_chunks, packed.data());
+            std::vector<float> dists(n_pts);
+            diskann::pq_fast_scan_lookup(packed.data(), n_pts, n_chunks, lut.data(), scale, bias, dists.data());
+
+            // the exact distances, from the unpacked codes
+            std::vector<float> exact(n_pts);
+            diskann::pq_dist_lookup(codes.data(), n_pts, n_chunks, pq_dists.data(), exact.data(),
+                                    PQ_FAST_SCAN_BITS);
+
+            for (size_t i = 0; i < n_pts; i++)
+            {
+                uint32_t lut_sum = 0;
+                float exact_sum = 0;
+                for (size_t c = 0; c < n_chunks; c++)
+                {
+                    lut_sum += lut[16 * c + code_ids[i * n_chunks + c]];
+                    exact_sum += pq_dists[256 * c + code_ids[i * n_chunks + c]];
+                }
+                BOOST_TEST(close_enough(dists[i], bias + scale * (float)lut_sum));
+                BOOST_TEST(close_enough(exact[i], exact_sum));
+                // each entry is off by at most half a quantization step
+                BOOST_TEST(std::abs(dists[i] - exact_sum) <= scale * (0.5f * n_chunks + 1));
+            }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_transpose_pq_codes)
+{
+    std::mt19937 gen(3);
+    for (size_t n_pts : test_n_pts)
+        for (size_t n_chunks : test_n_chunks)
+        {
+            std::vector<uint8_t> codes(n_pts * n_chunks);
+            for (auto &c : codes)
+                c = (uint8_t)gen();
+
+            std::vector<uint8_t> expected(diskann::transposed_codes_len(n_pts, n_chunks), 0);
+            for (size_t i = 0; i < n_pts; i++)
+                for (size_t c = 0; c < n_chunks; c++)
+                    expected[(i / PQ_TRANSPOSE_BLOCK) * PQ_TRANSPOSE_BLOCK * n_chunks + c * PQ_TRANSPOSE_BLOCK +
+                             i % PQ_TRANSPOSE_BLOCK] = codes[i * n_chunks + c];
+
+            std::vector<uint8_t> transposed(expected.size(), 0xff);
+            diskann::transpose_pq_codes(codes.data(), n_pts, n_chunks, transposed.data());
+            BOOST_TEST(transposed == expected, "n_pts " << n_pts << " n_chunks " << n_chunks);
+
+            std::vector<uint32_t> ids(n_pts);
+            for (size_t i = 0; i < n_pts; i++)
+                ids[i] = (uint32_t)(n_pts - 1 - i);
+            std::vector<uint8_t> aggregated(expected.size(), 0xff);
+            diskann::aggregate_coords_transposed(ids, codes.data(), n_chunks, aggregated.data());
+            for (size_t i = 0; i < n_pts; i++)
+                for (size_t c = 0; c < n_chunks; c++)
+                    BOOST_TEST(aggregated[(i / PQ_TRANSPOSE_BLOCK) * PQ_TRANSPOSE_BLOCK * n_chunks +
+                                          c * PQ_TRANSPOSE_BLOCK + i % PQ_TRANSPOSE_BLOCK] ==
+                               codes[ids[i] * n_chunks + c]);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_pq_dist_lookup_transposed)
+{
+    std::mt19937 gen(4);
+    std::uniform_real_distribution<float> dist(0.0f, 10.0f);
+    const bool has_avx2 = Avx2SupportedCPU;
+    for (size_t n_pts : test_n_pts)
+        for (size_t n_chunks : test_n_chunks)
+        {
+            std::vector<uint8_t> codes(n_pts * n_chunks);
+            for (auto &c : codes)
+                c = (uint8_t)gen();
+            std::vector<float> pq_dists(256 * n_chunks);
+            for (auto &d : pq_dists)
+                d = dist(gen);
+
+            std::vector<float> expected(n_pts);
+            diskann::pq_dist_lookup(codes.data(), n_pts, n_chunks, pq_dists.data(), expected.data());
+
+            std::vector<uint8_t> transposed(diskann::transposed_codes_len(n_pts, n_chunks));
+            diskann::transpose_pq_codes(codes.data(), n_pts, n_chunks, transposed.data());
+
+            // the scalar loop, and the AVX2 one where the CPU has it
+            for (bool use_avx2 : {false, true})
+            {
+                if (use_avx2 && !has_avx2)
+                    continue;
+                Avx2SupportedCPU = use_avx2;
+                std::vector<float> dists(n_pts, -1.0f);
+                diskann::pq_dist_lookup_transposed(transposed.data(), n_pts, n_chunks, pq_dists.data(),
+                                                   dists.data());
+                for (size_t i = 0; i < n_pts; i++)
+                    BOOST_TEST(close_enough(dists[i], expected[i]), "avx2 " << use_avx2 << " point " << i);
+            }
+            Avx2SupportedCPU = has_avx2;
+        }
+}
+
+BOOST_AUTO_TEST_SUITE_END()